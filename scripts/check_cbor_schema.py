@@ -0,0 +1,353 @@
+#!/usr/bin/env python3
+"""Check the C message schema (cbor_schema.h) against messages.cddl.
+
+The CBOR codec is driven by the X-macro field lists in
+src/lora/cbor_schema.h, which mirror src/messages/messages.cddl by hand.
+This script parses both, together with the message structs they refer
+to, and fails when they disagree: on the envelope keys and wire
+version, message type numbers, field count and order, CBOR kind, the
+size of each integer, byte string and list bound, and the channel
+ranges.  It runs as part of every build (see CMakeLists.txt).
+
+Usage: check_cbor_schema.py [repo root]
+"""
+
+import re
+import sys
+from pathlib import Path
+
+C_TYPE_SIZES = {
+    "bool": 1,
+    "uint8_t": 1,
+    "int8_t": 1,
+    "uint16_t": 2,
+    "int16_t": 2,
+    "uint32_t": 4,
+    "int32_t": 4,
+    "ts_status_t": 4,
+}
+
+# Envelope members in messages.cddl and their key macros in cbor.c
+ENVELOPE_KEYS = {
+    "wire-version": "KEY_VERSION",
+    "type": "KEY_TYPE",
+    "route": "KEY_ROUTE",
+    "payload": "KEY_DATA",
+}
+
+
+class SchemaError(Exception):
+    pass
+
+
+def join_continuations(text: str) -> str:
+    return re.sub(r"\\\n", " ", text)
+
+
+def parse_defines(text: str) -> dict[str, str]:
+    defines = {}
+    for m in re.finditer(r"^#define\s+(\w+)\s+(.+?)\s*(?:/[/*].*)?$",
+                         join_continuations(text), re.M):
+        defines[m.group(1)] = m.group(2)
+    return defines
+
+
+def eval_define(defines: dict[str, str], name: str) -> int:
+    expr = defines[name]
+    for _ in range(8):
+        expr = re.sub(r"\b(TS_\w+)\b", lambda m: f"({defines[m.group(1)]})",
+                      expr)
+    if not re.fullmatch(r"[\d\s()+\-*/]+", expr):
+        raise SchemaError(f"{name}: cannot evaluate '{expr}'")
+    return int(eval(expr))
+
+
+def strip_comments(text: str) -> str:
+    return re.sub(r"//.*", "", re.sub(r"/\*.*?\*/", "", text, 0, re.S))
+
+
+def parse_enum(text: str) -> dict[str, int]:
+    values, next_value = {}, 0
+    body = re.search(r"typedef enum \{(.*?)\} ts_msg_type_t;", text, re.S)
+    for m in re.finditer(r"(TS_MSG_\w+)(?:\s*=\s*(\d+))?\s*,",
+                         strip_comments(body.group(1))):
+        if m.group(2) is not None:
+            next_value = int(m.group(2))
+        values[m.group(1)] = next_value
+        next_value += 1
+    return values
+
+
+def parse_structs(text: str, defines: dict[str, str]) -> dict:
+    """Map struct name to {member: (c type, array length or None)}."""
+    structs = {}
+    for m in re.finditer(r"struct (\w+) \{(.*?)\};", text, re.S):
+        members = {}
+        for decl in strip_comments(m.group(2)).split(";"):
+            d = re.fullmatch(r"\s*((?:struct )?\w+)\s+(\w+)(?:\[(\w+)\])?\s*",
+                             decl)
+            if d is None:
+                continue
+            length = d.group(3)
+            if length is not None and not length.isdigit():
+                length = eval_define(defines, length)
+            members[d.group(2)] = (d.group(1),
+                                   None if length is None else int(length))
+        structs[m.group(1)] = members
+    return structs
+
+
+def parse_field_lists(text: str) -> dict[str, list[tuple]]:
+    """Map TS_CBOR_<NAME>_FIELDS to its (kind, member, aux, record) list."""
+    lists = {}
+    for m in re.finditer(r"#define (TS_CBOR_\w+_FIELDS)\(X, T\)(.*?)\n\n",
+                         join_continuations(text) + "\n\n", re.S):
+        lists[m.group(1)] = [
+            tuple(x.strip() for x in e.groups())
+            for e in re.finditer(r"X\(T,\s*(\w+),\s*(\w+),\s*([\w-]+),"
+                                 r"\s*([\w-]+)\)", m.group(2))
+        ]
+    return lists
+
+
+def parse_messages(text: str) -> list[tuple[str, str, str, str]]:
+    body = re.search(r"#define TS_CBOR_MESSAGES\(X\)(.*?)\n\n",
+                     join_continuations(text), re.S).group(1)
+    return re.findall(r"X\((TS_MSG_\w+),\s*(\w+),\s*struct (\w+),\s*"
+                      r"(TS_CBOR_\w+_FIELDS)\)", body)
+
+
+def parse_cddl(text: str) -> dict[str, object]:
+    """Map rule name to its entries, or to its type text if not a group.
+
+    Entries are (key or label, type, comment) tuples; the key is an int
+    for map rules and a label for array rules, where an unlabelled entry
+    is labelled by its type's rule name.
+    """
+    rules = {}
+    lines = text.splitlines()
+    i = 0
+    while i < len(lines):
+        m = re.match(r"([\w-]+)(?:<[^>]*>)?\s*=\s*(.*?)\s*(?:;.*)?$",
+                     lines[i])
+        i += 1
+        if m is None:
+            continue
+        name, rhs = m.groups()
+        if rhs not in ("{", "["):
+            while rhs.endswith("/"):
+                rhs += " " + lines[i].split(";")[0].strip()
+                i += 1
+            rules[name] = rhs
+            continue
+        entries = []
+        while not lines[i].startswith(("}", "]")):
+            entry, _, comment = lines[i].partition(";")
+            entry = entry.strip().rstrip(",")
+            i += 1
+            if not entry:
+                continue
+            keyed = re.fullmatch(r"(\d+)\s*=>\s*(.+)", entry)
+            labelled = re.fullmatch(r"([\w-]+):\s*(.+)", entry)
+            if keyed:
+                entries.append((int(keyed.group(1)), keyed.group(2),
+                                comment.strip()))
+            elif labelled:
+                entries.append((labelled.group(1), labelled.group(2),
+                                comment.strip()))
+            else:
+                entries.append((entry, entry, comment.strip()))
+        rules[name] = (rhs, entries)
+        i += 1
+    return rules
+
+
+class Checker:
+    def __init__(self, root: Path):
+        messages_h = (root / "src/messages/messages.h").read_text()
+        routing_h = (root / "src/routing/routing.h").read_text()
+        schema_h = (root / "src/lora/cbor_schema.h").read_text()
+        self.cbor_h = (root / "src/lora/cbor.h").read_text()
+        self.cbor_c = (root / "src/lora/cbor.c").read_text()
+        self.defines = parse_defines(messages_h)
+        self.enum = parse_enum(messages_h)
+        self.structs = parse_structs(messages_h + routing_h, self.defines)
+        self.field_lists = parse_field_lists(schema_h)
+        self.messages = parse_messages(schema_h)
+        self.rules = parse_cddl(
+            (root / "src/messages/messages.cddl").read_text())
+        self.errors = []
+
+    def error(self, where: str, what: str):
+        self.errors.append(f"{where}: {what}")
+
+    def resolve(self, type_text: str) -> str:
+        """Follow named rules down to a type expression."""
+        seen = set()
+        while type_text in self.rules and isinstance(self.rules[type_text],
+                                                     str):
+            if type_text in seen:
+                raise SchemaError(f"rule loop at {type_text}")
+            seen.add(type_text)
+            type_text = self.rules[type_text]
+        return type_text
+
+    def check_range(self, rule: str, lo: int, hi: int, where: str):
+        base = f"TS_TELEMETRY_{rule.upper()}"
+        if f"{base}_MIN" not in self.defines:
+            return
+        c_lo = eval_define(self.defines, f"{base}_MIN")
+        c_hi = eval_define(self.defines, f"{base}_MAX")
+        if (lo, hi) != (c_lo, c_hi):
+            self.error(where, f"{rule} is {lo}..{hi}, messages.h says "
+                       f"{c_lo}..{c_hi}")
+
+    def check_bound(self, bound: int, comment: str, where: str):
+        for name in re.findall(r"\bTS_\w+", comment):
+            if name in self.defines and eval_define(self.defines,
+                                                    name) != bound:
+                self.error(where, f"bound {bound} differs from {name}")
+
+    def check_field(self, type_text: str, comment: str, field: tuple,
+                    struct: str, where: str):
+        kind, member, aux, record = field
+        named = type_text if type_text in self.rules else None
+        resolved = self.resolve(type_text)
+        if member not in self.structs[struct]:
+            self.error(where, f"struct {struct} has no member {member}")
+            return
+        c_type, length = self.structs[struct][member]
+        c_size = C_TYPE_SIZES.get(c_type)
+
+        m = re.fullmatch(r"(uint|int) \.size (\d+)", resolved)
+        if m:
+            want = m.group(1).upper()
+            if kind != want:
+                self.error(where, f"{member} is {resolved}, schema says "
+                           f"{kind}")
+            if c_size != int(m.group(2)):
+                self.error(where, f"{member} is {resolved}, C member is "
+                           f"{c_type}")
+            return
+
+        m = re.fullmatch(r"(-?\d+)\.\.(-?\d+)", resolved)
+        if m:
+            lo, hi = int(m.group(1)), int(m.group(2))
+            if named:
+                self.check_range(named, lo, hi, where)
+            if kind not in ("INT", "UINT") or (lo < 0 and kind != "INT"):
+                self.error(where, f"{member} is {resolved}, schema says "
+                           f"{kind}")
+            elif c_size is not None:
+                bits = 8 * c_size - (kind == "INT")
+                if lo < -(1 << bits) or hi >= (1 << bits):
+                    self.error(where, f"{member} range {resolved} does not "
+                               f"fit {c_type}")
+            return
+
+        if resolved == "bool":
+            if kind != "BOOL" or c_type != "bool":
+                self.error(where, f"{member} is bool, schema says {kind}, "
+                           f"C member is {c_type}")
+            return
+
+        m = re.fullmatch(r"bstr \.size \(0\.\.(\d+)\)", resolved)
+        if m:
+            bound = int(m.group(1))
+            if kind != "BSTR":
+                self.error(where, f"{member} is bstr, schema says {kind}")
+            if length != bound:
+                self.error(where, f"{member} holds {length} bytes, cddl "
+                           f"allows {bound}")
+            self.check_bound(bound, comment, where)
+            return
+
+        m = re.fullmatch(r"\[1\*(\d+) ([\w-]+)\]", resolved)
+        if m:
+            bound, element = int(m.group(1)), m.group(2)
+            if kind != "LIST":
+                self.error(where, f"{member} is a list, schema says {kind}")
+                return
+            if length != bound:
+                self.error(where, f"{member} holds {length} records, cddl "
+                           f"allows {bound}")
+            self.check_bound(bound, comment, where)
+            self.check_group(element, record,
+                             c_type.removeprefix("struct "))
+            return
+
+        self.error(where, f"{member}: unsupported type '{resolved}'")
+
+    def check_group(self, rule: str, field_list: str, struct: str):
+        if rule not in self.rules or isinstance(self.rules[rule], str):
+            self.error(rule, "no such map or array rule in messages.cddl")
+            return
+        opener, entries = self.rules[rule]
+        fields = self.field_lists.get(field_list)
+        if fields is None:
+            self.error(rule, f"no {field_list} in cbor_schema.h")
+            return
+        if len(entries) != len(fields):
+            self.error(rule, f"{len(entries)} entries in messages.cddl, "
+                       f"{len(fields)} in {field_list}")
+        for pos, (entry, field) in enumerate(zip(entries, fields)):
+            key, type_text, comment = entry
+            where = f"{rule}[{pos}] ({field[1]})"
+            if opener == "{" and key != pos:
+                self.error(where, f"map key {key}, expected {pos}")
+            if opener == "[" and key != type_text and key != field[1]:
+                self.error(where, f"labelled {key} in messages.cddl")
+            if opener == "[" and field[0] in ("BSTR", "LIST"):
+                self.error(where, "records hold only UINT, INT or BOOL")
+            self.check_field(type_text, comment, field, struct, where)
+
+    def check_envelope(self):
+        opener, entries = self.rules["envelope"]
+        for key, member, _ in entries:
+            macro = ENVELOPE_KEYS.get(member)
+            m = re.search(rf"#define {macro} (\d+)", self.cbor_c)
+            if m is None or int(m.group(1)) != key:
+                self.error("envelope", f"{member} has key {key}, cbor.c "
+                           f"{macro} differs")
+        m = re.search(r"#define TS_CBOR_WIRE_VERSION (\d+)", self.cbor_h)
+        if m is None or self.rules.get("wire-version") != m.group(1):
+            self.error("wire-version", "differs from TS_CBOR_WIRE_VERSION")
+
+    def check(self) -> list[str]:
+        self.check_envelope()
+        self.check_group("route", "TS_CBOR_ROUTE_FIELDS", "ts_route_header")
+
+        envelopes = {}
+        for name, rhs in self.rules.items():
+            m = isinstance(rhs, str) and re.fullmatch(
+                r"envelope<(\d+), ([\w-]+)>", rhs)
+            if m:
+                envelopes[int(m.group(1))] = (name, m.group(2))
+
+        for msg_type, _, struct, field_list in self.messages:
+            number = self.enum.get(msg_type)
+            if number not in envelopes:
+                self.error(msg_type, f"type {number} has no envelope in "
+                           "messages.cddl")
+                continue
+            self.check_group(envelopes.pop(number)[1], field_list, struct)
+        for number, (name, _) in envelopes.items():
+            self.error(name, f"type {number} is not in TS_CBOR_MESSAGES")
+        return self.errors
+
+
+def main():
+    root = Path(sys.argv[1]) if len(sys.argv) > 1 else \
+        Path(__file__).resolve().parent.parent
+    try:
+        errors = Checker(root).check()
+    except (SchemaError, KeyError, AttributeError) as e:
+        errors = [f"cannot parse schema: {e!r}"]
+    for e in errors:
+        print(f"messages.cddl / cbor_schema.h mismatch: {e}",
+              file=sys.stderr)
+    sys.exit(1 if errors else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,193 @@
+#!/usr/bin/env python3
+"""Decode a gateway's binary UART uplink and print one JSON object per record.
+
+The source is a serial device or PTY (e.g. the one QEMU reports for
+-serial pty), or stdin when omitted.  Frames are COBS-encoded between zero
+delimiters and protected by CRC-16/CCITT-FALSE; see
+src/gateway/uplink_frame.h for the layout.  Bytes that don't form a valid
+frame (log output sharing the console) are skipped.  A summary with the
+record rate and link throughput is printed to stderr at the end.
+"""
+
+import json
+import struct
+import sys
+import time
+
+FRAME_VERSION = 1
+HEADER = struct.Struct(">BHB")  # version, seq, count
+RECORD_HEADER = struct.Struct(">BIHIhb")  # kind, rx_ms, src, msg_id, rssi, snr
+TELEMETRY = struct.Struct(">Iiii")
+STATUS = struct.Struct(">IIB")
+SUMMARY = struct.Struct(">IHHiiiiiiiii")
+VALUES_KIND = 3
+VALUES = struct.Struct(">IB")  # timestamp, count, then count x VALUE
+VALUE = struct.Struct(">Bi")  # channel id, value
+KINDS = {
+    0: ("telemetry", TELEMETRY, ("timestamp", "temperature", "humidity", "pressure")),
+    1: ("node_status", STATUS, ("timestamp", "uptime", "status")),
+    2: (
+        "telemetry_summary",
+        SUMMARY,
+        (
+            "timestamp",
+            "duration_s",
+            "count",
+            "temperature_min",
+            "temperature_max",
+            "temperature_mean",
+            "humidity_min",
+            "humidity_max",
+            "humidity_mean",
+            "pressure_min",
+            "pressure_max",
+            "pressure_mean",
+        ),
+    ),
+}
+
+
+def crc16_ccitt_false(data: bytes) -> int:
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_decode(data: bytes) -> bytes | None:
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        i += 1
+        if code == 0 or i + code - 1 > len(data):
+            return None
+        out += data[i : i + code - 1]
+        i += code - 1
+        if code < 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def parse_values(raw: bytes, pos: int, end: int) -> tuple[dict, int] | None:
+    """Return (fields, body size) of a sensor values record."""
+    if pos + VALUES.size > end:
+        return None
+    timestamp, count = VALUES.unpack_from(raw, pos)
+    size = VALUES.size + count * VALUE.size
+    if pos + size > end:
+        return None
+    values = []
+    for i in range(count):
+        channel, value = VALUE.unpack_from(raw, pos + VALUES.size + i * VALUE.size)
+        values.append({"id": channel, "value": value})
+    return {"timestamp": timestamp, "values": values}, size
+
+
+def parse_frame(raw: bytes) -> tuple[int, list[dict]] | None:
+    """Return (seq, records) for a valid frame, None otherwise."""
+    if len(raw) < HEADER.size + 2 or crc16_ccitt_false(raw) != 0:
+        return None
+    version, seq, count = HEADER.unpack_from(raw)
+    if version != FRAME_VERSION:
+        return None
+
+    records = []
+    pos = HEADER.size
+    body_end = len(raw) - 2
+    for _ in range(count):
+        if pos + RECORD_HEADER.size > body_end:
+            return None
+        kind, rx_ms, src, msg_id, rssi, snr = RECORD_HEADER.unpack_from(raw, pos)
+        pos += RECORD_HEADER.size
+        record = {
+            "rx_ms": rx_ms,
+            "src": src,
+            "msg_id": msg_id,
+            "rssi": rssi,
+            "snr": snr,
+        }
+        if kind == VALUES_KIND:
+            parsed = parse_values(raw, pos, body_end)
+            if parsed is None:
+                return None
+            values, size = parsed
+            record = {"type": "sensor_values", **record, **values}
+            pos += size
+            records.append(record)
+            continue
+        if kind not in KINDS:
+            return None
+        name, body, fields = KINDS[kind]
+        if pos + body.size > body_end:
+            return None
+        record = {"type": name, **record}
+        record.update(zip(fields, body.unpack_from(raw, pos)))
+        pos += body.size
+        records.append(record)
+    if pos != body_end:
+        return None
+    return seq, records
+
+
+def read_chunks(stream):
+    while True:
+        chunk = stream.read1(4096) if hasattr(stream, "read1") else stream.read(4096)
+        if not chunk:
+            return
+        yield chunk
+
+
+def main():
+    if len(sys.argv) > 2:
+        print(f"Usage: {sys.argv[0]} [serial device or pty]")
+        sys.exit(1)
+
+    stream = (
+        open(sys.argv[1], "rb", buffering=0)
+        if len(sys.argv) == 2
+        else sys.stdin.buffer
+    )
+    frames = records = bad = lost = total_bytes = 0
+    last_seq = None
+    pending = bytearray()
+    start = time.monotonic()
+
+    try:
+        for chunk in read_chunks(stream):
+            total_bytes += len(chunk)
+            pending += chunk
+            *blocks, rest = pending.split(b"\x00")
+            pending = bytearray(rest)
+            for block in blocks:
+                if not block:
+                    continue
+                raw = cobs_decode(block)
+                parsed = parse_frame(raw) if raw is not None else None
+                if parsed is None:
+                    bad += 1
+                    continue
+                seq, frame_records = parsed
+                if last_seq is not None:
+                    lost += (seq - last_seq - 1) & 0xFFFF
+                last_seq = seq
+                frames += 1
+                records += len(frame_records)
+                for record in frame_records:
+                    print(json.dumps(record), flush=True)
+    except KeyboardInterrupt:
+        pass
+
+    elapsed = max(time.monotonic() - start, 1e-6)
+    print(
+        f"{records} records in {frames} frames ({lost} lost, {bad} invalid blocks), "
+        f"{records / elapsed:.1f} records/s, {total_bytes / elapsed:.0f} B/s",
+        file=sys.stderr,
+    )
+
+
+if __name__ == "__main__":
+    main()
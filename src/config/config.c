@@ -2,6 +2,10 @@
 
 #include <string.h>
 #include <zephyr/settings/settings.h>
+#include <zephyr/sys/util.h>
+
+#include "messages/messages.h"
+#include "sensors/bme280_profile.h"
 
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(config);
@@ -20,9 +24,27 @@ struct ts_config_key {
     int32_t max;
 };
 
+// Longest key name, NUL included.  Every name is checked against it
+// at build time, so the "ts/" names built from them are never cut.
+#define KEY_NAME_SIZE 32
+#define FULL_NAME_SIZE (sizeof("ts/") - 1 + KEY_NAME_SIZE)
+
+BUILD_ASSERT(FULL_NAME_SIZE <= SETTINGS_MAX_NAME_LEN + 1,
+             "Config keys must fit the settings name limit");
+
+// The field name as a string; the struct only carries the length check
+#define KEY_NAME(field)                                               \
+    (sizeof(struct {                                                  \
+         BUILD_ASSERT(sizeof(#field) <= KEY_NAME_SIZE,                \
+                      "Config key " #field " exceeds KEY_NAME_SIZE"); \
+         int unused;                                                  \
+     })                                                               \
+         ? #field                                                     \
+         : NULL)
+
 #define CONFIG_KEY(field, lo, hi)                    \
     {                                                \
-        .name = #field,                              \
+        .name = KEY_NAME(field),                     \
         .offset = offsetof(struct ts_config, field), \
         .size = sizeof(((struct ts_config *)0)->field), \
         .min = (lo),                                 \
@@ -43,8 +65,24 @@ static const struct ts_config_key config_keys[] = {
     CONFIG_KEY(lora_cr, 1, 4),
     CONFIG_KEY(lora_tx_power, -9, 22),
     CONFIG_KEY(sensor_interval_s, 1, 86400),
+    CONFIG_KEY(sensor_period_temperature_s, 0, 86400),
+    CONFIG_KEY(sensor_period_humidity_s, 0, 86400),
+    CONFIG_KEY(sensor_period_pressure_s, 0, 86400),
+    CONFIG_KEY(sensor_profile, 0, TS_BME280_PROFILE_COUNT - 1),
     CONFIG_KEY(heartbeat_interval_s, 1, 86400),
     CONFIG_KEY(routing_table_age_interval_s, 1, 86400),
+    CONFIG_KEY(telemetry_batch_size, 1, TS_MSG_TELEMETRY_BATCH_MAX),
+    CONFIG_KEY(telemetry_max_latency_s, 1, 86400),
+    CONFIG_KEY(telemetry_keyframe_interval, 0, 255),
+    CONFIG_KEY(telemetry_window_s, 0, 86400),
+    CONFIG_KEY(telemetry_deadband_temperature, 0,
+               TS_TELEMETRY_TEMPERATURE_MAX - TS_TELEMETRY_TEMPERATURE_MIN),
+    CONFIG_KEY(telemetry_deadband_humidity, 0,
+               TS_TELEMETRY_HUMIDITY_MAX - TS_TELEMETRY_HUMIDITY_MIN),
+    CONFIG_KEY(telemetry_deadband_pressure, 0,
+               TS_TELEMETRY_PRESSURE_MAX - TS_TELEMETRY_PRESSURE_MIN),
+    CONFIG_KEY(telemetry_max_silence_s, 1, 86400),
+    CONFIG_KEY(telemetry_resync_s, 0, 86400),
 };
 
 #define CONFIG_KEY_COUNT ARRAY_SIZE(config_keys)
@@ -113,7 +151,7 @@ static int config_settings_export(
     const uint8_t *base = (const uint8_t *)&live_config;
 
     for (size_t i = 0; i < CONFIG_KEY_COUNT; i++) {
-        char full_name[32];
+        char full_name[FULL_NAME_SIZE];
         snprintf(full_name, sizeof(full_name), "ts/%s",
                  config_keys[i].name);
         int ret =
@@ -172,7 +210,7 @@ int ts_config_set(const char *p_key, int32_t value) {
     write_field(entry, value);
 
     // Persist to NVS using the full "ts/field" key
-    char full_name[32];
+    char full_name[FULL_NAME_SIZE];
     snprintf(full_name, sizeof(full_name), "ts/%s", entry->name);
     const uint8_t *base = (const uint8_t *)&live_config;
     int ret =
@@ -188,7 +226,7 @@ int ts_config_set(const char *p_key, int32_t value) {
 int ts_config_reset(void) {
     // Delete all persisted keys
     for (size_t i = 0; i < CONFIG_KEY_COUNT; i++) {
-        char full_name[32];
+        char full_name[FULL_NAME_SIZE];
         snprintf(full_name, sizeof(full_name), "ts/%s",
                  config_keys[i].name);
         settings_delete(full_name);
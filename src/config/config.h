@@ -68,12 +68,60 @@
 /** @brief Default sensor poll interval in seconds. */
 #define TS_CONFIG_SENSOR_INTERVAL_S_DEFAULT 10
 
+/**
+ * @brief Default per-channel sample periods in seconds (0 = every
+ *        sensor interval).
+ */
+#define TS_CONFIG_SENSOR_PERIOD_TEMPERATURE_S_DEFAULT 0
+#define TS_CONFIG_SENSOR_PERIOD_HUMIDITY_S_DEFAULT 0
+#define TS_CONFIG_SENSOR_PERIOD_PRESSURE_S_DEFAULT 0
+
+/**
+ * @brief Default BME280 sampling profile (0 = ultra-low-power,
+ *        1 = standard, 2 = high-resolution; see bme280_profile.h).
+ *        The BME280 backend only accepts the profile it was built for.
+ */
+#define TS_CONFIG_SENSOR_PROFILE_DEFAULT 1
+
 /** @brief Default heartbeat (node status) interval in seconds. */
 #define TS_CONFIG_HEARTBEAT_INTERVAL_S_DEFAULT 7
 
 /** @brief Default routing table aging interval in seconds. */
 #define TS_CONFIG_ROUTING_TABLE_AGE_INTERVAL_S_DEFAULT 60
 
+/* ── Telemetry batching defaults ───────────────────────────────────── */
+
+/** @brief Default readings per telemetry frame (1 = no batching). */
+#define TS_CONFIG_TELEMETRY_BATCH_SIZE_DEFAULT 1
+
+/** @brief Default longest a batched reading may wait, in seconds. */
+#define TS_CONFIG_TELEMETRY_MAX_LATENCY_S_DEFAULT 300
+
+/** @brief Default readings per delta-coding keyframe (0 = no delta coding). */
+#define TS_CONFIG_TELEMETRY_KEYFRAME_INTERVAL_DEFAULT 0
+
+/* ── Telemetry window defaults ─────────────────────────────────────── */
+
+/** @brief Default summary window in seconds (0 = send every reading). */
+#define TS_CONFIG_TELEMETRY_WINDOW_S_DEFAULT 0
+
+/** @brief Default temperature deadband (and prediction bound) in centi-°C. */
+#define TS_CONFIG_TELEMETRY_DEADBAND_TEMPERATURE_DEFAULT 20
+
+/** @brief Default humidity deadband (and prediction bound) in centi-%RH. */
+#define TS_CONFIG_TELEMETRY_DEADBAND_HUMIDITY_DEFAULT 100
+
+/** @brief Default pressure deadband (and prediction bound) in Pa. */
+#define TS_CONFIG_TELEMETRY_DEADBAND_PRESSURE_DEFAULT 50
+
+/** @brief Default longest time without a summary, in seconds. */
+#define TS_CONFIG_TELEMETRY_MAX_SILENCE_S_DEFAULT 3600
+
+/* ── Telemetry prediction defaults ─────────────────────────────────── */
+
+/** @brief Default longest time between model resyncs (0 = no prediction). */
+#define TS_CONFIG_TELEMETRY_RESYNC_S_DEFAULT 0
+
 /**
  * @brief Runtime configuration for all tunable parameters.
  *
@@ -105,8 +153,27 @@ struct ts_config {
 
     /* Timing intervals */
     uint32_t sensor_interval_s;
+    uint32_t sensor_period_temperature_s;
+    uint32_t sensor_period_humidity_s;
+    uint32_t sensor_period_pressure_s;
+    uint8_t sensor_profile;
     uint32_t heartbeat_interval_s;
     uint32_t routing_table_age_interval_s;
+
+    /* Telemetry batching */
+    uint8_t telemetry_batch_size;
+    uint32_t telemetry_max_latency_s;
+    uint8_t telemetry_keyframe_interval;
+
+    /* Telemetry windows */
+    uint32_t telemetry_window_s;
+    uint16_t telemetry_deadband_temperature;
+    uint16_t telemetry_deadband_humidity;
+    uint32_t telemetry_deadband_pressure;
+    uint32_t telemetry_max_silence_s;
+
+    /* Telemetry prediction */
+    uint32_t telemetry_resync_s;
 };
 
 /** @brief Static initializer that fills every field with its default. */
@@ -128,9 +195,31 @@ struct ts_config {
         .lora_cr = TS_CONFIG_LORA_CR_DEFAULT,                                \
         .lora_tx_power = TS_CONFIG_LORA_TX_POWER_DEFAULT,                    \
         .sensor_interval_s = TS_CONFIG_SENSOR_INTERVAL_S_DEFAULT,            \
+        .sensor_period_temperature_s =                                       \
+            TS_CONFIG_SENSOR_PERIOD_TEMPERATURE_S_DEFAULT,                   \
+        .sensor_period_humidity_s =                                          \
+            TS_CONFIG_SENSOR_PERIOD_HUMIDITY_S_DEFAULT,                      \
+        .sensor_period_pressure_s =                                          \
+            TS_CONFIG_SENSOR_PERIOD_PRESSURE_S_DEFAULT,                      \
+        .sensor_profile = TS_CONFIG_SENSOR_PROFILE_DEFAULT,                  \
         .heartbeat_interval_s = TS_CONFIG_HEARTBEAT_INTERVAL_S_DEFAULT,      \
         .routing_table_age_interval_s =                                      \
             TS_CONFIG_ROUTING_TABLE_AGE_INTERVAL_S_DEFAULT,                  \
+        .telemetry_batch_size = TS_CONFIG_TELEMETRY_BATCH_SIZE_DEFAULT,      \
+        .telemetry_max_latency_s =                                           \
+            TS_CONFIG_TELEMETRY_MAX_LATENCY_S_DEFAULT,                       \
+        .telemetry_keyframe_interval =                                       \
+            TS_CONFIG_TELEMETRY_KEYFRAME_INTERVAL_DEFAULT,                   \
+        .telemetry_window_s = TS_CONFIG_TELEMETRY_WINDOW_S_DEFAULT,          \
+        .telemetry_deadband_temperature =                                    \
+            TS_CONFIG_TELEMETRY_DEADBAND_TEMPERATURE_DEFAULT,                \
+        .telemetry_deadband_humidity =                                       \
+            TS_CONFIG_TELEMETRY_DEADBAND_HUMIDITY_DEFAULT,                   \
+        .telemetry_deadband_pressure =                                       \
+            TS_CONFIG_TELEMETRY_DEADBAND_PRESSURE_DEFAULT,                   \
+        .telemetry_max_silence_s =                                           \
+            TS_CONFIG_TELEMETRY_MAX_SILENCE_S_DEFAULT,                       \
+        .telemetry_resync_s = TS_CONFIG_TELEMETRY_RESYNC_S_DEFAULT,          \
     }
 
 /**
@@ -4,11 +4,17 @@
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 
+#include "drivers/lora_mock.h"
+#include "lora/airtime.h"
+
 LOG_MODULE_REGISTER(lora_mock);
 
-// Loopback: sent packets are queued here so lora_mock_recv can return them.
-// This simulates receiving our own transmissions, which exercises the full
-// TX→CBOR→radio→CBOR→RX pipeline during QEMU testing.
+// Loopback: sent packets are queued here so lora_mock_recv can return them,
+// or delivered to the async receive callback while one is armed.  This
+// simulates receiving our own transmissions, which exercises the full
+// TX→CBOR→radio→CBOR→RX pipeline during QEMU testing.  Each packet is
+// received like a real one: its preamble is reported when reception
+// starts, and the packet is delivered once its time on air has passed.
 #define MOCK_LOOPBACK_BUF_SIZE 256
 #define MOCK_LOOPBACK_QUEUE_DEPTH 4
 
@@ -18,8 +24,14 @@ struct lora_mock_packet {
 };
 
 struct lora_mock_data {
+    const struct device* dev;
     struct lora_modem_config config;
     bool configured;
+    lora_recv_cb async_cb;
+    void* async_user_data;
+    lora_mock_preamble_cb_t preamble_cb;
+    bool rx_in_flight;  // Head of rx_msgq announced, not yet delivered
+    struct k_work_delayable async_work;
     struct k_msgq rx_msgq;
     char rx_msgq_buf[MOCK_LOOPBACK_QUEUE_DEPTH *
                      sizeof(struct lora_mock_packet)];
@@ -57,9 +69,69 @@ static int lora_mock_send(const struct device* dev, uint8_t* data,
         LOG_WRN("Mock RX queue full, dropping loopback packet");
     }
 
+    if (drv_data->async_cb != NULL) {
+        k_work_schedule(&drv_data->async_work, K_NO_WAIT);
+    }
+
+    return 0;
+}
+
+// Stands in for the radio's preamble and RX-done interrupts, from work
+// queue context: announces the next queued loopback packet, then
+// delivers it to the armed callback one time on air later.
+static void lora_mock_async_work(struct k_work* work) {
+    struct k_work_delayable* dwork = k_work_delayable_from_work(work);
+    struct lora_mock_data* drv_data =
+        CONTAINER_OF(dwork, struct lora_mock_data, async_work);
+    struct lora_mock_packet pkt;
+
+    if (drv_data->async_cb == NULL) { return; }
+
+    if (!drv_data->rx_in_flight) {
+        if (k_msgq_peek(&drv_data->rx_msgq, &pkt) != 0) { return; }
+        drv_data->rx_in_flight = true;
+        if (drv_data->preamble_cb != NULL) { drv_data->preamble_cb(); }
+        k_work_schedule(dwork,
+                        K_MSEC(ts_airtime_ms(&drv_data->config, pkt.len)));
+        return;
+    }
+
+    drv_data->rx_in_flight = false;
+    if (k_msgq_get(&drv_data->rx_msgq, &pkt, K_NO_WAIT) == 0) {
+        LOG_INF("Mock LoRa async recv: %d bytes (loopback)", pkt.len);
+        drv_data->async_cb(drv_data->dev, pkt.data, pkt.len, -42, 10,
+                           drv_data->async_user_data);
+    }
+    k_work_schedule(dwork, K_NO_WAIT);
+}
+
+static int lora_mock_recv_async(const struct device* dev, lora_recv_cb cb,
+                                void* user_data) {
+    struct lora_mock_data* drv_data = dev->data;
+
+    drv_data->async_user_data = user_data;
+    drv_data->async_cb = cb;
+
+    // Cancelling RX aborts a reception in progress; the packet stays
+    // queued and is received again, like every packet sent while RX was
+    // cancelled, once RX is re-armed
+    if (cb == NULL) {
+        k_work_cancel_delayable(&drv_data->async_work);
+        drv_data->rx_in_flight = false;
+    } else {
+        k_work_schedule(&drv_data->async_work, K_NO_WAIT);
+    }
+
     return 0;
 }
 
+void lora_mock_set_preamble_cb(const struct device* dev,
+                               lora_mock_preamble_cb_t cb) {
+    struct lora_mock_data* drv_data = dev->data;
+
+    drv_data->preamble_cb = cb;
+}
+
 static int lora_mock_recv(const struct device* dev, uint8_t* data, uint8_t size,
                           k_timeout_t timeout, int16_t* rssi, int8_t* snr) {
     struct lora_mock_data* drv_data = dev->data;
@@ -88,12 +160,15 @@ static const struct lora_driver_api lora_mock_api = {
     .config = lora_mock_config,
     .send = lora_mock_send,
     .recv = lora_mock_recv,
+    .recv_async = lora_mock_recv_async,
     .test_cw = lora_mock_test_cw,
 };
 
 static int lora_mock_init(const struct device* dev) {
     struct lora_mock_data* data = dev->data;
 
+    data->dev = dev;
+    k_work_init_delayable(&data->async_work, lora_mock_async_work);
     k_msgq_init(&data->rx_msgq, data->rx_msgq_buf,
                 sizeof(struct lora_mock_packet), MOCK_LOOPBACK_QUEUE_DEPTH);
 
@@ -0,0 +1,34 @@
+#ifndef TS_LORA_MOCK_H
+#define TS_LORA_MOCK_H
+
+/**
+ * @defgroup lora_mock Mock LoRa Driver
+ * @brief Loopback LoRa driver for QEMU and native_sim.
+ *
+ * Every sent packet is received back through the normal receive API.
+ * Reception of each packet is reported in two steps, like the
+ * interrupts of a real modem: its preamble when reception starts, and
+ * the packet itself one time on air later.
+ * @{
+ */
+
+#include <zephyr/device.h>
+
+/** @brief Called when the mock starts receiving a packet. */
+typedef void (*lora_mock_preamble_cb_t)(void);
+
+/**
+ * @brief Set the callback for the start of each reception.
+ *
+ * Called from the system work queue, only while asynchronous receive
+ * is armed.
+ *
+ * @param dev  Mock LoRa device
+ * @param cb   Callback, or NULL to stop reporting
+ */
+void lora_mock_set_preamble_cb(const struct device* dev,
+                               lora_mock_preamble_cb_t cb);
+
+/** @} */
+
+#endif  // TS_LORA_MOCK_H
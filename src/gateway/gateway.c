@@ -0,0 +1,428 @@
+#include "gateway/gateway.h"
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/zbus/zbus.h>
+
+#include "lora/packed.h"
+#include "messages/msg_pool.h"
+#include "sensors/telemetry_delta.h"
+#include "sensors/telemetry_predict.h"
+#include "sensors/telemetry_range.h"
+#include "sensors/telemetry_window.h"
+
+LOG_MODULE_REGISTER(gateway);
+
+BUILD_ASSERT(TS_GATEWAY_SEQ_WINDOW <= 32, "Seen bitmap is 32 bits wide");
+
+struct gateway_slot {
+    bool occupied;
+    bool seq_valid;
+    uint32_t max_msg_id;  // Newest msg_id seen from this node
+    uint32_t seen;        // Bit i: max_msg_id - i was seen
+    bool clock_valid;
+    uint32_t clock_s;     // Newest full timestamp from this node
+    uint32_t clock_rx_ms; // Gateway uptime when it arrived
+    struct ts_gateway_node node;
+};
+
+// Mutex: messages arrive on the RX thread (listener) and batches leave
+// from the system work queue.  ts_gateway_flush() copies the queue out
+// under the lock and sends from the copy, so a slow uplink never holds
+// up the RX thread.  uplink_mutex keeps sends in order.
+static K_MUTEX_DEFINE(gateway_mutex);
+static K_MUTEX_DEFINE(uplink_mutex);
+static const struct ts_gateway_uplink* uplink;
+static struct gateway_slot nodes[TS_GATEWAY_MAX_NODES];
+static struct ts_gateway_record queue[TS_GATEWAY_BATCH_SIZE];
+static size_t queued;
+static struct ts_gateway_record sending[TS_GATEWAY_BATCH_SIZE];
+static struct ts_gateway_stats stats;
+static struct k_work_delayable flush_work;
+static bool work_initialized;
+
+static void flush_work_handler(struct k_work* work) {
+    int ret = ts_gateway_flush();
+    if (ret < 0) { LOG_WRN("Uplink failed, batch dropped: %d", ret); }
+}
+
+int ts_gateway_init(const struct ts_gateway_uplink* p_uplink) {
+    if (p_uplink == NULL || p_uplink->send == NULL) { return -EINVAL; }
+    if (p_uplink->init != NULL) {
+        int ret = p_uplink->init();
+        if (ret != 0) { return ret; }
+    }
+
+    if (!work_initialized) {
+        k_work_init_delayable(&flush_work, flush_work_handler);
+        work_initialized = true;
+    }
+    k_work_cancel_delayable(&flush_work);
+
+    k_mutex_lock(&gateway_mutex, K_FOREVER);
+    memset(nodes, 0, sizeof(nodes));
+    memset(&stats, 0, sizeof(stats));
+    queued = 0;
+    uplink = p_uplink;
+    k_mutex_unlock(&gateway_mutex);
+
+    // Deltas are decoded against the reading before them, predictions
+    // made from the readings before them; start from a clean slate so a
+    // stale reference is never used.
+    ts_delta_decoder_init();
+    ts_predict_decoder_init();
+    LOG_INF("Gateway started, uplink: %s", p_uplink->name);
+    return 0;
+}
+
+// Slot for a node, evicting the one heard from longest ago if the table
+// is full.  Called with the gateway mutex held.
+static struct gateway_slot* node_slot(uint16_t src) {
+    struct gateway_slot* victim = NULL;
+
+    for (int i = 0; i < TS_GATEWAY_MAX_NODES; i++) {
+        if (nodes[i].occupied && nodes[i].node.src == src) {
+            return &nodes[i];
+        }
+    }
+    for (int i = 0; i < TS_GATEWAY_MAX_NODES; i++) {
+        if (!nodes[i].occupied) {
+            victim = &nodes[i];
+            break;
+        }
+        if (victim == NULL ||
+            (int32_t)(nodes[i].node.last_rx_ms - victim->node.last_rx_ms) <
+                0) {
+            victim = &nodes[i];
+        }
+    }
+
+    if (victim->occupied) { stats.evictions++; }
+    memset(victim, 0, sizeof(*victim));
+    victim->occupied = true;
+    victim->node.src = src;
+    return victim;
+}
+
+// Record msg_id in the node's window; true if it was already there.
+// msg_ids count up per sender, so the window slides with the newest one
+// and a late copy from a longer path lands on a bit already set.  An id
+// further back than the window means the sender restarted and its
+// counter began again: the window restarts from there.
+static bool seen_before(struct gateway_slot* slot, uint32_t msg_id) {
+    if (!slot->seq_valid) {
+        slot->seq_valid = true;
+        slot->max_msg_id = msg_id;
+        slot->seen = BIT(0);
+        return false;
+    }
+
+    uint32_t ahead = msg_id - slot->max_msg_id;
+    uint32_t behind = slot->max_msg_id - msg_id;
+
+    if (ahead != 0 && ahead < UINT32_MAX / 2) {
+        slot->seen = ahead >= TS_GATEWAY_SEQ_WINDOW ? 0 : slot->seen << ahead;
+        slot->seen |= BIT(0);
+        slot->max_msg_id = msg_id;
+        return false;
+    }
+    if (behind >= TS_GATEWAY_SEQ_WINDOW) {
+        slot->max_msg_id = msg_id;
+        slot->seen = BIT(0);
+        return false;
+    }
+    if (slot->seen & BIT(behind)) { return true; }
+    slot->seen |= BIT(behind);
+    return false;
+}
+
+// Queue one record, scheduling the flush that sends it.  Called with
+// the gateway mutex held.
+static int queue_record(const struct ts_gateway_record* p_rec) {
+    if (queued == TS_GATEWAY_BATCH_SIZE) {
+        stats.dropped++;
+        return -ENOBUFS;
+    }
+
+    queue[queued++] = *p_rec;
+    stats.records++;
+    if (queued == 1) {
+        k_work_schedule(&flush_work, K_MSEC(TS_GATEWAY_FLUSH_MS));
+    }
+    if (queued == TS_GATEWAY_BATCH_SIZE) {
+        k_work_reschedule(&flush_work, K_NO_WAIT);
+    }
+    return 0;
+}
+
+// Remember where the node's clock stood when a message arrived
+static void sync_clock(struct gateway_slot* slot, uint32_t timestamp,
+                       uint32_t rx_ms) {
+    slot->clock_valid = true;
+    slot->clock_s = timestamp;
+    slot->clock_rx_ms = rx_ms;
+}
+
+// Packed frames carry only the low 16 bits of the timestamp.  The rest
+// comes from the node's clock as last seen, advanced by the time since.
+// Until the node has sent a full timestamp the wire value is all there
+// is; it is exact for the node's first 18 hours.
+static uint32_t full_timestamp(const struct gateway_slot* slot,
+                               uint32_t wire, uint32_t rx_ms) {
+    if (!slot->clock_valid) { return wire; }
+    uint32_t ref = slot->clock_s + (rx_ms - slot->clock_rx_ms) / MSEC_PER_SEC;
+    return ts_packed_unwrap_timestamp(wire, ref);
+}
+
+static int queue_reading(struct gateway_slot* slot,
+                         struct ts_gateway_record* p_rec,
+                         const struct ts_msg_telemetry* p_reading) {
+    sync_clock(slot, p_reading->timestamp, p_rec->rx_ms);
+    p_rec->type = TS_MSG_TELEMETRY;
+    p_rec->data.telemetry = *p_reading;
+    slot->node.telemetry = *p_reading;
+    slot->node.has_telemetry = true;
+    return queue_record(p_rec);
+}
+
+// Expand a batch into one record per sample, timestamped by the running
+// sum of the sample offsets.
+static int queue_batch(struct gateway_slot* slot,
+                       struct ts_gateway_record* p_rec,
+                       const struct ts_msg_telemetry_batch* p_batch) {
+    uint32_t timestamp = p_batch->base_timestamp;
+    size_t count = MIN(p_batch->count, TS_MSG_TELEMETRY_BATCH_MAX);
+    int ret = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        const struct ts_msg_telemetry_sample* sample = &p_batch->samples[i];
+        struct ts_msg_telemetry reading;
+
+        timestamp += sample->dt;
+        reading.timestamp = timestamp;
+        reading.temperature = sample->temperature;
+        reading.humidity = sample->humidity;
+        reading.pressure = sample->pressure;
+        int err = queue_reading(slot, p_rec, &reading);
+        if (err != 0) { ret = err; }
+    }
+    return ret;
+}
+
+// Telemetry channels in a value list refresh the node's latest reading.
+// A node without one yet keeps none: the other channels are unknown.
+static void update_telemetry_channels(
+    struct ts_gateway_node* p_node, const struct ts_msg_sensor_values* p_vals) {
+    size_t count = MIN(p_vals->count, TS_MSG_SENSOR_VALUES_MAX);
+
+    if (!p_node->has_telemetry) { return; }
+    for (size_t i = 0; i < count; i++) {
+        const struct ts_msg_sensor_value* v = &p_vals->values[i];
+        switch (v->id) {
+            case TS_TELEMETRY_TEMPERATURE:
+                p_node->telemetry.temperature = v->value;
+                break;
+            case TS_TELEMETRY_HUMIDITY:
+                p_node->telemetry.humidity = v->value;
+                break;
+            case TS_TELEMETRY_PRESSURE:
+                p_node->telemetry.pressure = v->value;
+                break;
+            default:
+                continue;
+        }
+        p_node->telemetry.timestamp = p_vals->timestamp;
+    }
+}
+
+int ts_gateway_handle(const struct ts_msg_lora_incoming* p_in) {
+    const struct ts_msg_lora_outgoing* p_msg = &p_in->msg;
+    struct ts_gateway_record rec = {
+        .rx_ms = k_uptime_get_32(),
+        .src = p_msg->route.src,
+        .msg_id = p_msg->route.msg_id,
+        .rssi = p_in->rssi,
+        .snr = p_in->snr,
+    };
+    int ret;
+
+    switch (p_msg->type) {
+        case TS_MSG_TELEMETRY:
+        case TS_MSG_TELEMETRY_BATCH:
+        case TS_MSG_TELEMETRY_DELTA:
+        case TS_MSG_TELEMETRY_SUMMARY:
+        case TS_MSG_TELEMETRY_MODEL:
+        case TS_MSG_SENSOR_VALUES:
+        case TS_MSG_NODE_STATUS:
+            break;
+        default:
+            return -ENOTSUP;
+    }
+
+    k_mutex_lock(&gateway_mutex, K_FOREVER);
+    if (uplink == NULL) {
+        k_mutex_unlock(&gateway_mutex);
+        return -ENODEV;
+    }
+
+    struct gateway_slot* slot = node_slot(rec.src);
+    // Checked before decoding: a duplicate delta or model update would
+    // otherwise look like a sequence gap and discard the decoder's
+    // reference.
+    if (seen_before(slot, rec.msg_id)) {
+        slot->node.duplicates++;
+        stats.duplicates++;
+        k_mutex_unlock(&gateway_mutex);
+        return -EALREADY;
+    }
+    slot->node.rssi = rec.rssi;
+    slot->node.snr = rec.snr;
+    slot->node.last_rx_ms = rec.rx_ms;
+    slot->node.messages++;
+    stats.messages++;
+
+    switch (p_msg->type) {
+        case TS_MSG_TELEMETRY: {
+            struct ts_msg_telemetry reading = p_msg->data.telemetry;
+            if (p_msg->short_timestamp) {
+                reading.timestamp =
+                    full_timestamp(slot, reading.timestamp, rec.rx_ms);
+            }
+            ret = queue_reading(slot, &rec, &reading);
+            break;
+        }
+        case TS_MSG_TELEMETRY_BATCH:
+            ret = queue_batch(slot, &rec, &p_msg->data.telemetry_batch);
+            break;
+        case TS_MSG_TELEMETRY_DELTA: {
+            struct ts_msg_telemetry reading;
+            ret = ts_delta_decode(rec.src, &p_msg->data.telemetry_delta,
+                                  &reading);
+            if (ret == 0) {
+                ret = queue_reading(slot, &rec, &reading);
+            } else {
+                stats.undecodable++;
+            }
+            break;
+        }
+        case TS_MSG_TELEMETRY_MODEL: {
+            struct ts_msg_telemetry reading;
+            ret = ts_predict_decode(rec.src, &p_msg->data.telemetry_model,
+                                    &reading);
+            if (ret == 0) {
+                ret = queue_reading(slot, &rec, &reading);
+            } else {
+                stats.undecodable++;
+            }
+            break;
+        }
+        case TS_MSG_TELEMETRY_SUMMARY:
+            // Forwarded whole; the table keeps the window's means
+            rec.type = TS_MSG_TELEMETRY_SUMMARY;
+            rec.data.telemetry_summary = p_msg->data.telemetry_summary;
+            ts_telemetry_summary_mean(&p_msg->data.telemetry_summary,
+                                      &slot->node.telemetry);
+            slot->node.has_telemetry = true;
+            ret = queue_record(&rec);
+            break;
+        case TS_MSG_SENSOR_VALUES:
+            rec.type = TS_MSG_SENSOR_VALUES;
+            rec.data.sensor_values = p_msg->data.sensor_values;
+            update_telemetry_channels(&slot->node,
+                                      &p_msg->data.sensor_values);
+            sync_clock(slot, p_msg->data.sensor_values.timestamp, rec.rx_ms);
+            ret = queue_record(&rec);
+            break;
+        default:
+            rec.type = TS_MSG_NODE_STATUS;
+            rec.data.node_status = p_msg->data.node_status;
+            slot->node.status = p_msg->data.node_status;
+            slot->node.has_status = true;
+            sync_clock(slot, p_msg->data.node_status.timestamp, rec.rx_ms);
+            ret = queue_record(&rec);
+            break;
+    }
+    k_mutex_unlock(&gateway_mutex);
+    return ret;
+}
+
+int ts_gateway_flush(void) {
+    const struct ts_gateway_uplink* p_uplink;
+    size_t count;
+
+    k_mutex_lock(&uplink_mutex, K_FOREVER);
+    k_mutex_lock(&gateway_mutex, K_FOREVER);
+    count = queued;
+    memcpy(sending, queue, count * sizeof(queue[0]));
+    queued = 0;
+    p_uplink = uplink;
+    k_mutex_unlock(&gateway_mutex);
+
+    if (count == 0 || p_uplink == NULL) {
+        k_mutex_unlock(&uplink_mutex);
+        return 0;
+    }
+
+    int ret = p_uplink->send(sending, count);
+
+    k_mutex_lock(&gateway_mutex, K_FOREVER);
+    if (ret == 0) {
+        stats.batches++;
+    } else {
+        stats.send_errors++;
+    }
+    k_mutex_unlock(&gateway_mutex);
+    k_mutex_unlock(&uplink_mutex);
+    return ret == 0 ? (int)count : ret;
+}
+
+int ts_gateway_node_get(uint16_t src, struct ts_gateway_node* p_node) {
+    int ret = -ENOENT;
+
+    k_mutex_lock(&gateway_mutex, K_FOREVER);
+    for (int i = 0; i < TS_GATEWAY_MAX_NODES; i++) {
+        if (nodes[i].occupied && nodes[i].node.src == src) {
+            *p_node = nodes[i].node;
+            ret = 0;
+            break;
+        }
+    }
+    k_mutex_unlock(&gateway_mutex);
+    return ret;
+}
+
+int ts_gateway_node_estimate(uint16_t src, uint32_t timestamp,
+                             struct ts_msg_telemetry* p_out) {
+    return ts_predict_estimate(src, timestamp, p_out);
+}
+
+uint32_t ts_gateway_node_count(void) {
+    uint32_t count = 0;
+
+    k_mutex_lock(&gateway_mutex, K_FOREVER);
+    for (int i = 0; i < TS_GATEWAY_MAX_NODES; i++) {
+        if (nodes[i].occupied) { count++; }
+    }
+    k_mutex_unlock(&gateway_mutex);
+    return count;
+}
+
+void ts_gateway_get_stats(struct ts_gateway_stats* p_stats) {
+    k_mutex_lock(&gateway_mutex, K_FOREVER);
+    *p_stats = stats;
+    k_mutex_unlock(&gateway_mutex);
+}
+
+// Telemetry and status reports are delivered on their own channels;
+// this listener is attached to both and does nothing until the gateway
+// role is started.
+static void gateway_listener_cb(const struct zbus_channel* chan) {
+    int ret = ts_gateway_handle(ts_msg_pool_peek(chan));
+
+    if (ret != 0 && ret != -ENODEV && ret != -EALREADY) {
+        LOG_DBG("Message not uplinked: %d", ret);
+    }
+}
+
+ZBUS_LISTENER_DEFINE(ts_gateway_lis, gateway_listener_cb);
@@ -0,0 +1,186 @@
+#ifndef TS_GATEWAY_H
+#define TS_GATEWAY_H
+
+/**
+ * @defgroup gateway Gateway
+ * @brief Latest-value store and batched uplink of mesh traffic.
+ *
+ * A gateway node listens on the telemetry and status channels and
+ * turns every delivered message into uplink records: one per reading,
+ * with batches expanded sample by sample and deltas decoded against the
+ * sender's previous reading.  Window summaries and sensor value lists
+ * are forwarded as they are.  Each record also updates the sender's
+ * entry in a RAM table holding its latest reading, status and link
+ * quality.
+ *
+ * Nodes running predictive suppression only send the readings the
+ * shared model could not predict.  The gateway feeds those to its copy
+ * of the model and can estimate the readings in between on request
+ * (ts_gateway_node_estimate()).
+ *
+ * Flooding delivers the same message along several paths, and the
+ * routing layer's duplicate cache only remembers the last few.  The
+ * gateway keeps a window of recent msg_ids per node instead, so a copy
+ * that arrives late over a longer route is still recognised and never
+ * uplinked twice.
+ *
+ * Records are queued and handed to the uplink backend in batches, when
+ * TS_GATEWAY_BATCH_SIZE are pending or TS_GATEWAY_FLUSH_MS after the
+ * first one was queued, whichever comes first.  The backend is chosen
+ * at ts_gateway_init() and only has to move a batch to the host.
+ * @{
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/kernel.h>
+
+#include "messages/messages.h"
+
+/** @brief Nodes tracked in the latest-value table (set via Kconfig). */
+#define TS_GATEWAY_MAX_NODES CONFIG_TS_GATEWAY_MAX_NODES
+
+/** @brief Records queued before a batch is flushed (set via Kconfig). */
+#define TS_GATEWAY_BATCH_SIZE CONFIG_TS_GATEWAY_BATCH_SIZE
+
+/** @brief Longest a record waits for its batch (set via Kconfig). */
+#define TS_GATEWAY_FLUSH_MS CONFIG_TS_GATEWAY_FLUSH_MS
+
+/** @brief Recent msg_ids remembered per node for duplicate detection. */
+#define TS_GATEWAY_SEQ_WINDOW 32
+
+BUILD_ASSERT(TS_GATEWAY_BATCH_SIZE >= TS_MSG_TELEMETRY_BATCH_MAX,
+             "A telemetry batch must fit one uplink batch");
+
+/** @brief One reading or status report, as sent to the uplink. */
+struct ts_gateway_record {
+    uint32_t rx_ms;      /**< Gateway uptime at reception */
+    uint16_t src;        /**< Originating node */
+    uint32_t msg_id;     /**< Message the record came from */
+    int16_t rssi;        /**< RSSI of the last hop (dBm) */
+    int8_t snr;          /**< SNR of the last hop (dB) */
+    ts_msg_type_t type;  /**< TS_MSG_TELEMETRY(_SUMMARY), _SENSOR_VALUES
+                              or _NODE_STATUS */
+    union {
+        struct ts_msg_telemetry telemetry;
+        struct ts_msg_telemetry_summary telemetry_summary;
+        struct ts_msg_sensor_values sensor_values;
+        struct ts_msg_node_status node_status;
+    } data;
+};
+
+/** @brief Latest known state of one node. */
+struct ts_gateway_node {
+    uint16_t src;
+    int16_t rssi;        /**< RSSI of the last message received */
+    int8_t snr;          /**< SNR of the last message received */
+    uint32_t last_rx_ms; /**< Gateway uptime at the last message */
+    uint32_t messages;   /**< Distinct messages received */
+    uint32_t duplicates; /**< Copies dropped as duplicates */
+    bool has_telemetry;
+    struct ts_msg_telemetry telemetry; /**< Latest reading or window mean */
+    bool has_status;
+    struct ts_msg_node_status status; /**< Latest status report */
+};
+
+/** @brief Gateway counters since ts_gateway_init(). */
+struct ts_gateway_stats {
+    uint32_t messages;    /**< Distinct messages accepted */
+    uint32_t duplicates;  /**< Copies dropped as duplicates */
+    uint32_t records;     /**< Records queued for the uplink */
+    uint32_t dropped;     /**< Records lost to a full queue */
+    uint32_t undecodable; /**< Deltas or model updates without a valid
+                               reference */
+    uint32_t batches;     /**< Batches handed to the uplink */
+    uint32_t send_errors; /**< Batches the uplink failed to send */
+    uint32_t evictions;   /**< Nodes evicted to make room */
+};
+
+/**
+ * @brief Uplink backend: moves batches of records to the host.
+ *
+ * send() is called from the system work queue, one batch at a time.
+ * The records are only valid for the duration of the call.
+ */
+struct ts_gateway_uplink {
+    const char* name;
+    /** Prepare the transport; may be NULL. */
+    int (*init)(void);
+    /** Send count records; 0 on success, negative errno otherwise. */
+    int (*send)(const struct ts_gateway_record* p_records, size_t count);
+};
+
+/**
+ * @brief Start the gateway role with the given uplink.
+ *
+ * Clears the node table, queue and counters.  Until this is called the
+ * gateway ignores delivered messages.
+ *
+ * @param p_uplink  Backend that receives the batches
+ * @return 0 on success, -EINVAL if p_uplink has no send(), or the
+ *         error from the backend's init()
+ */
+int ts_gateway_init(const struct ts_gateway_uplink* p_uplink);
+
+/**
+ * @brief Process one delivered message.
+ *
+ * Called by the gateway's channel listener; exposed for testing.
+ *
+ * @param p_in  Received message with radio metadata
+ * @return 0 if records were queued, -EALREADY for a duplicate,
+ *         -ENOTSUP for a type the gateway does not uplink, -ENODATA
+ *         for a delta or model update that cannot be applied yet,
+ *         -ENOBUFS if the queue was full and records were dropped,
+ *         -ENODEV if the gateway was not started
+ */
+int ts_gateway_handle(const struct ts_msg_lora_incoming* p_in);
+
+/**
+ * @brief Send the queued records now.
+ *
+ * @return Number of records sent (0 if the queue was empty), or the
+ *         uplink's error (the batch is dropped)
+ */
+int ts_gateway_flush(void);
+
+/**
+ * @brief Look up a node's latest state.
+ *
+ * @param src     Node address
+ * @param p_node  Output state
+ * @return 0 on success, -ENOENT if the node is not in the table
+ */
+int ts_gateway_node_get(uint16_t src, struct ts_gateway_node* p_node);
+
+/**
+ * @brief Estimate a predicting node's reading at a given time.
+ *
+ * Uses the same model as the node, so the estimate is within the node's
+ * configured error bound as long as none of its messages were lost
+ * since its last resync.
+ *
+ * @param src        Node address
+ * @param timestamp  Time in the node's clock, as in its readings
+ * @param p_out      Estimated reading
+ * @return 0 on success, -ENODATA if the node has no valid model
+ */
+int ts_gateway_node_estimate(uint16_t src, uint32_t timestamp,
+                             struct ts_msg_telemetry* p_out);
+
+/**
+ * @brief Number of nodes in the table.
+ */
+uint32_t ts_gateway_node_count(void);
+
+/**
+ * @brief Copy the gateway counters.
+ *
+ * @param p_stats  Output counters
+ */
+void ts_gateway_get_stats(struct ts_gateway_stats* p_stats);
+
+/** @} */
+
+#endif  // TS_GATEWAY_H
@@ -0,0 +1,245 @@
+#include "gateway/uplink_frame.h"
+
+#include <errno.h>
+#include <stdbool.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/crc.h>
+
+#define CRC_SEED 0xFFFF
+#define COBS_MAX_CODE 0xFF
+#define FRAME_DELIMITER 0x00
+
+// Incremental COBS encoder.  Bytes go straight from the record fields
+// into the output, so the unstuffed frame never needs its own buffer.
+// code counts the bytes of the current block plus one; its slot at
+// code_pos is filled in when the block ends.  With raw set, bytes are
+// copied unchanged (for transports that do their own framing).
+struct cobs_writer {
+    uint8_t* out;
+    size_t size;
+    size_t pos;
+    size_t code_pos;
+    uint8_t code;
+    bool raw;
+    bool overflow;
+};
+
+static void cobs_start_block(struct cobs_writer* w) {
+    if (w->raw) { return; }
+    if (w->pos >= w->size) {
+        w->overflow = true;
+        return;
+    }
+    w->code_pos = w->pos++;
+    w->code = 1;
+}
+
+static void cobs_end_block(struct cobs_writer* w) {
+    if (!w->overflow && !w->raw) { w->out[w->code_pos] = w->code; }
+}
+
+static void cobs_init(struct cobs_writer* w, uint8_t* p_out, size_t size,
+                      size_t start, bool raw) {
+    w->out = p_out;
+    w->size = size;
+    w->pos = start;
+    w->raw = raw;
+    w->overflow = false;
+    cobs_start_block(w);
+}
+
+static void cobs_put(struct cobs_writer* w, uint8_t byte) {
+    if (w->overflow) { return; }
+
+    if (byte == 0 && !w->raw) {
+        cobs_end_block(w);
+        cobs_start_block(w);
+        return;
+    }
+    if (w->pos >= w->size) {
+        w->overflow = true;
+        return;
+    }
+    w->out[w->pos++] = byte;
+    if (w->raw) { return; }
+    if (++w->code == COBS_MAX_CODE) {
+        cobs_end_block(w);
+        cobs_start_block(w);
+    }
+}
+
+// Finish the last block; returns the end position, or 0 on overflow
+static size_t cobs_finish(struct cobs_writer* w) {
+    cobs_end_block(w);
+    return w->overflow ? 0 : w->pos;
+}
+
+size_t ts_cobs_encode(const uint8_t* p_in, size_t len, uint8_t* p_out,
+                      size_t out_size) {
+    struct cobs_writer w;
+
+    cobs_init(&w, p_out, out_size, 0, false);
+    for (size_t i = 0; i < len; i++) { cobs_put(&w, p_in[i]); }
+    return cobs_finish(&w);
+}
+
+int ts_cobs_decode(const uint8_t* p_in, size_t len, uint8_t* p_out,
+                   size_t out_size, size_t* p_out_len) {
+    size_t in = 0;
+    size_t out = 0;
+
+    while (in < len) {
+        uint8_t code = p_in[in++];
+
+        if (code == 0 || in + code - 1 > len) { return -EBADMSG; }
+        for (uint8_t i = 1; i < code; i++) {
+            if (p_in[in] == 0) { return -EBADMSG; }
+            if (out >= out_size) { return -EMSGSIZE; }
+            p_out[out++] = p_in[in++];
+        }
+        // A block shorter than the maximum stood for a zero in the
+        // input, unless it is the last one
+        if (code < COBS_MAX_CODE && in < len) {
+            if (out >= out_size) { return -EMSGSIZE; }
+            p_out[out++] = 0;
+        }
+    }
+    *p_out_len = out;
+    return 0;
+}
+
+// Feed raw frame bytes to the encoder and the running CRC
+static void frame_put(struct cobs_writer* w, uint16_t* p_crc,
+                      const uint8_t* p_buf, size_t len) {
+    *p_crc = crc16_itu_t(*p_crc, p_buf, len);
+    for (size_t i = 0; i < len; i++) { cobs_put(w, p_buf[i]); }
+}
+
+static uint8_t record_kind(ts_msg_type_t type) {
+    switch (type) {
+        case TS_MSG_NODE_STATUS:
+            return TS_UPLINK_KIND_STATUS;
+        case TS_MSG_TELEMETRY_SUMMARY:
+            return TS_UPLINK_KIND_SUMMARY;
+        case TS_MSG_SENSOR_VALUES:
+            return TS_UPLINK_KIND_VALUES;
+        default:
+            return TS_UPLINK_KIND_TELEMETRY;
+    }
+}
+
+static size_t summary_pack(const struct ts_msg_telemetry_summary* p_sum,
+                           uint8_t* p_body) {
+    const int32_t values[] = {
+        p_sum->temperature_min, p_sum->temperature_max, p_sum->temperature_mean,
+        p_sum->humidity_min,    p_sum->humidity_max,    p_sum->humidity_mean,
+        p_sum->pressure_min,    p_sum->pressure_max,    p_sum->pressure_mean,
+    };
+
+    sys_put_be32(p_sum->timestamp, &p_body[0]);
+    sys_put_be16(p_sum->duration_s, &p_body[4]);
+    sys_put_be16(p_sum->count, &p_body[6]);
+    for (size_t i = 0; i < ARRAY_SIZE(values); i++) {
+        sys_put_be32((uint32_t)values[i], &p_body[8 + 4 * i]);
+    }
+    return TS_UPLINK_SUMMARY_RECORD_SIZE;
+}
+
+static size_t values_pack(const struct ts_msg_sensor_values* p_vals,
+                          uint8_t* p_body) {
+    size_t count = MIN(p_vals->count, TS_MSG_SENSOR_VALUES_MAX);
+
+    sys_put_be32(p_vals->timestamp, &p_body[0]);
+    p_body[4] = (uint8_t)count;
+    for (size_t i = 0; i < count; i++) {
+        p_body[5 + 5 * i] = p_vals->values[i].id;
+        sys_put_be32((uint32_t)p_vals->values[i].value, &p_body[6 + 5 * i]);
+    }
+    return TS_UPLINK_VALUES_RECORD_SIZE(count);
+}
+
+static size_t record_pack(const struct ts_gateway_record* p_rec,
+                          uint8_t buf[TS_UPLINK_RECORD_MAX_SIZE]) {
+    uint8_t* body = &buf[TS_UPLINK_RECORD_HEADER_SIZE];
+
+    buf[0] = record_kind(p_rec->type);
+    sys_put_be32(p_rec->rx_ms, &buf[1]);
+    sys_put_be16(p_rec->src, &buf[5]);
+    sys_put_be32(p_rec->msg_id, &buf[7]);
+    sys_put_be16((uint16_t)p_rec->rssi, &buf[11]);
+    buf[13] = (uint8_t)p_rec->snr;
+
+    if (p_rec->type == TS_MSG_NODE_STATUS) {
+        const struct ts_msg_node_status* st = &p_rec->data.node_status;
+        sys_put_be32(st->timestamp, &body[0]);
+        sys_put_be32(st->uptime, &body[4]);
+        body[8] = (uint8_t)st->status;
+        return TS_UPLINK_STATUS_RECORD_SIZE;
+    }
+    if (p_rec->type == TS_MSG_TELEMETRY_SUMMARY) {
+        return summary_pack(&p_rec->data.telemetry_summary, body);
+    }
+    if (p_rec->type == TS_MSG_SENSOR_VALUES) {
+        return values_pack(&p_rec->data.sensor_values, body);
+    }
+
+    const struct ts_msg_telemetry* tel = &p_rec->data.telemetry;
+    sys_put_be32(tel->timestamp, &body[0]);
+    sys_put_be32((uint32_t)tel->temperature, &body[4]);
+    sys_put_be32((uint32_t)tel->humidity, &body[8]);
+    sys_put_be32((uint32_t)tel->pressure, &body[12]);
+    return TS_UPLINK_TELEMETRY_RECORD_SIZE;
+}
+
+// Write header, records and CRC through w; returns the end position,
+// or 0 if the output is too small
+static size_t frame_write(struct cobs_writer* w, uint16_t seq,
+                          const struct ts_gateway_record* p_records,
+                          size_t count) {
+    uint8_t buf[TS_UPLINK_RECORD_MAX_SIZE];
+    uint16_t crc = CRC_SEED;
+
+    buf[0] = TS_UPLINK_FRAME_VERSION;
+    sys_put_be16(seq, &buf[1]);
+    buf[3] = (uint8_t)count;
+    frame_put(w, &crc, buf, TS_UPLINK_HEADER_SIZE);
+
+    for (size_t i = 0; i < count; i++) {
+        size_t len = record_pack(&p_records[i], buf);
+        frame_put(w, &crc, buf, len);
+    }
+
+    sys_put_be16(crc, buf);
+    for (size_t i = 0; i < TS_UPLINK_CRC_SIZE; i++) { cobs_put(w, buf[i]); }
+    return cobs_finish(w);
+}
+
+int ts_uplink_frame_encode(uint16_t seq,
+                           const struct ts_gateway_record* p_records,
+                           size_t count, uint8_t* p_out, size_t out_size) {
+    struct cobs_writer w;
+
+    if (count > TS_UPLINK_MAX_RECORDS) { return -EINVAL; }
+    // Leading and trailing delimiter
+    if (out_size < 2) { return -EMSGSIZE; }
+
+    p_out[0] = FRAME_DELIMITER;
+    cobs_init(&w, p_out, out_size - 1, 1, false);
+
+    size_t end = frame_write(&w, seq, p_records, count);
+    if (end == 0) { return -EMSGSIZE; }
+    p_out[end] = FRAME_DELIMITER;
+    return (int)end + 1;
+}
+
+int ts_uplink_frame_pack(uint16_t seq,
+                         const struct ts_gateway_record* p_records,
+                         size_t count, uint8_t* p_out, size_t out_size) {
+    struct cobs_writer w;
+
+    if (count > TS_UPLINK_MAX_RECORDS) { return -EINVAL; }
+
+    cobs_init(&w, p_out, out_size, 0, true);
+    size_t end = frame_write(&w, seq, p_records, count);
+    return end == 0 ? -EMSGSIZE : (int)end;
+}
@@ -0,0 +1,158 @@
+#ifndef TS_UPLINK_FRAME_H
+#define TS_UPLINK_FRAME_H
+
+/**
+ * @defgroup uplink_frame Uplink Framing
+ * @brief Binary, COBS-framed batches of gateway records for a serial
+ *        link.
+ *
+ * A batch is encoded as one frame:
+ *
+ *     [version:1 | seq:2 | count:1 | record ... | crc:2]
+ *
+ * followed by COBS (Consistent Overhead Byte Stuffing), which removes
+ * every zero byte at a cost of one byte per 254, and wrapped in zero
+ * delimiters.  A receiver that joins mid-stream, or sees log text
+ * between frames, resynchronises on the next zero.  seq counts frames
+ * so the host can detect lost ones; crc is CRC-16/CCITT-FALSE
+ * (crc16_itu_t, seed 0xFFFF) over everything before it.
+ *
+ * Every record starts with a common header:
+ *
+ *     [kind:1 | rx_ms:4 | src:2 | msg_id:4 | rssi:2 | snr:1]
+ *
+ * followed by the body for its kind:
+ *
+ * | Kind | Body                                                    |
+ * | ---- | ------------------------------------------------------- |
+ * | 0    | telemetry: timestamp:4, temperature:4, humidity:4,      |
+ * |      | pressure:4 (signed, in the units of messages.h)         |
+ * | 1    | node status: timestamp:4, uptime:4, status:1            |
+ * | 2    | summary: timestamp:4, duration_s:2, count:2, then min:4, |
+ * |      | max:4, mean:4 for temperature, humidity and pressure    |
+ * | 3    | sensor values: timestamp:4, count:1, then id:1, value:4 |
+ * |      | per value                                               |
+ *
+ * Multi-byte fields are big-endian.  A telemetry record takes 30 bytes
+ * against about 50 characters as a text line, and needs no formatting.
+ *
+ * Packet transports (MQTT-SN, flash log entries) carry the same frame
+ * without COBS and delimiters; see ts_uplink_frame_pack().
+ * @{
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/sys/util.h>
+
+#include "gateway/gateway.h"
+
+/** @brief Frame format version, first byte of every frame. */
+#define TS_UPLINK_FRAME_VERSION 1
+
+/** @brief Record kinds. */
+#define TS_UPLINK_KIND_TELEMETRY 0
+#define TS_UPLINK_KIND_STATUS 1
+#define TS_UPLINK_KIND_SUMMARY 2
+#define TS_UPLINK_KIND_VALUES 3
+
+/** @brief Frame header: version, seq, count. */
+#define TS_UPLINK_HEADER_SIZE 4
+
+/** @brief Trailing CRC. */
+#define TS_UPLINK_CRC_SIZE 2
+
+/** @brief Common record header: kind, rx_ms, src, msg_id, rssi, snr. */
+#define TS_UPLINK_RECORD_HEADER_SIZE 14
+
+/** @brief Record sizes including the common header. */
+#define TS_UPLINK_TELEMETRY_RECORD_SIZE (TS_UPLINK_RECORD_HEADER_SIZE + 16)
+#define TS_UPLINK_STATUS_RECORD_SIZE (TS_UPLINK_RECORD_HEADER_SIZE + 9)
+#define TS_UPLINK_SUMMARY_RECORD_SIZE (TS_UPLINK_RECORD_HEADER_SIZE + 44)
+#define TS_UPLINK_VALUES_RECORD_SIZE(count) \
+    (TS_UPLINK_RECORD_HEADER_SIZE + 5 + 5 * (count))
+
+/** @brief Largest record of any kind. */
+#define TS_UPLINK_RECORD_MAX_SIZE                 \
+    MAX(TS_UPLINK_SUMMARY_RECORD_SIZE,            \
+        TS_UPLINK_VALUES_RECORD_SIZE(TS_MSG_SENSOR_VALUES_MAX))
+
+/** @brief Most records one frame can carry. */
+#define TS_UPLINK_MAX_RECORDS UINT8_MAX
+
+/** @brief Worst-case COBS output for len input bytes. */
+#define TS_COBS_MAX_SIZE(len) ((len) + (len) / 254 + 1)
+
+/** @brief Frame of count records without COBS, see ts_uplink_frame_pack(). */
+#define TS_UPLINK_PACKED_MAX_SIZE(count)                                     \
+    (TS_UPLINK_HEADER_SIZE + (count) * TS_UPLINK_RECORD_MAX_SIZE +           \
+     TS_UPLINK_CRC_SIZE)
+
+/** @brief Buffer needed for a frame of count records, delimiters included. */
+#define TS_UPLINK_FRAME_MAX_SIZE(count)                                      \
+    (TS_COBS_MAX_SIZE(TS_UPLINK_PACKED_MAX_SIZE(count)) + 2)
+
+/**
+ * @brief COBS-encode a buffer.
+ *
+ * @param p_in      Input bytes
+ * @param len       Input length
+ * @param p_out     Output buffer (must not overlap p_in)
+ * @param out_size  Size of p_out; TS_COBS_MAX_SIZE(len) always suffices
+ * @return Encoded length (no zero bytes, no delimiter), or 0 if p_out is
+ *         too small
+ */
+size_t ts_cobs_encode(const uint8_t* p_in, size_t len, uint8_t* p_out,
+                      size_t out_size);
+
+/**
+ * @brief Decode one COBS-encoded block (without delimiters).
+ *
+ * @param p_in      Encoded bytes
+ * @param len       Encoded length
+ * @param p_out     Output buffer (may be p_in: decoding never grows)
+ * @param out_size  Size of p_out
+ * @param p_out_len Output: decoded length
+ * @return 0 on success, -EBADMSG if the input contains a zero byte or a
+ *         code runs past the end, -EMSGSIZE if p_out is too small
+ */
+int ts_cobs_decode(const uint8_t* p_in, size_t len, uint8_t* p_out,
+                   size_t out_size, size_t* p_out_len);
+
+/**
+ * @brief Encode a batch of records as one delimited frame.
+ *
+ * @param seq        Frame sequence number
+ * @param p_records  Records to send
+ * @param count      Number of records (at most TS_UPLINK_MAX_RECORDS)
+ * @param p_out      Output buffer
+ * @param out_size   Size of p_out; TS_UPLINK_FRAME_MAX_SIZE(count)
+ *                   always suffices
+ * @return Bytes to transmit, or -EINVAL if count is too large,
+ *         -EMSGSIZE if p_out is too small
+ */
+int ts_uplink_frame_encode(uint16_t seq,
+                           const struct ts_gateway_record* p_records,
+                           size_t count, uint8_t* p_out, size_t out_size);
+
+/**
+ * @brief Build the same frame without COBS or delimiters.
+ *
+ * For transports that preserve message boundaries themselves.
+ *
+ * @param seq        Frame sequence number
+ * @param p_records  Records to send
+ * @param count      Number of records (at most TS_UPLINK_MAX_RECORDS)
+ * @param p_out      Output buffer
+ * @param out_size   Size of p_out; TS_UPLINK_PACKED_MAX_SIZE(count)
+ *                   always suffices
+ * @return Frame length, or -EINVAL if count is too large, -EMSGSIZE if
+ *         p_out is too small
+ */
+int ts_uplink_frame_pack(uint16_t seq,
+                         const struct ts_gateway_record* p_records,
+                         size_t count, uint8_t* p_out, size_t out_size);
+
+/** @} */
+
+#endif  // TS_UPLINK_FRAME_H
@@ -0,0 +1,237 @@
+#include "gateway/uplink_mqtt_sn.h"
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/net/mqtt_sn.h>
+#include <zephyr/net/socket.h>
+
+#include "gateway/uplink_frame.h"
+
+#if defined(CONFIG_TS_GATEWAY_MQTT_SN_BACKLOG)
+#include "storage/flash_log.h"
+
+#if !DT_HAS_CHOSEN(terrascope_backlog_partition)
+#error "The MQTT-SN backlog needs a terrascope,backlog-partition chosen node"
+#endif
+#define BACKLOG_AREA \
+    DT_FIXED_PARTITION_ID(DT_CHOSEN(terrascope_backlog_partition))
+#endif
+
+LOG_MODULE_REGISTER(uplink_mqtt_sn);
+
+#define MQTT_SN_POLL_INTERVAL K_MSEC(100)
+#define MQTT_SN_RECONNECT_MS 10000
+
+#define TOPIC_PREFIX CONFIG_TS_GATEWAY_MQTT_SN_TOPIC_PREFIX
+
+// Publish payload: one frame of up to a full batch, all of one kind
+#define PAYLOAD_SIZE TS_UPLINK_PACKED_MAX_SIZE(TS_GATEWAY_BATCH_SIZE)
+
+// Backlog entry: [topic:1 | frame]
+#define ENTRY_SIZE (1 + PAYLOAD_SIZE)
+
+// PUBLISH header with a 3-byte length field
+#define PUBLISH_OVERHEAD 9
+
+BUILD_ASSERT(TS_GATEWAY_BATCH_SIZE <= TS_UPLINK_MAX_RECORDS,
+             "A batch must fit one uplink frame");
+BUILD_ASSERT(PAYLOAD_SIZE <= CONFIG_MQTT_SN_LIB_MAX_PAYLOAD_SIZE,
+             "Raise MQTT_SN_LIB_MAX_PAYLOAD_SIZE to fit a batch");
+BUILD_ASSERT(CONFIG_TS_GATEWAY_MQTT_SN_MAX_INFLIGHT <=
+                 CONFIG_MQTT_SN_LIB_MAX_PUBLISH,
+             "The in-flight window needs as many MQTT-SN publish slots");
+
+enum uplink_topic {
+    TOPIC_TELEMETRY,
+    TOPIC_STATUS,
+    TOPIC_COUNT,
+};
+
+#define MQTT_SN_STRING(s) {.data = (const uint8_t*)(s), .size = sizeof(s) - 1}
+
+static struct mqtt_sn_data topics[TOPIC_COUNT] = {
+    [TOPIC_TELEMETRY] = MQTT_SN_STRING(TOPIC_PREFIX "/telemetry"),
+    [TOPIC_STATUS] = MQTT_SN_STRING(TOPIC_PREFIX "/status"),
+};
+
+static struct mqtt_sn_data client_id =
+    MQTT_SN_STRING(CONFIG_TS_GATEWAY_MQTT_SN_CLIENT_ID);
+
+// The client, the poll work and send() all run under mqtt_mutex.  The
+// library calls evt_cb from mqtt_sn_input(), with the mutex held.
+static K_MUTEX_DEFINE(mqtt_mutex);
+static struct mqtt_sn_client client;
+static struct mqtt_sn_transport_udp transport;
+static uint8_t tx_buf[PAYLOAD_SIZE + PUBLISH_OVERHEAD];
+static uint8_t rx_buf[64];
+static uint8_t entry_buf[ENTRY_SIZE];
+static struct ts_gateway_record split[TS_GATEWAY_BATCH_SIZE];
+static uint16_t frame_seq;
+static bool connected;
+static int64_t next_connect_ms;
+static struct k_work_delayable poll_work;
+
+#if defined(CONFIG_TS_GATEWAY_MQTT_SN_BACKLOG)
+static struct ts_flash_log backlog;
+static bool backlog_ready;
+#endif
+
+static void evt_cb(struct mqtt_sn_client* p_client,
+                   const struct mqtt_sn_evt* evt) {
+    switch (evt->type) {
+        case MQTT_SN_EVT_CONNECTED:
+            LOG_INF("Connected to MQTT-SN gateway");
+            connected = true;
+            break;
+        case MQTT_SN_EVT_DISCONNECTED:
+            LOG_WRN("Disconnected from MQTT-SN gateway");
+            connected = false;
+            break;
+        default:
+            break;
+    }
+}
+
+// Publishes queued in the library: waiting for their topic ID, to be
+// sent, or (QoS 1/2) for their acknowledgement
+static bool window_full(void) {
+    return sys_slist_len(&client.publish) >=
+           CONFIG_TS_GATEWAY_MQTT_SN_MAX_INFLIGHT;
+}
+
+static int publish_entry(const uint8_t* p_entry, size_t len) {
+    struct mqtt_sn_data data = {.data = &p_entry[1], .size = len - 1};
+
+    if (p_entry[0] >= TOPIC_COUNT) { return -EBADMSG; }
+    return mqtt_sn_publish(&client,
+                           (enum mqtt_sn_qos)CONFIG_TS_GATEWAY_MQTT_SN_QOS,
+                           &topics[p_entry[0]], false, &data);
+}
+
+#if defined(CONFIG_TS_GATEWAY_MQTT_SN_BACKLOG)
+static bool backlog_empty(void) {
+    return !backlog_ready || ts_flash_log_pending(&backlog) == 0;
+}
+
+// Publish backlogged batches, oldest first, while the window has room
+static void backlog_drain(void) {
+    while (connected && !window_full()) {
+        int len = ts_flash_log_peek(&backlog, entry_buf, sizeof(entry_buf));
+        if (len == -ENOENT) { return; }
+
+        // An entry that can't be read or published never will be
+        int ret = len < 0 ? len : publish_entry(entry_buf, len);
+        if (ret == -ENOMEM || ret == -ENOTCONN) { return; }
+        if (ret != 0) { LOG_WRN("Dropping backlog entry: %d", ret); }
+        ts_flash_log_pop(&backlog);
+    }
+}
+#else
+static bool backlog_empty(void) { return true; }
+
+static void backlog_drain(void) {}
+#endif
+
+// Publish now if nothing older is waiting, otherwise queue in flash
+static int send_entry(size_t len) {
+    if (connected && backlog_empty() && !window_full()) {
+        int ret = publish_entry(entry_buf, len);
+        if (ret == 0) { return 0; }
+        LOG_DBG("Publish failed: %d", ret);
+    }
+
+#if defined(CONFIG_TS_GATEWAY_MQTT_SN_BACKLOG)
+    if (backlog_ready) {
+        return ts_flash_log_append(&backlog, entry_buf, len);
+    }
+#endif
+    return -EAGAIN;
+}
+
+static void poll_work_handler(struct k_work* work) {
+    k_mutex_lock(&mqtt_mutex, K_FOREVER);
+    if (!connected && k_uptime_get() >= next_connect_ms) {
+        next_connect_ms = k_uptime_get() + MQTT_SN_RECONNECT_MS;
+        int ret = mqtt_sn_connect(&client, false, true);
+        if (ret != 0) { LOG_DBG("Connect failed: %d", ret); }
+    }
+    mqtt_sn_input(&client);
+    backlog_drain();
+    k_mutex_unlock(&mqtt_mutex);
+
+    k_work_schedule(&poll_work, MQTT_SN_POLL_INTERVAL);
+}
+
+static int uplink_mqtt_sn_init(void) {
+    struct sockaddr_in gw_addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(CONFIG_TS_GATEWAY_MQTT_SN_GATEWAY_PORT),
+    };
+    int ret;
+
+    if (zsock_inet_pton(AF_INET, CONFIG_TS_GATEWAY_MQTT_SN_GATEWAY_ADDR,
+                        &gw_addr.sin_addr) != 1) {
+        return -EINVAL;
+    }
+
+    ret = mqtt_sn_transport_udp_init(&transport, (struct sockaddr*)&gw_addr,
+                                     sizeof(gw_addr));
+    if (ret != 0) { return ret; }
+
+    ret = mqtt_sn_client_init(&client, &client_id, &transport.tp, evt_cb,
+                              tx_buf, sizeof(tx_buf), rx_buf,
+                              sizeof(rx_buf));
+    if (ret != 0) { return ret; }
+
+#if defined(CONFIG_TS_GATEWAY_MQTT_SN_BACKLOG)
+    ret = ts_flash_log_init(&backlog, BACKLOG_AREA);
+    if (ret == 0) {
+        backlog_ready = true;
+    } else {
+        // Still useful without it while the link is up
+        LOG_ERR("Backlog unavailable: %d", ret);
+    }
+#endif
+
+    k_work_init_delayable(&poll_work, poll_work_handler);
+    k_work_schedule(&poll_work, K_NO_WAIT);
+    LOG_INF("MQTT-SN uplink to %s:%d, QoS %d",
+            CONFIG_TS_GATEWAY_MQTT_SN_GATEWAY_ADDR,
+            CONFIG_TS_GATEWAY_MQTT_SN_GATEWAY_PORT,
+            CONFIG_TS_GATEWAY_MQTT_SN_QOS);
+    return 0;
+}
+
+static int uplink_mqtt_sn_send(const struct ts_gateway_record* p_records,
+                               size_t count) {
+    int ret = 0;
+
+    k_mutex_lock(&mqtt_mutex, K_FOREVER);
+    for (int topic = 0; topic < TOPIC_COUNT; topic++) {
+        bool status = topic == TOPIC_STATUS;
+        size_t n = 0;
+
+        for (size_t i = 0; i < count; i++) {
+            if ((p_records[i].type == TS_MSG_NODE_STATUS) == status) {
+                split[n++] = p_records[i];
+            }
+        }
+        if (n == 0) { continue; }
+
+        entry_buf[0] = (uint8_t)topic;
+        int len = ts_uplink_frame_pack(frame_seq++, split, n, &entry_buf[1],
+                                       sizeof(entry_buf) - 1);
+        if (len >= 0) { len = send_entry(1 + len); }
+        if (len < 0) { ret = len; }
+    }
+    backlog_drain();
+    k_mutex_unlock(&mqtt_mutex);
+    return ret;
+}
+
+const struct ts_gateway_uplink ts_uplink_mqtt_sn = {
+    .name = "mqtt-sn",
+    .init = uplink_mqtt_sn_init,
+    .send = uplink_mqtt_sn_send,
+};
@@ -0,0 +1,37 @@
+#ifndef TS_UPLINK_MQTT_SN_H
+#define TS_UPLINK_MQTT_SN_H
+
+/**
+ * @addtogroup gateway
+ * @{
+ */
+
+#include "gateway/gateway.h"
+
+/**
+ * @brief Uplink that publishes batches to an MQTT-SN gateway over UDP.
+ *
+ * Each batch is split by record kind and published as at most two
+ * messages, to `<prefix>/telemetry` and `<prefix>/status`.  The
+ * payload is the uplink frame without COBS (see @ref uplink_frame and
+ * ts_uplink_frame_pack()), so the host side parses MQTT and UART
+ * uplinks alike.  Topic names are registered once per session and
+ * every PUBLISH carries only the 2-byte topic ID.
+ *
+ * Publishes use CONFIG_TS_GATEWAY_MQTT_SN_QOS.  At QoS 1 and 2 at most
+ * CONFIG_TS_GATEWAY_MQTT_SN_MAX_INFLIGHT publishes wait for their
+ * acknowledgement at once.  While disconnected or with the window full,
+ * batches are appended to a flash log in the partition named by the
+ * terrascope,backlog-partition chosen node
+ * (CONFIG_TS_GATEWAY_MQTT_SN_BACKLOG, see @ref flash_log) and published
+ * in order once the gateway is reachable again.  Without
+ * the backlog they are dropped and counted as send errors.
+ *
+ * The network interface must be configured (e.g. CONFIG_NET_CONFIG_*);
+ * the client connects, and reconnects, on its own.
+ */
+extern const struct ts_gateway_uplink ts_uplink_mqtt_sn;
+
+/** @} */
+
+#endif  // TS_UPLINK_MQTT_SN_H
@@ -0,0 +1,85 @@
+#include "gateway/uplink_uart.h"
+
+#include <errno.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/uart.h>
+#include <zephyr/logging/log.h>
+
+#include "gateway/uplink_frame.h"
+
+LOG_MODULE_REGISTER(uplink_uart);
+
+#if DT_HAS_CHOSEN(terrascope_uplink_uart)
+#define UPLINK_UART_NODE DT_CHOSEN(terrascope_uplink_uart)
+#else
+#define UPLINK_UART_NODE DT_CHOSEN(zephyr_console)
+#endif
+
+// Longest wait for the previous frame; a default 16-record batch
+// takes about half a second at 9600 baud
+#define UPLINK_TX_TIMEOUT K_SECONDS(2)
+
+#define UPLINK_FRAME_SIZE TS_UPLINK_FRAME_MAX_SIZE(TS_GATEWAY_BATCH_SIZE)
+
+BUILD_ASSERT(TS_GATEWAY_BATCH_SIZE <= TS_UPLINK_MAX_RECORDS,
+             "A batch must fit one uplink frame");
+
+static const struct device* const uart_dev = DEVICE_DT_GET(UPLINK_UART_NODE);
+
+// Double buffer: the next batch is encoded while the previous frame is
+// still going out by DMA.  tx_idle_sem is taken for the duration of a
+// transmission and given back by the TX_DONE event.
+static uint8_t frame_buf[2][UPLINK_FRAME_SIZE];
+static uint8_t frame_idx;
+static uint16_t frame_seq;
+static bool use_async;
+static K_SEM_DEFINE(tx_idle_sem, 1, 1);
+
+static void uart_event_cb(const struct device* dev, struct uart_event* evt,
+                          void* user_data) {
+    if (evt->type == UART_TX_DONE || evt->type == UART_TX_ABORTED) {
+        k_sem_give(&tx_idle_sem);
+    }
+}
+
+static int uplink_uart_init(void) {
+    if (!device_is_ready(uart_dev)) { return -ENODEV; }
+
+    // Drivers without the async API (or builds without
+    // CONFIG_UART_ASYNC_API) reject the callback; frames are then
+    // written byte by byte instead.
+    use_async = uart_callback_set(uart_dev, uart_event_cb, NULL) == 0;
+    LOG_INF("UART uplink, %s TX", use_async ? "async" : "polled");
+    return 0;
+}
+
+static int uplink_uart_send(const struct ts_gateway_record* p_records,
+                            size_t count) {
+    uint8_t* buf = frame_buf[frame_idx];
+    int len = ts_uplink_frame_encode(frame_seq, p_records, count, buf,
+                                     UPLINK_FRAME_SIZE);
+    if (len < 0) { return len; }
+
+    if (k_sem_take(&tx_idle_sem, UPLINK_TX_TIMEOUT) != 0) { return -EBUSY; }
+    frame_seq++;
+
+    if (use_async) {
+        int ret = uart_tx(uart_dev, buf, len, SYS_FOREVER_US);
+        if (ret != 0) {
+            k_sem_give(&tx_idle_sem);
+            return ret;
+        }
+        frame_idx ^= 1;
+        return 0;
+    }
+
+    for (int i = 0; i < len; i++) { uart_poll_out(uart_dev, buf[i]); }
+    k_sem_give(&tx_idle_sem);
+    return 0;
+}
+
+const struct ts_gateway_uplink ts_uplink_uart = {
+    .name = "uart",
+    .init = uplink_uart_init,
+    .send = uplink_uart_send,
+};
@@ -0,0 +1,29 @@
+#ifndef TS_UPLINK_UART_H
+#define TS_UPLINK_UART_H
+
+/**
+ * @addtogroup gateway
+ * @{
+ */
+
+#include "gateway/gateway.h"
+
+/**
+ * @brief Uplink that streams binary frames over a UART.
+ *
+ * Each batch goes out as one COBS-framed, CRC-protected frame (see
+ * @ref uplink_frame), decoded on the host by scripts/gateway_uplink.py.
+ * Uses the zephyr,console UART unless a terrascope,uplink-uart chosen
+ * node names another one; on the console, log lines between frames are
+ * skipped by the decoder.
+ *
+ * With CONFIG_UART_ASYNC_API and a driver that supports it, frames are
+ * sent with uart_tx() (DMA on most SoCs) and the next batch is encoded
+ * while the previous one is on the wire.  Otherwise they are written
+ * with uart_poll_out().
+ */
+extern const struct ts_gateway_uplink ts_uplink_uart;
+
+/** @} */
+
+#endif  // TS_UPLINK_UART_H
@@ -0,0 +1,228 @@
+#include "lora/ack.h"
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/random/random.h>
+#include <zephyr/zbus/zbus.h>
+
+#include "lora/contention.h"
+#include "lora/tx_power.h"
+#include "routing/routing.h"
+
+LOG_MODULE_REGISTER(ack);
+
+extern struct zbus_channel ts_lora_out_chan;
+
+// Retransmissions are published without blocking the system work
+// queue; one that finds the TX queue busy is tried again this soon
+#define ACK_REPUBLISH_DELAY_MS 50
+
+// Mutex: slots are tracked by the TX thread, confirmed by the RX thread,
+// and expired on the system work queue.  Same copy-then-release pattern
+// as the contention pool: the retransmit publish happens unlocked.
+static K_MUTEX_DEFINE(ack_mutex);
+static struct ts_ack_slot pool[TS_ACK_POOL_SIZE];
+static struct ts_ack_stats stats;
+static bool pool_initialized;
+
+static struct ts_ack_slot* find_slot(uint16_t src, uint32_t msg_id) {
+    for (int i = 0; i < TS_ACK_POOL_SIZE; i++) {
+        if (pool[i].occupied && pool[i].msg.route.src == src &&
+            pool[i].msg.route.msg_id == msg_id) {
+            return &pool[i];
+        }
+    }
+    return NULL;
+}
+
+static struct ts_ack_slot* find_free_slot(void) {
+    for (int i = 0; i < TS_ACK_POOL_SIZE; i++) {
+        if (!pool[i].occupied) { return &pool[i]; }
+    }
+    return NULL;
+}
+
+// Caller holds ack_mutex.  Up to one airtime of jitter keeps two
+// senders that collided from retrying in lockstep.
+static void arm_timeout_locked(struct ts_ack_slot* slot) {
+    uint32_t wait_ms = ts_ack_timeout_ms(slot->airtime_ms, slot->retries) +
+                       sys_rand32_get() % (slot->airtime_ms + 1);
+    k_work_reschedule(&slot->work, K_MSEC(wait_ms));
+}
+
+static void ack_work_handler(struct k_work* work) {
+    struct k_work_delayable* dwork = k_work_delayable_from_work(work);
+    struct ts_ack_slot* slot = CONTAINER_OF(dwork, struct ts_ack_slot, work);
+    struct ts_msg_lora_outgoing msg_copy;
+
+    k_mutex_lock(&ack_mutex, K_FOREVER);
+    if (!slot->occupied) {
+        k_mutex_unlock(&ack_mutex);
+        return;
+    }
+    msg_copy = slot->msg;
+    if (slot->retries >= TS_ACK_MAX_RETRIES) {
+        slot->occupied = false;
+        stats.failed++;
+        k_mutex_unlock(&ack_mutex);
+        LOG_WRN("No ACK for msg_id=%u from 0x%04x, giving up",
+                msg_copy.route.msg_id, msg_copy.route.src);
+        ts_tx_power_report_delivery(false);
+        return;
+    }
+    slot->retries++;
+    stats.retries++;
+    // Arm the next timeout here rather than relying on ts_ack_track()
+    // after the send: a retransmission that never reaches the radio
+    // (encode or send failure) must still count as a retry.
+    arm_timeout_locked(slot);
+    k_mutex_unlock(&ack_mutex);
+
+    int ret = zbus_chan_pub(&ts_lora_out_chan, &msg_copy, K_NO_WAIT);
+    if (ret != 0) {
+        // Not queued: give the retry back and try again shortly, unless
+        // the frame was confirmed in the meantime
+        LOG_WRN("Retransmit publish failed: %d", ret);
+        k_mutex_lock(&ack_mutex, K_FOREVER);
+        if (slot->occupied && slot->msg.route.src == msg_copy.route.src &&
+            slot->msg.route.msg_id == msg_copy.route.msg_id) {
+            slot->retries--;
+            stats.retries--;
+            k_work_reschedule(&slot->work, K_MSEC(ACK_REPUBLISH_DELAY_MS));
+        }
+        k_mutex_unlock(&ack_mutex);
+        return;
+    }
+
+    // Each missed ACK also nudges TX power up, once the retry is queued
+    // so a republished retry doesn't count it twice
+    ts_tx_power_report_delivery(false);
+    LOG_DBG("Retransmitting msg_id=%u from 0x%04x", msg_copy.route.msg_id,
+            msg_copy.route.src);
+}
+
+void ts_ack_init(void) {
+    k_mutex_lock(&ack_mutex, K_FOREVER);
+    for (int i = 0; i < TS_ACK_POOL_SIZE; i++) {
+        // Cancel any pending work before reinit (safe for test reuse)
+        if (pool_initialized) {
+            struct k_work_sync sync;
+            k_work_cancel_delayable_sync(&pool[i].work, &sync);
+        }
+        k_work_init_delayable(&pool[i].work, ack_work_handler);
+        pool[i].occupied = false;
+    }
+    memset(&stats, 0, sizeof(stats));
+    pool_initialized = true;
+    k_mutex_unlock(&ack_mutex);
+}
+
+bool ts_ack_required(const struct ts_msg_lora_outgoing* p_msg) {
+    // Bulk sessions recover lost chunks end to end with selective NACKs;
+    // a link ACK per chunk would only double their airtime.
+    switch (p_msg->type) {
+        case TS_MSG_ACK:
+        case TS_MSG_BULK_DATA:
+        case TS_MSG_BULK_STATUS:
+            return false;
+        default:
+            return p_msg->route.dst != TS_ROUTING_BROADCAST_ADDR;
+    }
+}
+
+uint32_t ts_ack_timeout_ms(uint32_t airtime_ms, uint8_t retries) {
+    uint32_t backoff = TS_ACK_BACKOFF_MAX_MS;
+
+    if (retries < 16) {
+        backoff = MIN((uint64_t)airtime_ms << retries, TS_ACK_BACKOFF_MAX_MS);
+    }
+    return TS_CONTENTION_DELAY_MAX_MS + airtime_ms + backoff;
+}
+
+int ts_ack_track(const struct ts_msg_lora_outgoing* p_msg,
+                 uint32_t airtime_ms) {
+    k_mutex_lock(&ack_mutex, K_FOREVER);
+    struct ts_ack_slot* slot = find_slot(p_msg->route.src, p_msg->route.msg_id);
+    if (slot != NULL) {
+        stats.retry_airtime_ms += airtime_ms;
+    } else {
+        slot = find_free_slot();
+        if (slot == NULL) {
+            k_mutex_unlock(&ack_mutex);
+            LOG_WRN("ACK pool full, msg_id=%u sent unacknowledged",
+                    p_msg->route.msg_id);
+            return -ENOMEM;
+        }
+        slot->msg = *p_msg;
+        slot->retries = 0;
+        slot->occupied = true;
+        stats.tracked++;
+    }
+    slot->airtime_ms = airtime_ms;
+    stats.tx_airtime_ms += airtime_ms;
+    arm_timeout_locked(slot);
+    k_mutex_unlock(&ack_mutex);
+    return 0;
+}
+
+// Caller holds ack_mutex
+static void confirm_locked(struct ts_ack_slot* slot) {
+    k_work_cancel_delayable(&slot->work);
+    slot->occupied = false;
+    stats.delivered++;
+}
+
+int ts_ack_overheard(const struct ts_route_header* p_hdr) {
+    k_mutex_lock(&ack_mutex, K_FOREVER);
+    struct ts_ack_slot* slot = find_slot(p_hdr->src, p_hdr->msg_id);
+    if (slot == NULL || p_hdr->ttl >= slot->msg.route.ttl) {
+        k_mutex_unlock(&ack_mutex);
+        return -ENOENT;
+    }
+    confirm_locked(slot);
+    stats.implicit_acks++;
+    k_mutex_unlock(&ack_mutex);
+
+    ts_tx_power_report_delivery(true);
+    return 0;
+}
+
+int ts_ack_confirm(const struct ts_msg_ack* p_ack) {
+    k_mutex_lock(&ack_mutex, K_FOREVER);
+    // An ACK for a copy with another TTL is for a different hop that also
+    // holds this frame, e.g. a relay acknowledging our upstream
+    struct ts_ack_slot* slot = find_slot(p_ack->src, p_ack->msg_id);
+    if (slot == NULL || slot->msg.route.ttl != p_ack->ttl) {
+        k_mutex_unlock(&ack_mutex);
+        return -ENOENT;
+    }
+    confirm_locked(slot);
+    stats.explicit_acks++;
+    k_mutex_unlock(&ack_mutex);
+
+    ts_tx_power_report_delivery(true);
+    return 0;
+}
+
+void ts_ack_build(struct ts_msg_lora_outgoing* p_out,
+                  const struct ts_route_header* p_acked) {
+    *p_out = (struct ts_msg_lora_outgoing){
+        .type = TS_MSG_ACK,
+        .data.ack = {.src = p_acked->src,
+                     .msg_id = p_acked->msg_id,
+                     .ttl = p_acked->ttl},
+    };
+    ts_routing_prepare_header(&p_out->route, p_acked->src);
+    p_out->route.ttl = 0;
+
+    k_mutex_lock(&ack_mutex, K_FOREVER);
+    stats.acks_sent++;
+    k_mutex_unlock(&ack_mutex);
+}
+
+void ts_ack_get_stats(struct ts_ack_stats* p_stats) {
+    k_mutex_lock(&ack_mutex, K_FOREVER);
+    *p_stats = stats;
+    k_mutex_unlock(&ack_mutex);
+}
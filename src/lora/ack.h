@@ -0,0 +1,144 @@
+#ifndef TS_ACK_H
+#define TS_ACK_H
+
+/**
+ * @defgroup ack Link-Layer Acknowledgement
+ * @brief Hop-by-hop acknowledged unicast with bounded retransmission.
+ *
+ * Every unicast frame a node sends (originated or forwarded) is tracked
+ * until the next hop confirms it.  Confirmation is implicit when the
+ * node overhears the same (src, msg_id) forwarded with a lower TTL, and
+ * explicit (a short TS_MSG_ACK) from the final hop, which does not
+ * forward, or from a relay that hears a frame again after forwarding
+ * it.  Unconfirmed frames are republished to ts_lora_out_chan after
+ * a wait that covers the next hop's contention delay plus an
+ * exponential backoff scaled by the frame's time on air.
+ * @{
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <zephyr/kernel.h>
+
+#include "messages/messages.h"
+
+/** @brief Number of unicast frames awaiting acknowledgement. */
+#define TS_ACK_POOL_SIZE 8
+
+/** @brief Retransmissions before a frame is declared lost. */
+#define TS_ACK_MAX_RETRIES 3
+
+/** @brief Upper bound on the backoff added to the ACK wait (ms). */
+#define TS_ACK_BACKOFF_MAX_MS 10000
+
+/** @brief A frame awaiting acknowledgement. */
+struct ts_ack_slot {
+    struct k_work_delayable work;
+    struct ts_msg_lora_outgoing msg;
+    uint32_t airtime_ms;
+    uint8_t retries;
+    bool occupied;
+};
+
+/** @brief Reliability and cost counters since ts_ack_init(). */
+struct ts_ack_stats {
+    uint32_t tracked;          /**< Unicast frames that required an ACK */
+    uint32_t delivered;        /**< Frames confirmed by the next hop */
+    uint32_t failed;           /**< Frames dropped after all retries */
+    uint32_t retries;          /**< Retransmissions */
+    uint32_t implicit_acks;    /**< Confirmations by overheard forwards */
+    uint32_t explicit_acks;    /**< Confirmations by TS_MSG_ACK */
+    uint32_t acks_sent;        /**< TS_MSG_ACK frames built by this node */
+    uint32_t tx_airtime_ms;    /**< Airtime of tracked sends incl. retries */
+    uint32_t retry_airtime_ms; /**< Share of tx_airtime_ms spent on retries */
+};
+
+/**
+ * @brief Reset the pending pool and counters.
+ */
+void ts_ack_init(void);
+
+/**
+ * @brief Check whether a frame needs link-layer acknowledgement.
+ *
+ * @param p_msg  Outgoing message
+ * @return true for unicast frames other than ACKs and bulk-transfer frames
+ */
+bool ts_ack_required(const struct ts_msg_lora_outgoing* p_msg);
+
+/**
+ * @brief Start or restart waiting for the ACK of a sent frame.
+ *
+ * Call after every successful send of a frame for which
+ * ts_ack_required() is true.  A frame already being tracked is a
+ * retransmission: its wait is restarted from the send.  Retransmissions
+ * arm their own timeout when published, so a frame whose retransmission
+ * is never sent still times out and is eventually dropped.
+ *
+ * @param p_msg       Message as sent (copied for retransmission)
+ * @param airtime_ms  Time on air of the encoded frame
+ * @return 0 on success, -ENOMEM if the pool is full
+ */
+int ts_ack_track(const struct ts_msg_lora_outgoing* p_msg,
+                 uint32_t airtime_ms);
+
+/**
+ * @brief Handle an overheard copy of a frame (implicit ACK).
+ *
+ * Confirms a pending frame when the copy carries a lower TTL, i.e. it
+ * was forwarded by a downstream hop rather than retransmitted by an
+ * upstream one.
+ *
+ * @param p_hdr  Route header of the overheard frame
+ * @return 0 if a pending frame was confirmed, -ENOENT otherwise
+ */
+int ts_ack_overheard(const struct ts_route_header* p_hdr);
+
+/**
+ * @brief Handle a received TS_MSG_ACK (explicit ACK).
+ *
+ * Confirms the pending frame only if it was sent with the TTL the ACK
+ * names, i.e. the ACK answers this node's copy.
+ *
+ * @param p_ack  ACK payload
+ * @return 0 if a pending frame was confirmed, -ENOENT otherwise
+ */
+int ts_ack_confirm(const struct ts_msg_ack* p_ack);
+
+/**
+ * @brief Build the explicit ACK for a received frame.
+ *
+ * Used by the destination, and by a relay that receives a frame again
+ * from upstream after its forward was missed.  The ACK carries TTL 0 so
+ * no node forwards it.
+ *
+ * @param p_out    Output message
+ * @param p_acked  Route header of the copy being acknowledged
+ */
+void ts_ack_build(struct ts_msg_lora_outgoing* p_out,
+                  const struct ts_route_header* p_acked);
+
+/**
+ * @brief Wait before retransmitting a frame.
+ *
+ * The next hop forwards only after its contention delay (up to
+ * TS_CONTENTION_DELAY_MAX_MS), so the base wait covers that plus the
+ * forward's own airtime.  On top comes a backoff of the frame's
+ * airtime doubled per retry, capped at TS_ACK_BACKOFF_MAX_MS.
+ *
+ * @param airtime_ms  Time on air of the frame
+ * @param retries     Retransmissions so far
+ * @return Wait in milliseconds (without random jitter)
+ */
+uint32_t ts_ack_timeout_ms(uint32_t airtime_ms, uint8_t retries);
+
+/**
+ * @brief Copy the reliability counters.
+ *
+ * @param p_stats  Output counters
+ */
+void ts_ack_get_stats(struct ts_ack_stats* p_stats);
+
+/** @} */
+
+#endif  // TS_ACK_H
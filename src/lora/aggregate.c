@@ -0,0 +1,39 @@
+#include "lora/aggregate.h"
+
+#include <errno.h>
+#include <string.h>
+
+bool ts_agg_is_aggregate(const uint8_t* p_buf, size_t len) {
+    return len > 0 && p_buf[0] == TS_AGG_MARKER;
+}
+
+int ts_agg_append(uint8_t* p_frame, size_t* p_len, size_t cap,
+                  const uint8_t* p_sub, size_t sub_len) {
+    size_t used = *p_len == 0 ? TS_AGG_HEADER_SIZE : *p_len;
+
+    if (sub_len == 0 || sub_len > UINT8_MAX) { return -EINVAL; }
+    if (used + TS_AGG_LEN_SIZE + sub_len > cap) { return -EMSGSIZE; }
+
+    p_frame[0] = TS_AGG_MARKER;
+    p_frame[used] = (uint8_t)sub_len;
+    memcpy(&p_frame[used + TS_AGG_LEN_SIZE], p_sub, sub_len);
+    *p_len = used + TS_AGG_LEN_SIZE + sub_len;
+    return 0;
+}
+
+int ts_agg_next(const uint8_t* p_frame, size_t len, size_t* p_offset,
+                const uint8_t** pp_sub, size_t* p_sub_len) {
+    size_t pos = *p_offset == 0 ? TS_AGG_HEADER_SIZE : *p_offset;
+
+    if (pos >= len) { return -ENOENT; }
+
+    size_t sub_len = p_frame[pos];
+    if (sub_len == 0 || pos + TS_AGG_LEN_SIZE + sub_len > len) {
+        return -EBADMSG;
+    }
+
+    *pp_sub = &p_frame[pos + TS_AGG_LEN_SIZE];
+    *p_sub_len = sub_len;
+    *p_offset = pos + TS_AGG_LEN_SIZE + sub_len;
+    return 0;
+}
@@ -0,0 +1,81 @@
+#ifndef TS_AGGREGATE_H
+#define TS_AGGREGATE_H
+
+/**
+ * @defgroup aggregate Relay Aggregation
+ * @brief Several signed frames packed into one LoRa transmission.
+ *
+ * A busy relay often holds a handful of small forwards whose contention
+ * delays end within moments of each other.  Sending them one by one
+ * pays the preamble, radio header and turnaround for each; an aggregate
+ * frame pays them once:
+ *
+ *     [0xF3 | len:1 | frame | len:1 | frame | ...]
+ *
+ * Every sub-frame is a complete signed payload exactly as it would be
+ * sent alone (encoding followed by its own auth tag), so the receiver
+ * verifies and processes each one independently and a corrupted
+ * sub-frame costs only itself.  The aggregate carries no tag of its own.
+ * Like the fragment and packed markers, 0xF3 can never start a CBOR
+ * frame.
+ * @{
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** @brief First byte of every aggregate frame. */
+#define TS_AGG_MARKER 0xF3
+
+/** @brief Bytes before the first sub-frame (the marker). */
+#define TS_AGG_HEADER_SIZE 1
+
+/** @brief Length prefix in front of each sub-frame. */
+#define TS_AGG_LEN_SIZE 1
+
+/**
+ * @brief Check whether a received frame is an aggregate.
+ *
+ * @param p_buf  Received frame
+ * @param len    Frame length
+ * @return true if the frame starts with TS_AGG_MARKER
+ */
+bool ts_agg_is_aggregate(const uint8_t* p_buf, size_t len);
+
+/**
+ * @brief Append a signed sub-frame to an aggregate being built.
+ *
+ * Start with *p_len = 0; the marker is written with the first
+ * sub-frame.
+ *
+ * @param p_frame  Aggregate frame buffer
+ * @param p_len    In/out: bytes used in p_frame
+ * @param cap      Size of p_frame (the largest frame the radio sends)
+ * @param p_sub    Signed sub-frame (payload followed by its auth tag)
+ * @param sub_len  Sub-frame length
+ * @return 0 on success, -EINVAL if sub_len is 0 or over 255,
+ *         -EMSGSIZE if the sub-frame doesn't fit (p_frame unchanged)
+ */
+int ts_agg_append(uint8_t* p_frame, size_t* p_len, size_t cap,
+                  const uint8_t* p_sub, size_t sub_len);
+
+/**
+ * @brief Iterate over the sub-frames of a received aggregate.
+ *
+ * Start with *p_offset = 0 and call until it returns -ENOENT.
+ *
+ * @param p_frame    Aggregate frame
+ * @param len        Frame length
+ * @param p_offset   In/out: iteration position
+ * @param pp_sub     Output: start of the next sub-frame (within p_frame)
+ * @param p_sub_len  Output: its length
+ * @return 0 if a sub-frame was returned, -ENOENT after the last one,
+ *         -EBADMSG if a length prefix runs past the end of the frame
+ */
+int ts_agg_next(const uint8_t* p_frame, size_t len, size_t* p_offset,
+                const uint8_t** pp_sub, size_t* p_sub_len);
+
+/** @} */
+
+#endif  // TS_AGGREGATE_H
@@ -0,0 +1,51 @@
+#include "lora/airtime.h"
+
+#include <zephyr/sys/util.h>
+
+uint32_t ts_airtime_bandwidth_hz(enum lora_signal_bandwidth bw) {
+    switch (bw) {
+        case BW_250_KHZ:
+            return 250000;
+        case BW_500_KHZ:
+            return 500000;
+        case BW_125_KHZ:
+        default:
+            return 125000;
+    }
+}
+
+uint32_t ts_airtime_symbol_us(const struct lora_modem_config* p_config) {
+    uint32_t sf = (uint32_t)p_config->datarate;
+    return (uint32_t)(((uint64_t)1000000 << sf) /
+                      ts_airtime_bandwidth_hz(p_config->bandwidth));
+}
+
+uint32_t ts_airtime_us(const struct lora_modem_config* p_config,
+                       size_t payload_len) {
+    int32_t sf = (int32_t)p_config->datarate;
+    int32_t cr = (int32_t)p_config->coding_rate;
+    uint32_t t_sym = ts_airtime_symbol_us(p_config);
+    uint32_t preamble = (p_config->preamble_len != 0)
+                            ? p_config->preamble_len
+                            : TS_AIRTIME_DEFAULT_PREAMBLE_LEN;
+
+    // Low data rate optimization is mandated once a symbol exceeds 16 ms
+    int32_t de = (t_sym >= 16000) ? 1 : 0;
+
+    // Payload symbols: 8 + max(ceil((8PL - 4SF + 28 + 16CRC - 20IH) /
+    // 4(SF - 2DE)) * (CR + 4), 0) with CRC on and explicit header.
+    int32_t num = 8 * (int32_t)payload_len - 4 * sf + 28 + 16;
+    int32_t den = 4 * (sf - 2 * de);
+    int32_t blocks = (num > 0) ? (num + den - 1) / den : 0;
+    uint32_t payload_symbols = 8 + (uint32_t)(blocks * (cr + 4));
+
+    // Preamble is (n + 4.25) symbols; keep the quarter symbol exact
+    uint32_t preamble_us = preamble * t_sym + (17 * t_sym) / 4;
+
+    return preamble_us + payload_symbols * t_sym;
+}
+
+uint32_t ts_airtime_ms(const struct lora_modem_config* p_config,
+                       size_t payload_len) {
+    return DIV_ROUND_UP(ts_airtime_us(p_config, payload_len), 1000);
+}
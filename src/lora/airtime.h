@@ -0,0 +1,59 @@
+#ifndef TS_AIRTIME_H
+#define TS_AIRTIME_H
+
+/**
+ * @defgroup airtime Airtime
+ * @brief LoRa time-on-air calculation.
+ *
+ * Implements the Semtech SX127x/SX126x time-on-air formula for explicit
+ * header mode with payload CRC enabled, which is how every Terrascope
+ * frame is sent.
+ * @{
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/drivers/lora.h>
+
+/** @brief Preamble length assumed when the modem config leaves it at 0. */
+#define TS_AIRTIME_DEFAULT_PREAMBLE_LEN 8
+
+/**
+ * @brief Bandwidth of a modem config in Hz.
+ *
+ * @param bw  Zephyr bandwidth enum
+ * @return Bandwidth in Hz (125 kHz for unknown values)
+ */
+uint32_t ts_airtime_bandwidth_hz(enum lora_signal_bandwidth bw);
+
+/**
+ * @brief Duration of one LoRa symbol.
+ *
+ * @param p_config  Modem configuration
+ * @return Symbol time in microseconds
+ */
+uint32_t ts_airtime_symbol_us(const struct lora_modem_config* p_config);
+
+/**
+ * @brief Time on air of a frame.
+ *
+ * @param p_config     Modem configuration (SF, BW, CR, preamble)
+ * @param payload_len  PHY payload length in bytes
+ * @return Time on air in microseconds
+ */
+uint32_t ts_airtime_us(const struct lora_modem_config* p_config,
+                       size_t payload_len);
+
+/**
+ * @brief Time on air of a frame, rounded up to whole milliseconds.
+ *
+ * @param p_config     Modem configuration (SF, BW, CR, preamble)
+ * @param payload_len  PHY payload length in bytes
+ * @return Time on air in milliseconds
+ */
+uint32_t ts_airtime_ms(const struct lora_modem_config* p_config,
+                       size_t payload_len);
+
+/** @} */
+
+#endif  // TS_AIRTIME_H
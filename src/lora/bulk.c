@@ -0,0 +1,431 @@
+#include "lora/bulk.h"
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/random/random.h>
+#include <zephyr/zbus/zbus.h>
+
+#include "lora/airtime.h"
+#include "messages/msg_pool.h"
+#include "routing/routing.h"
+
+LOG_MODULE_REGISTER(bulk);
+
+extern struct zbus_channel ts_lora_out_chan;
+
+#define BULK_PUB_TIMEOUT K_MSEC(200)
+
+struct bulk_tx {
+    bool active;
+    uint16_t dst;
+    uint16_t session;
+    uint16_t total;      // Chunks in the session
+    uint16_t base;       // Lowest chunk not yet acknowledged
+    uint16_t next;       // Next chunk never sent
+    uint32_t resend;     // Bit i: chunk base + i was NACKed
+    bool waiting;        // Status requested, nothing left to send
+    uint8_t status_retries;
+    const uint8_t* data;
+    size_t len;
+    int64_t started_ms;
+    struct k_work_delayable work;
+};
+
+struct bulk_rx {
+    bool active;
+    bool complete;
+    uint16_t src;
+    uint16_t session;
+    uint16_t total;
+    uint16_t base;     // Lowest chunk not yet received
+    uint16_t highest;  // One past the highest chunk received
+    size_t len;
+    int64_t started_ms;
+    uint32_t received;  // Bit i: chunk base + i received
+    // Rounded up to whole chunks, so that no chunk straddles the end
+    uint8_t buf[TS_BULK_MAX_CHUNKS * TS_MSG_BULK_CHUNK_SIZE];
+};
+
+// Mutex: sends are started by the application, statuses and chunks
+// arrive on the RX thread, and chunks go out from the system work queue.
+// Messages and callbacks are always issued after the lock is released.
+static K_MUTEX_DEFINE(bulk_mutex);
+static struct bulk_tx tx;
+static struct bulk_rx rx;
+static struct ts_bulk_stats stats;
+static ts_bulk_rx_cb_t rx_done_cb;
+static ts_bulk_tx_done_cb_t tx_done_cb;
+static uint32_t pacing_ms;
+static uint16_t next_session;
+static bool work_initialized;
+
+static uint16_t chunk_len(uint16_t seq, size_t len) {
+    size_t offset = (size_t)seq * TS_MSG_BULK_CHUNK_SIZE;
+    return (uint16_t)MIN(len - offset, TS_MSG_BULK_CHUNK_SIZE);
+}
+
+static void publish(const struct ts_msg_lora_outgoing* p_msg) {
+    int ret = zbus_chan_pub(&ts_lora_out_chan, p_msg, BULK_PUB_TIMEOUT);
+    if (ret != 0) { LOG_ERR("Bulk publish failed: %d", ret); }
+}
+
+// Drop acknowledged chunks from the resend bitmap after base moved.
+static void tx_advance(uint16_t new_base) {
+    uint16_t shift = new_base - tx.base;
+
+    tx.resend = (shift >= 32) ? 0 : (tx.resend >> shift);
+    tx.base = new_base;
+    if (tx.next < tx.base) { tx.next = tx.base; }
+}
+
+// Next chunk to send: NACKed chunks first, then new ones while the
+// window has room.  Returns false when the sender has to wait.
+static bool tx_pick_chunk(uint16_t* p_seq, bool* p_resend) {
+    if (tx.resend != 0) {
+        uint16_t offset = (uint16_t)__builtin_ctz(tx.resend);
+        tx.resend &= ~BIT(offset);
+        *p_seq = tx.base + offset;
+        *p_resend = true;
+        return true;
+    }
+    if (tx.next < tx.total && tx.next < tx.base + TS_BULK_WINDOW) {
+        *p_seq = tx.next++;
+        *p_resend = false;
+        return true;
+    }
+    return false;
+}
+
+static bool tx_has_more(void) {
+    return tx.resend != 0 ||
+           (tx.next < tx.total && tx.next < tx.base + TS_BULK_WINDOW);
+}
+
+static void tx_build_chunk(struct ts_msg_lora_outgoing* p_msg, uint16_t seq,
+                           bool ack_req) {
+    size_t offset = (size_t)seq * TS_MSG_BULK_CHUNK_SIZE;
+
+    memset(p_msg, 0, sizeof(*p_msg));
+    p_msg->type = TS_MSG_BULK_DATA;
+    ts_routing_prepare_header(&p_msg->route, tx.dst);
+    p_msg->data.bulk_data.session = tx.session;
+    p_msg->data.bulk_data.seq = seq;
+    p_msg->data.bulk_data.total = tx.total;
+    p_msg->data.bulk_data.ack_req = ack_req;
+    p_msg->data.bulk_data.len = (uint8_t)chunk_len(seq, tx.len);
+    memcpy(p_msg->data.bulk_data.data, tx.data + offset,
+           p_msg->data.bulk_data.len);
+}
+
+// Must be called with the lock held.  Returns the callback result to
+// report once unlocked.
+static int tx_finish(int result) {
+    tx.active = false;
+    k_work_cancel_delayable(&tx.work);
+    if (result == 0) {
+        stats.sessions_ok++;
+        stats.last_bytes = tx.len;
+        stats.last_duration_ms = (uint32_t)(k_uptime_get() - tx.started_ms);
+    } else {
+        stats.sessions_failed++;
+    }
+    return result;
+}
+
+static void tx_work_handler(struct k_work* work) {
+    ARG_UNUSED(work);
+    struct ts_msg_lora_outgoing msg;
+    uint16_t seq;
+    bool resend;
+    int result = 1;
+
+    k_mutex_lock(&bulk_mutex, K_FOREVER);
+    if (!tx.active) {
+        k_mutex_unlock(&bulk_mutex);
+        return;
+    }
+
+    if (tx.waiting) {
+        // The status request or its answer was lost: ask again with the
+        // oldest unacknowledged chunk, which the receiver needs anyway.
+        stats.status_timeouts++;
+        if (++tx.status_retries > TS_BULK_MAX_STATUS_RETRIES) {
+            LOG_WRN("Bulk session %u to 0x%04x: no status, aborting",
+                    tx.session, tx.dst);
+            result = tx_finish(-ETIMEDOUT);
+            k_mutex_unlock(&bulk_mutex);
+            if (tx_done_cb != NULL) { tx_done_cb(result); }
+            return;
+        }
+        seq = tx.base;
+        resend = true;
+    } else if (!tx_pick_chunk(&seq, &resend)) {
+        // Nothing left to send and no request outstanding; only reached
+        // if a status emptied the window without finishing the session.
+        seq = tx.base;
+        resend = true;
+    }
+
+    // Request a status whenever this is the last chunk we can send
+    // before the window has to slide.
+    bool ack_req = !tx_has_more();
+    tx_build_chunk(&msg, seq, ack_req);
+    stats.chunks_sent++;
+    if (resend) { stats.chunks_resent++; }
+
+    tx.waiting = ack_req;
+    k_work_reschedule(&tx.work,
+                      K_MSEC(ack_req ? pacing_ms +
+                                           CONFIG_TS_BULK_STATUS_TIMEOUT_MS
+                                     : pacing_ms));
+    k_mutex_unlock(&bulk_mutex);
+
+    LOG_DBG("Bulk chunk %u/%u%s%s", seq, msg.data.bulk_data.total,
+            resend ? " (resend)" : "", ack_req ? " +status" : "");
+    publish(&msg);
+}
+
+static int tx_handle_status(const struct ts_msg_lora_outgoing* p_msg) {
+    const struct ts_msg_bulk_status* st = &p_msg->data.bulk_status;
+    int result = 1;
+
+    k_mutex_lock(&bulk_mutex, K_FOREVER);
+    if (!tx.active || st->session != tx.session ||
+        p_msg->route.src != tx.dst) {
+        k_mutex_unlock(&bulk_mutex);
+        return -ENOENT;
+    }
+    if (st->ack_base > tx.total) {
+        k_mutex_unlock(&bulk_mutex);
+        return -EINVAL;
+    }
+
+    // Statuses can arrive out of order; never move the window back.
+    if (st->ack_base >= tx.base) { tx_advance(st->ack_base); }
+    tx.status_retries = 0;
+
+    if (tx.base == tx.total) {
+        result = tx_finish(0);
+        LOG_INF("Bulk session %u: %u bytes in %u ms", tx.session,
+                stats.last_bytes, stats.last_duration_ms);
+        k_mutex_unlock(&bulk_mutex);
+        if (tx_done_cb != NULL) { tx_done_cb(result); }
+        return 0;
+    }
+
+    // Bit i of the bitmap is chunk ack_base + 1 + i; ack_base itself is
+    // missing by definition.  Only chunks already sent can be missing.
+    uint32_t missing = BIT(0) | (st->nack_bitmap << 1);
+    uint16_t sent = tx.next - tx.base;
+    if (sent < 32) { missing &= BIT_MASK(sent); }
+    tx.resend |= missing;
+
+    // Resume after the pacing gap of the last chunk, not right away: the
+    // off time is owed regardless of why the next chunk goes out.
+    if (tx.waiting) {
+        tx.waiting = false;
+        k_work_reschedule(&tx.work, K_MSEC(pacing_ms));
+    }
+    k_mutex_unlock(&bulk_mutex);
+    return 0;
+}
+
+// Must be called with the lock held.
+static void rx_build_status(struct ts_msg_lora_outgoing* p_msg) {
+    uint32_t nack = 0;
+
+    // Report chunks above base that are still missing, up to the highest
+    // one seen; anything beyond that simply hasn't been sent yet.
+    for (uint16_t seq = rx.base + 1; seq < rx.highest; seq++) {
+        uint16_t offset = seq - rx.base;
+        if (offset > 32) { break; }
+        if (!(rx.received & BIT(offset))) { nack |= BIT(offset - 1); }
+    }
+
+    memset(p_msg, 0, sizeof(*p_msg));
+    p_msg->type = TS_MSG_BULK_STATUS;
+    ts_routing_prepare_header(&p_msg->route, rx.src);
+    p_msg->data.bulk_status.session = rx.session;
+    p_msg->data.bulk_status.ack_base = rx.base;
+    p_msg->data.bulk_status.nack_bitmap = nack;
+}
+
+static int rx_handle_data(const struct ts_msg_lora_outgoing* p_msg) {
+    const struct ts_msg_bulk_data* chunk = &p_msg->data.bulk_data;
+    struct ts_msg_lora_outgoing status;
+    size_t pos = (size_t)chunk->seq * TS_MSG_BULK_CHUNK_SIZE;
+    bool send_status = chunk->ack_req;
+    bool delivered = false;
+    uint16_t src = p_msg->route.src;
+
+    if (chunk->total == 0 || chunk->total > TS_BULK_MAX_CHUNKS ||
+        chunk->seq >= chunk->total || chunk->len == 0 ||
+        chunk->len > TS_MSG_BULK_CHUNK_SIZE ||
+        (chunk->seq + 1 < chunk->total &&
+         chunk->len != TS_MSG_BULK_CHUNK_SIZE)) {
+        return -EINVAL;
+    }
+    // TS_BULK_MAX_SIZE need not be a multiple of the chunk size, so a
+    // full last chunk can still run past it
+    if (pos + chunk->len > TS_BULK_MAX_SIZE) { return -EMSGSIZE; }
+
+    k_mutex_lock(&bulk_mutex, K_FOREVER);
+    if (!rx.active || rx.src != src || rx.session != chunk->session) {
+        // A new session replaces whatever was in progress: the receiver
+        // only has one buffer, and a stalled sender would otherwise
+        // block everyone else.
+        if (rx.active && !rx.complete) {
+            LOG_WRN("Bulk session %u from 0x%04x abandoned", rx.session,
+                    rx.src);
+        }
+        rx.active = true;
+        rx.complete = false;
+        rx.src = src;
+        rx.session = chunk->session;
+        rx.total = chunk->total;
+        rx.base = 0;
+        rx.highest = 0;
+        rx.len = 0;
+        rx.received = 0;
+        rx.started_ms = k_uptime_get();
+    } else if (chunk->total != rx.total) {
+        k_mutex_unlock(&bulk_mutex);
+        return -EINVAL;
+    }
+
+    // Chunks below base or beyond the bitmap are duplicates or from a
+    // window we can't track yet; either way only the status matters.
+    if (!rx.complete && chunk->seq >= rx.base &&
+        chunk->seq - rx.base < 32) {
+        uint16_t offset = chunk->seq - rx.base;
+        if (!(rx.received & BIT(offset))) {
+            memcpy(rx.buf + pos, chunk->data, chunk->len);
+            rx.received |= BIT(offset);
+            if (chunk->seq + 1 == chunk->total) { rx.len = pos + chunk->len; }
+            rx.highest = MAX(rx.highest, chunk->seq + 1);
+        }
+        while (rx.received & BIT(0)) {
+            rx.received >>= 1;
+            rx.base++;
+        }
+        if (rx.base == rx.total) {
+            rx.complete = true;
+            delivered = true;
+            send_status = true;
+            stats.sessions_rx++;
+        }
+    }
+    rx_build_status(&status);
+    size_t len = rx.len;
+    uint32_t duration = (uint32_t)(k_uptime_get() - rx.started_ms);
+    k_mutex_unlock(&bulk_mutex);
+
+    if (delivered) {
+        LOG_INF("Bulk session from 0x%04x: %u bytes in %u ms", src,
+                (unsigned int)len, duration);
+        if (rx_done_cb != NULL) { rx_done_cb(src, rx.buf, len); }
+    }
+    if (send_status) { publish(&status); }
+    return 0;
+}
+
+void ts_bulk_init(const struct lora_modem_config* p_config,
+                  ts_bulk_rx_cb_t rx_cb, ts_bulk_tx_done_cb_t tx_done) {
+    uint32_t airtime = ts_airtime_ms(p_config, TS_BULK_FRAME_LEN_ESTIMATE);
+
+    k_mutex_lock(&bulk_mutex, K_FOREVER);
+    // Cancel any pending work before reinit (safe for test reuse)
+    if (work_initialized) {
+        struct k_work_sync sync;
+        k_work_cancel_delayable_sync(&tx.work, &sync);
+    }
+    memset(&tx, 0, sizeof(tx));
+    k_work_init_delayable(&tx.work, tx_work_handler);
+    work_initialized = true;
+    rx.active = false;
+    memset(&stats, 0, sizeof(stats));
+    rx_done_cb = rx_cb;
+    tx_done_cb = tx_done;
+    pacing_ms = ts_bulk_pacing_ms(airtime, CONFIG_TS_BULK_DUTY_CYCLE_PERMILLE);
+    next_session = (uint16_t)sys_rand32_get();
+    k_mutex_unlock(&bulk_mutex);
+
+    LOG_DBG("Bulk pacing: %u ms airtime, %u ms off", airtime, pacing_ms);
+}
+
+int ts_bulk_send(uint16_t dst, const uint8_t* p_data, size_t len) {
+    if (dst == TS_ROUTING_BROADCAST_ADDR || p_data == NULL || len == 0) {
+        return -EINVAL;
+    }
+    if (len > TS_BULK_MAX_SIZE) { return -EMSGSIZE; }
+
+    k_mutex_lock(&bulk_mutex, K_FOREVER);
+    if (tx.active) {
+        k_mutex_unlock(&bulk_mutex);
+        return -EBUSY;
+    }
+    tx.active = true;
+    tx.dst = dst;
+    tx.session = next_session++;
+    tx.total = DIV_ROUND_UP(len, TS_MSG_BULK_CHUNK_SIZE);
+    tx.base = 0;
+    tx.next = 0;
+    tx.resend = 0;
+    tx.waiting = false;
+    tx.status_retries = 0;
+    tx.data = p_data;
+    tx.len = len;
+    tx.started_ms = k_uptime_get();
+    k_work_reschedule(&tx.work, K_NO_WAIT);
+    k_mutex_unlock(&bulk_mutex);
+
+    LOG_INF("Bulk session %u to 0x%04x: %u bytes in %u chunks", tx.session,
+            dst, (unsigned int)len, tx.total);
+    return 0;
+}
+
+int ts_bulk_handle(const struct ts_msg_lora_outgoing* p_msg) {
+    switch (p_msg->type) {
+        case TS_MSG_BULK_DATA:
+            return rx_handle_data(p_msg);
+        case TS_MSG_BULK_STATUS:
+            return tx_handle_status(p_msg);
+        default:
+            return -ENOTSUP;
+    }
+}
+
+uint32_t ts_bulk_pacing_ms(uint32_t airtime_ms, uint16_t duty_permille) {
+    if (duty_permille == 0 || duty_permille >= 1000) { return 0; }
+    return (uint32_t)(((uint64_t)airtime_ms * (1000 - duty_permille) +
+                       duty_permille - 1) /
+                      duty_permille);
+}
+
+bool ts_bulk_tx_active(void) {
+    k_mutex_lock(&bulk_mutex, K_FOREVER);
+    bool active = tx.active;
+    k_mutex_unlock(&bulk_mutex);
+    return active;
+}
+
+void ts_bulk_get_stats(struct ts_bulk_stats* p_stats) {
+    k_mutex_lock(&bulk_mutex, K_FOREVER);
+    *p_stats = stats;
+    k_mutex_unlock(&bulk_mutex);
+}
+
+// Bulk frames are delivered on the incoming channel like any other
+// message; feed the ones addressed to us into the session state.
+static void bulk_listener_cb(const struct zbus_channel* chan) {
+    const struct ts_msg_lora_incoming* in = ts_msg_pool_peek(chan);
+
+    if (in->msg.route.dst != ts_routing_get_node_id()) { return; }
+    int ret = ts_bulk_handle(&in->msg);
+    if (ret != 0 && ret != -ENOTSUP) {
+        LOG_DBG("Bulk message ignored: %d", ret);
+    }
+}
+
+ZBUS_LISTENER_DEFINE(ts_bulk_lis, bulk_listener_cb);
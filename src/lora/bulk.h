@@ -0,0 +1,140 @@
+#ifndef TS_BULK_H
+#define TS_BULK_H
+
+/**
+ * @defgroup bulk Bulk Transfer
+ * @brief Windowed, selectively acknowledged transfer of large buffers.
+ *
+ * Moves a buffer of up to TS_BULK_MAX_SIZE bytes to one node over a
+ * unicast route as a session of TS_MSG_BULK_DATA chunks.  The sender
+ * keeps at most TS_BULK_WINDOW chunks in flight and asks for a status
+ * on the last chunk of each burst.  The receiver answers with
+ * TS_MSG_BULK_STATUS: a cumulative ACK plus a bitmap of chunks still
+ * missing above it.  Only those are resent, and the window slides as
+ * the cumulative ACK advances.
+ *
+ * Chunks are paced by the regulatory duty cycle: after a chunk with
+ * airtime T the sender stays silent for T * (1 / duty - 1), so a
+ * session can run indefinitely without exceeding the budget.
+ *
+ * One outgoing and one incoming session are supported at a time.
+ * Bulk frames handle their own end-to-end recovery and are exempt from
+ * hop-by-hop link ACKs.
+ * @{
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/drivers/lora.h>
+#include <zephyr/kernel.h>
+
+#include "messages/messages.h"
+
+/** @brief Largest buffer a session can carry (set via Kconfig). */
+#define TS_BULK_MAX_SIZE CONFIG_TS_BULK_MAX_SIZE
+
+/** @brief Chunks per session at TS_BULK_MAX_SIZE. */
+#define TS_BULK_MAX_CHUNKS \
+    DIV_ROUND_UP(TS_BULK_MAX_SIZE, TS_MSG_BULK_CHUNK_SIZE)
+
+/** @brief Chunks in flight before the sender waits for a status. */
+#define TS_BULK_WINDOW 8
+
+/** @brief Status timeouts in a row before the session is aborted. */
+#define TS_BULK_MAX_STATUS_RETRIES 5
+
+/** @brief Frame size used to estimate chunk airtime for pacing. */
+#define TS_BULK_FRAME_LEN_ESTIMATE 240
+
+BUILD_ASSERT(TS_BULK_WINDOW <= 32,
+             "NACK bitmap must cover the whole window");
+BUILD_ASSERT(TS_BULK_MAX_CHUNKS <= UINT16_MAX,
+             "Chunk sequence numbers are 16-bit");
+
+/**
+ * @brief Completed incoming transfer callback.
+ *
+ * @param src     Sending node
+ * @param p_data  Received buffer (valid until the next session starts)
+ * @param len     Buffer length
+ */
+typedef void (*ts_bulk_rx_cb_t)(uint16_t src, const uint8_t* p_data,
+                                size_t len);
+
+/**
+ * @brief Outgoing transfer finished callback.
+ *
+ * @param result  0 when every chunk was acknowledged, -ETIMEDOUT when
+ *                the receiver stopped answering
+ */
+typedef void (*ts_bulk_tx_done_cb_t)(int result);
+
+/** @brief Session counters since ts_bulk_init(). */
+struct ts_bulk_stats {
+    uint32_t sessions_ok;     /**< Outgoing sessions fully acknowledged */
+    uint32_t sessions_failed; /**< Outgoing sessions aborted */
+    uint32_t sessions_rx;     /**< Incoming sessions completed */
+    uint32_t chunks_sent;     /**< Chunk transmissions incl. resends */
+    uint32_t chunks_resent;   /**< Chunks resent after NACK or timeout */
+    uint32_t status_timeouts; /**< Status waits that expired */
+    uint32_t last_bytes;       /**< Size of the last completed session */
+    uint32_t last_duration_ms; /**< Duration of the last completed session */
+};
+
+/**
+ * @brief Reset both session states and counters.
+ *
+ * @param p_config  Modem configuration used to estimate chunk airtime
+ * @param rx_cb     Completed-transfer callback (NULL to only log)
+ * @param tx_done   Outgoing-session callback (may be NULL)
+ */
+void ts_bulk_init(const struct lora_modem_config* p_config,
+                  ts_bulk_rx_cb_t rx_cb, ts_bulk_tx_done_cb_t tx_done);
+
+/**
+ * @brief Start sending a buffer to a node.
+ *
+ * @param dst     Destination node (unicast only)
+ * @param p_data  Buffer to send; must stay valid until tx_done
+ * @param len     Buffer length
+ * @return 0 on success, -EBUSY if a session is active, -EINVAL for a
+ *         broadcast destination or empty buffer, -EMSGSIZE if too large
+ */
+int ts_bulk_send(uint16_t dst, const uint8_t* p_data, size_t len);
+
+/**
+ * @brief Feed a received bulk message into the session state.
+ *
+ * @param p_msg  Decoded message addressed to this node
+ * @return 0 if consumed, -ENOTSUP for non-bulk types, -ENOENT if it
+ *         belongs to no known session, -EINVAL if malformed
+ */
+int ts_bulk_handle(const struct ts_msg_lora_outgoing* p_msg);
+
+/**
+ * @brief Silence required after a frame to respect a duty cycle.
+ *
+ * @param airtime_ms    Time on air of the frame
+ * @param duty_permille Duty-cycle budget in 1/1000 (10 = 1 %)
+ * @return Off time in milliseconds
+ */
+uint32_t ts_bulk_pacing_ms(uint32_t airtime_ms, uint16_t duty_permille);
+
+/**
+ * @brief Check whether an outgoing session is in progress.
+ *
+ * @return true while sending
+ */
+bool ts_bulk_tx_active(void);
+
+/**
+ * @brief Copy the session counters.
+ *
+ * @param p_stats  Output counters
+ */
+void ts_bulk_get_stats(struct ts_bulk_stats* p_stats);
+
+/** @} */
+
+#endif  // TS_BULK_H
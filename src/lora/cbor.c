@@ -1,104 +1,270 @@
 #include "lora/cbor.h"
 
 #include <errno.h>
+#include <stddef.h>
+#include <string.h>
 #include <zcbor_decode.h>
 #include <zcbor_encode.h>
 #include <zephyr/logging/log.h>
 
+#include "lora/cbor_schema.h"
+
 LOG_MODULE_REGISTER(cbor);
 
-static int serialize_route(zcbor_state_t* state,
-                           const struct ts_route_header* p_route) {
-    if (!zcbor_tstr_put_lit(state, "route") ||
-        !zcbor_map_start_encode(state, 5) ||
-        !zcbor_tstr_put_lit(state, "src") ||
-        !zcbor_uint32_put(state, (uint32_t)p_route->src) ||
-        !zcbor_tstr_put_lit(state, "dst") ||
-        !zcbor_uint32_put(state, (uint32_t)p_route->dst) ||
-        !zcbor_tstr_put_lit(state, "msg_id") ||
-        !zcbor_uint32_put(state, p_route->msg_id) ||
-        !zcbor_tstr_put_lit(state, "ttl") ||
-        !zcbor_uint32_put(state, (uint32_t)p_route->ttl) ||
-        !zcbor_tstr_put_lit(state, "key_id") ||
-        !zcbor_uint32_put(state, (uint32_t)p_route->key_id) ||
-        !zcbor_map_end_encode(state, 5)) {
-        return -ENOMEM;
+BUILD_ASSERT(TS_CBOR_MAX_SIZE <= ZBOR_ENCODE_BUFFER_SIZE,
+             "Encode buffer must hold the largest message");
+
+// Envelope map keys (see messages.cddl)
+#define KEY_VERSION 0
+#define KEY_TYPE 1
+#define KEY_ROUTE 2
+#define KEY_DATA 3
+#define ENVELOPE_KEYS 4
+
+enum field_kind { KIND_UINT, KIND_INT, KIND_BOOL, KIND_BSTR, KIND_LIST };
+
+struct cbor_schema;
+
+// One member of an encoded structure, expanded from cbor_schema.h.
+// Offsets are relative to the structure, sizes those of the member.
+struct cbor_field {
+    uint8_t kind;
+    uint16_t size;
+    uint16_t offset;
+    uint16_t aux_offset;  // BSTR length / LIST count member
+    uint16_t elem_size;   // LIST element size
+    const struct cbor_schema* record;  // LIST element fields
+};
+
+struct cbor_schema {
+    const struct cbor_field* fields;
+    uint8_t count;
+};
+
+#define AUX_OFFSET_UINT(T, aux) 0
+#define AUX_OFFSET_INT(T, aux) 0
+#define AUX_OFFSET_BOOL(T, aux) 0
+#define AUX_OFFSET_BSTR(T, aux) offsetof(T, aux)
+#define AUX_OFFSET_LIST(T, aux) offsetof(T, aux)
+
+#define ELEM_SIZE_UINT(T, m) 0
+#define ELEM_SIZE_INT(T, m) 0
+#define ELEM_SIZE_BOOL(T, m) 0
+#define ELEM_SIZE_BSTR(T, m) 0
+#define ELEM_SIZE_LIST(T, m) TS_CBOR_MEMBER_SIZE(T, m[0])
+
+// Record elements are flat, so their fields need no aux or record
+#define RECORD_FIELD(T, K, m, aux, rec)     \
+    {.kind = KIND_##K,                      \
+     .size = TS_CBOR_MEMBER_SIZE(T, m),     \
+     .offset = offsetof(T, m)},
+#define RECORD_COUNT(T, K, m, aux, rec) +1
+
+#define RECORD_UINT(T, m, rec) NULL
+#define RECORD_INT(T, m, rec) NULL
+#define RECORD_BOOL(T, m, rec) NULL
+#define RECORD_BSTR(T, m, rec) NULL
+#define RECORD_LIST(T, m, rec)                                         \
+    &(const struct cbor_schema) {                                      \
+        .fields = (const struct cbor_field[]){rec(                      \
+            RECORD_FIELD, __typeof__(((T*)0)->m[0]))},                  \
+        .count = 0 rec(RECORD_COUNT, -),                               \
     }
-    return 0;
+
+#define FIELD(T, K, m, aux, rec)                   \
+    {.kind = KIND_##K,                             \
+     .size = TS_CBOR_MEMBER_SIZE(T, m),            \
+     .offset = offsetof(T, m),                     \
+     .aux_offset = AUX_OFFSET_##K(T, aux),      \
+     .elem_size = ELEM_SIZE_##K(T, m),          \
+     .record = RECORD_##K(T, m, rec)},
+
+static const struct cbor_field route_fields[] = {
+    TS_CBOR_ROUTE_FIELDS(FIELD, struct ts_route_header)};
+static const struct cbor_schema route_schema = {
+    .fields = route_fields, .count = ARRAY_SIZE(route_fields)};
+
+#define PAYLOAD_FIELDS(type, member, T, LIST) \
+    static const struct cbor_field member##_fields[] = {LIST(FIELD, T)};
+TS_CBOR_MESSAGES(PAYLOAD_FIELDS)
+
+#define PAYLOAD_SCHEMA(type, member, T, LIST) \
+    [type] = {.fields = member##_fields, .count = ARRAY_SIZE(member##_fields)},
+
+// Indexed by ts_msg_type_t; the dispatch is a lookup, not a switch
+static const struct cbor_schema payload_schemas[] = {
+    TS_CBOR_MESSAGES(PAYLOAD_SCHEMA)};
+
+static const struct cbor_schema* payload_schema(uint32_t type) {
+    if (type >= ARRAY_SIZE(payload_schemas) ||
+        payload_schemas[type].fields == NULL) {
+        return NULL;
+    }
+    return &payload_schemas[type];
+}
+
+static uint32_t load_uint(const uint8_t* p_member, uint16_t size) {
+    switch (size) {
+        case 1:
+            return *p_member;
+        case 2:
+            return *(const uint16_t*)p_member;
+        default:
+            return *(const uint32_t*)p_member;
+    }
+}
+
+static void store_uint(uint8_t* p_member, uint16_t size, uint32_t value) {
+    switch (size) {
+        case 1:
+            *p_member = (uint8_t)value;
+            break;
+        case 2:
+            *(uint16_t*)p_member = (uint16_t)value;
+            break;
+        default:
+            *(uint32_t*)p_member = value;
+            break;
+    }
+}
+
+static int32_t load_int(const uint8_t* p_member, uint16_t size) {
+    switch (size) {
+        case 1:
+            return *(const int8_t*)p_member;
+        case 2:
+            return *(const int16_t*)p_member;
+        default:
+            return *(const int32_t*)p_member;
+    }
+}
+
+static void store_int(uint8_t* p_member, uint16_t size, int32_t value) {
+    switch (size) {
+        case 1:
+            *(int8_t*)p_member = (int8_t)value;
+            break;
+        case 2:
+            *(int16_t*)p_member = (int16_t)value;
+            break;
+        default:
+            *(int32_t*)p_member = value;
+            break;
+    }
+}
+
+static int encode_struct(zcbor_state_t* state,
+                         const struct cbor_schema* schema,
+                         const uint8_t* p_base, bool keyed);
+
+static int encode_field(zcbor_state_t* state, const struct cbor_field* field,
+                        const uint8_t* p_base) {
+    const uint8_t* p_member = p_base + field->offset;
+    bool ok;
+
+    switch (field->kind) {
+        case KIND_UINT:
+            ok = zcbor_uint32_put(state, load_uint(p_member, field->size));
+            break;
+        case KIND_INT:
+            ok = zcbor_int32_put(state, load_int(p_member, field->size));
+            break;
+        case KIND_BOOL:
+            ok = zcbor_bool_put(state, *(const bool*)p_member);
+            break;
+        case KIND_BSTR: {
+            uint8_t len = p_base[field->aux_offset];
+            if (len > field->size) { return -EINVAL; }
+            ok = zcbor_bstr_encode_ptr(state, (const char*)p_member, len);
+            break;
+        }
+        case KIND_LIST: {
+            uint8_t count = p_base[field->aux_offset];
+            if (count == 0 || count > field->size / field->elem_size) {
+                return -EINVAL;
+            }
+            if (!zcbor_list_start_encode(state, count)) { return -ENOMEM; }
+            for (uint8_t i = 0; i < count; i++) {
+                int ret = encode_struct(state, field->record,
+                                        p_member + i * field->elem_size,
+                                        false);
+                if (ret != 0) { return ret; }
+            }
+            ok = zcbor_list_end_encode(state, count);
+            break;
+        }
+        default:
+            return -EINVAL;
+    }
+    return ok ? 0 : -ENOMEM;
+}
+
+// Keyed structures are maps keyed by field position; records inside a
+// list are positional arrays, since repeating keys per element would
+// cost more than the values.
+static int encode_struct(zcbor_state_t* state,
+                         const struct cbor_schema* schema,
+                         const uint8_t* p_base, bool keyed) {
+    bool ok = keyed ? zcbor_map_start_encode(state, schema->count)
+                    : zcbor_list_start_encode(state, schema->count);
+    if (!ok) { return -ENOMEM; }
+
+    for (uint8_t i = 0; i < schema->count; i++) {
+        if (keyed && !zcbor_uint32_put(state, i)) { return -ENOMEM; }
+        int ret = encode_field(state, &schema->fields[i], p_base);
+        if (ret != 0) { return ret; }
+    }
+
+    ok = keyed ? zcbor_map_end_encode(state, schema->count)
+               : zcbor_list_end_encode(state, schema->count);
+    return ok ? 0 : -ENOMEM;
 }
 
 int cbor_serialize(struct ts_msg_lora_outgoing* msg, uint8_t* p_buf,
                    size_t buf_len, size_t* p_size) {
-    ZCBOR_STATE_E(enc_state, 0, p_buf, buf_len, 0);
-    int ret;
+    // Canonical encoding needs a backup per open container: envelope,
+    // payload map, and the record list and each record of a LIST field
+    ZCBOR_STATE_E(enc_state, 4, p_buf, buf_len, 0);
 
-    if (!zcbor_map_start_encode(enc_state, 3)) {
-        ret = zcbor_peek_error(enc_state);
-        LOG_ERR("Failed to start CBOR map, error: %d", ret);
-        return -ENOMEM;
+    const struct cbor_schema* schema = payload_schema(msg->type);
+    if (schema == NULL) {
+        LOG_ERR("Unknown message type: %d", msg->type);
+        return -EINVAL;
     }
 
-    if (!zcbor_tstr_put_lit(enc_state, "type") ||
-        !zcbor_uint32_put(enc_state, msg->type)) {
-        ret = zcbor_peek_error(enc_state);
-        LOG_ERR("Failed to encode type, error: %d", ret);
+    if (!zcbor_map_start_encode(enc_state, ENVELOPE_KEYS) ||
+        !zcbor_uint32_put(enc_state, KEY_VERSION) ||
+        !zcbor_uint32_put(enc_state, TS_CBOR_WIRE_VERSION) ||
+        !zcbor_uint32_put(enc_state, KEY_TYPE) ||
+        !zcbor_uint32_put(enc_state, msg->type) ||
+        !zcbor_uint32_put(enc_state, KEY_ROUTE)) {
+        LOG_ERR("Failed to encode envelope, error: %d",
+                zcbor_peek_error(enc_state));
         return -ENOMEM;
     }
 
-    ret = serialize_route(enc_state, &msg->route);
+    int ret = encode_struct(enc_state, &route_schema,
+                            (const uint8_t*)&msg->route, true);
     if (ret != 0) {
         LOG_ERR("Failed to encode route header");
         return ret;
     }
 
-    if (!zcbor_tstr_put_lit(enc_state, "data")) {
-        ret = zcbor_peek_error(enc_state);
-        LOG_ERR("Failed to encode data key, error: %d", ret);
+    if (!zcbor_uint32_put(enc_state, KEY_DATA)) {
+        LOG_ERR("Failed to encode data key, error: %d",
+                zcbor_peek_error(enc_state));
         return -ENOMEM;
     }
 
-    switch (msg->type) {
-        case TS_MSG_TELEMETRY:
-            if (!zcbor_map_start_encode(enc_state, 4) ||
-                !zcbor_tstr_put_lit(enc_state, "timestamp") ||
-                !zcbor_uint32_put(enc_state, msg->data.telemetry.timestamp) ||
-                !zcbor_tstr_put_lit(enc_state, "temperature") ||
-                !zcbor_uint32_put(enc_state, msg->data.telemetry.temperature) ||
-                !zcbor_tstr_put_lit(enc_state, "humidity") ||
-                !zcbor_uint32_put(enc_state, msg->data.telemetry.humidity) ||
-                !zcbor_tstr_put_lit(enc_state, "pressure") ||
-                !zcbor_uint32_put(enc_state, msg->data.telemetry.pressure) ||
-                !zcbor_map_end_encode(enc_state, 4)) {
-                ret = zcbor_peek_error(enc_state);
-                LOG_ERR("Failed to encode telemetry data, error: %d", ret);
-                return -ENOMEM;
-            }
-            break;
-
-        case TS_MSG_NODE_STATUS:
-            if (!zcbor_map_start_encode(enc_state, 3) ||
-                !zcbor_tstr_put_lit(enc_state, "timestamp") ||
-                !zcbor_uint32_put(enc_state, msg->data.node_status.timestamp) ||
-                !zcbor_tstr_put_lit(enc_state, "uptime") ||
-                !zcbor_uint32_put(enc_state, msg->data.node_status.uptime) ||
-                !zcbor_tstr_put_lit(enc_state, "status") ||
-                !zcbor_uint32_put(enc_state,
-                                  (uint32_t)msg->data.node_status.status) ||
-                !zcbor_map_end_encode(enc_state, 3)) {
-                ret = zcbor_peek_error(enc_state);
-                LOG_ERR("Failed to encode node_status data, error: %d", ret);
-                return -ENOMEM;
-            }
-            break;
-
-        default:
-            LOG_ERR("Unknown message type: %d", msg->type);
-            return -EINVAL;
+    ret = encode_struct(enc_state, schema, (const uint8_t*)&msg->data, true);
+    if (ret != 0) {
+        LOG_ERR("Failed to encode type %d payload: %d", msg->type, ret);
+        return ret;
     }
 
-    if (!zcbor_map_end_encode(enc_state, 3)) {
-        ret = zcbor_peek_error(enc_state);
-        LOG_ERR("Failed to end CBOR map, error: %d", ret);
+    if (!zcbor_map_end_encode(enc_state, ENVELOPE_KEYS)) {
+        LOG_ERR("Failed to end CBOR map, error: %d",
+                zcbor_peek_error(enc_state));
         return -ENOMEM;
     }
 
@@ -107,117 +273,142 @@ int cbor_serialize(struct ts_msg_lora_outgoing* msg, uint8_t* p_buf,
     return 0;
 }
 
-static int deserialize_route(zcbor_state_t* state,
-                             struct ts_route_header* p_route) {
-    uint32_t src, dst, msg_id, ttl, key_id;
-
-    if (!zcbor_tstr_expect_lit(state, "route") ||
-        !zcbor_map_start_decode(state) ||
-        !zcbor_tstr_expect_lit(state, "src") ||
-        !zcbor_uint32_decode(state, &src) ||
-        !zcbor_tstr_expect_lit(state, "dst") ||
-        !zcbor_uint32_decode(state, &dst) ||
-        !zcbor_tstr_expect_lit(state, "msg_id") ||
-        !zcbor_uint32_decode(state, &msg_id) ||
-        !zcbor_tstr_expect_lit(state, "ttl") ||
-        !zcbor_uint32_decode(state, &ttl) ||
-        !zcbor_tstr_expect_lit(state, "key_id") ||
-        !zcbor_uint32_decode(state, &key_id) || !zcbor_map_end_decode(state)) {
-        return -EBADMSG;
-    }
+static int decode_struct(zcbor_state_t* state,
+                         const struct cbor_schema* schema, uint8_t* p_base,
+                         bool keyed);
 
-    p_route->src = (uint16_t)src;
-    p_route->dst = (uint16_t)dst;
-    p_route->msg_id = msg_id;
-    p_route->ttl = (uint8_t)ttl;
-    p_route->key_id = (uint8_t)key_id;
-    return 0;
-}
+static int decode_field(zcbor_state_t* state, const struct cbor_field* field,
+                        uint8_t* p_base) {
+    uint8_t* p_member = p_base + field->offset;
 
-static int deserialize_telemetry(zcbor_state_t* state,
-                                 struct ts_msg_telemetry* p_tel) {
-    if (!zcbor_map_start_decode(state) ||
-        !zcbor_tstr_expect_lit(state, "timestamp") ||
-        !zcbor_uint32_decode(state, &p_tel->timestamp) ||
-        !zcbor_tstr_expect_lit(state, "temperature") ||
-        !zcbor_uint32_decode(state, &p_tel->temperature) ||
-        !zcbor_tstr_expect_lit(state, "humidity") ||
-        !zcbor_uint32_decode(state, &p_tel->humidity) ||
-        !zcbor_tstr_expect_lit(state, "pressure") ||
-        !zcbor_uint32_decode(state, &p_tel->pressure) ||
-        !zcbor_map_end_decode(state)) {
-        return -EBADMSG;
+    switch (field->kind) {
+        case KIND_UINT: {
+            uint32_t value;
+            if (!zcbor_uint32_decode(state, &value)) { return -EBADMSG; }
+            if (field->size < 4 && value >> (8 * field->size) != 0) {
+                return -EBADMSG;
+            }
+            store_uint(p_member, field->size, value);
+            return 0;
+        }
+        case KIND_INT: {
+            int32_t value;
+            if (!zcbor_int32_decode(state, &value)) { return -EBADMSG; }
+            if (field->size < 4 &&
+                (value < -(1 << (8 * field->size - 1)) ||
+                 value >= (1 << (8 * field->size - 1)))) {
+                return -EBADMSG;
+            }
+            store_int(p_member, field->size, value);
+            return 0;
+        }
+        case KIND_BOOL:
+            return zcbor_bool_decode(state, (bool*)p_member) ? 0 : -EBADMSG;
+        case KIND_BSTR: {
+            struct zcbor_string str;
+            if (!zcbor_bstr_decode(state, &str) || str.len > field->size) {
+                return -EBADMSG;
+            }
+            memcpy(p_member, str.value, str.len);
+            p_base[field->aux_offset] = (uint8_t)str.len;
+            return 0;
+        }
+        case KIND_LIST: {
+            size_t capacity = field->size / field->elem_size;
+            uint8_t count = 0;
+
+            if (!zcbor_list_start_decode(state)) { return -EBADMSG; }
+            while (!zcbor_array_at_end(state)) {
+                if (count == capacity) { return -EBADMSG; }
+                int ret = decode_struct(state, field->record,
+                                        p_member + count * field->elem_size,
+                                        false);
+                if (ret != 0) { return ret; }
+                count++;
+            }
+            if (!zcbor_list_end_decode(state) || count == 0) {
+                return -EBADMSG;
+            }
+            p_base[field->aux_offset] = count;
+            return 0;
+        }
+        default:
+            return -EBADMSG;
     }
-    return 0;
 }
 
-static int deserialize_node_status(zcbor_state_t* state,
-                                   struct ts_msg_node_status* p_ns) {
-    uint32_t status_val;
-
-    if (!zcbor_map_start_decode(state) ||
-        !zcbor_tstr_expect_lit(state, "timestamp") ||
-        !zcbor_uint32_decode(state, &p_ns->timestamp) ||
-        !zcbor_tstr_expect_lit(state, "uptime") ||
-        !zcbor_uint32_decode(state, &p_ns->uptime) ||
-        !zcbor_tstr_expect_lit(state, "status") ||
-        !zcbor_uint32_decode(state, &status_val) ||
-        !zcbor_map_end_decode(state)) {
-        return -EBADMSG;
+// Keys are checked as integers against the field's position, so a
+// decoder never compares strings and rejects reordered or unknown keys.
+static int decode_struct(zcbor_state_t* state,
+                         const struct cbor_schema* schema, uint8_t* p_base,
+                         bool keyed) {
+    bool ok = keyed ? zcbor_map_start_decode(state)
+                    : zcbor_list_start_decode(state);
+    if (!ok) { return -EBADMSG; }
+
+    for (uint8_t i = 0; i < schema->count; i++) {
+        if (keyed && !zcbor_uint32_expect(state, i)) { return -EBADMSG; }
+        int ret = decode_field(state, &schema->fields[i], p_base);
+        if (ret != 0) { return ret; }
     }
-    p_ns->status = (ts_status_t)status_val;
-    return 0;
+
+    ok = keyed ? zcbor_map_end_decode(state) : zcbor_list_end_decode(state);
+    return ok ? 0 : -EBADMSG;
 }
 
 int cbor_deserialize(const uint8_t* p_buf, size_t buf_len,
                      struct ts_msg_lora_outgoing* p_msg) {
     if (p_buf == NULL || buf_len == 0) { return -EINVAL; }
+    p_msg->short_timestamp = false;
 
-    // 2 backups for nested containers (outer map + route/data map)
-    ZCBOR_STATE_D(dec_state, 2, p_buf, buf_len, 1, 0);
+    // 4 backups for nested containers (envelope, payload map, and the
+    // record list and each record inside a LIST field)
+    ZCBOR_STATE_D(dec_state, 4, p_buf, buf_len, 1, 0);
 
+    uint32_t version;
     uint32_t type_val;
 
     if (!zcbor_map_start_decode(dec_state) ||
-        !zcbor_tstr_expect_lit(dec_state, "type") ||
-        !zcbor_uint32_decode(dec_state, &type_val)) {
+        !zcbor_uint32_expect(dec_state, KEY_VERSION) ||
+        !zcbor_uint32_decode(dec_state, &version)) {
+        LOG_ERR("Failed to decode CBOR envelope");
+        return -EBADMSG;
+    }
+    if (version != TS_CBOR_WIRE_VERSION) {
+        LOG_ERR("Unsupported wire version: %u", version);
+        return -EPROTONOSUPPORT;
+    }
+
+    if (!zcbor_uint32_expect(dec_state, KEY_TYPE) ||
+        !zcbor_uint32_decode(dec_state, &type_val) ||
+        !zcbor_uint32_expect(dec_state, KEY_ROUTE)) {
         LOG_ERR("Failed to decode CBOR envelope");
         return -EBADMSG;
     }
 
     p_msg->type = (ts_msg_type_t)type_val;
+    const struct cbor_schema* schema = payload_schema(type_val);
+    if (schema == NULL) {
+        LOG_ERR("Unknown message type: %u", type_val);
+        return -EINVAL;
+    }
 
-    int ret = deserialize_route(dec_state, &p_msg->route);
+    int ret = decode_struct(dec_state, &route_schema,
+                            (uint8_t*)&p_msg->route, true);
     if (ret != 0) {
         LOG_ERR("Failed to decode route header");
         return ret;
     }
 
-    if (!zcbor_tstr_expect_lit(dec_state, "data")) {
+    if (!zcbor_uint32_expect(dec_state, KEY_DATA)) {
         LOG_ERR("Failed to decode data key");
         return -EBADMSG;
     }
 
-    switch (p_msg->type) {
-        case TS_MSG_TELEMETRY:
-            ret = deserialize_telemetry(dec_state, &p_msg->data.telemetry);
-            if (ret != 0) {
-                LOG_ERR("Failed to decode telemetry data");
-                return ret;
-            }
-            break;
-
-        case TS_MSG_NODE_STATUS:
-            ret = deserialize_node_status(dec_state, &p_msg->data.node_status);
-            if (ret != 0) {
-                LOG_ERR("Failed to decode node_status data");
-                return ret;
-            }
-            break;
-
-        default:
-            LOG_ERR("Unknown message type: %d", p_msg->type);
-            return -EINVAL;
+    ret = decode_struct(dec_state, schema, (uint8_t*)&p_msg->data, true);
+    if (ret != 0) {
+        LOG_ERR("Failed to decode type %u payload: %d", type_val, ret);
+        return ret;
     }
 
     if (!zcbor_map_end_decode(dec_state)) {
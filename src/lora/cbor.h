@@ -4,6 +4,11 @@
 /**
  * @defgroup cbor CBOR
  * @brief CBOR serialization and deserialization for mesh messages.
+ *
+ * The wire format is specified in src/messages/messages.cddl: every
+ * message is a map of wire version, type, route header and payload,
+ * keyed by small integers.  The codec is table-driven from the field lists in
+ * cbor_schema.h, which also yield TS_CBOR_MAX_SIZE at compile time.
  * @{
  */
 
@@ -12,19 +17,30 @@
 
 #include "messages/messages.h"
 
+/**
+ * @brief Version of the CBOR wire format, sent in every envelope.
+ *
+ * Bumped whenever an existing message changes its encoding, so a node
+ * running older firmware drops the frame as unsupported instead of
+ * misreading its fields.
+ */
+#define TS_CBOR_WIRE_VERSION 1
+
 /** @brief Maximum buffer size for CBOR encoding. */
 #define ZBOR_ENCODE_BUFFER_SIZE 256
 
 /**
  * @brief Serialize a message to CBOR binary format.
  *
- * Encodes the route header, message type, and payload data.
+ * Encodes the wire version, message type, route header, and payload
+ * data.
  *
  * @param msg      Message to serialize
  * @param p_buf    Output buffer
  * @param buf_len  Size of the output buffer
  * @param p_size   Output: number of bytes written
- * @return 0 on success, -ENOMEM if buffer too small, -EINVAL if unknown type
+ * @return 0 on success, -ENOMEM if buffer too small, -EINVAL if unknown
+ *         type or a length or count out of range
  */
 int cbor_serialize(struct ts_msg_lora_outgoing* msg, uint8_t* p_buf,
                    size_t buf_len, size_t* p_size);
@@ -37,7 +53,9 @@ int cbor_serialize(struct ts_msg_lora_outgoing* msg, uint8_t* p_buf,
  * @param p_buf    Input CBOR buffer
  * @param buf_len  Length of the input buffer
  * @param p_msg    Output message struct
- * @return 0 on success, -EINVAL if null/empty, -EBADMSG if malformed
+ * @return 0 on success, -EINVAL if null/empty or unknown type, -EBADMSG
+ *         if malformed or not matching the schema, -EPROTONOSUPPORT if
+ *         sent with another TS_CBOR_WIRE_VERSION
  */
 int cbor_deserialize(const uint8_t* p_buf, size_t buf_len,
                      struct ts_msg_lora_outgoing* p_msg);
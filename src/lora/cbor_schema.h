@@ -0,0 +1,196 @@
+#ifndef TS_CBOR_SCHEMA_H
+#define TS_CBOR_SCHEMA_H
+
+/**
+ * @addtogroup cbor
+ * @{
+ */
+
+#include <stdint.h>
+#include <zephyr/sys/util.h>
+
+#include "messages/messages.h"
+
+/**
+ * @name Message schema
+ *
+ * C mirror of src/messages/messages.cddl.  Each structure is a list of
+ * X(T, kind, member, aux, record) entries in wire order, and a member's
+ * CBOR map key is its position in the list.  Kinds:
+ *
+ * - UINT, INT: unsigned or signed integer member of 1, 2 or 4 bytes
+ * - BOOL: bool member
+ * - BSTR: byte array member; aux names its uint8_t length member
+ * - LIST: array of records; aux names its uint8_t count member and
+ *   record the field list of one element, sent as a positional array
+ *   of UINT, INT or BOOL fields
+ *
+ * Unused aux and record slots are "-".  The codec tables in cbor.c and
+ * the maximum sizes below are both expanded from these lists, so a
+ * type added here is encoded, decoded and size-checked with no further
+ * code.
+ * @{
+ */
+
+#define TS_CBOR_ROUTE_FIELDS(X, T) \
+    X(T, UINT, src, -, -)          \
+    X(T, UINT, dst, -, -)          \
+    X(T, UINT, msg_id, -, -)       \
+    X(T, UINT, ttl, -, -)          \
+    X(T, UINT, key_id, -, -)       \
+    X(T, INT, tx_power, -, -)
+
+#define TS_CBOR_TELEMETRY_FIELDS(X, T) \
+    X(T, UINT, timestamp, -, -)        \
+    X(T, INT, temperature, -, -)       \
+    X(T, INT, humidity, -, -)          \
+    X(T, INT, pressure, -, -)
+
+#define TS_CBOR_NODE_STATUS_FIELDS(X, T) \
+    X(T, UINT, timestamp, -, -)          \
+    X(T, UINT, uptime, -, -)             \
+    X(T, UINT, status, -, -)
+
+#define TS_CBOR_ACK_FIELDS(X, T) \
+    X(T, UINT, src, -, -)        \
+    X(T, UINT, msg_id, -, -)     \
+    X(T, UINT, ttl, -, -)
+
+#define TS_CBOR_BULK_DATA_FIELDS(X, T) \
+    X(T, UINT, session, -, -)          \
+    X(T, UINT, seq, -, -)              \
+    X(T, UINT, total, -, -)            \
+    X(T, BOOL, ack_req, -, -)          \
+    X(T, BSTR, data, len, -)
+
+#define TS_CBOR_BULK_STATUS_FIELDS(X, T) \
+    X(T, UINT, session, -, -)            \
+    X(T, UINT, ack_base, -, -)           \
+    X(T, UINT, nack_bitmap, -, -)
+
+#define TS_CBOR_SAMPLE_FIELDS(X, T) \
+    X(T, UINT, dt, -, -)            \
+    X(T, INT, temperature, -, -)    \
+    X(T, INT, humidity, -, -)       \
+    X(T, INT, pressure, -, -)
+
+#define TS_CBOR_TELEMETRY_BATCH_FIELDS(X, T) \
+    X(T, UINT, base_timestamp, -, -)         \
+    X(T, LIST, samples, count, TS_CBOR_SAMPLE_FIELDS)
+
+#define TS_CBOR_TELEMETRY_DELTA_FIELDS(X, T) \
+    X(T, UINT, seq, -, -)                    \
+    X(T, BOOL, keyframe, -, -)               \
+    X(T, BSTR, data, len, -)
+
+#define TS_CBOR_TELEMETRY_SUMMARY_FIELDS(X, T) \
+    X(T, UINT, timestamp, -, -)                \
+    X(T, UINT, duration_s, -, -)               \
+    X(T, UINT, count, -, -)                    \
+    X(T, INT, temperature_min, -, -)           \
+    X(T, INT, temperature_max, -, -)           \
+    X(T, INT, temperature_mean, -, -)          \
+    X(T, INT, humidity_min, -, -)              \
+    X(T, INT, humidity_max, -, -)              \
+    X(T, INT, humidity_mean, -, -)             \
+    X(T, INT, pressure_min, -, -)              \
+    X(T, INT, pressure_max, -, -)              \
+    X(T, INT, pressure_mean, -, -)
+
+#define TS_CBOR_TELEMETRY_MODEL_FIELDS(X, T) \
+    X(T, UINT, seq, -, -)                    \
+    X(T, BOOL, resync, -, -)                 \
+    X(T, UINT, timestamp, -, -)              \
+    X(T, INT, temperature, -, -)             \
+    X(T, INT, humidity, -, -)                \
+    X(T, INT, pressure, -, -)
+
+#define TS_CBOR_SENSOR_VALUE_FIELDS(X, T) \
+    X(T, UINT, id, -, -)                  \
+    X(T, INT, value, -, -)
+
+#define TS_CBOR_SENSOR_VALUES_FIELDS(X, T) \
+    X(T, UINT, timestamp, -, -)            \
+    X(T, LIST, values, count, TS_CBOR_SENSOR_VALUE_FIELDS)
+
+/**
+ * Every message type as X(type, union member, payload struct, fields).
+ */
+#define TS_CBOR_MESSAGES(X)                                               \
+    X(TS_MSG_TELEMETRY, telemetry, struct ts_msg_telemetry,               \
+      TS_CBOR_TELEMETRY_FIELDS)                                           \
+    X(TS_MSG_NODE_STATUS, node_status, struct ts_msg_node_status,         \
+      TS_CBOR_NODE_STATUS_FIELDS)                                         \
+    X(TS_MSG_ACK, ack, struct ts_msg_ack, TS_CBOR_ACK_FIELDS)             \
+    X(TS_MSG_BULK_DATA, bulk_data, struct ts_msg_bulk_data,               \
+      TS_CBOR_BULK_DATA_FIELDS)                                           \
+    X(TS_MSG_BULK_STATUS, bulk_status, struct ts_msg_bulk_status,         \
+      TS_CBOR_BULK_STATUS_FIELDS)                                         \
+    X(TS_MSG_TELEMETRY_BATCH, telemetry_batch,                            \
+      struct ts_msg_telemetry_batch, TS_CBOR_TELEMETRY_BATCH_FIELDS)      \
+    X(TS_MSG_TELEMETRY_DELTA, telemetry_delta,                            \
+      struct ts_msg_telemetry_delta, TS_CBOR_TELEMETRY_DELTA_FIELDS)      \
+    X(TS_MSG_TELEMETRY_SUMMARY, telemetry_summary,                        \
+      struct ts_msg_telemetry_summary, TS_CBOR_TELEMETRY_SUMMARY_FIELDS)  \
+    X(TS_MSG_TELEMETRY_MODEL, telemetry_model,                            \
+      struct ts_msg_telemetry_model, TS_CBOR_TELEMETRY_MODEL_FIELDS)      \
+    X(TS_MSG_SENSOR_VALUES, sensor_values, struct ts_msg_sensor_values,   \
+      TS_CBOR_SENSOR_VALUES_FIELDS)
+
+/** @} */
+
+/**
+ * @name Worst-case encoded sizes
+ *
+ * Derived from the field lists: an integer takes a header byte plus at
+ * most its member size, a byte string (under 256 bytes) two header
+ * bytes plus its capacity, a map key one byte, and every container a
+ * canonical header of at most two bytes (fewer than 256 entries).
+ * @{
+ */
+
+#define TS_CBOR_MEMBER_SIZE(T, m) sizeof(((T*)0)->m)
+
+#define TS_CBOR_MAX_UINT(T, m, aux, rec) (1 + TS_CBOR_MEMBER_SIZE(T, m))
+#define TS_CBOR_MAX_INT(T, m, aux, rec) (1 + TS_CBOR_MEMBER_SIZE(T, m))
+#define TS_CBOR_MAX_BOOL(T, m, aux, rec) 1
+#define TS_CBOR_MAX_BSTR(T, m, aux, rec) (2 + TS_CBOR_MEMBER_SIZE(T, m))
+#define TS_CBOR_MAX_LIST(T, m, aux, rec)                               \
+    (2 + TS_CBOR_MEMBER_SIZE(T, m) / TS_CBOR_MEMBER_SIZE(T, m[0]) *    \
+             TS_CBOR_RECORD_MAX(rec, __typeof__(((T*)0)->m[0])))
+
+#define TS_CBOR_KEYED_MAX(T, kind, m, aux, rec) \
+    +1 + TS_CBOR_MAX_##kind(T, m, aux, rec)
+#define TS_CBOR_POSITIONAL_MAX(T, kind, m, aux, rec) \
+    +TS_CBOR_MAX_##kind(T, m, aux, rec)
+
+/** @brief Largest encoding of a structure sent as a keyed map. */
+#define TS_CBOR_MAP_MAX(LIST, T) (2 LIST(TS_CBOR_KEYED_MAX, T))
+
+/** @brief Largest encoding of a structure sent as a positional array. */
+#define TS_CBOR_RECORD_MAX(LIST, T) (2 LIST(TS_CBOR_POSITIONAL_MAX, T))
+
+#define TS_CBOR_PAYLOAD_SLOT(type, member, T, LIST) \
+    uint8_t member[TS_CBOR_MAP_MAX(LIST, T)];
+
+/** @brief Sized by its largest member: the largest payload encoding. */
+union ts_cbor_payload_max {
+    TS_CBOR_MESSAGES(TS_CBOR_PAYLOAD_SLOT)
+};
+
+/**
+ * @brief Largest encoding of any message.
+ *
+ * Envelope map with keyed version (under 24), type (under 256), route
+ * header and payload.
+ */
+#define TS_CBOR_MAX_SIZE                                                \
+    (2 + (1 + 1) + (1 + 2) +                                            \
+     (1 + TS_CBOR_MAP_MAX(TS_CBOR_ROUTE_FIELDS, struct ts_route_header)) + \
+     (1 + sizeof(union ts_cbor_payload_max)))
+
+/** @} */
+
+/** @} */
+
+#endif  // TS_CBOR_SCHEMA_H
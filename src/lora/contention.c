@@ -7,6 +7,7 @@
 LOG_MODULE_REGISTER(contention);
 
 extern struct zbus_channel ts_lora_out_chan;
+extern struct zbus_channel ts_lora_agg_chan;
 
 // Mutex: pool slots are accessed from the lora_in_task thread
 // (schedule/cancel) and from the system work queue
@@ -17,6 +18,12 @@ static K_MUTEX_DEFINE(pool_mutex);
 static struct ts_contention_slot pool[TS_CONTENTION_POOL_SIZE];
 static bool pool_initialized;
 
+// The frame being forwarded, up to TS_MSG_AGGREGATE_MAX messages: too
+// large for the system work queue stack.  Only the work handler uses
+// it; fwd_mutex is held from the claim through the publish.
+static K_MUTEX_DEFINE(fwd_mutex);
+static struct ts_msg_lora_aggregate fwd_agg;
+
 static struct ts_contention_slot* find_free_slot(void) {
     for (int i = 0; i < TS_CONTENTION_POOL_SIZE; i++) {
         if (!pool[i].occupied) { return &pool[i]; }
@@ -35,6 +42,27 @@ static struct ts_contention_slot* find_slot_by_msg(uint16_t src,
     return NULL;
 }
 
+// Claim the pending forwards that can share a frame with the one that
+// fired: same destination, so they'd go out at the same TX power to the
+// same neighbours, and due within the window, so none is sent much
+// earlier than its contention delay intended.  Called with the pool
+// mutex held.
+static void claim_compatible(struct ts_msg_lora_aggregate* p_agg) {
+    uint16_t dst = p_agg->msgs[0].route.dst;
+    int64_t horizon = k_uptime_get() + CONFIG_TS_RELAY_AGGREGATION_WINDOW_MS;
+
+    for (int i = 0; i < TS_CONTENTION_POOL_SIZE; i++) {
+        if (p_agg->count == TS_MSG_AGGREGATE_MAX) { return; }
+        if (!pool[i].occupied || pool[i].msg.route.dst != dst ||
+            pool[i].deadline_ms > horizon) {
+            continue;
+        }
+        k_work_cancel_delayable(&pool[i].work);
+        p_agg->msgs[p_agg->count++] = pool[i].msg;
+        pool[i].occupied = false;
+    }
+}
+
 void ts_contention_work_handler(struct k_work* work) {
     struct k_work_delayable* dwork = k_work_delayable_from_work(work);
     struct ts_contention_slot* slot =
@@ -44,28 +72,38 @@ void ts_contention_work_handler(struct k_work* work) {
     // lock and immediately free it.  The zbus publish that follows can
     // block for up to 200 ms, and holding the mutex across that would
     // stall schedule/cancel calls on the RX thread.
-    struct ts_msg_lora_outgoing msg_copy;
+    struct ts_msg_lora_aggregate* agg = &fwd_agg;
     uint32_t msg_id;
     uint16_t src;
 
+    k_mutex_lock(&fwd_mutex, K_FOREVER);
     k_mutex_lock(&pool_mutex, K_FOREVER);
     if (!slot->occupied) {
         k_mutex_unlock(&pool_mutex);
+        k_mutex_unlock(&fwd_mutex);
         return;
     }
-    msg_copy = slot->msg;
+    agg->msgs[0] = slot->msg;
+    agg->count = 1;
     msg_id = slot->msg_id;
     src = slot->src;
     slot->occupied = false;
+    if (IS_ENABLED(CONFIG_TS_RELAY_AGGREGATION)) { claim_compatible(agg); }
     k_mutex_unlock(&pool_mutex);
 
-    int ret = zbus_chan_pub(&ts_lora_out_chan, &msg_copy, K_MSEC(200));
+    int ret;
+    if (agg->count > 1) {
+        ret = zbus_chan_pub(&ts_lora_agg_chan, agg, K_MSEC(200));
+    } else {
+        ret = zbus_chan_pub(&ts_lora_out_chan, &agg->msgs[0], K_MSEC(200));
+    }
     if (ret != 0) {
         LOG_ERR("Contention forward publish failed: %d", ret);
     } else {
-        LOG_DBG("Forwarded msg_id=%u from 0x%04x, TTL=%u", msg_id, src,
-                msg_copy.route.ttl);
+        LOG_DBG("Forwarded msg_id=%u from 0x%04x, TTL=%u (%u in frame)",
+                msg_id, src, agg->msgs[0].route.ttl, agg->count);
     }
+    k_mutex_unlock(&fwd_mutex);
 }
 
 void ts_contention_init(void) {
@@ -113,6 +151,7 @@ int ts_contention_schedule(const struct ts_msg_lora_outgoing* p_msg,
     slot->occupied = true;
 
     uint32_t delay_ms = ts_contention_rssi_to_delay_ms(rssi);
+    slot->deadline_ms = k_uptime_get() + delay_ms;
     LOG_DBG("Scheduling forward: msg_id=%u from 0x%04x, delay=%u ms",
             slot->msg_id, slot->src, delay_ms);
 
@@ -121,10 +160,12 @@ int ts_contention_schedule(const struct ts_msg_lora_outgoing* p_msg,
     return 0;
 }
 
-int ts_contention_cancel(uint16_t src, uint32_t msg_id) {
+// Cancel the pending forward of (src, msg_id) if its copy came in with
+// a TTL of at least min_rx_ttl
+static int cancel_forward(uint16_t src, uint32_t msg_id, uint8_t min_rx_ttl) {
     k_mutex_lock(&pool_mutex, K_FOREVER);
     struct ts_contention_slot* slot = find_slot_by_msg(src, msg_id);
-    if (slot == NULL) {
+    if (slot == NULL || slot->msg.route.ttl + 1 < min_rx_ttl) {
         k_mutex_unlock(&pool_mutex);
         return -ENOENT;
     }
@@ -141,3 +182,21 @@ int ts_contention_cancel(uint16_t src, uint32_t msg_id) {
     LOG_DBG("Cancelled forward: msg_id=%u from 0x%04x", msg_id, src);
     return 0;
 }
+
+int ts_contention_cancel(uint16_t src, uint32_t msg_id) {
+    return cancel_forward(src, msg_id, 0);
+}
+
+int ts_contention_cancel_acked(const struct ts_msg_ack* p_ack) {
+    // Held forwards are one TTL below the copy they were made from.  An
+    // ACK for a copy with a higher TTL than ours came from a relay
+    // upstream of us, and the frame still needs our forward.
+    return cancel_forward(p_ack->src, p_ack->msg_id, p_ack->ttl);
+}
+
+bool ts_contention_is_pending(uint16_t src, uint32_t msg_id) {
+    k_mutex_lock(&pool_mutex, K_FOREVER);
+    bool pending = find_slot_by_msg(src, msg_id) != NULL;
+    k_mutex_unlock(&pool_mutex);
+    return pending;
+}
@@ -8,6 +8,11 @@
  * Nodes that receive a message with weaker RSSI (farther from sender)
  * forward sooner. If a duplicate arrives while a forward is pending,
  * the forward is cancelled (another node already forwarded).
+ *
+ * With CONFIG_TS_RELAY_AGGREGATION, a slot that fires also releases
+ * every other pending forward to the same destination that is due
+ * within CONFIG_TS_RELAY_AGGREGATION_WINDOW_MS, and they go out
+ * together as one aggregate frame (see @ref aggregate).
  * @{
  */
 
@@ -36,6 +41,7 @@
 struct ts_contention_slot {
     struct k_work_delayable work;
     struct ts_msg_lora_outgoing msg;
+    int64_t deadline_ms;  // uptime at which the forward is due
     uint16_t src;
     uint32_t msg_id;
     bool occupied;
@@ -56,7 +62,9 @@ void ts_contention_init(void);
  * on the RX thread.
  *
  * If the slot was already cancelled (occupied == false), the handler
- * returns immediately.
+ * returns immediately.  With relay aggregation, compatible slots due
+ * within the window are claimed the same way and the group is
+ * published on ts_lora_agg_chan instead.
  *
  * @param work  Pointer to the k_work embedded in k_work_delayable
  */
@@ -85,6 +93,27 @@ int ts_contention_schedule(const struct ts_msg_lora_outgoing* p_msg,
  */
 int ts_contention_cancel(uint16_t src, uint32_t msg_id);
 
+/**
+ * @brief Cancel a pending forward made redundant by an explicit ACK.
+ *
+ * Only forwards of a copy received with at least the acknowledged
+ * copy's TTL are cancelled: an ACK from a relay further upstream does
+ * not mean the frame has moved past this node.
+ *
+ * @param p_ack  Received ACK payload
+ * @return 0 if found and cancelled, -ENOENT otherwise
+ */
+int ts_contention_cancel_acked(const struct ts_msg_ack* p_ack);
+
+/**
+ * @brief Check whether a forward of (src, msg_id) is still pending.
+ *
+ * @param src     Original source node ID
+ * @param msg_id  Message identifier
+ * @return true if a slot holds the forward
+ */
+bool ts_contention_is_pending(uint16_t src, uint32_t msg_id);
+
 /**
  * @brief Convert RSSI to forwarding delay in milliseconds.
  *
@@ -0,0 +1,169 @@
+#include "lora/frag.h"
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/byteorder.h>
+
+#include "routing/routing.h"
+
+LOG_MODULE_REGISTER(frag);
+
+// Header field offsets
+#define FRAG_OFF_TX_SRC 1
+#define FRAG_OFF_ID 3
+#define FRAG_OFF_INDEX 5
+#define FRAG_OFF_COUNT 6
+
+// Only the RX thread touches the pool, so it needs no lock.
+static struct ts_frag_slot pool[TS_FRAG_REASSEMBLY_SLOTS];
+static struct ts_frag_stats stats;
+static atomic_t next_frag_id;
+
+void ts_frag_init(void) {
+    for (int i = 0; i < TS_FRAG_REASSEMBLY_SLOTS; i++) {
+        pool[i].occupied = false;
+    }
+    memset(&stats, 0, sizeof(stats));
+}
+
+bool ts_frag_is_fragment(const uint8_t* p_frame, size_t len) {
+    return len > 0 && p_frame[0] == TS_FRAG_MARKER;
+}
+
+int ts_frag_count(size_t payload_len) {
+    if (payload_len == 0) { return 1; }
+    if (payload_len > TS_FRAG_MAX_PAYLOAD) { return -EMSGSIZE; }
+    return (int)DIV_ROUND_UP(payload_len, TS_FRAG_CHUNK_SIZE);
+}
+
+uint16_t ts_frag_next_id(void) {
+    return (uint16_t)atomic_inc(&next_frag_id);
+}
+
+int ts_frag_build(const uint8_t* p_payload, size_t len, uint16_t frag_id,
+                  uint8_t index, uint8_t* p_frame, size_t* p_frame_len) {
+    int count = ts_frag_count(len);
+    if (count < 0) { return count; }
+    if (index >= count) { return -EINVAL; }
+
+    size_t offset = (size_t)index * TS_FRAG_CHUNK_SIZE;
+    size_t chunk_len = MIN(len - offset, TS_FRAG_CHUNK_SIZE);
+
+    p_frame[0] = TS_FRAG_MARKER;
+    sys_put_be16(ts_routing_get_node_id(), &p_frame[FRAG_OFF_TX_SRC]);
+    sys_put_be16(frag_id, &p_frame[FRAG_OFF_ID]);
+    p_frame[FRAG_OFF_INDEX] = index;
+    p_frame[FRAG_OFF_COUNT] = (uint8_t)count;
+    memcpy(&p_frame[TS_FRAG_HEADER_SIZE], p_payload + offset, chunk_len);
+
+    // The tag covers the header too, so a chunk can't be replayed into
+    // another position or another sender's reassembly.
+    size_t signed_len = TS_FRAG_HEADER_SIZE + chunk_len;
+    if (ts_auth_sign(p_frame, signed_len, p_frame + signed_len) != 0) {
+        return -EIO;
+    }
+
+    *p_frame_len = signed_len + TS_AUTH_TAG_SIZE;
+    return 0;
+}
+
+// Drop reassemblies whose missing fragments are not coming anymore
+static void expire_stale(int64_t now) {
+    for (int i = 0; i < TS_FRAG_REASSEMBLY_SLOTS; i++) {
+        if (pool[i].occupied &&
+            now - pool[i].started_ms > TS_FRAG_REASSEMBLY_TIMEOUT_MS) {
+            LOG_WRN("Reassembly 0x%04x/%u timed out (have 0x%08x)",
+                    pool[i].tx_src, pool[i].frag_id, pool[i].received);
+            pool[i].occupied = false;
+            stats.timeouts++;
+        }
+    }
+}
+
+static struct ts_frag_slot* find_or_alloc_slot(uint16_t tx_src,
+                                               uint16_t frag_id,
+                                               uint8_t count, int64_t now) {
+    struct ts_frag_slot* free_slot = NULL;
+
+    for (int i = 0; i < TS_FRAG_REASSEMBLY_SLOTS; i++) {
+        if (!pool[i].occupied) {
+            if (free_slot == NULL) { free_slot = &pool[i]; }
+            continue;
+        }
+        if (pool[i].tx_src == tx_src && pool[i].frag_id == frag_id &&
+            pool[i].count == count) {
+            return &pool[i];
+        }
+    }
+
+    if (free_slot != NULL) {
+        free_slot->tx_src = tx_src;
+        free_slot->frag_id = frag_id;
+        free_slot->count = count;
+        free_slot->received = 0;
+        free_slot->len = 0;
+        free_slot->started_ms = now;
+        free_slot->occupied = true;
+    }
+    return free_slot;
+}
+
+int ts_frag_reassemble(const uint8_t* p_frame, size_t len, uint8_t* p_out,
+                       size_t out_size, size_t* p_out_len) {
+    if (!ts_frag_is_fragment(p_frame, len) ||
+        len <= TS_FRAG_HEADER_SIZE + TS_AUTH_TAG_SIZE) {
+        return -EBADMSG;
+    }
+
+    size_t signed_len = len - TS_AUTH_TAG_SIZE;
+    if (ts_auth_verify(p_frame, signed_len, p_frame + signed_len) != 0) {
+        stats.auth_failures++;
+        return -EACCES;
+    }
+
+    uint16_t tx_src = sys_get_be16(&p_frame[FRAG_OFF_TX_SRC]);
+    uint16_t frag_id = sys_get_be16(&p_frame[FRAG_OFF_ID]);
+    uint8_t index = p_frame[FRAG_OFF_INDEX];
+    uint8_t count = p_frame[FRAG_OFF_COUNT];
+    const uint8_t* chunk = &p_frame[TS_FRAG_HEADER_SIZE];
+    size_t chunk_len = signed_len - TS_FRAG_HEADER_SIZE;
+
+    // Every fragment but the last is full, which fixes each offset
+    bool last = index == count - 1;
+    if (count == 0 || count > TS_FRAG_MAX_COUNT || index >= count ||
+        (!last && chunk_len != TS_FRAG_CHUNK_SIZE) ||
+        chunk_len > TS_FRAG_CHUNK_SIZE) {
+        return -EBADMSG;
+    }
+
+    size_t offset = (size_t)index * TS_FRAG_CHUNK_SIZE;
+    if (offset + chunk_len > TS_FRAG_MAX_PAYLOAD) { return -EBADMSG; }
+
+    int64_t now = k_uptime_get();
+    expire_stale(now);
+
+    struct ts_frag_slot* slot =
+        find_or_alloc_slot(tx_src, frag_id, count, now);
+    if (slot == NULL) {
+        stats.no_slot++;
+        return -ENOBUFS;
+    }
+
+    memcpy(&slot->data[offset], chunk, chunk_len);
+    slot->received |= BIT(index);
+    if (last) { slot->len = offset + chunk_len; }
+
+    uint32_t complete = (count == 32) ? UINT32_MAX : BIT_MASK(count);
+    if (slot->received != complete) { return -EINPROGRESS; }
+
+    slot->occupied = false;
+    if (slot->len > out_size) { return -ENOMEM; }
+    memcpy(p_out, slot->data, slot->len);
+    *p_out_len = slot->len;
+    stats.reassembled++;
+    return 0;
+}
+
+void ts_frag_get_stats(struct ts_frag_stats* p_stats) { *p_stats = stats; }
@@ -0,0 +1,155 @@
+#ifndef TS_FRAG_H
+#define TS_FRAG_H
+
+/**
+ * @defgroup frag Fragmentation
+ * @brief Link-layer fragmentation and reassembly of oversized payloads.
+ *
+ * Encoded messages that don't fit one LoRa frame together with the auth
+ * tag are split into fragments, each carrying a compact header and its
+ * own CMAC tag:
+ *
+ *     [0xF1 | tx_src:2 | frag_id:2 | index:1 | count:1 | chunk | tag:8]
+ *
+ * The marker byte can never start a regular frame, which always begins
+ * with a CBOR map header.  Fragmentation is hop-by-hop: every node
+ * reassembles, verifies, and decodes the full message before routing
+ * it, and re-fragments it when forwarding.  tx_src is the transmitting
+ * node, not the route source.
+ *
+ * Fragments are verified individually, so a forged or corrupted chunk
+ * is dropped on arrival instead of poisoning a whole reassembly.
+ * Incomplete reassemblies are discarded after
+ * TS_FRAG_REASSEMBLY_TIMEOUT_MS.
+ * @{
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+
+#include "lora/auth.h"
+
+/** @brief First byte of every fragment frame. */
+#define TS_FRAG_MARKER 0xF1
+
+/** @brief Fragment header size in bytes (marker included). */
+#define TS_FRAG_HEADER_SIZE 7
+
+/** @brief Largest LoRa PHY payload. */
+#define TS_FRAG_MAX_FRAME 255
+
+/** @brief Payload bytes carried by every fragment but the last. */
+#define TS_FRAG_CHUNK_SIZE \
+    (TS_FRAG_MAX_FRAME - TS_FRAG_HEADER_SIZE - TS_AUTH_TAG_SIZE)
+
+/** @brief Largest payload that can be fragmented (set via Kconfig). */
+#define TS_FRAG_MAX_PAYLOAD CONFIG_TS_FRAG_MAX_PAYLOAD
+
+/** @brief Most fragments a payload can be split into. */
+#define TS_FRAG_MAX_COUNT DIV_ROUND_UP(TS_FRAG_MAX_PAYLOAD, TS_FRAG_CHUNK_SIZE)
+
+/** @brief Concurrent reassemblies (one per transmitting neighbor). */
+#define TS_FRAG_REASSEMBLY_SLOTS 2
+
+/** @brief Age at which an incomplete reassembly is dropped (ms). */
+#define TS_FRAG_REASSEMBLY_TIMEOUT_MS CONFIG_TS_FRAG_REASSEMBLY_TIMEOUT_MS
+
+BUILD_ASSERT(TS_FRAG_MAX_COUNT <= 32,
+             "Reassembly tracks received fragments in a 32-bit bitmap");
+
+/** @brief A reassembly buffer. */
+struct ts_frag_slot {
+    uint8_t data[TS_FRAG_MAX_PAYLOAD];
+    int64_t started_ms;
+    uint32_t received;
+    size_t len;
+    uint16_t tx_src;
+    uint16_t frag_id;
+    uint8_t count;
+    bool occupied;
+};
+
+/** @brief Reassembly counters since ts_frag_init(). */
+struct ts_frag_stats {
+    uint32_t reassembled;   /**< Payloads completed */
+    uint32_t timeouts;      /**< Reassemblies dropped as incomplete */
+    uint32_t auth_failures; /**< Fragments with a bad tag */
+    uint32_t no_slot;       /**< Fragments dropped, all slots busy */
+};
+
+/**
+ * @brief Reset the reassembly pool and counters.
+ */
+void ts_frag_init(void);
+
+/**
+ * @brief Check whether a received frame is a fragment.
+ *
+ * @param p_frame  Frame bytes
+ * @param len      Frame length
+ * @return true if the frame starts with TS_FRAG_MARKER
+ */
+bool ts_frag_is_fragment(const uint8_t* p_frame, size_t len);
+
+/**
+ * @brief Number of fragments needed for a payload.
+ *
+ * @param payload_len  Payload length in bytes
+ * @return Fragment count, or -EMSGSIZE if larger than TS_FRAG_MAX_PAYLOAD
+ */
+int ts_frag_count(size_t payload_len);
+
+/**
+ * @brief Allocate the identifier for the next fragmented payload.
+ *
+ * @return Fragment set identifier
+ */
+uint16_t ts_frag_next_id(void);
+
+/**
+ * @brief Build one signed fragment frame.
+ *
+ * @param p_payload    Complete payload being fragmented
+ * @param len          Payload length
+ * @param frag_id      Identifier from ts_frag_next_id(), same for all
+ *                     fragments of the payload
+ * @param index        Fragment index (0 .. count-1)
+ * @param p_frame      Output buffer of at least TS_FRAG_MAX_FRAME bytes
+ * @param p_frame_len  Output: frame length
+ * @return 0 on success, -EINVAL on bad index, -EMSGSIZE if too large,
+ *         -EIO on signing failure
+ */
+int ts_frag_build(const uint8_t* p_payload, size_t len, uint16_t frag_id,
+                  uint8_t index, uint8_t* p_frame, size_t* p_frame_len);
+
+/**
+ * @brief Verify a fragment and add it to its reassembly.
+ *
+ * Not thread-safe: call from the RX thread only.
+ *
+ * @param p_frame    Fragment frame
+ * @param len        Frame length
+ * @param p_out      Output buffer for the completed payload
+ * @param out_size   Size of p_out
+ * @param p_out_len  Output: payload length when complete
+ * @return 0 when the payload is complete, -EINPROGRESS while fragments
+ *         are missing, -EBADMSG for a malformed fragment, -EACCES for a
+ *         bad tag, -ENOBUFS if no reassembly slot is free, -ENOMEM if
+ *         p_out is too small
+ */
+int ts_frag_reassemble(const uint8_t* p_frame, size_t len, uint8_t* p_out,
+                       size_t out_size, size_t* p_out_len);
+
+/**
+ * @brief Copy the reassembly counters.
+ *
+ * @param p_stats  Output counters
+ */
+void ts_frag_get_stats(struct ts_frag_stats* p_stats);
+
+/** @} */
+
+#endif  // TS_FRAG_H
@@ -1,57 +1,122 @@
 #include "lora.h"
 
+#include <string.h>
 #include <zephyr/logging/log.h>
 
+#if defined(CONFIG_LORA_MOCK)
+#include "drivers/lora_mock.h"
+#endif
+
+#include "lora/ack.h"
+#include "lora/aggregate.h"
+#include "lora/airtime.h"
 #include "lora/auth.h"
+#include "lora/bulk.h"
+#include "lora/cbor_schema.h"
 #include "lora/contention.h"
+#include "lora/frag.h"
+#include "lora/packed.h"
+#include "lora/radio.h"
+#include "lora/rx_ring.h"
+#include "lora/tx_power.h"
+#include "messages/msg_pool.h"
 #include "routing/routing.h"
 #include "routing/routing_table.h"
+#include "sensors/telemetry_store.h"
+#include "sensors/telemetry_window.h"
 
 #define LORA_CHAN_OUT_READ_TIMEOUT K_MSEC(1)
-#define LORA_RECV_TIMEOUT K_MSEC(1000)
 #define LORA_CHAN_IN_PUB_TIMEOUT K_MSEC(200)
-// lora_recv size parameter is uint8_t, so RX buffer is capped at UINT8_MAX
-#define LORA_RX_BUFFER_SIZE UINT8_MAX
-BUILD_ASSERT(LORA_RX_BUFFER_SIZE <= UINT8_MAX,
-             "LORA_RX_BUFFER_SIZE exceeds lora_recv uint8_t size parameter");
 BUILD_ASSERT(ZBOR_ENCODE_BUFFER_SIZE > TS_AUTH_TAG_SIZE,
              "CBOR buffer must be larger than auth tag to hold any payload");
+BUILD_ASSERT(TS_CBOR_MAX_SIZE <= TS_FRAG_MAX_PAYLOAD,
+             "Reassembly buffer must hold the largest CBOR message");
 
 LOG_MODULE_REGISTER(lora);
 
 ZBUS_SUBSCRIBER_DEFINE(ts_lora_out_sub, 2);
 extern struct zbus_channel ts_lora_out_chan;
-extern struct zbus_channel ts_lora_in_chan;
+extern struct zbus_channel ts_lora_agg_chan;
+extern struct zbus_channel ts_lora_in_telemetry_chan;
+extern struct zbus_channel ts_lora_in_status_chan;
+extern struct zbus_channel ts_lora_in_control_chan;
+
+// Where each delivered message type is published.  Types without an
+// entry (ACKs, which are link-local) are never delivered.
+static const struct zbus_channel* const in_chans[] = {
+    [TS_MSG_TELEMETRY] = &ts_lora_in_telemetry_chan,
+    [TS_MSG_TELEMETRY_BATCH] = &ts_lora_in_telemetry_chan,
+    [TS_MSG_TELEMETRY_DELTA] = &ts_lora_in_telemetry_chan,
+    [TS_MSG_TELEMETRY_SUMMARY] = &ts_lora_in_telemetry_chan,
+    [TS_MSG_TELEMETRY_MODEL] = &ts_lora_in_telemetry_chan,
+    [TS_MSG_SENSOR_VALUES] = &ts_lora_in_telemetry_chan,
+    [TS_MSG_NODE_STATUS] = &ts_lora_in_status_chan,
+    [TS_MSG_BULK_DATA] = &ts_lora_in_control_chan,
+    [TS_MSG_BULK_STATUS] = &ts_lora_in_control_chan,
+};
 
 K_THREAD_DEFINE(lora_out_tid, LORA_OUT_THREAD_STACK_SIZE, lora_out_task, NULL,
                 NULL, NULL, 3, 0, 0);
 K_THREAD_DEFINE(lora_in_tid, LORA_IN_THREAD_STACK_SIZE, lora_in_task, NULL,
                 NULL, NULL, 3, 0, 0);
 
-static const struct device* lora_dev;
 // Semaphore: replaces the plain bool lora_config_done flag.  SYS_INIT
 // gives the semaphore after configuring the radio; both TX and RX
 // threads take-then-regive it to wait without polling and with a
 // proper memory barrier so all preceding config writes are visible.
 static K_SEM_DEFINE(lora_ready_sem, 0, 1);
-static uint8_t cbor_buffer[ZBOR_ENCODE_BUFFER_SIZE];
+// Sized for the largest fragmentable payload: messages whose encoding
+// plus auth tag exceeds one LoRa frame are split by the frag layer.
+static uint8_t cbor_buffer[MAX(ZBOR_ENCODE_BUFFER_SIZE, TS_FRAG_MAX_PAYLOAD)];
+static uint8_t frag_frame[TS_FRAG_MAX_FRAME];
+static uint8_t reassembly_buffer[TS_FRAG_MAX_PAYLOAD];
+// Relay aggregates: the released forwards (too large for the TX stack)
+// and the frame their signed encodings are packed into.
+static struct ts_msg_lora_aggregate agg_msgs;
+static uint8_t agg_frame[TS_FRAG_MAX_FRAME];
+// Decode target for frames received while the message pool is empty
+static struct ts_msg_lora_incoming rx_scratch;
+
+// Runs in driver context for every frame while async RX is armed.  The
+// data pointer is only valid for the duration of the call, so the frame
+// is copied straight into a ring slot and all CMAC/CBOR work is left to
+// the RX thread — the radio is back in receive before processing starts.
+static void lora_rx_cb(const uint8_t* data, uint16_t size, int16_t rssi,
+                       int8_t snr) {
+    int ret = ts_rx_ring_put(data, size, rssi, snr);
+    if (ret == -ENOBUFS) {
+        LOG_WRN("RX ring full, dropping frame");
+    } else if (ret != 0) {
+        LOG_WRN("Dropping oversized frame (%u bytes)", size);
+    }
+}
 
 // Initialize the LoRa device reference
 static int lora_init(void) {
-    lora_dev = DEVICE_DT_GET(DT_ALIAS(lora0));
+    const struct device* lora_dev = DEVICE_DT_GET(DT_ALIAS(lora0));
     if (!device_is_ready(lora_dev)) {
         LOG_ERR("LoRa device not ready");
         return -ENODEV;
     }
 
-    // Configure the device
-    struct lora_modem_config config;
-    lora_config_ready_device(&config);
+    // Configure the device; from here on the radio arbiter owns it
+    struct lora_modem_config modem_config;
+    ts_rx_ring_init();
+    ts_frag_init();
+    ts_ack_init();
+    ts_tx_power_init(SF_10);
+    lora_config_ready_device(&modem_config);
 
-    if (lora_config(lora_dev, &config) < 0) {
-        LOG_ERR("LoRa config failed");
+    if (ts_radio_init(lora_dev, &modem_config, lora_rx_cb) < 0) {
+        LOG_ERR("LoRa radio init failed");
         return -EIO;
     }
+#if defined(CONFIG_LORA_MOCK)
+    // The mock reports each reception's preamble, so sends can wait for
+    // frames in flight; the SX126x/SX127x drivers have no such hook
+    lora_mock_set_preamble_cb(lora_dev, ts_radio_notify_preamble);
+#endif
+    ts_bulk_init(ts_radio_get_config(), NULL, NULL);
 
     return 0;
 }
@@ -65,12 +130,215 @@ bool lora_config_ready_device(struct lora_modem_config* config) {
     config->coding_rate = CR_4_5;
     config->iq_inverted = false;
     config->public_network = false;
-    config->tx_power = 4;
+    config->tx_power = ts_tx_power_get();
     config->tx = true;
     k_sem_give(&lora_ready_sem);
     return true;
 }
 
+// Encode a message into cbor_buffer, reserving tail room for the auth
+// tag.  Telemetry uses the packed format when ts_packed_wanted() says so
+// and its values fit; everything else, and any reading that doesn't,
+// stays CBOR.
+static int lora_serialize(struct ts_msg_lora_outgoing* p_msg,
+                          size_t* p_size) {
+    size_t space = sizeof(cbor_buffer) - TS_AUTH_TAG_SIZE;
+
+    if (ts_packed_wanted(p_msg) &&
+        ts_packed_serialize(p_msg, cbor_buffer, space, p_size) == 0) {
+        return 0;
+    }
+    return cbor_serialize(p_msg, cbor_buffer, space, p_size);
+}
+
+// Send the CBOR payload in cbor_buffer.  If payload and auth tag fit one
+// frame it goes out as before, with the tag appended in place; larger
+// payloads are split into individually signed fragments.  The arbiter
+// parks RX for each send and re-arms it afterwards.  Reports the total
+// airtime spent.
+static int lora_transmit(size_t cbor_size, int8_t tx_power,
+                         uint32_t* p_airtime_ms) {
+    const struct lora_modem_config* config = ts_radio_get_config();
+    int ret;
+
+    *p_airtime_ms = 0;
+
+    if (cbor_size + TS_AUTH_TAG_SIZE <= TS_FRAG_MAX_FRAME) {
+        ret = ts_auth_sign(cbor_buffer, cbor_size, cbor_buffer + cbor_size);
+        if (ret != 0) {
+            LOG_ERR("Auth sign failed: %d", ret);
+            return ret;
+        }
+
+        size_t total_size = cbor_size + TS_AUTH_TAG_SIZE;
+        LOG_HEXDUMP_DBG(cbor_buffer, total_size, "TX payload: ");
+        ret = ts_radio_send(cbor_buffer, total_size, tx_power);
+        if (ret == 0) { *p_airtime_ms = ts_airtime_ms(config, total_size); }
+        return ret;
+    }
+
+    int count = ts_frag_count(cbor_size);
+    if (count < 0) { return count; }
+
+    uint16_t frag_id = ts_frag_next_id();
+    LOG_DBG("Fragmenting %zu bytes into %d frames (id %u)", cbor_size, count,
+            frag_id);
+
+    for (int i = 0; i < count; i++) {
+        size_t frame_len;
+        ret = ts_frag_build(cbor_buffer, cbor_size, frag_id, (uint8_t)i,
+                            frag_frame, &frame_len);
+        if (ret == 0) { ret = ts_radio_send(frag_frame, frame_len, tx_power); }
+        if (ret != 0) {
+            LOG_ERR("Fragment %d/%d failed: %d", i + 1, count, ret);
+            return ret;
+        }
+        *p_airtime_ms += ts_airtime_ms(config, frame_len);
+    }
+    return 0;
+}
+
+// Keep this node's own readings from a frame that could not be sent, to
+// be drained later (a summary as its means).  Delta-coded readings
+// can't be recovered without the encoder state and are left to the
+// receiver's gap handling; so is the model update a lost model message
+// carried, though its reading is kept.  Sensor value lists don't fit
+// the store's record of full readings and are not kept.
+static void lora_store_unsent(const struct ts_msg_lora_outgoing* p_msg) {
+#if defined(CONFIG_TS_TELEMETRY_STORE)
+    if (p_msg->route.src != ts_routing_get_node_id()) { return; }
+
+    if (p_msg->type == TS_MSG_TELEMETRY) {
+        ts_telemetry_store_add(&p_msg->data.telemetry);
+    } else if (p_msg->type == TS_MSG_TELEMETRY_BATCH) {
+        ts_telemetry_store_add_batch(&p_msg->data.telemetry_batch);
+    } else if (p_msg->type == TS_MSG_TELEMETRY_SUMMARY) {
+        struct ts_msg_telemetry mean;
+        ts_telemetry_summary_mean(&p_msg->data.telemetry_summary, &mean);
+        ts_telemetry_store_add(&mean);
+    } else if (p_msg->type == TS_MSG_TELEMETRY_MODEL) {
+        const struct ts_msg_telemetry_model* m = &p_msg->data.telemetry_model;
+        struct ts_msg_telemetry reading = {
+            .timestamp = m->timestamp,
+            .temperature = m->temperature,
+            .humidity = m->humidity,
+            .pressure = m->pressure,
+        };
+        ts_telemetry_store_add(&reading);
+    }
+#endif
+}
+
+// Encode, sign and send one message, then hand it to link-ACK tracking
+static void lora_send_msg(struct ts_msg_lora_outgoing* p_msg) {
+    LOG_DBG("Processing message type: %d", p_msg->type);
+    // Stamp key version here (not at publish site) so producers
+    // don't need to know about the auth module.  The power goes in the
+    // header so receivers can tell path loss from our power setting.
+    p_msg->route.key_id = ts_auth_get_key_id();
+    p_msg->route.tx_power = ts_tx_power_select(p_msg->route.dst);
+
+    size_t cbor_size = 0;
+    int ret = lora_serialize(p_msg, &cbor_size);
+    if (ret != 0) {
+        LOG_ERR("Serialization failed: %d", ret);
+        return;
+    }
+
+    uint32_t airtime_ms;
+    ret = lora_transmit(cbor_size, p_msg->route.tx_power, &airtime_ms);
+    if (ret < 0) {
+        LOG_ERR("LoRa send failed: %d", ret);
+        lora_store_unsent(p_msg);
+        return;
+    }
+
+    if (IS_ENABLED(CONFIG_TS_LINK_ACK) && ts_ack_required(p_msg)) {
+        ts_ack_track(p_msg, airtime_ms);
+    }
+
+    LOG_DBG("Message sent successfully");
+}
+
+// Send the n sub-frames collected in agg_frame.  A lone sub-frame goes
+// out without the aggregate header, as the plain signed frame it is.
+static void lora_flush_aggregate(struct ts_msg_lora_outgoing** pp_msgs,
+                                 size_t n, size_t agg_len, int8_t tx_power) {
+    const uint8_t* p_frame = agg_frame;
+    size_t len = agg_len;
+
+    if (n == 0) { return; }
+    if (n == 1) {
+        p_frame += TS_AGG_HEADER_SIZE + TS_AGG_LEN_SIZE;
+        len -= TS_AGG_HEADER_SIZE + TS_AGG_LEN_SIZE;
+    }
+
+    int ret = ts_radio_send(p_frame, len, tx_power);
+    if (ret != 0) {
+        LOG_ERR("Aggregate send failed: %d", ret);
+        return;
+    }
+    LOG_DBG("Sent %zu forwards in one %zu-byte frame", n, len);
+
+    uint32_t airtime_ms = ts_airtime_ms(ts_radio_get_config(), len);
+    for (size_t i = 0; i < n; i++) {
+        if (IS_ENABLED(CONFIG_TS_LINK_ACK) && ts_ack_required(pp_msgs[i])) {
+            ts_ack_track(pp_msgs[i], airtime_ms);
+        }
+    }
+}
+
+// Send forwards released together by the contention pool.  Each one is
+// encoded and signed exactly as if sent alone and packed behind a
+// length byte into as few frames as they fit; one too large to share a
+// frame goes out on its own.  The forwards share a destination and so
+// one transmit power, which each sub-frame's header carries.
+static void lora_send_aggregate(struct ts_msg_lora_aggregate* p_agg) {
+    struct ts_msg_lora_outgoing* pending[TS_MSG_AGGREGATE_MAX];
+    size_t n_pending = 0;
+    size_t agg_len = 0;
+    int8_t tx_power;
+
+    if (p_agg->count == 0) { return; }
+    tx_power = ts_tx_power_select(p_agg->msgs[0].route.dst);
+
+    for (uint8_t i = 0; i < p_agg->count; i++) {
+        struct ts_msg_lora_outgoing* p_msg = &p_agg->msgs[i];
+        size_t size;
+
+        p_msg->route.key_id = ts_auth_get_key_id();
+        p_msg->route.tx_power = tx_power;
+        int ret = lora_serialize(p_msg, &size);
+        if (ret != 0) {
+            LOG_ERR("Serialization failed: %d", ret);
+            continue;
+        }
+        if (TS_AGG_HEADER_SIZE + TS_AGG_LEN_SIZE + size + TS_AUTH_TAG_SIZE >
+            sizeof(agg_frame)) {
+            lora_send_msg(p_msg);
+            continue;
+        }
+
+        ret = ts_auth_sign(cbor_buffer, size, cbor_buffer + size);
+        if (ret != 0) {
+            LOG_ERR("Auth sign failed: %d", ret);
+            continue;
+        }
+        size += TS_AUTH_TAG_SIZE;
+
+        if (ts_agg_append(agg_frame, &agg_len, sizeof(agg_frame), cbor_buffer,
+                          size) == -EMSGSIZE) {
+            lora_flush_aggregate(pending, n_pending, agg_len, tx_power);
+            n_pending = 0;
+            agg_len = 0;
+            ts_agg_append(agg_frame, &agg_len, sizeof(agg_frame), cbor_buffer,
+                          size);
+        }
+        pending[n_pending++] = p_msg;
+    }
+    lora_flush_aggregate(pending, n_pending, agg_len, tx_power);
+}
+
 int lora_out_task() {
     const struct zbus_channel* chan;
 
@@ -99,39 +367,15 @@ int lora_out_task() {
                 LOG_ERR("Failed to read from channel: %d", ret);
                 continue;
             }
-
-            LOG_DBG("Processing message type: %d", msg.type);
-            // Stamp key version here (not at publish site) so producers
-            // don't need to know about the auth module.
-            msg.route.key_id = ts_auth_get_key_id();
-
-            // Reserve tail room for the auth tag that will be appended
-            // after the CBOR payload in the same contiguous buffer.
-            size_t cbor_size = 0;
-            ret = cbor_serialize(&msg, cbor_buffer,
-                                 sizeof(cbor_buffer) - TS_AUTH_TAG_SIZE,
-                                 &cbor_size);
-            if (ret != 0) {
-                LOG_ERR("CBOR serialization failed: %d", ret);
-                continue;
-            }
-
-            ret = ts_auth_sign(cbor_buffer, cbor_size, cbor_buffer + cbor_size);
+            lora_send_msg(&msg);
+        } else if (chan == &ts_lora_agg_chan) {
+            ret = zbus_chan_read(&ts_lora_agg_chan, &agg_msgs,
+                                 LORA_CHAN_OUT_READ_TIMEOUT);
             if (ret != 0) {
-                LOG_ERR("Auth sign failed: %d", ret);
-                continue;
-            }
-
-            size_t total_size = cbor_size + TS_AUTH_TAG_SIZE;
-            LOG_HEXDUMP_DBG(cbor_buffer, total_size, "TX payload: ");
-
-            ret = lora_send(lora_dev, cbor_buffer, (uint32_t)total_size);
-            if (ret < 0) {
-                LOG_ERR("LoRa send failed: %d", ret);
+                LOG_ERR("Failed to read from channel: %d", ret);
                 continue;
             }
-
-            LOG_DBG("Message sent successfully");
+            lora_send_aggregate(&agg_msgs);
         } else {
             LOG_WRN("Received message on unexpected channel");
         }
@@ -139,103 +383,243 @@ int lora_out_task() {
     return 0;  // unreachable!
 }
 
-int lora_in_task() {
-    // Separate buffer from the output task to avoid contention between
-    // the TX and RX threads without needing a mutex
-    static uint8_t rx_buffer[LORA_RX_BUFFER_SIZE];
+// Queue an explicit ACK for a unicast frame that reached us.  Goes
+// through ts_lora_out_chan like any other frame so the radio arbiter
+// serializes it with regular traffic.
+static void lora_send_ack(const struct ts_route_header* p_acked) {
+    struct ts_msg_lora_outgoing ack;
 
-    // Block until SYS_INIT has configured the radio.
-    k_sem_take(&lora_ready_sem, K_FOREVER);
-    k_sem_give(&lora_ready_sem);
+    ts_ack_build(&ack, p_acked);
+    int ret = zbus_chan_pub(&ts_lora_out_chan, &ack, LORA_CHAN_IN_PUB_TIMEOUT);
+    if (ret != 0) { LOG_ERR("Failed to queue ACK: %d", ret); }
+}
 
-    ts_contention_init();
-    LOG_INF("LoRa receive task started");
+// Handle a duplicate of an acknowledged unicast.  A repeat of a frame
+// we accepted as final hop means our ACK was lost: acknowledge again.
+// A relay that hears the previous hop retransmit a frame it already
+// forwarded knows that forward was missed, and acknowledges explicitly;
+// a forward still pending will serve as the implicit ACK once sent.
+// Returns whether the duplicate was an upstream repeat.
+static bool lora_answer_repeat(const struct ts_route_header* p_hdr) {
+    bool final_hop = p_hdr->dst == ts_routing_get_node_id();
+
+    if (!final_hop && !ts_routing_is_repeat(p_hdr)) { return false; }
+    if (final_hop || !ts_contention_is_pending(p_hdr->src, p_hdr->msg_id)) {
+        lora_send_ack(p_hdr);
+    }
+    return true;
+}
 
-    while (true) {
-        int16_t rssi;
-        int8_t snr;
-
-        // lora_recv returns positive byte count on success, negative on error
-        int len = lora_recv(lora_dev, rx_buffer, (uint8_t)sizeof(rx_buffer),
-                            LORA_RECV_TIMEOUT, &rssi, &snr);
-        if (len < 0) {
-            if (len == -EAGAIN) {
-                // Timeout with no data is normal operation
-                continue;
-            }
-            LOG_ERR("LoRa recv failed: %d", len);
-            continue;
+// Route one decoded message: consume ACKs, suppress duplicates, answer
+// or schedule a forward.  Returns whether it should also be delivered
+// to local consumers.
+static bool lora_route_msg(const struct ts_msg_lora_incoming* p_in) {
+    // key_id is checked after deserialize because it lives inside
+    // the CBOR-encoded route header.  This is safe: the CMAC already
+    // proved the packet is authentic, so a mismatched key_id just
+    // means the sender is on a different key rotation epoch.
+    if (p_in->msg.route.key_id != ts_auth_get_key_id()) {
+        LOG_WRN("Key ID mismatch: got %u, expected %u",
+                p_in->msg.route.key_id, ts_auth_get_key_id());
+        return false;
+    }
+
+    // Explicit ACKs are link-local: consume them here, never deliver or
+    // forward.  Relays still holding the acknowledged copy for
+    // contention drop it — a node past them already has it.
+    if (p_in->msg.type == TS_MSG_ACK) {
+        if (IS_ENABLED(CONFIG_TS_LINK_ACK)) {
+            ts_ack_confirm(&p_in->msg.data.ack);
         }
+        ts_contention_cancel_acked(&p_in->msg.data.ack);
+        return false;
+    }
 
-        LOG_INF("LoRa RX: %d bytes, RSSI=%d, SNR=%d", len, rssi, snr);
-        LOG_HEXDUMP_DBG(rx_buffer, len, "LoRa RX raw: ");
+    // Flooding: drop own messages that returned via other nodes.  For
+    // our own unicast that echo is the next hop's implicit ACK.
+    if (p_in->msg.route.src == ts_routing_get_node_id()) {
+        if (IS_ENABLED(CONFIG_TS_LINK_ACK)) {
+            ts_ack_overheard(&p_in->msg.route);
+        }
+        return false;
+    }
 
-        // Verify auth before CBOR decode so unauthenticated packets
-        // never reach the parser — limits attack surface to the tag
-        // check alone.  Wire format: [CBOR payload | 8-byte CMAC tag].
-        if (len <= TS_AUTH_TAG_SIZE) {
-            LOG_WRN("Packet too short for auth tag (%d bytes)", len);
-            continue;
+    // Flooding: drop duplicates and cancel any pending contention forward
+    if (ts_routing_is_duplicate(&p_in->msg.route)) {
+        LOG_DBG("Dropping duplicate msg_id=%u from 0x%04x",
+                p_in->msg.route.msg_id, p_in->msg.route.src);
+        if (IS_ENABLED(CONFIG_TS_LINK_ACK) && ts_ack_required(&p_in->msg) &&
+            lora_answer_repeat(&p_in->msg.route)) {
+            return false;
+        }
+        ts_contention_cancel(p_in->msg.route.src, p_in->msg.route.msg_id);
+        if (IS_ENABLED(CONFIG_TS_LINK_ACK)) {
+            ts_ack_overheard(&p_in->msg.route);
+        }
+        return false;
+    }
+    ts_routing_mark_seen(&p_in->msg.route);
+    ts_routing_table_update(p_in->msg.route.src, p_in->rssi, p_in->snr,
+                            p_in->msg.route.tx_power, p_in->msg.route.ttl);
+
+    // Deliver locally if addressed to this node or broadcast; the caller
+    // publishes once routing is done
+    bool deliver = ts_routing_is_for_us(&p_in->msg.route);
+
+    // Final hop of a unicast: acknowledge instead of forwarding
+    if (p_in->msg.route.dst == ts_routing_get_node_id()) {
+        if (IS_ENABLED(CONFIG_TS_LINK_ACK) && ts_ack_required(&p_in->msg)) {
+            lora_send_ack(&p_in->msg.route);
         }
+        return deliver;
+    }
 
-        size_t cbor_len = (size_t)len - TS_AUTH_TAG_SIZE;
-        int ret = ts_auth_verify(rx_buffer, cbor_len, rx_buffer + cbor_len);
+    // Contention-based rebroadcast: delay based on RSSI
+    struct ts_msg_lora_outgoing fwd = p_in->msg;
+    if (ts_routing_decrement_ttl(&fwd.route) == 0 && fwd.route.ttl > 0) {
+        int ret = ts_contention_schedule(&fwd, p_in->rssi);
         if (ret != 0) {
-            LOG_WRN("Auth verification failed, dropping packet");
-            continue;
+            LOG_ERR("Failed to schedule contention forward: %d", ret);
         }
+    }
+    return deliver;
+}
+
+// Decode and route one authenticated CBOR payload, either a single
+// frame or a reassembled fragment set.  The message is decoded straight
+// into a pool block that local consumers then share by reference.  With
+// the pool exhausted the frame is decoded into rx_scratch instead: it is
+// still routed and forwarded, only not delivered here.
+static void lora_process_payload(const uint8_t* p_cbor, size_t cbor_len,
+                                 int16_t rssi, int8_t snr) {
+    struct ts_msg_lora_incoming* p_in = ts_msg_pool_alloc();
+    bool pooled = p_in != NULL;
+
+    if (!pooled) {
+        p_in = &rx_scratch;
+        memset(p_in, 0, sizeof(*p_in));
+    }
+    p_in->rssi = rssi;
+    p_in->snr = snr;
+
+    int ret = ts_packed_is_packed(p_cbor, cbor_len)
+                  ? ts_packed_deserialize(p_cbor, cbor_len, &p_in->msg)
+                  : cbor_deserialize(p_cbor, cbor_len, &p_in->msg);
+    if (ret != 0) {
+        LOG_ERR("Deserialization failed: %d", ret);
+        if (pooled) { ts_msg_pool_unref(p_in); }
+        return;
+    }
+
+    if (!lora_route_msg(p_in)) {
+        if (pooled) { ts_msg_pool_unref(p_in); }
+        return;
+    }
+
+    const struct zbus_channel* chan = NULL;
+    if (p_in->msg.type < ARRAY_SIZE(in_chans)) {
+        chan = in_chans[p_in->msg.type];
+    }
+    if (chan == NULL) {
+        LOG_DBG("No channel for type %d", p_in->msg.type);
+        if (pooled) { ts_msg_pool_unref(p_in); }
+        return;
+    }
+    if (!pooled) {
+        LOG_WRN("Message pool exhausted, not delivering msg_id=%u",
+                p_in->msg.route.msg_id);
+        return;
+    }
+
+    ret = ts_msg_pool_publish(chan, p_in, LORA_CHAN_IN_PUB_TIMEOUT);
+    if (ret != 0) { LOG_ERR("Failed to publish incoming message: %d", ret); }
+}
+
+// Verify auth before CBOR decode so unauthenticated packets never reach
+// the parser — limits attack surface to the tag check alone.  Wire
+// format: [CBOR payload | 8-byte CMAC tag].
+static void lora_process_signed(const uint8_t* p_frame, size_t len,
+                                int16_t rssi, int8_t snr) {
+    if (len <= TS_AUTH_TAG_SIZE) {
+        LOG_WRN("Packet too short for auth tag (%zu bytes)", len);
+        return;
+    }
+
+    size_t cbor_len = len - TS_AUTH_TAG_SIZE;
+    int ret = ts_auth_verify(p_frame, cbor_len, p_frame + cbor_len);
+    if (ret != 0) {
+        LOG_WRN("Auth verification failed, dropping packet");
+        return;
+    }
 
-        struct ts_msg_lora_incoming in_msg = {0};
-        in_msg.rssi = rssi;
-        in_msg.snr = snr;
+    lora_process_payload(p_frame, cbor_len, rssi, snr);
+}
 
-        ret = cbor_deserialize(rx_buffer, cbor_len, &in_msg.msg);
+// Verify, reassemble if needed, and route one received frame.  The frame
+// is read in place from its ring slot; the caller releases the slot
+// afterwards.
+static void lora_process_frame(const struct ts_rx_frame* frame) {
+    const uint8_t* rx_buffer = frame->data;
+    int len = frame->len;
+    int16_t rssi = frame->rssi;
+    int8_t snr = frame->snr;
+
+    LOG_INF("LoRa RX: %d bytes, RSSI=%d, SNR=%d", len, rssi, snr);
+    LOG_HEXDUMP_DBG(rx_buffer, len, "LoRa RX raw: ");
+
+    // Fragments carry their own tag; the payload is only decoded once
+    // every fragment has verified and arrived.  The last fragment's
+    // RSSI/SNR stand for the whole message.
+    if (ts_frag_is_fragment(rx_buffer, len)) {
+        size_t payload_len;
+        int ret = ts_frag_reassemble(rx_buffer, len, reassembly_buffer,
+                                     sizeof(reassembly_buffer), &payload_len);
+        if (ret == -EINPROGRESS) { return; }
         if (ret != 0) {
-            LOG_ERR("CBOR deserialization failed: %d", ret);
-            continue;
+            LOG_WRN("Dropping fragment: %d", ret);
+            return;
         }
+        lora_process_payload(reassembly_buffer, payload_len, rssi, snr);
+        return;
+    }
 
-        // key_id is checked after deserialize because it lives inside
-        // the CBOR-encoded route header.  This is safe: the CMAC already
-        // proved the packet is authentic, so a mismatched key_id just
-        // means the sender is on a different key rotation epoch.
-        if (in_msg.msg.route.key_id != ts_auth_get_key_id()) {
-            LOG_WRN("Key ID mismatch: got %u, expected %u",
-                    in_msg.msg.route.key_id, ts_auth_get_key_id());
-            continue;
+    // Aggregates carry no tag of their own; each sub-frame is verified
+    // and processed as if it had arrived alone.  A bad sub-frame is
+    // dropped without affecting its neighbours.
+    if (ts_agg_is_aggregate(rx_buffer, len)) {
+        const uint8_t* p_sub;
+        size_t sub_len;
+        size_t offset = 0;
+        int ret;
+
+        while ((ret = ts_agg_next(rx_buffer, len, &offset, &p_sub,
+                                  &sub_len)) == 0) {
+            lora_process_signed(p_sub, sub_len, rssi, snr);
         }
+        if (ret != -ENOENT) { LOG_WRN("Truncated aggregate frame"); }
+        return;
+    }
 
-        // Flooding: drop own messages that returned via other nodes
-        if (in_msg.msg.route.src == ts_routing_get_node_id()) { continue; }
+    lora_process_signed(rx_buffer, len, rssi, snr);
+}
 
-        // Flooding: drop duplicates and cancel any pending contention forward
-        if (ts_routing_is_duplicate(&in_msg.msg.route)) {
-            LOG_DBG("Dropping duplicate msg_id=%u from 0x%04x",
-                    in_msg.msg.route.msg_id, in_msg.msg.route.src);
-            ts_contention_cancel(in_msg.msg.route.src, in_msg.msg.route.msg_id);
-            continue;
-        }
-        ts_routing_mark_seen(&in_msg.msg.route);
-        ts_routing_table_update(in_msg.msg.route.src, rssi, snr,
-                                in_msg.msg.route.ttl);
+int lora_in_task() {
+    // Block until SYS_INIT has configured the radio.
+    k_sem_take(&lora_ready_sem, K_FOREVER);
+    k_sem_give(&lora_ready_sem);
 
-        // Deliver locally if addressed to this node or broadcast
-        if (ts_routing_is_for_us(&in_msg.msg.route)) {
-            ret = zbus_chan_pub(&ts_lora_in_chan, &in_msg,
-                                LORA_CHAN_IN_PUB_TIMEOUT);
-            if (ret != 0) {
-                LOG_ERR("Failed to publish incoming message: %d", ret);
-            }
-        }
+    ts_contention_init();
+    LOG_INF("LoRa receive task started");
 
-        // Contention-based rebroadcast: delay based on RSSI
-        struct ts_msg_lora_outgoing fwd = in_msg.msg;
-        if (ts_routing_decrement_ttl(&fwd.route) == 0 && fwd.route.ttl > 0) {
-            ret = ts_contention_schedule(&fwd, rssi);
-            if (ret != 0) {
-                LOG_ERR("Failed to schedule contention forward: %d", ret);
-            }
-        }
+    while (true) {
+        // Sleeps until the radio callback fills a ring slot — no
+        // periodic wakeups while the channel is idle.  Frames that
+        // arrive while this one is processed land in the next slots.
+        const struct ts_rx_frame* frame = ts_rx_ring_peek(K_FOREVER);
+        if (frame == NULL) { continue; }
+
+        lora_process_frame(frame);
+        ts_rx_ring_release();
     }
     return 0;  // unreachable!
 }
@@ -37,9 +37,13 @@ int lora_out_task(void);
 /**
  * @brief LoRa receive task entry point.
  *
- * Polls the radio, CBOR-decodes received packets, applies flooding
- * logic (duplicate detection, contention forwarding), and delivers
- * locally addressed messages to ts_lora_in_chan.
+ * Consumes raw frames placed in the RX ring by the asynchronous
+ * receive callback, CBOR-decodes them, applies flooding logic
+ * (duplicate detection, contention forwarding), and delivers locally
+ * addressed messages as pooled, shared references (see @ref msg_pool)
+ * to the incoming channel for their class: telemetry, status or
+ * control.  The radio stays in continuous receive while
+ * frames are processed.
  *
  * @return Does not return
  */
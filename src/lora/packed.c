@@ -0,0 +1,195 @@
+#include "lora/packed.h"
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/util.h>
+
+// Header field offsets
+#define PACKED_OFF_SRC 1
+#define PACKED_OFF_DST 3
+#define PACKED_OFF_MSG_ID 5
+#define PACKED_OFF_TTL 9
+#define PACKED_OFF_KEY_ID 10
+#define PACKED_OFF_TX_POWER 11
+#define PACKED_OFF_FIELDS (1 + TS_PACKED_HEADER_SIZE)
+
+// One field of the layout.  The wire value is value / scale - offset,
+// rounded to nearest, as a bits-wide unsigned or two's complement number.
+struct packed_field {
+    uint8_t bits;
+    bool is_signed;
+    bool wraps;  // keep the low bits instead of rejecting large values
+    int32_t scale;
+    int32_t offset;
+};
+
+enum {
+    FIELD_TIMESTAMP,
+    FIELD_TEMPERATURE,
+    FIELD_HUMIDITY,
+    FIELD_PRESSURE,
+    FIELD_COUNT,
+};
+
+static const struct packed_field layout[FIELD_COUNT] = {
+    [FIELD_TIMESTAMP] = {.bits = TS_PACKED_TIMESTAMP_BITS,
+                         .wraps = true,
+                         .scale = 1},
+    [FIELD_TEMPERATURE] = {.bits = TS_PACKED_TEMPERATURE_BITS,
+                           .is_signed = true,
+                           .scale = 10},
+    [FIELD_HUMIDITY] = {.bits = TS_PACKED_HUMIDITY_BITS, .scale = 10},
+    [FIELD_PRESSURE] = {.bits = TS_PACKED_PRESSURE_BITS,
+                        .scale = 1,
+                        .offset = TS_PACKED_PRESSURE_OFFSET_PA},
+};
+
+// The fields are assembled in a 64-bit accumulator
+BUILD_ASSERT(TS_PACKED_FIELDS_SIZE <= sizeof(uint64_t));
+
+// Every reading that passes the declared channel ranges must pack, so
+// CBOR stays a fallback for faulty values only.  Temperature and
+// humidity are stored at 0.01 and packed at 0.1 units.
+BUILD_ASSERT(TS_TELEMETRY_TEMPERATURE_SCALE == 100 &&
+             TS_TELEMETRY_HUMIDITY_SCALE == 100 &&
+             TS_TELEMETRY_PRESSURE_SCALE == 1);
+BUILD_ASSERT(TS_TELEMETRY_TEMPERATURE_MIN / 10 >=
+                 -(1 << (TS_PACKED_TEMPERATURE_BITS - 1)) &&
+             TS_TELEMETRY_TEMPERATURE_MAX / 10 <
+                 (1 << (TS_PACKED_TEMPERATURE_BITS - 1)));
+BUILD_ASSERT(TS_TELEMETRY_HUMIDITY_MIN >= 0 &&
+             TS_TELEMETRY_HUMIDITY_MAX / 10 < (1 << TS_PACKED_HUMIDITY_BITS));
+BUILD_ASSERT(TS_TELEMETRY_PRESSURE_MIN >= TS_PACKED_PRESSURE_OFFSET_PA &&
+             TS_TELEMETRY_PRESSURE_MAX - TS_PACKED_PRESSURE_OFFSET_PA <
+                 (1 << TS_PACKED_PRESSURE_BITS));
+
+static int64_t round_div(int64_t value, int32_t divisor) {
+    return value >= 0 ? (value + divisor / 2) / divisor
+                      : -((-value + divisor / 2) / divisor);
+}
+
+static int quantize(const struct packed_field* p_field, int64_t value,
+                    uint64_t* p_out) {
+    int64_t q = round_div(value, p_field->scale) - p_field->offset;
+    uint64_t mask = BIT64(p_field->bits) - 1;
+
+    if (!p_field->wraps) {
+        int64_t lo = p_field->is_signed ? -(int64_t)BIT64(p_field->bits - 1)
+                                        : 0;
+        int64_t hi = p_field->is_signed ? (int64_t)BIT64(p_field->bits - 1) - 1
+                                        : (int64_t)mask;
+        if (q < lo || q > hi) { return -ERANGE; }
+    }
+    *p_out = (uint64_t)q & mask;
+    return 0;
+}
+
+static int64_t dequantize(const struct packed_field* p_field,
+                          uint64_t wire) {
+    int64_t q = (int64_t)wire;
+
+    if (p_field->is_signed && (wire & BIT64(p_field->bits - 1))) {
+        q -= (int64_t)BIT64(p_field->bits);
+    }
+    return (q + p_field->offset) * p_field->scale;
+}
+
+bool ts_packed_is_packed(const uint8_t* p_buf, size_t len) {
+    return len > 0 && p_buf[0] == TS_PACKED_MARKER;
+}
+
+bool ts_packed_wanted(const struct ts_msg_lora_outgoing* msg) {
+    return msg->type == TS_MSG_TELEMETRY &&
+           (IS_ENABLED(CONFIG_TS_TELEMETRY_PACKED) || msg->short_timestamp);
+}
+
+int ts_packed_serialize(const struct ts_msg_lora_outgoing* msg,
+                        uint8_t* p_buf, size_t buf_len, size_t* p_size) {
+    const struct ts_msg_telemetry* p_tel = &msg->data.telemetry;
+    int64_t values[FIELD_COUNT] = {
+        [FIELD_TIMESTAMP] = p_tel->timestamp,
+        [FIELD_TEMPERATURE] = p_tel->temperature,
+        [FIELD_HUMIDITY] = p_tel->humidity,
+        [FIELD_PRESSURE] = p_tel->pressure,
+    };
+    uint64_t acc = 0;
+
+    if (msg->type != TS_MSG_TELEMETRY) { return -ENOTSUP; }
+    if (buf_len < TS_PACKED_TELEMETRY_SIZE) { return -ENOMEM; }
+
+    for (int i = 0; i < FIELD_COUNT; i++) {
+        uint64_t wire;
+        int ret = quantize(&layout[i], values[i], &wire);
+        if (ret != 0) { return ret; }
+        acc = (acc << layout[i].bits) | wire;
+    }
+    // Left-align so the first field starts at the MSB of the first byte
+    acc <<= 8 * TS_PACKED_FIELDS_SIZE - TS_PACKED_FIELDS_BITS;
+
+    p_buf[0] = TS_PACKED_MARKER;
+    sys_put_be16(msg->route.src, &p_buf[PACKED_OFF_SRC]);
+    sys_put_be16(msg->route.dst, &p_buf[PACKED_OFF_DST]);
+    sys_put_be32(msg->route.msg_id, &p_buf[PACKED_OFF_MSG_ID]);
+    p_buf[PACKED_OFF_TTL] = msg->route.ttl;
+    p_buf[PACKED_OFF_KEY_ID] = msg->route.key_id;
+    p_buf[PACKED_OFF_TX_POWER] = (uint8_t)msg->route.tx_power;
+    for (int i = TS_PACKED_FIELDS_SIZE - 1; i >= 0; i--) {
+        p_buf[PACKED_OFF_FIELDS + i] = (uint8_t)acc;
+        acc >>= 8;
+    }
+
+    *p_size = TS_PACKED_TELEMETRY_SIZE;
+    return 0;
+}
+
+int ts_packed_deserialize(const uint8_t* p_buf, size_t buf_len,
+                          struct ts_msg_lora_outgoing* p_msg) {
+    int64_t values[FIELD_COUNT];
+    uint64_t acc = 0;
+    int shift = 8 * TS_PACKED_FIELDS_SIZE;
+
+    if (buf_len != TS_PACKED_TELEMETRY_SIZE ||
+        !ts_packed_is_packed(p_buf, buf_len)) {
+        return -EBADMSG;
+    }
+
+    for (int i = 0; i < TS_PACKED_FIELDS_SIZE; i++) {
+        acc = (acc << 8) | p_buf[PACKED_OFF_FIELDS + i];
+    }
+    for (int i = 0; i < FIELD_COUNT; i++) {
+        shift -= layout[i].bits;
+        uint64_t wire = (acc >> shift) & (BIT64(layout[i].bits) - 1);
+        values[i] = dequantize(&layout[i], wire);
+    }
+
+    memset(p_msg, 0, sizeof(*p_msg));
+    p_msg->route.src = sys_get_be16(&p_buf[PACKED_OFF_SRC]);
+    p_msg->route.dst = sys_get_be16(&p_buf[PACKED_OFF_DST]);
+    p_msg->route.msg_id = sys_get_be32(&p_buf[PACKED_OFF_MSG_ID]);
+    p_msg->route.ttl = p_buf[PACKED_OFF_TTL];
+    p_msg->route.key_id = p_buf[PACKED_OFF_KEY_ID];
+    p_msg->route.tx_power = (int8_t)p_buf[PACKED_OFF_TX_POWER];
+    p_msg->type = TS_MSG_TELEMETRY;
+    p_msg->data.telemetry.timestamp = (uint32_t)values[FIELD_TIMESTAMP];
+    p_msg->data.telemetry.temperature = (int32_t)values[FIELD_TEMPERATURE];
+    p_msg->data.telemetry.humidity = (int32_t)values[FIELD_HUMIDITY];
+    p_msg->data.telemetry.pressure = (int32_t)values[FIELD_PRESSURE];
+    p_msg->short_timestamp = true;
+    return 0;
+}
+
+uint32_t ts_packed_unwrap_timestamp(uint32_t wire, uint32_t ref) {
+    const uint32_t span = BIT(TS_PACKED_TIMESTAMP_BITS);
+    uint32_t t = (ref & ~(span - 1)) | (wire & (span - 1));
+    int32_t ahead = (int32_t)(t - ref);
+
+    // Pick the neighbouring period if it lands closer to ref, without
+    // going below zero or past UINT32_MAX
+    if (ahead > (int32_t)(span / 2) && t >= span) {
+        t -= span;
+    } else if (ahead < -(int32_t)(span / 2) && t <= UINT32_MAX - span) {
+        t += span;
+    }
+    return t;
+}
@@ -0,0 +1,128 @@
+#ifndef TS_PACKED_H
+#define TS_PACKED_H
+
+/**
+ * @defgroup packed Packed Telemetry
+ * @brief Fixed-layout bit-packed encoding of telemetry readings.
+ *
+ * Telemetry is the bulk of the traffic and its schema never changes, so
+ * the keys and byte-aligned values of a CBOR map are pure overhead for
+ * it.  A reading is instead sent as a fixed 19-byte frame:
+ *
+ *     [0xF2 | src:2 | dst:2 | msg_id:4 | ttl:1 | key_id:1 | tx_power:1 |
+ *      fields:7]
+ *
+ * The seven field bytes hold, MSB first:
+ *
+ * | Field       | Bits | Encoding                                   |
+ * | ----------- | ---- | ------------------------------------------ |
+ * | timestamp   | 16   | seconds modulo 2^16 (about 18 hours)       |
+ * | temperature | 11   | signed, 0.1 °C (-102.4 to 102.3 °C)        |
+ * | humidity    | 10   | 0.1 %RH (0 to 102.3 %RH)                   |
+ * | pressure    | 17   | Pa above 30000 (30000 to 161071 Pa)        |
+ *
+ * Temperature and humidity lose their last decimal, well below the
+ * sensor's accuracy.  The receiver restores the timestamp's upper bits
+ * from its own estimate of the sender's clock, which only has to be
+ * right to within 9 hours.  A reading outside the ranges can't be packed and
+ * is sent as CBOR instead; CBOR stays the format for every other
+ * message type.  Like the fragment marker, 0xF2 can never start a CBOR
+ * frame, so receivers tell the formats apart by the first byte.
+ * @{
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/sys/util.h>
+
+#include "messages/messages.h"
+
+/** @brief First byte of every packed telemetry frame. */
+#define TS_PACKED_MARKER 0xF2
+
+/** @brief Field widths in bits, in wire order. */
+#define TS_PACKED_TIMESTAMP_BITS 16
+#define TS_PACKED_TEMPERATURE_BITS 11
+#define TS_PACKED_HUMIDITY_BITS 10
+#define TS_PACKED_PRESSURE_BITS 17
+
+/** @brief Pressure is sent as an offset from this value (Pa). */
+#define TS_PACKED_PRESSURE_OFFSET_PA 30000
+
+/** @brief Route header bytes (src, dst, msg_id, ttl, key_id, tx_power). */
+#define TS_PACKED_HEADER_SIZE 11
+
+/** @brief Total width of the bit-packed fields. */
+#define TS_PACKED_FIELDS_BITS                                 \
+    (TS_PACKED_TIMESTAMP_BITS + TS_PACKED_TEMPERATURE_BITS + \
+     TS_PACKED_HUMIDITY_BITS + TS_PACKED_PRESSURE_BITS)
+
+/** @brief Bytes taken by the bit-packed fields. */
+#define TS_PACKED_FIELDS_SIZE DIV_ROUND_UP(TS_PACKED_FIELDS_BITS, 8)
+
+/** @brief Size of a packed telemetry frame, marker included. */
+#define TS_PACKED_TELEMETRY_SIZE \
+    (1 + TS_PACKED_HEADER_SIZE + TS_PACKED_FIELDS_SIZE)
+
+/**
+ * @brief Check whether a payload uses the packed format.
+ *
+ * @param p_buf  Received payload (auth tag already stripped)
+ * @param len    Payload length
+ * @return true if the payload starts with TS_PACKED_MARKER
+ */
+bool ts_packed_is_packed(const uint8_t* p_buf, size_t len);
+
+/**
+ * @brief Check whether a message should be sent in the packed format.
+ *
+ * True for telemetry when CONFIG_TS_TELEMETRY_PACKED is enabled, and
+ * always for a forward of a reading that arrived packed: its timestamp
+ * was cut to 16 bits, and only the packed marker tells the gateway so.
+ *
+ * @param msg  Message about to be encoded
+ * @return true if the caller should try ts_packed_serialize() first
+ */
+bool ts_packed_wanted(const struct ts_msg_lora_outgoing* msg);
+
+/**
+ * @brief Encode a telemetry message in the packed format.
+ *
+ * @param msg      Message to encode
+ * @param p_buf    Output buffer
+ * @param buf_len  Size of the output buffer
+ * @param p_size   Output: number of bytes written
+ * @return 0 on success, -ENOTSUP if msg is not TS_MSG_TELEMETRY,
+ *         -ERANGE if a value doesn't fit its field, -ENOMEM if the
+ *         buffer is too small
+ */
+int ts_packed_serialize(const struct ts_msg_lora_outgoing* msg,
+                        uint8_t* p_buf, size_t buf_len, size_t* p_size);
+
+/**
+ * @brief Decode a packed telemetry frame.
+ *
+ * The timestamp comes back as the sender's value modulo 2^16, with
+ * short_timestamp set; see ts_packed_unwrap_timestamp().
+ *
+ * @param p_buf    Input buffer
+ * @param buf_len  Length of the input buffer
+ * @param p_msg    Output message struct
+ * @return 0 on success, -EBADMSG if the marker or length is wrong
+ */
+int ts_packed_deserialize(const uint8_t* p_buf, size_t buf_len,
+                          struct ts_msg_lora_outgoing* p_msg);
+
+/**
+ * @brief Rebuild a full timestamp from its packed low 16 bits.
+ *
+ * @param wire  Timestamp as decoded (sender's time modulo 2^16)
+ * @param ref   Estimate of the sender's time when the frame was sent
+ * @return The time nearest @p ref whose low 16 bits are @p wire
+ */
+uint32_t ts_packed_unwrap_timestamp(uint32_t wire, uint32_t ref);
+
+/** @} */
+
+#endif  // TS_PACKED_H
@@ -0,0 +1,208 @@
+#include "lora/radio.h"
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "lora/airtime.h"
+
+LOG_MODULE_REGISTER(radio);
+
+// Largest PHY payload the modem accepts.  A preamble seen in RX can hold
+// off a send for at most the time on air of a frame this size.
+#define RADIO_MAX_FRAME_LEN 255
+
+static const struct device* radio_dev;
+static struct lora_modem_config radio_config;
+static ts_radio_rx_cb_t radio_rx_cb;
+
+// Mutex: serializes whole stop-RX/config/send/start-RX sequences between
+// threads.  Spinlock: guards state and stats, which the driver callback
+// also touches and where sleeping is not allowed.
+static K_MUTEX_DEFINE(radio_mutex);
+static struct k_spinlock radio_lock;
+static K_SEM_DEFINE(radio_rx_done_sem, 0, 1);
+
+static enum ts_radio_state radio_state;
+static int64_t radio_state_since_ms;
+static int64_t radio_busy_until_ms;
+static struct ts_radio_stats radio_stats;
+
+// Caller holds radio_lock
+static void set_state_locked(enum ts_radio_state state) {
+    int64_t now = k_uptime_get();
+
+    radio_stats.state_ms[radio_state] += (uint64_t)(now - radio_state_since_ms);
+    radio_state = state;
+    radio_state_since_ms = now;
+}
+
+static void set_state(enum ts_radio_state state) {
+    k_spinlock_key_t key = k_spin_lock(&radio_lock);
+    set_state_locked(state);
+    k_spin_unlock(&radio_lock, key);
+}
+
+static void radio_recv_cb(const struct device* dev, uint8_t* data,
+                          uint16_t size, int16_t rssi, int8_t snr,
+                          void* user_data) {
+    ARG_UNUSED(dev);
+    ARG_UNUSED(user_data);
+
+    k_spinlock_key_t key = k_spin_lock(&radio_lock);
+    radio_stats.rx_frames++;
+    if (radio_state == TS_RADIO_STATE_RX_BUSY) {
+        set_state_locked(TS_RADIO_STATE_RX);
+    }
+    k_spin_unlock(&radio_lock, key);
+
+    // Wake a send waiting for this frame to finish
+    k_sem_give(&radio_rx_done_sem);
+
+    if (radio_rx_cb != NULL) { radio_rx_cb(data, size, rssi, snr); }
+}
+
+// Caller holds radio_mutex
+static int rx_start(void) {
+    int ret = lora_recv_async(radio_dev, radio_recv_cb, NULL);
+    set_state(ret == 0 ? TS_RADIO_STATE_RX : TS_RADIO_STATE_IDLE);
+    return ret;
+}
+
+// Caller holds radio_mutex
+static void rx_stop(void) {
+    lora_recv_async(radio_dev, NULL, NULL);
+    set_state(TS_RADIO_STATE_IDLE);
+}
+
+// Wait until no frame is in flight.  A frame that never completes (CRC
+// error, lost sync) releases the radio once a maximum-length frame would
+// have ended.  Returns true if the caller had to wait.  Caller holds
+// radio_mutex.
+static bool wait_rx_idle(void) {
+    bool deferred = false;
+
+    while (true) {
+        k_spinlock_key_t key = k_spin_lock(&radio_lock);
+        bool busy = radio_state == TS_RADIO_STATE_RX_BUSY;
+        int64_t remaining = radio_busy_until_ms - k_uptime_get();
+        if (busy && remaining <= 0) {
+            set_state_locked(TS_RADIO_STATE_RX);
+            busy = false;
+        }
+        k_spin_unlock(&radio_lock, key);
+
+        if (!busy) { return deferred; }
+        deferred = true;
+        k_sem_take(&radio_rx_done_sem, K_MSEC(remaining));
+    }
+}
+
+int ts_radio_init(const struct device* p_dev,
+                  const struct lora_modem_config* p_config,
+                  ts_radio_rx_cb_t rx_cb) {
+    k_mutex_lock(&radio_mutex, K_FOREVER);
+
+    radio_dev = p_dev;
+    radio_config = *p_config;
+    radio_rx_cb = rx_cb;
+
+    k_spinlock_key_t key = k_spin_lock(&radio_lock);
+    memset(&radio_stats, 0, sizeof(radio_stats));
+    radio_state = TS_RADIO_STATE_IDLE;
+    radio_state_since_ms = k_uptime_get();
+    k_spin_unlock(&radio_lock, key);
+
+    // The modem keeps separate RX and TX parameter sets; program both so
+    // receive doesn't run on driver defaults.  TX last, so the packet
+    // parameters left active are the ones every send expects.
+    radio_config.tx = false;
+    int ret = lora_config(radio_dev, &radio_config);
+    if (ret == 0) {
+        radio_config.tx = true;
+        ret = lora_config(radio_dev, &radio_config);
+    }
+    if (ret < 0) {
+        LOG_ERR("Modem config failed: %d", ret);
+        k_mutex_unlock(&radio_mutex);
+        return ret;
+    }
+
+    ret = rx_start();
+    if (ret < 0) { LOG_ERR("Async receive failed to start: %d", ret); }
+
+    k_mutex_unlock(&radio_mutex);
+    return ret;
+}
+
+int ts_radio_send(const uint8_t* p_data, size_t len, int8_t tx_power) {
+    if (radio_dev == NULL) { return -ENODEV; }
+    if (len > RADIO_MAX_FRAME_LEN) { return -EMSGSIZE; }
+
+    k_mutex_lock(&radio_mutex, K_FOREVER);
+
+    // A completion given while nobody waited must not cut the next wait
+    // short
+    k_sem_reset(&radio_rx_done_sem);
+    bool deferred = wait_rx_idle();
+
+    rx_stop();
+    set_state(TS_RADIO_STATE_TX);
+
+    // Reprogram the modem only when the power changes — lora_config()
+    // rewrites every radio register.
+    int ret = 0;
+    if (radio_config.tx_power != tx_power) {
+        int8_t prev = radio_config.tx_power;
+        radio_config.tx_power = tx_power;
+        ret = lora_config(radio_dev, &radio_config);
+        if (ret < 0) { radio_config.tx_power = prev; }
+    }
+    if (ret == 0) {
+        ret = lora_send(radio_dev, (uint8_t*)p_data, (uint32_t)len);
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&radio_lock);
+    if (deferred) { radio_stats.tx_deferred++; }
+    if (ret == 0) {
+        radio_stats.tx_frames++;
+    } else {
+        radio_stats.tx_errors++;
+    }
+    k_spin_unlock(&radio_lock, key);
+
+    if (rx_start() < 0) { LOG_ERR("Async receive failed to restart"); }
+
+    k_mutex_unlock(&radio_mutex);
+    return ret;
+}
+
+void ts_radio_notify_preamble(void) {
+    k_spinlock_key_t key = k_spin_lock(&radio_lock);
+    if (radio_state == TS_RADIO_STATE_RX) {
+        radio_busy_until_ms =
+            k_uptime_get() + ts_airtime_ms(&radio_config, RADIO_MAX_FRAME_LEN);
+        set_state_locked(TS_RADIO_STATE_RX_BUSY);
+    }
+    k_spin_unlock(&radio_lock, key);
+}
+
+enum ts_radio_state ts_radio_get_state(void) {
+    k_spinlock_key_t key = k_spin_lock(&radio_lock);
+    enum ts_radio_state state = radio_state;
+    k_spin_unlock(&radio_lock, key);
+    return state;
+}
+
+void ts_radio_get_stats(struct ts_radio_stats* p_stats) {
+    k_spinlock_key_t key = k_spin_lock(&radio_lock);
+    *p_stats = radio_stats;
+    p_stats->state_ms[radio_state] +=
+        (uint64_t)(k_uptime_get() - radio_state_since_ms);
+    k_spin_unlock(&radio_lock, key);
+}
+
+const struct lora_modem_config* ts_radio_get_config(void) {
+    return &radio_config;
+}
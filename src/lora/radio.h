@@ -0,0 +1,116 @@
+#ifndef TS_RADIO_H
+#define TS_RADIO_H
+
+/**
+ * @defgroup radio Radio Arbiter
+ * @brief Half-duplex ownership of the LoRa modem.
+ *
+ * The TX and RX threads never touch the modem directly.  The arbiter
+ * keeps the radio in continuous receive, and every transmission goes
+ * through ts_radio_send(), which waits for an in-progress reception to
+ * finish, parks receive, reprograms power if needed, sends, and re-arms
+ * receive.  Transitions are serialized by a mutex, and the time spent
+ * in each state is accounted for throughput and energy estimates.
+ *
+ * A reception is in progress from ts_radio_notify_preamble() until its
+ * frame is delivered.  The source of that call is the modem's preamble
+ * or header interrupt, where the driver reports one: the mock LoRa
+ * driver does for its loopback frames.  The Zephyr SX126x and SX127x
+ * drivers don't expose such an interrupt, so with them sends are not
+ * deferred.
+ * @{
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/lora.h>
+
+/** @brief Modem states tracked by the arbiter. */
+enum ts_radio_state {
+    TS_RADIO_STATE_IDLE,     /**< Not configured or receive parked */
+    TS_RADIO_STATE_RX,       /**< Listening for a preamble */
+    TS_RADIO_STATE_RX_BUSY,  /**< Preamble detected, frame in flight */
+    TS_RADIO_STATE_TX,       /**< Transmitting */
+    TS_RADIO_STATE_COUNT,
+};
+
+/** @brief Cumulative arbiter statistics since ts_radio_init(). */
+struct ts_radio_stats {
+    uint64_t state_ms[TS_RADIO_STATE_COUNT]; /**< Time spent per state */
+    uint32_t tx_frames;    /**< Frames handed to the modem */
+    uint32_t tx_errors;    /**< Sends or reconfigs that failed */
+    uint32_t rx_frames;    /**< Frames delivered by the modem */
+    uint32_t tx_deferred;  /**< Sends that waited for a reception */
+};
+
+/**
+ * @brief Frame delivery callback.
+ *
+ * Called in driver context; @p p_data is only valid during the call.
+ */
+typedef void (*ts_radio_rx_cb_t)(const uint8_t* p_data, uint16_t len,
+                                 int16_t rssi, int8_t snr);
+
+/**
+ * @brief Configure the modem and enter continuous receive.
+ *
+ * @param p_dev     LoRa device; owned by the arbiter from here on
+ * @param p_config  Modem configuration (copied)
+ * @param rx_cb     Callback for every received frame
+ * @return 0 on success, negative errno on failure
+ */
+int ts_radio_init(const struct device* p_dev,
+                  const struct lora_modem_config* p_config,
+                  ts_radio_rx_cb_t rx_cb);
+
+/**
+ * @brief Transmit one frame.
+ *
+ * Blocks while a reception is in flight (bounded by the maximum frame
+ * time on air), then sends at @p tx_power and returns the radio to
+ * receive.  Safe to call from multiple threads.
+ *
+ * @param p_data    Frame bytes
+ * @param len       Frame length
+ * @param tx_power  Transmit power in dBm
+ * @return 0 on success, negative errno on failure
+ */
+int ts_radio_send(const uint8_t* p_data, size_t len, int8_t tx_power);
+
+/**
+ * @brief Report that the modem has started receiving a frame.
+ *
+ * Call from the modem's preamble-detect or valid-header interrupt.
+ * Sends wait until the frame is delivered, or until a maximum-length
+ * frame would have ended if it never is.  Ignored unless listening.
+ * Safe to call from ISR context.
+ */
+void ts_radio_notify_preamble(void);
+
+/**
+ * @brief Get the current arbiter state.
+ *
+ * @return Current state
+ */
+enum ts_radio_state ts_radio_get_state(void);
+
+/**
+ * @brief Copy the arbiter statistics.
+ *
+ * Time in the current state is included up to now.
+ *
+ * @param p_stats  Output statistics
+ */
+void ts_radio_get_stats(struct ts_radio_stats* p_stats);
+
+/**
+ * @brief Get the active modem configuration.
+ *
+ * @return Pointer to the arbiter's copy of the configuration
+ */
+const struct lora_modem_config* ts_radio_get_config(void);
+
+/** @} */
+
+#endif  // TS_RADIO_H
@@ -0,0 +1,78 @@
+#include "lora/rx_ring.h"
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+
+LOG_MODULE_REGISTER(rx_ring);
+
+#define RING_MASK (TS_RX_RING_SLOTS - 1)
+
+static struct ts_rx_frame slots[TS_RX_RING_SLOTS];
+// Free-running indices: head is written only by the producer, tail only
+// by the consumer.  head - tail is the occupancy even across wraparound.
+static atomic_t head;
+static atomic_t tail;
+// Counts committed frames so the consumer can sleep without polling.
+static K_SEM_DEFINE(frames_sem, 0, TS_RX_RING_SLOTS);
+
+static atomic_t stat_received;
+static atomic_t stat_overflows;
+static atomic_t stat_high_water;
+
+void ts_rx_ring_init(void) {
+    atomic_set(&head, 0);
+    atomic_set(&tail, 0);
+    k_sem_reset(&frames_sem);
+    atomic_set(&stat_received, 0);
+    atomic_set(&stat_overflows, 0);
+    atomic_set(&stat_high_water, 0);
+}
+
+int ts_rx_ring_put(const uint8_t* p_data, size_t len, int16_t rssi,
+                   int8_t snr) {
+    if (len > TS_RX_FRAME_MAX_LEN) { return -EMSGSIZE; }
+
+    uint32_t h = (uint32_t)atomic_get(&head);
+    uint32_t used = h - (uint32_t)atomic_get(&tail);
+    if (used >= TS_RX_RING_SLOTS) {
+        atomic_inc(&stat_overflows);
+        return -ENOBUFS;
+    }
+
+    struct ts_rx_frame* slot = &slots[h & RING_MASK];
+    memcpy(slot->data, p_data, len);
+    slot->len = (uint8_t)len;
+    slot->rssi = rssi;
+    slot->snr = snr;
+    slot->timestamp_ms = k_uptime_get();
+
+    // atomic_set is a full barrier, so the slot contents are visible
+    // before the consumer can observe the new head.
+    atomic_set(&head, (atomic_val_t)(h + 1));
+    atomic_inc(&stat_received);
+    if (used + 1 > (uint32_t)atomic_get(&stat_high_water)) {
+        atomic_set(&stat_high_water, (atomic_val_t)(used + 1));
+    }
+
+    k_sem_give(&frames_sem);
+    return 0;
+}
+
+const struct ts_rx_frame* ts_rx_ring_peek(k_timeout_t timeout) {
+    if (k_sem_take(&frames_sem, timeout) != 0) { return NULL; }
+    return &slots[(uint32_t)atomic_get(&tail) & RING_MASK];
+}
+
+void ts_rx_ring_release(void) { atomic_inc(&tail); }
+
+uint32_t ts_rx_ring_count(void) {
+    return (uint32_t)atomic_get(&head) - (uint32_t)atomic_get(&tail);
+}
+
+void ts_rx_ring_get_stats(struct ts_rx_ring_stats* p_stats) {
+    p_stats->received = (uint32_t)atomic_get(&stat_received);
+    p_stats->overflows = (uint32_t)atomic_get(&stat_overflows);
+    p_stats->high_water = (uint32_t)atomic_get(&stat_high_water);
+}
@@ -0,0 +1,107 @@
+#ifndef TS_RX_RING_H
+#define TS_RX_RING_H
+
+/**
+ * @defgroup rx_ring RX Frame Ring
+ * @brief Pre-allocated single-producer/single-consumer ring of raw frames.
+ *
+ * Decouples the radio receive callback (producer) from the processing
+ * thread (consumer) so frames arriving during CMAC verification, CBOR
+ * decode, or a blocking zbus publish are buffered instead of lost.
+ * Frames are written in place by the producer and read in place by the
+ * consumer — no intermediate copies.
+ *
+ * The ring is lock-free: the producer only advances the head index and
+ * the consumer only advances the tail, so neither side ever blocks the
+ * other.  Exactly one producer and one consumer context are supported.
+ * @{
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/kernel.h>
+
+/** @brief Number of frame slots (power of two, set via Kconfig). */
+#define TS_RX_RING_SLOTS CONFIG_TS_RX_RING_SLOTS
+
+/** @brief Maximum LoRa PHY payload stored per slot. */
+#define TS_RX_FRAME_MAX_LEN UINT8_MAX
+
+BUILD_ASSERT((TS_RX_RING_SLOTS & (TS_RX_RING_SLOTS - 1)) == 0,
+             "TS_RX_RING_SLOTS must be a power of two");
+
+/** @brief A received frame with its PHY-layer metadata. */
+struct ts_rx_frame {
+    int64_t timestamp_ms;
+    int16_t rssi;
+    int8_t snr;
+    uint8_t len;
+    uint8_t data[TS_RX_FRAME_MAX_LEN];
+};
+
+/** @brief Ring occupancy counters for sizing per deployment. */
+struct ts_rx_ring_stats {
+    /** Frames accepted into the ring. */
+    uint32_t received;
+    /** Frames dropped because every slot was occupied. */
+    uint32_t overflows;
+    /** Highest number of slots occupied at once. */
+    uint32_t high_water;
+};
+
+/**
+ * @brief Empty the ring and reset its statistics.
+ *
+ * Must not race with producer or consumer calls.
+ */
+void ts_rx_ring_init(void);
+
+/**
+ * @brief Copy a frame into the next free slot (producer side).
+ *
+ * Safe to call from ISR or driver callback context.
+ *
+ * @param p_data  Raw frame bytes
+ * @param len     Frame length
+ * @param rssi    Received signal strength (dBm)
+ * @param snr     Signal-to-noise ratio (dB)
+ * @return 0 on success, -EMSGSIZE if len exceeds a slot,
+ *         -ENOBUFS if the ring is full (counted as overflow)
+ */
+int ts_rx_ring_put(const uint8_t* p_data, size_t len, int16_t rssi,
+                   int8_t snr);
+
+/**
+ * @brief Wait for the oldest unprocessed frame (consumer side).
+ *
+ * The frame stays in its slot and must be handed back with
+ * ts_rx_ring_release() once processing is done.
+ *
+ * @param timeout  How long to wait for a frame
+ * @return Pointer to the frame, or NULL on timeout
+ */
+const struct ts_rx_frame* ts_rx_ring_peek(k_timeout_t timeout);
+
+/**
+ * @brief Release the frame returned by the last ts_rx_ring_peek().
+ */
+void ts_rx_ring_release(void);
+
+/**
+ * @brief Get the number of frames currently queued.
+ *
+ * @return Occupied slot count
+ */
+uint32_t ts_rx_ring_count(void);
+
+/**
+ * @brief Copy the ring statistics.
+ *
+ * @param p_stats  Output statistics
+ */
+void ts_rx_ring_get_stats(struct ts_rx_ring_stats* p_stats);
+
+/** @} */
+
+#endif  // TS_RX_RING_H
@@ -0,0 +1,129 @@
+#include "lora/tx_power.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "routing/routing.h"
+
+LOG_MODULE_REGISTER(tx_power);
+
+// Thermal noise over 125 kHz (-174 + 10*log10(125e3) ≈ -123 dBm) plus a
+// typical 6 dB receiver noise figure.  Sensitivity is this plus the SF's
+// SNR floor.
+#define TX_POWER_NOISE_FLOOR_DBM (-117)
+
+// Demodulation SNR floors for SF5..SF12 at 125 kHz, rounded up to the
+// next whole dB so the margin estimate errs on the safe side.
+static const int8_t snr_floor_db[] = {-2, -5, -7, -10, -12, -15, -17, -20};
+
+// Atomics: select() runs on the TX thread while delivery feedback can
+// arrive from the RX thread or the system work queue.
+static atomic_t current_dbm = ATOMIC_INIT(TS_TX_POWER_INITIAL_DBM);
+static atomic_t boost_db;
+static uint8_t active_sf = 10;
+
+void ts_tx_power_init(uint8_t sf) {
+    active_sf = sf;
+    atomic_set(&current_dbm, TS_TX_POWER_INITIAL_DBM);
+    atomic_set(&boost_db, 0);
+}
+
+int8_t ts_tx_power_snr_floor_db(uint8_t sf) {
+    sf = CLAMP(sf, 5, 12);
+    return snr_floor_db[sf - 5];
+}
+
+int16_t ts_tx_power_link_margin_db(const struct ts_neighbor* p_neighbor) {
+    int16_t floor = ts_tx_power_snr_floor_db(active_sf);
+
+    if (p_neighbor->snr < TS_TX_POWER_SNR_SATURATION_DB) {
+        return (int16_t)p_neighbor->snr - floor;
+    }
+    return p_neighbor->rssi - (TX_POWER_NOISE_FLOOR_DBM + floor);
+}
+
+int16_t ts_tx_power_needed_dbm(const struct ts_neighbor* p_neighbor) {
+    // The neighbor's margin was measured at the power it sent with; with
+    // reciprocal path loss, sending at P gives it P - tx_power more.
+    return (int16_t)p_neighbor->tx_power + TS_TX_POWER_TARGET_MARGIN_DB -
+           ts_tx_power_link_margin_db(p_neighbor);
+}
+
+// Power needed by the hardest to reach of the neighbors this frame has
+// to reach.  Returns false when no such neighbor is known.
+static bool highest_needed_power(uint16_t dst, int16_t* p_power) {
+    struct ts_neighbor neighbors[TS_ROUTING_TABLE_SIZE];
+    size_t count = ts_routing_table_snapshot(neighbors, ARRAY_SIZE(neighbors));
+    bool found = false;
+
+    for (size_t i = 0; i < count; i++) {
+        if (dst != TS_ROUTING_BROADCAST_ADDR && neighbors[i].node_id == dst &&
+            neighbors[i].direct) {
+            *p_power = ts_tx_power_needed_dbm(&neighbors[i]);
+            return true;
+        }
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (!neighbors[i].direct) { continue; }
+        int16_t power = ts_tx_power_needed_dbm(&neighbors[i]);
+        if (!found || power > *p_power) {
+            *p_power = power;
+            found = true;
+        }
+    }
+    return found;
+}
+
+int8_t ts_tx_power_select(uint16_t dst) {
+    int32_t current = (int32_t)atomic_get(&current_dbm);
+    int16_t needed;
+    int32_t power;
+
+    if (highest_needed_power(dst, &needed)) {
+        // Open-loop estimate plus the closed-loop boost from failed
+        // deliveries
+        power = needed + (int32_t)atomic_get(&boost_db);
+
+        // Raise immediately when short of margin, but only step down
+        // one step per frame so a single optimistic reading can't drop
+        // a marginal link.
+        if (power < current) {
+            power = MAX(power, current - TS_TX_POWER_STEP_DB);
+        }
+    } else {
+        power = TS_TX_POWER_MAX_DBM;
+    }
+
+    power = CLAMP(power, TS_TX_POWER_MIN_DBM, TS_TX_POWER_MAX_DBM);
+    if (power != current) {
+        LOG_DBG("TX power %d -> %d dBm (dst=0x%04x)", (int)current, (int)power,
+                dst);
+        atomic_set(&current_dbm, power);
+    }
+    return (int8_t)power;
+}
+
+void ts_tx_power_report_delivery(bool delivered) {
+    atomic_val_t boost;
+    atomic_val_t next;
+
+    // Reports arrive from the TX thread and the ACK work item at once:
+    // retry until no other report changed the boost in between.
+    do {
+        boost = atomic_get(&boost_db);
+        if (delivered) {
+            if (boost <= 0) { return; }
+            next = boost - TS_TX_POWER_STEP_DB;
+        } else {
+            if (boost >= TS_TX_POWER_MAX_DBM - TS_TX_POWER_MIN_DBM) { return; }
+            next = boost + TS_TX_POWER_STEP_DB;
+        }
+    } while (!atomic_cas(&boost_db, boost, next));
+
+    if (!delivered) {
+        LOG_DBG("Delivery failed, TX power boost now %d dB", (int)next);
+    }
+}
+
+int8_t ts_tx_power_get(void) { return (int8_t)atomic_get(&current_dbm); }
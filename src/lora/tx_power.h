@@ -0,0 +1,122 @@
+#ifndef TS_TX_POWER_H
+#define TS_TX_POWER_H
+
+/**
+ * @defgroup tx_power TX Power Control
+ * @brief Per-frame transmit power derived from neighbor link margin.
+ *
+ * Each frame is sent at the lowest power that still reaches the weakest
+ * neighbor it needs to reach with TS_TX_POWER_TARGET_MARGIN_DB to spare.
+ * Link margin is estimated from the RSSI/SNR of the neighbor's own frames
+ * (assuming reciprocal links).  Neighbors run this same controller, so
+ * every frame's route header carries the power it was sent at, and the
+ * margin is scaled from that power to ours.  Delivery feedback corrects
+ * the estimate: failures step power up, successes let it step back
+ * down.  Power rises immediately when margin is short and falls one
+ * step per frame when links have margin to spare.
+ *
+ * Delivery feedback comes only from link-layer ACKs (ack.c), so only
+ * unicast frames sent with CONFIG_TS_LINK_ACK feed it.  Broadcasts and
+ * bulk frames are never acknowledged, and ts_radio_send() errors are
+ * local modem faults that say nothing about the link; for all of these
+ * power follows the margin estimate alone.
+ * @{
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "routing/routing_table.h"
+
+/** @brief Lowest transmit power the controller will select (dBm). */
+#define TS_TX_POWER_MIN_DBM 0
+
+/** @brief Highest transmit power the controller will select (dBm). */
+#define TS_TX_POWER_MAX_DBM 14
+
+/** @brief Power used before any neighbor is known (dBm). */
+#define TS_TX_POWER_INITIAL_DBM 4
+
+/** @brief Size of a single power adjustment step (dB). */
+#define TS_TX_POWER_STEP_DB 2
+
+/** @brief Link margin the controller aims to keep above the floor (dB). */
+#define TS_TX_POWER_TARGET_MARGIN_DB 10
+
+/**
+ * @brief SNR above which the radio's SNR estimate saturates (dB).
+ *
+ * Above this point SNR no longer tracks signal strength, so margin is
+ * taken from RSSI relative to the receiver sensitivity instead.
+ */
+#define TS_TX_POWER_SNR_SATURATION_DB 5
+
+/**
+ * @brief Reset the controller to its initial state.
+ *
+ * @param sf  Spreading factor in use (5–12); selects demodulation floor
+ */
+void ts_tx_power_init(uint8_t sf);
+
+/**
+ * @brief Demodulation SNR floor for a spreading factor.
+ *
+ * @param sf  Spreading factor (5–12); values outside are clamped
+ * @return Minimum SNR in dB at which LoRa frames still decode
+ */
+int8_t ts_tx_power_snr_floor_db(uint8_t sf);
+
+/**
+ * @brief Estimate the link margin of a neighbor entry.
+ *
+ * Uses SNR above the demodulation floor while SNR is in its linear
+ * range, and RSSI above receiver sensitivity once SNR saturates.
+ *
+ * @param p_neighbor  Neighbor entry from the routing table
+ * @return Estimated margin in dB (negative when below the floor)
+ */
+int16_t ts_tx_power_link_margin_db(const struct ts_neighbor* p_neighbor);
+
+/**
+ * @brief Power at which a neighbor would hear us with the target margin.
+ *
+ * @param p_neighbor  Neighbor entry, with the power its frames were sent at
+ * @return Transmit power in dBm, not clamped to the supported range
+ */
+int16_t ts_tx_power_needed_dbm(const struct ts_neighbor* p_neighbor);
+
+/**
+ * @brief Select the transmit power for the next frame.
+ *
+ * For unicast to a direct neighbor, only that neighbor's margin counts.
+ * Otherwise the weakest direct neighbor must be reached.  Power drops
+ * by at most TS_TX_POWER_STEP_DB per call.  With no direct neighbors
+ * known the controller transmits at maximum power so the node can be
+ * discovered.
+ *
+ * @param dst  Destination node ID or TS_ROUTING_BROADCAST_ADDR
+ * @return Transmit power in dBm
+ */
+int8_t ts_tx_power_select(uint16_t dst);
+
+/**
+ * @brief Feed delivery outcome back into the controller.
+ *
+ * A failed or unacknowledged delivery adds one step of boost on top of
+ * the margin-based estimate; each successful delivery removes one.
+ * Called by the link-layer ACK tracker only.
+ *
+ * @param delivered  true if the frame was delivered
+ */
+void ts_tx_power_report_delivery(bool delivered);
+
+/**
+ * @brief Get the most recently selected transmit power.
+ *
+ * @return Transmit power in dBm
+ */
+int8_t ts_tx_power_get(void);
+
+/** @} */
+
+#endif  // TS_TX_POWER_H
@@ -2,14 +2,23 @@
 #include <zephyr/kernel.h>
 #include <zephyr/zbus/zbus.h>
 
+#include "config/config.h"
 #include "logging/logging.h"
 #include "lora/auth.h"
 #include "messages/messages.h"
 #include "routing/routing.h"
 #include "routing/routing_table.h"
+#include "scheduler/scheduler.h"
 #include "sensors/sensor_manager.h"
+#include "sensors/telemetry_store.h"
 #include "version.h"
 
+#if defined(CONFIG_TS_GATEWAY)
+#include "gateway/gateway.h"
+#include "gateway/uplink_mqtt_sn.h"
+#include "gateway/uplink_uart.h"
+#endif
+
 #define DEFAULT_RADIO_NODE DT_ALIAS(lora0)
 
 #include <zephyr/logging/log.h>
@@ -20,30 +29,109 @@ LOG_MODULE_REGISTER(terrascope);
 
 #define ZBUS_SEND_TIMEOUT K_MSEC(200)
 
+#if defined(CONFIG_TS_TELEMETRY_STORE)
+#if !DT_HAS_CHOSEN(terrascope_telemetry_store_partition)
+#error "The telemetry store needs a terrascope,telemetry-store-partition"
+#endif
+#define TELEMETRY_STORE_AREA \
+    DT_FIXED_PARTITION_ID(DT_CHOSEN(terrascope_telemetry_store_partition))
+#endif
+
+#if defined(CONFIG_TS_GATEWAY)
+#if defined(CONFIG_TS_GATEWAY_UPLINK_MQTT_SN)
+#define GATEWAY_UPLINK (&ts_uplink_mqtt_sn)
+#else
+#define GATEWAY_UPLINK (&ts_uplink_uart)
+#endif
+#define GATEWAY_OBSERVERS ZBUS_OBSERVERS(ts_gateway_lis)
+#else
+#define GATEWAY_OBSERVERS ZBUS_OBSERVERS_EMPTY
+#endif
+
 ZBUS_CHAN_DEFINE(ts_lora_out_chan, struct ts_msg_lora_outgoing, NULL, NULL,
                  ZBUS_OBSERVERS(ts_lora_out_sub), ZBUS_MSG_INIT(0));
 
-// No observers yet — mesh routing and gateway modules will subscribe later
-ZBUS_CHAN_DEFINE(ts_lora_in_chan, struct ts_msg_lora_incoming, NULL, NULL,
-                 ZBUS_OBSERVERS_EMPTY, ZBUS_MSG_INIT(0));
+// Relay forwards released together by the contention pool
+ZBUS_CHAN_DEFINE(ts_lora_agg_chan, struct ts_msg_lora_aggregate, NULL, NULL,
+                 ZBUS_OBSERVERS(ts_lora_out_sub), ZBUS_MSG_INIT(0));
 
-// Set up periodic sensor readings using a timer and submit the work to the
-// system workqueue
-K_WORK_DEFINE(sensor_take_reading, sensor_take_reading_wrapper);
-void sensor_periodic_timer_handler(struct k_timer* dummy) {
-    k_work_submit(&sensor_take_reading);
+// Messages delivered to this node, split by class so an observer only
+// wakes for the messages it handles.  lora.c routes each type to one of
+// these.  Each carries a pointer to a pooled message (see msg_pool.h)
+// that all observers share instead of copying.
+
+// Telemetry, batches and deltas
+ZBUS_CHAN_DEFINE(ts_lora_in_telemetry_chan, const struct ts_msg_lora_incoming*,
+                 NULL, NULL, GATEWAY_OBSERVERS, ZBUS_MSG_INIT(NULL));
+
+// Node status reports
+ZBUS_CHAN_DEFINE(ts_lora_in_status_chan, const struct ts_msg_lora_incoming*,
+                 NULL, NULL, GATEWAY_OBSERVERS, ZBUS_MSG_INIT(NULL));
+
+// Bulk-transfer chunks and statuses
+ZBUS_CHAN_DEFINE(ts_lora_in_control_chan, const struct ts_msg_lora_incoming*,
+                 NULL, NULL, ZBUS_OBSERVERS(ts_bulk_lis), ZBUS_MSG_INIT(NULL));
+
+// Periodic jobs.  Intervals follow the live config; the tolerances let
+// the heartbeat and table aging share wakeups with sensor sampling,
+// which runs exactly when the sensor registry asks.
+
+// Let the mesh know this node is alive
+static uint32_t heartbeat_run(void) {
+    uint32_t now = (uint32_t)k_uptime_seconds();
+    struct ts_msg_lora_outgoing out_msg = {
+        .type = TS_MSG_NODE_STATUS,
+        .data.node_status = {.timestamp = now, .uptime = now, .status = OK},
+    };
+    ts_routing_prepare_header(&out_msg.route, TS_ROUTING_BROADCAST_ADDR);
+    LOG_DBG("Notifying mesh of node status: uptime=%d, status=%d",
+            out_msg.data.node_status.uptime, out_msg.data.node_status.status);
+
+    int ret = zbus_chan_pub(&ts_lora_out_chan, &out_msg, ZBUS_SEND_TIMEOUT);
+    log_chan_pub_ret(ret);
+    return 0;
 }
-K_TIMER_DEFINE(sensor_periodic_timer, sensor_periodic_timer_handler, NULL);
 
-// Periodic routing table aging
-static void routing_table_age_handler(struct k_work* work) {
-    ts_routing_table_age_seconds(TS_ROUTING_TABLE_STALE_TIMEOUT_S);
+static uint32_t routing_table_age_run(void) {
+    const struct ts_config* cfg = ts_config_get();
+
+    ts_routing_table_age_seconds(cfg->routing_table_stale_timeout_s);
+    return 0;
 }
-K_WORK_DEFINE(routing_table_age_work, routing_table_age_handler);
-static void routing_table_age_timer_handler(struct k_timer* dummy) {
-    k_work_submit(&routing_table_age_work);
+
+static struct ts_sched_job sensor_job = {
+    .name = "sensor",
+    .run = ts_sensor_manager_poll,
+    .tolerance_s = 0,
+};
+
+static struct ts_sched_job heartbeat_job = {
+    .name = "heartbeat",
+    .run = heartbeat_run,
+    .tolerance_s = 3,
+};
+
+static struct ts_sched_job routing_table_age_job = {
+    .name = "routing_table_age",
+    .run = routing_table_age_run,
+    .tolerance_s = 30,
+};
+
+static void schedule_jobs(void) {
+    const struct ts_config* cfg = ts_config_get();
+    uint32_t now = (uint32_t)k_uptime_seconds();
+
+    sensor_job.p_interval_s = &cfg->sensor_interval_s;
+    heartbeat_job.p_interval_s = &cfg->heartbeat_interval_s;
+    routing_table_age_job.p_interval_s = &cfg->routing_table_age_interval_s;
+
+    ts_sched_init();
+    ts_sched_add(&sensor_job, now + 1);
+    ts_sched_add(&heartbeat_job, now + cfg->heartbeat_interval_s);
+    ts_sched_add(&routing_table_age_job,
+                 now + cfg->routing_table_age_interval_s);
+    ts_sched_start();
 }
-K_TIMER_DEFINE(routing_table_age_timer, routing_table_age_timer_handler, NULL);
 
 int main() {
     LOG_INF("Terrascope v%s (%s %s) started", FIRMWARE_VERSION_STRING,
@@ -59,24 +147,23 @@ int main() {
     ts_routing_table_init();
     LOG_INF("Node ID: 0x%04x", ts_routing_get_node_id());
 
-    k_timer_start(&sensor_periodic_timer, K_SECONDS(1), K_SECONDS(10));
-    k_timer_start(&routing_table_age_timer, K_SECONDS(60), K_SECONDS(60));
-
-    while (true) {
-        k_sleep(K_SECONDS(7));
-        uint32_t now = (uint32_t)k_uptime_seconds();
-        struct ts_msg_lora_outgoing out_msg = {
-            .type = TS_MSG_NODE_STATUS,
-            .data.node_status = {.timestamp = now, .uptime = now, .status = OK},
-        };
-        ts_routing_prepare_header(&out_msg.route, TS_ROUTING_BROADCAST_ADDR);
-        LOG_DBG("Notifying mesh of node status: uptime=%d, status=%d",
-                out_msg.data.node_status.uptime,
-                out_msg.data.node_status.status);
-
-        int ret = zbus_chan_pub(&ts_lora_out_chan, &out_msg, ZBUS_SEND_TIMEOUT);
-        log_chan_pub_ret(ret);
+#if defined(CONFIG_TS_TELEMETRY_STORE)
+    int store_ret = ts_telemetry_store_init(TELEMETRY_STORE_AREA);
+    if (store_ret != 0) {
+        LOG_ERR("Failed to open telemetry store: %d", store_ret);
+    }
+#endif
+
+#if defined(CONFIG_TS_GATEWAY)
+    int gw_ret = ts_gateway_init(GATEWAY_UPLINK);
+    if (gw_ret != 0) { LOG_ERR("Failed to start gateway: %d", gw_ret); }
+#endif
+
+    int sensor_ret = ts_sensor_manager_start();
+    if (sensor_ret != 0) {
+        LOG_ERR("Failed to start sensor sampling: %d", sensor_ret);
     }
 
+    schedule_jobs();
     return 0;
 }
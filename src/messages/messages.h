@@ -7,6 +7,7 @@
  * @{
  */
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "routing/routing.h"
@@ -15,6 +16,14 @@
 typedef enum {
     TS_MSG_TELEMETRY = 0,
     TS_MSG_NODE_STATUS = 1,
+    TS_MSG_ACK = 2,
+    TS_MSG_BULK_DATA = 3,
+    TS_MSG_BULK_STATUS = 4,
+    TS_MSG_TELEMETRY_BATCH = 5,
+    TS_MSG_TELEMETRY_DELTA = 6,
+    TS_MSG_TELEMETRY_SUMMARY = 7,
+    TS_MSG_TELEMETRY_MODEL = 8,
+    TS_MSG_SENSOR_VALUES = 9,
 } ts_msg_type_t;
 
 /** @brief Node status codes. */
@@ -23,12 +32,144 @@ typedef enum {
     ERROR = 1,
 } ts_status_t;
 
-/** @brief Telemetry payload (temperature, humidity, pressure). */
+/**
+ * @name Telemetry channel ranges
+ * Each sensor channel is a signed fixed-point value: the reading in the
+ * channel's unit times its scale.  Readings outside [min, max] are a
+ * sensor fault and are never sent.  The limits are the BME280's
+ * operating ranges.
+ * @{
+ */
+#define TS_TELEMETRY_TEMPERATURE_SCALE 100 /**< centi-°C */
+#define TS_TELEMETRY_TEMPERATURE_MIN (-40 * TS_TELEMETRY_TEMPERATURE_SCALE)
+#define TS_TELEMETRY_TEMPERATURE_MAX (85 * TS_TELEMETRY_TEMPERATURE_SCALE)
+#define TS_TELEMETRY_HUMIDITY_SCALE 100 /**< centi-%RH */
+#define TS_TELEMETRY_HUMIDITY_MIN 0
+#define TS_TELEMETRY_HUMIDITY_MAX (100 * TS_TELEMETRY_HUMIDITY_SCALE)
+#define TS_TELEMETRY_PRESSURE_SCALE 1 /**< Pa */
+#define TS_TELEMETRY_PRESSURE_MIN 30000
+#define TS_TELEMETRY_PRESSURE_MAX 110000
+/** @} */
+
+/**
+ * @brief Telemetry payload (temperature, humidity, pressure).
+ *
+ * Channels are signed so sub-zero temperatures keep their sign; CBOR
+ * then encodes them as negative integers whose size follows the
+ * magnitude.
+ */
 struct ts_msg_telemetry {
     uint32_t timestamp;
-    uint32_t temperature;
-    uint32_t humidity;
-    uint32_t pressure;
+    int32_t temperature;
+    int32_t humidity;
+    int32_t pressure;
+};
+
+/** @brief Most readings carried by one telemetry batch. */
+#define TS_MSG_TELEMETRY_BATCH_MAX 8
+
+/** @brief One reading inside a telemetry batch. */
+struct ts_msg_telemetry_sample {
+    uint16_t dt;  // seconds since the previous sample (0 for the first)
+    int32_t temperature;
+    int32_t humidity;
+    int32_t pressure;
+};
+
+/**
+ * @brief Several readings sent as one frame.
+ *
+ * Sample i was taken at base_timestamp plus the dt of samples 0..i, so
+ * each sample time costs one or two bytes on the wire instead of a full
+ * timestamp.
+ */
+struct ts_msg_telemetry_batch {
+    uint32_t base_timestamp;
+    uint8_t count;
+    struct ts_msg_telemetry_sample samples[TS_MSG_TELEMETRY_BATCH_MAX];
+};
+
+/** @brief Largest packed payload of a delta-coded reading (4 varints). */
+#define TS_MSG_TELEMETRY_DELTA_MAX_LEN 20
+
+/**
+ * @brief Reading coded against the previous one from the same node.
+ *
+ * data holds four zigzag varints: timestamp, temperature, humidity and
+ * pressure.  A keyframe carries the values themselves; otherwise each
+ * is the difference from the previous reading.  seq increments with
+ * every message so the receiver can detect a gap and wait for the next
+ * keyframe.
+ */
+struct ts_msg_telemetry_delta {
+    uint8_t seq;
+    bool keyframe;
+    uint8_t len;
+    uint8_t data[TS_MSG_TELEMETRY_DELTA_MAX_LEN];
+};
+
+/**
+ * @brief Statistics of the readings taken over one window.
+ *
+ * Covers count readings from timestamp to timestamp + duration_s.  Each
+ * channel carries the lowest, highest and mean value, in the units of
+ * ts_msg_telemetry.
+ */
+struct ts_msg_telemetry_summary {
+    uint32_t timestamp;  // first reading of the window
+    uint16_t duration_s; // last reading minus first
+    uint16_t count;
+    int32_t temperature_min;
+    int32_t temperature_max;
+    int32_t temperature_mean;
+    int32_t humidity_min;
+    int32_t humidity_max;
+    int32_t humidity_mean;
+    int32_t pressure_min;
+    int32_t pressure_max;
+    int32_t pressure_mean;
+};
+
+/**
+ * @brief Reading the receiver could not have predicted.
+ *
+ * Sent by a node running predictive suppression (see telemetry_predict)
+ * whenever a reading strays too far from what the shared model
+ * predicts.  Sender and receiver both feed it to their copy of the
+ * model; a resync message restarts the model from this reading alone.
+ * seq increments with every message so the receiver can detect a gap
+ * and wait for the next resync.
+ */
+struct ts_msg_telemetry_model {
+    uint8_t seq;
+    bool resync;
+    uint32_t timestamp;
+    int32_t temperature;
+    int32_t humidity;
+    int32_t pressure;
+};
+
+/** @brief Most channel values carried by one sensor values message. */
+#define TS_MSG_SENSOR_VALUES_MAX 8
+
+/** @brief One channel's value, in the units its descriptor declares. */
+struct ts_msg_sensor_value {
+    uint8_t id;
+    int32_t value;
+};
+
+/**
+ * @brief Values of the channels sampled together at one time.
+ *
+ * Sent for samples that are not one full temperature/humidity/pressure
+ * reading, e.g. when channels run at different periods.  Channel IDs
+ * are assigned by the sensor registry (see sensor_registry.h); IDs 0–2
+ * are the channels of ts_msg_telemetry.
+ */
+struct ts_msg_sensor_values {
+    uint32_t timestamp;
+    uint8_t count;
+    struct ts_msg_sensor_value values[TS_MSG_SENSOR_VALUES_MAX];
 };
 
 /** @brief Node status payload (uptime and health). */
@@ -38,6 +179,46 @@ struct ts_msg_node_status {
     ts_status_t status;
 };
 
+/**
+ * @brief Explicit link-layer acknowledgement payload.
+ *
+ * Identifies the acknowledged frame by its original (src, msg_id) and
+ * the TTL of the copy that was received, so only the hop that sent that
+ * copy takes it as confirmation.  Sent by the final hop of a unicast,
+ * or by a relay whose forward the previous hop missed; never forwarded.
+ */
+struct ts_msg_ack {
+    uint16_t src;
+    uint32_t msg_id;
+    uint8_t ttl;  // TTL of the acknowledged copy as received
+};
+
+/** @brief Payload bytes carried by one bulk-transfer chunk. */
+#define TS_MSG_BULK_CHUNK_SIZE 128
+
+/** @brief One chunk of a bulk transfer session. */
+struct ts_msg_bulk_data {
+    uint16_t session;
+    uint16_t seq;
+    uint16_t total;  // chunks in the whole transfer
+    bool ack_req;    // receiver should answer with a status
+    uint8_t len;
+    uint8_t data[TS_MSG_BULK_CHUNK_SIZE];
+};
+
+/**
+ * @brief Bulk transfer receiver status (cumulative ACK + selective NACK).
+ *
+ * Every chunk below ack_base has arrived and ack_base itself has not.
+ * Bit i of nack_bitmap is set when chunk ack_base + 1 + i is still
+ * missing.
+ */
+struct ts_msg_bulk_status {
+    uint16_t session;
+    uint16_t ack_base;
+    uint32_t nack_bitmap;
+};
+
 /** @brief Outgoing message with route header and typed payload. */
 struct ts_msg_lora_outgoing {
     struct ts_route_header route;
@@ -45,7 +226,32 @@ struct ts_msg_lora_outgoing {
     union {
         struct ts_msg_telemetry telemetry;
         struct ts_msg_node_status node_status;
+        struct ts_msg_ack ack;
+        struct ts_msg_bulk_data bulk_data;
+        struct ts_msg_bulk_status bulk_status;
+        struct ts_msg_telemetry_batch telemetry_batch;
+        struct ts_msg_telemetry_delta telemetry_delta;
+        struct ts_msg_telemetry_summary telemetry_summary;
+        struct ts_msg_telemetry_model telemetry_model;
+        struct ts_msg_sensor_values sensor_values;
     } data;
+    // Decoded from a packed frame: the telemetry timestamp is modulo
+    // 2^16, and a forward of it is sent packed again
+    bool short_timestamp;
+};
+
+/** @brief Most forwards the contention pool releases as one aggregate. */
+#define TS_MSG_AGGREGATE_MAX 4
+
+/**
+ * @brief Forwards released together by the contention pool.
+ *
+ * Published on ts_lora_agg_chan; the LoRa TX task packs them into as
+ * few aggregate frames as they fit.  All share the same destination.
+ */
+struct ts_msg_lora_aggregate {
+    uint8_t count;
+    struct ts_msg_lora_outgoing msgs[TS_MSG_AGGREGATE_MAX];
 };
 
 /** @brief Incoming message wrapper with PHY-layer radio metadata. */
@@ -0,0 +1,84 @@
+#include "messages/msg_pool.h"
+
+#include <string.h>
+#include <zephyr/sys/atomic.h>
+
+struct msg_block {
+    atomic_t refs;
+    struct ts_msg_lora_incoming msg;
+};
+
+K_MEM_SLAB_DEFINE_STATIC(msg_slab, sizeof(struct msg_block),
+                         TS_MSG_POOL_BLOCKS, 4);
+
+static struct msg_block* block_of(const struct ts_msg_lora_incoming* p_msg) {
+    return CONTAINER_OF(p_msg, struct msg_block, msg);
+}
+
+struct ts_msg_lora_incoming* ts_msg_pool_alloc(void) {
+    struct msg_block* block;
+
+    if (k_mem_slab_alloc(&msg_slab, (void**)&block, K_NO_WAIT) != 0) {
+        return NULL;
+    }
+    memset(&block->msg, 0, sizeof(block->msg));
+    atomic_set(&block->refs, 1);
+    return &block->msg;
+}
+
+void ts_msg_pool_ref(const struct ts_msg_lora_incoming* p_msg) {
+    atomic_inc(&block_of(p_msg)->refs);
+}
+
+void ts_msg_pool_unref(const struct ts_msg_lora_incoming* p_msg) {
+    if (p_msg == NULL) { return; }
+
+    struct msg_block* block = block_of(p_msg);
+    // atomic_dec returns the value before the decrement
+    if (atomic_dec(&block->refs) == 1) { k_mem_slab_free(&msg_slab, block); }
+}
+
+// The channel holds one reference to its current message.  Swapping
+// the pointer under the channel lock means a subscriber in
+// ts_msg_pool_get() either sees the old message before it is released
+// or the new one; it never refs a block that has gone back to the pool.
+int ts_msg_pool_publish(const struct zbus_channel* chan,
+                        const struct ts_msg_lora_incoming* p_msg,
+                        k_timeout_t timeout) {
+    const struct ts_msg_lora_incoming** pp_slot;
+    const struct ts_msg_lora_incoming* p_old;
+
+    int ret = zbus_chan_claim(chan, timeout);
+    if (ret != 0) {
+        ts_msg_pool_unref(p_msg);
+        return ret;
+    }
+    pp_slot = zbus_chan_msg(chan);
+    p_old = *pp_slot;
+    *pp_slot = p_msg;
+    zbus_chan_finish(chan);
+
+    ts_msg_pool_unref(p_old);
+    return zbus_chan_notify(chan, timeout);
+}
+
+const struct ts_msg_lora_incoming* ts_msg_pool_peek(
+    const struct zbus_channel* chan) {
+    return *(const struct ts_msg_lora_incoming* const*)zbus_chan_const_msg(
+        chan);
+}
+
+const struct ts_msg_lora_incoming* ts_msg_pool_get(
+    const struct zbus_channel* chan, k_timeout_t timeout) {
+    const struct ts_msg_lora_incoming* p_msg;
+
+    if (zbus_chan_claim(chan, timeout) != 0) { return NULL; }
+    p_msg = ts_msg_pool_peek(chan);
+    if (p_msg != NULL) { ts_msg_pool_ref(p_msg); }
+    zbus_chan_finish(chan);
+    return p_msg;
+}
+
+uint32_t ts_msg_pool_num_free(void) {
+    return k_mem_slab_num_free_get(&msg_slab);
+}
@@ -0,0 +1,109 @@
+#ifndef TS_MSG_POOL_H
+#define TS_MSG_POOL_H
+
+/**
+ * @defgroup msg_pool Message Pool
+ * @brief Reference-counted incoming messages shared through zbus.
+ *
+ * A received message is decoded once into a fixed-size block from a
+ * k_mem_slab, and the incoming channels carry a pointer to that block
+ * instead of the message itself.  Publishing copies one pointer, and
+ * every consumer reads the same block in place, so a message costs the
+ * same however many modules listen to it.
+ *
+ * Ownership rules:
+ *
+ * - ts_msg_pool_alloc() returns a block holding one reference, owned
+ *   by the caller.
+ * - ts_msg_pool_publish() moves that reference into the channel, which
+ *   keeps its current message alive until the next publish replaces it.
+ * - Listeners read the message with ts_msg_pool_peek(), valid for the
+ *   duration of the callback.  Subscribers and anything that keeps a
+ *   message past its callback take their own reference with
+ *   ts_msg_pool_get() or ts_msg_pool_ref() and drop it with
+ *   ts_msg_pool_unref().
+ *
+ * Messages are read-only once published.
+ * @{
+ */
+
+#include <stddef.h>
+#include <zephyr/kernel.h>
+#include <zephyr/zbus/zbus.h>
+
+#include "messages/messages.h"
+
+/** @brief Number of message blocks in the pool. */
+#define TS_MSG_POOL_BLOCKS CONFIG_TS_MSG_POOL_BLOCKS
+
+/**
+ * @brief Take a free block from the pool.
+ *
+ * Never blocks: the RX thread would rather drop local delivery of one
+ * message than stall the radio behind a slow consumer.
+ *
+ * @return Zeroed message holding one reference, or NULL if the pool is
+ *         exhausted
+ */
+struct ts_msg_lora_incoming* ts_msg_pool_alloc(void);
+
+/**
+ * @brief Take an additional reference to a pooled message.
+ *
+ * @param p_msg  Message from ts_msg_pool_alloc()
+ */
+void ts_msg_pool_ref(const struct ts_msg_lora_incoming* p_msg);
+
+/**
+ * @brief Drop a reference; the block returns to the pool with the last.
+ *
+ * @param p_msg  Message from ts_msg_pool_alloc(), or NULL (ignored)
+ */
+void ts_msg_pool_unref(const struct ts_msg_lora_incoming* p_msg);
+
+/**
+ * @brief Publish a pooled message on a pointer channel.
+ *
+ * The caller's reference moves into the channel whether or not the
+ * publish succeeds; the message the channel held before is released.
+ *
+ * @param chan     Channel whose message type is a message pointer
+ * @param p_msg    Message from ts_msg_pool_alloc()
+ * @param timeout  How long to wait for the channel
+ * @return 0 on success, or the zbus error
+ */
+int ts_msg_pool_publish(const struct zbus_channel* chan,
+                        const struct ts_msg_lora_incoming* p_msg,
+                        k_timeout_t timeout);
+
+/**
+ * @brief Read the message on a pointer channel from a listener.
+ *
+ * @param chan  Channel passed to the listener callback
+ * @return Message, valid until the callback returns
+ */
+const struct ts_msg_lora_incoming* ts_msg_pool_peek(
+    const struct zbus_channel* chan);
+
+/**
+ * @brief Take a reference to the message on a pointer channel.
+ *
+ * For subscribers, which run after the publish returned and may find
+ * the channel already holding a newer message.
+ *
+ * @param chan     Channel to read
+ * @param timeout  How long to wait for the channel
+ * @return Message with a reference owned by the caller, or NULL if the
+ *         channel is empty or busy
+ */
+const struct ts_msg_lora_incoming* ts_msg_pool_get(
+    const struct zbus_channel* chan, k_timeout_t timeout);
+
+/**
+ * @brief Number of blocks currently free.
+ */
+uint32_t ts_msg_pool_num_free(void);
+
+/** @} */
+
+#endif  // TS_MSG_POOL_H
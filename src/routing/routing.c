@@ -16,6 +16,7 @@ static atomic_t next_msg_id;
 static struct {
     uint16_t src;
     uint32_t msg_id;
+    uint8_t ttl;  // TTL of the first copy
 } seen_cache[TS_ROUTING_SEEN_CACHE_SIZE];
 static uint32_t seen_write_idx;
 static uint32_t seen_count;
@@ -48,22 +49,32 @@ bool ts_routing_is_for_us(const struct ts_route_header* p_hdr) {
            p_hdr->dst == TS_ROUTING_BROADCAST_ADDR;
 }
 
-bool ts_routing_is_duplicate(const struct ts_route_header* p_hdr) {
+static int find_seen(const struct ts_route_header* p_hdr) {
     uint32_t entries = (seen_count < TS_ROUTING_SEEN_CACHE_SIZE)
                            ? seen_count
                            : TS_ROUTING_SEEN_CACHE_SIZE;
     for (uint32_t i = 0; i < entries; i++) {
         if (seen_cache[i].src == p_hdr->src &&
             seen_cache[i].msg_id == p_hdr->msg_id) {
-            return true;
+            return (int)i;
         }
     }
-    return false;
+    return -1;
+}
+
+bool ts_routing_is_duplicate(const struct ts_route_header* p_hdr) {
+    return find_seen(p_hdr) >= 0;
+}
+
+bool ts_routing_is_repeat(const struct ts_route_header* p_hdr) {
+    int i = find_seen(p_hdr);
+    return i >= 0 && p_hdr->ttl >= seen_cache[i].ttl;
 }
 
 void ts_routing_mark_seen(const struct ts_route_header* p_hdr) {
     seen_cache[seen_write_idx].src = p_hdr->src;
     seen_cache[seen_write_idx].msg_id = p_hdr->msg_id;
+    seen_cache[seen_write_idx].ttl = p_hdr->ttl;
     seen_write_idx = (seen_write_idx + 1) % TS_ROUTING_SEEN_CACHE_SIZE;
     seen_count++;
 }
@@ -26,6 +26,7 @@ struct ts_route_header {
     uint32_t msg_id;
     uint8_t ttl;
     uint8_t key_id;
+    int8_t tx_power;  // Power this hop was sent at (dBm), set by the sender
 };
 
 /**
@@ -79,6 +80,20 @@ bool ts_routing_is_for_us(const struct ts_route_header* p_hdr);
  */
 bool ts_routing_is_duplicate(const struct ts_route_header* p_hdr);
 
+/**
+ * @brief Check if a duplicate was sent again by a hop no further from
+ *        the source than the one it first came from.
+ *
+ * Forwards of a frame lose one TTL per hop, so a copy whose TTL is not
+ * lower than the first copy's is a retransmission from upstream rather
+ * than a downstream node forwarding it.
+ *
+ * @param p_hdr  Routing header of the duplicate
+ * @return true if the pair is in the seen cache with a TTL of at most
+ *         @p p_hdr's
+ */
+bool ts_routing_is_repeat(const struct ts_route_header* p_hdr);
+
 /**
  * @brief Record a message in the duplicate detection cache.
  *
@@ -52,7 +52,7 @@ void ts_routing_table_init(void) {
 }
 
 int ts_routing_table_update(uint16_t node_id, int16_t rssi, int8_t snr,
-                            uint8_t ttl) {
+                            int8_t tx_power, uint8_t ttl) {
     uint32_t now = (uint32_t)k_uptime_seconds();
     bool is_direct = (ttl == TS_ROUTING_DEFAULT_TTL);
 
@@ -62,6 +62,7 @@ int ts_routing_table_update(uint16_t node_id, int16_t rssi, int8_t snr,
     if (entry != NULL) {
         entry->rssi = rssi;
         entry->snr = snr;
+        entry->tx_power = tx_power;
         entry->last_seen = now;
         // Never downgrade direct flag
         if (is_direct) { entry->direct = true; }
@@ -78,6 +79,7 @@ int ts_routing_table_update(uint16_t node_id, int16_t rssi, int8_t snr,
     entry->node_id = node_id;
     entry->rssi = rssi;
     entry->snr = snr;
+    entry->tx_power = tx_power;
     entry->direct = is_direct;
     entry->last_seen = now;
     entry->occupied = true;
@@ -123,3 +125,13 @@ uint32_t ts_routing_table_count(void) {
     k_mutex_unlock(&table_mutex);
     return count;
 }
+
+size_t ts_routing_table_snapshot(struct ts_neighbor* p_out, size_t max) {
+    size_t n = 0;
+    k_mutex_lock(&table_mutex, K_FOREVER);
+    for (int i = 0; i < TS_ROUTING_TABLE_SIZE && n < max; i++) {
+        if (table[i].occupied) { p_out[n++] = table[i]; }
+    }
+    k_mutex_unlock(&table_mutex);
+    return n;
+}
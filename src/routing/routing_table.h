@@ -8,6 +8,7 @@
  */
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 /** @brief Maximum number of neighbors tracked. */
@@ -21,6 +22,7 @@ struct ts_neighbor {
     uint16_t node_id;
     int16_t rssi;
     int8_t snr;
+    int8_t tx_power;  // Power the neighbor sent at (dBm)
     bool direct;
     uint32_t last_seen;
     bool occupied;
@@ -34,17 +36,18 @@ void ts_routing_table_init(void);
 /**
  * @brief Insert or update a neighbor entry.
  *
- * If the node is already in the table, updates RSSI, SNR, and timestamp.
- * If the table is full, evicts the oldest entry.
+ * If the node is already in the table, updates RSSI, SNR, TX power and
+ * timestamp.  If the table is full, evicts the oldest entry.
  *
- * @param node_id  Neighbor's node ID
- * @param rssi     Received signal strength (dBm)
- * @param snr      Signal-to-noise ratio (dB)
- * @param ttl      Received packet's TTL (used to infer direct neighbor)
+ * @param node_id   Neighbor's node ID
+ * @param rssi      Received signal strength (dBm)
+ * @param snr       Signal-to-noise ratio (dB)
+ * @param tx_power  Power the packet was sent at, from its header (dBm)
+ * @param ttl       Received packet's TTL (used to infer direct neighbor)
  * @return 0 on success
  */
 int ts_routing_table_update(uint16_t node_id, int16_t rssi, int8_t snr,
-                            uint8_t ttl);
+                            int8_t tx_power, uint8_t ttl);
 
 /**
  * @brief Look up a neighbor by node ID.
@@ -72,6 +75,18 @@ int ts_routing_table_age_seconds(uint32_t max_age_s);
  */
 uint32_t ts_routing_table_count(void);
 
+/**
+ * @brief Copy all occupied entries into a caller-provided array.
+ *
+ * Entries are copied under the table lock so callers can evaluate
+ * the whole neighborhood without holding it.
+ *
+ * @param p_out  Output array
+ * @param max    Capacity of p_out in entries
+ * @return Number of entries copied
+ */
+size_t ts_routing_table_snapshot(struct ts_neighbor* p_out, size_t max);
+
 /** @} */
 
 #endif  // TS_ROUTING_TABLE_H
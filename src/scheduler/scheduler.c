@@ -0,0 +1,148 @@
+#include "scheduler/scheduler.h"
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/util.h>
+
+LOG_MODULE_REGISTER(scheduler);
+
+// Covers the job list and every job's state.  Jobs run with it held,
+// so a stats read waits for the wakeup in progress to finish.
+static K_MUTEX_DEFINE(sched_mutex);
+static struct ts_sched_job* jobs[TS_SCHED_MAX_JOBS];
+static size_t job_count;
+static uint32_t wakeups;
+static bool started;
+
+static void sched_work_handler(struct k_work* work);
+static K_WORK_DELAYABLE_DEFINE(sched_work, sched_work_handler);
+
+static uint32_t job_interval(const struct ts_sched_job* p_job) {
+    return MAX(*p_job->p_interval_s, 1);
+}
+
+static void run_job(struct ts_sched_job* p_job, uint32_t now_s,
+                    bool coalesced) {
+    struct ts_sched_job_stats* st = &p_job->stats;
+    uint32_t due = p_job->due;
+
+    uint32_t start = k_cycle_get_32();
+    uint32_t next_in = p_job->run();
+    uint32_t run_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+    st->runs++;
+    if (coalesced) { st->coalesced++; }
+    if (now_s < due) {
+        st->max_early_s = MAX(st->max_early_s, due - now_s);
+    } else {
+        st->max_late_s = MAX(st->max_late_s, now_s - due);
+    }
+    st->last_run_us = run_us;
+    st->max_run_us = MAX(st->max_run_us, run_us);
+    st->total_run_us += run_us;
+
+    // Keep the job's phase unless it asked for a time itself.  Runs
+    // missed altogether (e.g. a long stall) are skipped, not caught up.
+    if (next_in > 0) {
+        p_job->due = now_s + next_in;
+    } else {
+        p_job->due = due + job_interval(p_job);
+        if (p_job->due <= now_s) { p_job->due = now_s + job_interval(p_job); }
+    }
+}
+
+static void sched_work_handler(struct k_work* work) {
+    uint32_t wait_s = ts_sched_run_due((uint32_t)k_uptime_seconds());
+
+    if (wait_s != UINT32_MAX) {
+        k_work_schedule(&sched_work, K_SECONDS(wait_s));
+    }
+}
+
+void ts_sched_init(void) {
+    k_work_cancel_delayable(&sched_work);
+    k_mutex_lock(&sched_mutex, K_FOREVER);
+    memset(jobs, 0, sizeof(jobs));
+    job_count = 0;
+    wakeups = 0;
+    started = false;
+    k_mutex_unlock(&sched_mutex);
+}
+
+int ts_sched_add(struct ts_sched_job* p_job, uint32_t first_s) {
+    int ret = 0;
+
+    if (p_job->run == NULL || p_job->p_interval_s == NULL) { return -EINVAL; }
+
+    k_mutex_lock(&sched_mutex, K_FOREVER);
+    for (size_t i = 0; i < job_count; i++) {
+        if (jobs[i] == p_job) { ret = -EEXIST; }
+    }
+    if (ret == 0 && job_count == TS_SCHED_MAX_JOBS) { ret = -ENOMEM; }
+    if (ret == 0) {
+        p_job->due = first_s;
+        memset(&p_job->stats, 0, sizeof(p_job->stats));
+        jobs[job_count++] = p_job;
+    }
+    k_mutex_unlock(&sched_mutex);
+
+    if (ret == 0 && started) {
+        // Replan: the new job may be due before the pending wakeup
+        k_work_reschedule(&sched_work, K_NO_WAIT);
+    }
+    return ret;
+}
+
+void ts_sched_start(void) {
+    k_mutex_lock(&sched_mutex, K_FOREVER);
+    started = true;
+    k_mutex_unlock(&sched_mutex);
+    k_work_reschedule(&sched_work, K_NO_WAIT);
+}
+
+uint32_t ts_sched_run_due(uint32_t now_s) {
+    uint32_t next = UINT32_MAX;
+    size_t ran = 0;
+    bool run[TS_SCHED_MAX_JOBS];
+
+    k_mutex_lock(&sched_mutex, K_FOREVER);
+
+    // Decide first, so that jobs whose window opens during this
+    // wakeup's runs are left to the next one
+    for (size_t i = 0; i < job_count; i++) {
+        run[i] = jobs[i]->due <= now_s + jobs[i]->tolerance_s;
+        if (run[i]) { ran++; }
+    }
+    for (size_t i = 0; i < job_count; i++) {
+        if (run[i]) { run_job(jobs[i], now_s, ran > 1); }
+    }
+    if (ran > 0) {
+        wakeups++;
+        LOG_DBG("Wakeup at %u ran %u jobs", now_s, (unsigned)ran);
+    }
+
+    // Wake when the least patient job can wait no longer
+    for (size_t i = 0; i < job_count; i++) {
+        uint32_t latest = jobs[i]->due + jobs[i]->tolerance_s;
+        next = MIN(next, latest > now_s ? latest - now_s : 1);
+    }
+
+    k_mutex_unlock(&sched_mutex);
+    return next;
+}
+
+void ts_sched_get_stats(const struct ts_sched_job* p_job,
+                        struct ts_sched_job_stats* p_stats) {
+    k_mutex_lock(&sched_mutex, K_FOREVER);
+    *p_stats = p_job->stats;
+    k_mutex_unlock(&sched_mutex);
+}
+
+uint32_t ts_sched_get_wakeups(void) {
+    k_mutex_lock(&sched_mutex, K_FOREVER);
+    uint32_t n = wakeups;
+    k_mutex_unlock(&sched_mutex);
+    return n;
+}
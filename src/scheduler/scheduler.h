@@ -0,0 +1,114 @@
+#ifndef TS_SCHEDULER_H
+#define TS_SCHEDULER_H
+
+/**
+ * @defgroup scheduler Periodic Scheduler
+ * @brief One wakeup source for all periodic jobs, with coalescing.
+ *
+ * Periodic jobs (sensor polling, heartbeat, neighbor-table aging) run
+ * from a single delayable work item on the system work queue instead
+ * of one timer each.  Every job has an interval, read from the live
+ * config on each run, and a tolerance: how far it may run before or
+ * after its due time.
+ *
+ * Each wakeup is placed at the latest time the most urgent job can
+ * still run (its due time plus tolerance), and runs every job whose
+ * tolerance window has opened by then.  Jobs with some slack thus
+ * move onto the wakeups of stricter ones, instead of waking the CPU
+ * and radio at their own, independently drifting phases.  A job keeps
+ * its nominal phase: its next due time is one interval after the last
+ * due time, not after the moment it happened to run.
+ * @{
+ */
+
+#include <stdint.h>
+
+/** @brief Most jobs the scheduler holds. */
+#define TS_SCHED_MAX_JOBS 8
+
+/**
+ * @brief Job body, run on the system work queue.
+ *
+ * @return Seconds until the job wants to run next, or 0 to run again
+ *         one interval after this run's due time
+ */
+typedef uint32_t (*ts_sched_fn_t)(void);
+
+/** @brief Run-time counters of one job. */
+struct ts_sched_job_stats {
+    uint32_t runs;         /**< Times the job ran */
+    uint32_t coalesced;    /**< Runs that shared a wakeup with another job */
+    uint32_t max_early_s;  /**< Furthest ahead of its due time it ran */
+    uint32_t max_late_s;   /**< Furthest behind its due time it ran */
+    uint32_t last_run_us;  /**< Duration of the last run */
+    uint32_t max_run_us;   /**< Longest run */
+    uint64_t total_run_us; /**< Sum of all runs */
+};
+
+/** @brief A periodic job.  Owned by the caller; must outlive the scheduler. */
+struct ts_sched_job {
+    const char* name;
+    ts_sched_fn_t run;
+    const uint32_t* p_interval_s; /**< Interval, e.g. a ts_config field */
+    uint32_t tolerance_s;         /**< Allowed distance from the due time */
+
+    /* Scheduler state, not to be set by the caller */
+    uint32_t due;
+    struct ts_sched_job_stats stats;
+};
+
+/**
+ * @brief Remove all jobs and reset the wakeup counter.
+ *
+ * Cancels a pending wakeup; call ts_sched_start() again afterwards.
+ */
+void ts_sched_init(void);
+
+/**
+ * @brief Add a job.
+ *
+ * @param p_job    Job with run and p_interval_s set
+ * @param first_s  Uptime in seconds at which it is first due
+ * @return 0 on success, -EINVAL if run or p_interval_s is missing,
+ *         -EEXIST if the job was already added, -ENOMEM if
+ *         TS_SCHED_MAX_JOBS are registered
+ */
+int ts_sched_add(struct ts_sched_job* p_job, uint32_t first_s);
+
+/**
+ * @brief Start running jobs from the system work queue.
+ *
+ * Jobs added later are picked up at the following wakeup.
+ */
+void ts_sched_start(void);
+
+/**
+ * @brief Run every job that may run now.
+ *
+ * Called by the scheduler's work item; exposed for testing.
+ *
+ * @param now_s  Current uptime in seconds
+ * @return Seconds until the next wakeup, at least 1, or UINT32_MAX
+ *         without jobs
+ */
+uint32_t ts_sched_run_due(uint32_t now_s);
+
+/**
+ * @brief Read a job's counters.
+ *
+ * @param p_job    Registered job
+ * @param p_stats  Output
+ */
+void ts_sched_get_stats(const struct ts_sched_job* p_job,
+                        struct ts_sched_job_stats* p_stats);
+
+/**
+ * @brief Number of wakeups that ran at least one job since init.
+ *
+ * @return Wakeup count
+ */
+uint32_t ts_sched_get_wakeups(void);
+
+/** @} */
+
+#endif  // TS_SCHEDULER_H
@@ -0,0 +1,55 @@
+#include "sensors/bme280_profile.h"
+
+#include <stddef.h>
+
+static const struct ts_bme280_profile_desc
+    profiles[TS_BME280_PROFILE_COUNT] = {
+        [TS_BME280_PROFILE_ULTRA_LOW_POWER] = {.name = "ultra-low-power",
+                                               .osr_temperature = 1,
+                                               .osr_pressure = 1,
+                                               .osr_humidity = 1,
+                                               .iir_filter = 0},
+        [TS_BME280_PROFILE_STANDARD] = {.name = "standard",
+                                        .osr_temperature = 2,
+                                        .osr_pressure = 4,
+                                        .osr_humidity = 1,
+                                        .iir_filter = 4},
+        [TS_BME280_PROFILE_HIGH_RESOLUTION] = {.name = "high-resolution",
+                                               .osr_temperature = 2,
+                                               .osr_pressure = 16,
+                                               .osr_humidity = 1,
+                                               .iir_filter = 16},
+};
+
+// Datasheet timings in microseconds
+#define T_MEASURE_BASE_US 1250
+#define T_SAMPLE_US 2300
+#define T_CHANNEL_SETUP_US 575
+
+const struct ts_bme280_profile_desc* ts_bme280_profile_get(
+    enum ts_bme280_profile profile) {
+    if (profile < 0 || profile >= TS_BME280_PROFILE_COUNT) { return NULL; }
+    return &profiles[profile];
+}
+
+enum ts_bme280_profile ts_bme280_profile_find(
+    const struct ts_bme280_profile_desc* p_settings) {
+    for (int i = 0; i < TS_BME280_PROFILE_COUNT; i++) {
+        const struct ts_bme280_profile_desc* desc = &profiles[i];
+
+        if (desc->osr_temperature == p_settings->osr_temperature &&
+            desc->osr_pressure == p_settings->osr_pressure &&
+            desc->osr_humidity == p_settings->osr_humidity &&
+            desc->iir_filter == p_settings->iir_filter) {
+            return (enum ts_bme280_profile)i;
+        }
+    }
+    return TS_BME280_PROFILE_COUNT;
+}
+
+uint32_t ts_bme280_profile_max_conversion_us(
+    const struct ts_bme280_profile_desc* p_desc) {
+    return T_MEASURE_BASE_US + T_SAMPLE_US * p_desc->osr_temperature +
+           T_SAMPLE_US * p_desc->osr_pressure + T_CHANNEL_SETUP_US +
+           T_SAMPLE_US * p_desc->osr_humidity + T_CHANNEL_SETUP_US;
+}
@@ -0,0 +1,76 @@
+#ifndef TS_BME280_PROFILE_H
+#define TS_BME280_PROFILE_H
+
+/**
+ * @defgroup bme280_profile BME280 Sampling Profiles
+ * @brief Oversampling and IIR filter settings traded against energy.
+ *
+ * Every BME280 measurement is a forced-mode conversion: the sensor
+ * wakes, converts each enabled channel as many times as its
+ * oversampling setting asks, and goes back to sleep.  Conversion time,
+ * and with it the current drawn, grows linearly with the oversampling
+ * (datasheet section 9.1), while noise falls with its square root.  The
+ * IIR filter smooths pressure and temperature over successive
+ * measurements at no conversion cost but slows the response to real
+ * changes.
+ *
+ * The profiles follow the datasheet's recommended modes of operation
+ * (section 3.5): ultra-low-power is its weather-monitoring setting,
+ * standard trades some energy for less pressure noise, and
+ * high-resolution is the indoor-navigation setting.
+ * @{
+ */
+
+#include <stdint.h>
+
+/** @brief Sampling profiles, as stored in ts/sensor_profile. */
+enum ts_bme280_profile {
+    TS_BME280_PROFILE_ULTRA_LOW_POWER,
+    TS_BME280_PROFILE_STANDARD,
+    TS_BME280_PROFILE_HIGH_RESOLUTION,
+    TS_BME280_PROFILE_COUNT,
+};
+
+/** @brief Settings of one profile. */
+struct ts_bme280_profile_desc {
+    const char* name;
+    uint8_t osr_temperature; /**< Oversampling: 1, 2, 4, 8 or 16 */
+    uint8_t osr_pressure;
+    uint8_t osr_humidity;
+    uint8_t iir_filter; /**< IIR coefficient: 0 (off), 2, 4, 8 or 16 */
+};
+
+/**
+ * @brief Look up a profile's settings.
+ *
+ * @param profile  Profile to look up
+ * @return Settings, or NULL for an unknown profile
+ */
+const struct ts_bme280_profile_desc* ts_bme280_profile_get(
+    enum ts_bme280_profile profile);
+
+/**
+ * @brief Find the profile with exactly these settings.
+ *
+ * @param p_settings  Oversampling and filter settings; name is ignored
+ * @return Matching profile, or TS_BME280_PROFILE_COUNT if none matches
+ */
+enum ts_bme280_profile ts_bme280_profile_find(
+    const struct ts_bme280_profile_desc* p_settings);
+
+/**
+ * @brief Longest a forced-mode conversion with these settings takes.
+ *
+ * The datasheet's maximum measurement time (appendix B):
+ * 1.25 ms + 2.3 ms per temperature sample, plus 2.3 ms per pressure
+ * and per humidity sample and 0.575 ms for each of those two channels.
+ *
+ * @param p_desc  Profile settings
+ * @return Conversion time in microseconds
+ */
+uint32_t ts_bme280_profile_max_conversion_us(
+    const struct ts_bme280_profile_desc* p_desc);
+
+/** @} */
+
+#endif  // TS_BME280_PROFILE_H
@@ -6,18 +6,54 @@
  * @{
  */
 
-#include "messages/messages.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "sensors/bme280_profile.h"
 
 /**
- * @brief Read sensor data into a telemetry message.
+ * @brief Register the build's sensor source with the sensor registry.
+ *
+ * Each backend (BME280, mock) provides its own implementation and
+ * source; the active backend is selected at build time via
+ * CMake/devicetree.  Both measure the temperature, humidity and
+ * pressure channels (IDs 0–2, see sensor_registry.h) asynchronously:
+ * the completion runs in the backend's own context.
  *
- * Each backend (BME280, mock) provides its own implementation.
- * The active backend is selected at build time via CMake/devicetree.
+ * @return 0 on success, negative errno from ts_sensor_registry_add()
+ */
+int ts_sensor_backend_register(void);
+
+/** @brief Measurement timing since boot. */
+struct ts_sensor_backend_timing {
+    uint8_t profile;      /**< Profile in use, or TS_BME280_PROFILE_COUNT */
+    bool applied;         /**< The requested profile is the one in use */
+    uint32_t expected_us; /**< Datasheet maximum for the settings in use */
+    uint32_t last_us;     /**< Start to completion, last measurement */
+    uint32_t max_us;      /**< Longest measurement seen */
+    uint32_t count;       /**< Measurements completed */
+};
+
+/**
+ * @brief Select the sampling profile for the following measurements.
+ *
+ * The BME280 backend cannot switch profiles: the driver takes its
+ * oversampling and filter from the CONFIG_BME280_* options at build
+ * time, and only the profile those match is accepted.  The mock
+ * backend reports whichever profile was asked for.
+ *
+ * @param profile  Profile to use
+ * @return 0 on success, -EINVAL for an unknown profile, -ENOTSUP if
+ *         the backend is built for another one
+ */
+int ts_sensor_backend_set_profile(enum ts_bme280_profile profile);
+
+/**
+ * @brief Read the measurement timing.
  *
- * @param p_tel  Output telemetry struct to populate
- * @return 0 on success, negative errno on failure
+ * @param p_timing  Output
  */
-int ts_sensor_backend_read(struct ts_msg_telemetry* p_tel);
+void ts_sensor_backend_get_timing(struct ts_sensor_backend_timing* p_timing);
 
 /** @} */
 
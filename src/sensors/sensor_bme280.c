@@ -2,39 +2,223 @@
 #include <zephyr/devicetree.h>
 #include <zephyr/drivers/sensor.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/rtio/rtio.h>
+#include <zephyr/sys/atomic.h>
 
+#include "sensors/bme280_profile.h"
 #include "sensors/sensor_backend.h"
+#include "sensors/sensor_registry.h"
 
 LOG_MODULE_REGISTER(sensor_bme280);
 
-static const struct device* const bme280 =
-    DEVICE_DT_GET(DT_COMPAT_GET_ANY_STATUS_OKAY(bosch_bme280));
+#define BME280_NODE DT_COMPAT_GET_ANY_STATUS_OKAY(bosch_bme280)
 
-int ts_sensor_backend_read(struct ts_msg_telemetry* p_tel) {
-    struct sensor_value val;
+#define BME280_THREAD_STACK_SIZE 1024
+#define BME280_THREAD_PRIORITY 5
 
+// Oversampling and filter are the driver's CONFIG_BME280_* choices,
+// written to the device when it is initialized.  The upstream driver
+// has no attributes to change them, so the profile is fixed at build
+// time and ts/sensor_profile can only confirm it.
+#define BUILD_OSR(ch)                                \
+    (IS_ENABLED(CONFIG_BME280_##ch##_OVER_16X)  ? 16 \
+     : IS_ENABLED(CONFIG_BME280_##ch##_OVER_8X) ? 8  \
+     : IS_ENABLED(CONFIG_BME280_##ch##_OVER_4X) ? 4  \
+     : IS_ENABLED(CONFIG_BME280_##ch##_OVER_2X) ? 2  \
+                                                : 1)
+#define BUILD_FILTER                           \
+    (IS_ENABLED(CONFIG_BME280_FILTER_16)  ? 16 \
+     : IS_ENABLED(CONFIG_BME280_FILTER_8) ? 8  \
+     : IS_ENABLED(CONFIG_BME280_FILTER_4) ? 4  \
+     : IS_ENABLED(CONFIG_BME280_FILTER_2) ? 2  \
+                                          : 0)
+
+static const struct ts_bme280_profile_desc build_settings = {
+    .name = "build",
+    .osr_temperature = BUILD_OSR(TEMP),
+    .osr_pressure = BUILD_OSR(PRESS),
+    .osr_humidity = BUILD_OSR(HUMIDITY),
+    .iir_filter = BUILD_FILTER,
+};
+
+static const struct device* const bme280 = DEVICE_DT_GET(BME280_NODE);
+
+// One read of all three channels at a time, into a single pool block
+// sized for the driver's encoded sample
+SENSOR_DT_READ_IODEV(bme280_iodev, BME280_NODE,
+                     {SENSOR_CHAN_AMBIENT_TEMP, 0}, {SENSOR_CHAN_HUMIDITY, 0},
+                     {SENSOR_CHAN_PRESS, 0});
+RTIO_DEFINE_WITH_MEMPOOL(bme280_rtio, 1, 1, 1, 64, sizeof(void*));
+
+static const struct ts_sensor_channel bme280_channels[] = {
+    TS_SENSOR_TELEMETRY_CHANNEL(TEMPERATURE, "temperature"),
+    TS_SENSOR_TELEMETRY_CHANNEL(HUMIDITY, "humidity"),
+    TS_SENSOR_TELEMETRY_CHANNEL(PRESSURE, "pressure"),
+};
+
+static int bme280_start(uint32_t mask, ts_sensor_source_cb_t cb);
+
+static const struct ts_sensor_source bme280_source = {
+    .name = "bme280",
+    .channels = bme280_channels,
+    .channel_count = ARRAY_SIZE(bme280_channels),
+    .start = bme280_start,
+};
+
+// The device converts all three channels in one measurement, so every
+// start reads them all; the mask only says which ones were due
+static atomic_t busy;
+static ts_sensor_source_cb_t done_cb;
+static uint32_t done_mask;
+static uint32_t start_cycles;
+
+// Last profile asked for, -1 before the first request
+static int requested_profile = -1;
+
+// Written on completion, read from anywhere
+static K_MUTEX_DEFINE(timing_mutex);
+static struct ts_sensor_backend_timing timing;
+
+// q31 sample (value * 2^shift / 2^31, in the channel's SI unit) as a
+// fixed-point value with scale steps per unit, truncated toward zero
+static int32_t q31_to_fixed(q31_t value, int8_t shift, int32_t scale) {
+    int64_t scaled = (int64_t)value * scale;
+
+    if (shift >= 0) { return (int32_t)(scaled * (1LL << shift) / (1LL << 31)); }
+    return (int32_t)(scaled / (1LL << (31 - shift)));
+}
+
+static int decode_channel(const struct sensor_decoder_api* decoder,
+                          const uint8_t* p_buf, enum sensor_channel chan,
+                          int32_t scale, int32_t* p_out) {
+    struct sensor_q31_data data = {0};
+    uint32_t fit = 0;
+
+    int ret = decoder->decode(p_buf, (struct sensor_chan_spec){chan, 0}, &fit,
+                              1, &data);
+    if (ret <= 0) { return ret < 0 ? ret : -ENODATA; }
+    *p_out = q31_to_fixed(data.readings[0].value, data.shift, scale);
+    return 0;
+}
+
+static int decode(const uint8_t* p_buf,
+                  int32_t values[TS_TELEMETRY_CHANNEL_COUNT]) {
+    const struct sensor_decoder_api* decoder;
+
+    int ret = sensor_get_decoder(bme280, &decoder);
+    if (ret != 0) { return ret; }
+
+    // Temperature in centi-degrees C (e.g. 2512 = 25.12 °C)
+    ret = decode_channel(decoder, p_buf, SENSOR_CHAN_AMBIENT_TEMP, 100,
+                         &values[TS_TELEMETRY_TEMPERATURE]);
+    // Humidity in centi-percent RH (e.g. 6543 = 65.43 %RH)
+    if (ret == 0) {
+        ret = decode_channel(decoder, p_buf, SENSOR_CHAN_HUMIDITY, 100,
+                             &values[TS_TELEMETRY_HUMIDITY]);
+    }
+    // Pressure in Pa; the driver reports kPa
+    if (ret == 0) {
+        ret = decode_channel(decoder, p_buf, SENSOR_CHAN_PRESS, 1000,
+                             &values[TS_TELEMETRY_PRESSURE]);
+    }
+    return ret;
+}
+
+static void read_done(int result, uint8_t* p_buf, uint32_t buf_len,
+                      void* p_userdata) {
+    int32_t values[TS_TELEMETRY_CHANNEL_COUNT] = {0};
+    ts_sensor_source_cb_t cb = done_cb;
+    uint32_t mask = done_mask;
+    uint32_t elapsed_us =
+        k_cyc_to_us_floor32(k_cycle_get_32() - start_cycles);
+
+    ARG_UNUSED(buf_len);
+    ARG_UNUSED(p_userdata);
+
+    if (result == 0) { result = decode(p_buf, values); }
+    if (result != 0) {
+        LOG_ERR("BME280 read failed: %d", result);
+    } else {
+        k_mutex_lock(&timing_mutex, K_FOREVER);
+        timing.last_us = elapsed_us;
+        timing.max_us = MAX(timing.max_us, elapsed_us);
+        timing.count++;
+        k_mutex_unlock(&timing_mutex);
+        LOG_DBG("BME280 measurement took %u us", elapsed_us);
+    }
+
+    // Free for the next measurement before handing this one over
+    atomic_clear(&busy);
+    cb(&bme280_source, result, mask, values);
+}
+
+// Waits for completions so that neither the caller nor the system work
+// queue has to sit through the I2C transfer and conversion time
+static void bme280_task(void* p1, void* p2, void* p3) {
+    while (true) {
+        sensor_processing_with_callback(&bme280_rtio, read_done);
+    }
+}
+
+K_THREAD_DEFINE(bme280_tid, BME280_THREAD_STACK_SIZE, bme280_task, NULL, NULL,
+                NULL, BME280_THREAD_PRIORITY, 0, 0);
+
+static int bme280_start(uint32_t mask, ts_sensor_source_cb_t cb) {
     if (!device_is_ready(bme280)) {
         LOG_ERR("BME280 device not ready");
         return -ENODEV;
     }
+    if (!atomic_cas(&busy, 0, 1)) { return -EBUSY; }
 
-    int ret = sensor_sample_fetch(bme280);
+    done_cb = cb;
+    done_mask = mask;
+    start_cycles = k_cycle_get_32();
+    int ret = sensor_read_async_mempool(&bme280_iodev, &bme280_rtio, NULL);
     if (ret != 0) {
-        LOG_ERR("BME280 sample fetch failed: %d", ret);
-        return ret;
+        LOG_ERR("BME280 read submit failed: %d", ret);
+        atomic_clear(&busy);
     }
+    return ret;
+}
 
-    // Temperature in centi-degrees C (e.g. 2512 = 25.12 °C)
-    sensor_channel_get(bme280, SENSOR_CHAN_AMBIENT_TEMP, &val);
-    p_tel->temperature = (uint32_t)(val.val1 * 100 + val.val2 / 10000);
+int ts_sensor_backend_register(void) {
+    enum ts_bme280_profile built = ts_bme280_profile_find(&build_settings);
+    const struct ts_bme280_profile_desc* desc = ts_bme280_profile_get(built);
 
-    // Humidity in centi-percent RH (e.g. 6543 = 65.43 %RH)
-    sensor_channel_get(bme280, SENSOR_CHAN_HUMIDITY, &val);
-    p_tel->humidity = (uint32_t)(val.val1 * 100 + val.val2 / 10000);
+    LOG_INF("BME280 built for %s (T/P/H x%u/%u/%u, filter %u)",
+            desc != NULL ? desc->name : "no profile",
+            build_settings.osr_temperature, build_settings.osr_pressure,
+            build_settings.osr_humidity, build_settings.iir_filter);
 
-    // Pressure in Pa (e.g. 101325 = 1013.25 hPa)
-    sensor_channel_get(bme280, SENSOR_CHAN_PRESS, &val);
-    p_tel->pressure = (uint32_t)(val.val1 * 1000 + val.val2 / 1000);
+    k_mutex_lock(&timing_mutex, K_FOREVER);
+    timing.profile = (uint8_t)built;
+    timing.expected_us = ts_bme280_profile_max_conversion_us(&build_settings);
+    k_mutex_unlock(&timing_mutex);
+    return ts_sensor_registry_add(&bme280_source);
+}
 
-    return 0;
+int ts_sensor_backend_set_profile(enum ts_bme280_profile profile) {
+    const struct ts_bme280_profile_desc* desc = ts_bme280_profile_get(profile);
+
+    if (desc == NULL) { return -EINVAL; }
+
+    k_mutex_lock(&timing_mutex, K_FOREVER);
+    bool changed = (int)profile != requested_profile;
+    bool applied = profile == timing.profile;
+    requested_profile = (int)profile;
+    timing.applied = applied;
+    k_mutex_unlock(&timing_mutex);
+
+    // Polled with the live config: warn once per change, not per poll
+    if (changed && !applied) {
+        LOG_WRN("BME280 profile is set at build time, %s not applied",
+                desc->name);
+    }
+    return applied ? 0 : -ENOTSUP;
+}
+
+void ts_sensor_backend_get_timing(struct ts_sensor_backend_timing* p_timing) {
+    k_mutex_lock(&timing_mutex, K_FOREVER);
+    *p_timing = timing;
+    k_mutex_unlock(&timing_mutex);
 }
@@ -1,33 +1,397 @@
 #include "sensor_manager.h"
 
+#include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/zbus/zbus.h>
 
+#include "config/config.h"
 #include "logging/logging.h"
+#include "lora/airtime.h"
+#include "lora/radio.h"
 #include "routing/routing.h"
+#include "routing/routing_table.h"
 #include "sensors/sensor_backend.h"
+#include "sensors/sensor_registry.h"
+#include "sensors/telemetry_batch.h"
+#include "sensors/telemetry_delta.h"
+#include "sensors/telemetry_predict.h"
+#include "sensors/telemetry_range.h"
+#include "sensors/telemetry_store.h"
+#include "sensors/telemetry_window.h"
 
 LOG_MODULE_REGISTER(sensor);
 
 extern struct zbus_channel ts_lora_out_chan;
 
-void periodic_work_handler(const struct zbus_channel* chan) {
+// Limits the current batch was started with; 0 until the first batch
+static uint8_t batch_size;
+static uint32_t batch_latency_s;
+
+// Delta coding state; keyframe_interval 0 until the first coded reading
+static struct ts_delta_encoder delta_encoder;
+
+// Summary window and what was last reported; empty while windows are
+// off
+static struct ts_telemetry_window window;
+static struct ts_telemetry_deadband deadband;
+
+// Shared-model state; restarted with a resync whenever prediction is
+// switched on
+static struct ts_predict_encoder predict_encoder;
+static bool predicting;
+
+// Measurements complete in the sensor sources' contexts.  Samples are
+// queued and processed on the system work queue, where all the state
+// above lives, so that queue never waits for sensor I/O.
+K_MSGQ_DEFINE(sample_q, sizeof(struct ts_msg_sensor_values), 4, 4);
+static void sample_work_handler(struct k_work* work);
+static K_WORK_DEFINE(sample_work, sample_work_handler);
+
+static void publish_batch(void);
+
+// Sends whatever is buffered once the oldest reading reaches the
+// maximum latency, even if no further reading arrives to trigger it.
+static void batch_flush_handler(struct k_work* work) { publish_batch(); }
+static K_WORK_DELAYABLE_DEFINE(batch_flush_work, batch_flush_handler);
+
+static void publish_batch(void) {
+    struct ts_msg_lora_outgoing out_msg = {.type = TS_MSG_TELEMETRY_BATCH};
+
+    k_work_cancel_delayable(&batch_flush_work);
+    if (ts_telemetry_batch_take(&out_msg.data.telemetry_batch) != 0) {
+        return;
+    }
+    ts_routing_prepare_header(&out_msg.route, TS_ROUTING_BROADCAST_ADDR);
+
+    LOG_DBG("Sending telemetry batch: base=%u, count=%u",
+            out_msg.data.telemetry_batch.base_timestamp,
+            out_msg.data.telemetry_batch.count);
+
+    int ret = zbus_chan_pub(&ts_lora_out_chan, &out_msg, K_MSEC(200));
+    log_chan_pub_ret(ret);
+}
+
+// Batch limits follow the live config.  A change takes effect with the
+// next reading, after anything buffered under the old limits is sent.
+static void apply_batch_config(const struct ts_config* p_cfg) {
+    if (p_cfg->telemetry_batch_size == batch_size &&
+        p_cfg->telemetry_max_latency_s == batch_latency_s) {
+        return;
+    }
+    publish_batch();
+    if (ts_telemetry_batch_init(p_cfg->telemetry_batch_size,
+                                p_cfg->telemetry_max_latency_s) == 0) {
+        batch_size = p_cfg->telemetry_batch_size;
+        batch_latency_s = p_cfg->telemetry_max_latency_s;
+    }
+}
+
+static void batch_reading(const struct ts_msg_telemetry* p_reading) {
+    int ret = ts_telemetry_batch_add(p_reading);
+    if (ret == -EAGAIN) {
+        publish_batch();
+        ret = ts_telemetry_batch_add(p_reading);
+    }
+
+    if (ret == 1) {
+        publish_batch();
+    } else if (ret == 0 && ts_telemetry_batch_count() == 1) {
+        k_work_schedule(&batch_flush_work, K_SECONDS(batch_latency_s));
+    }
+}
+
+#if defined(CONFIG_TS_TELEMETRY_STORE)
+// Size assumed for a drained batch frame (8 samples as CBOR plus auth
+// tag) when pacing the drain
+#define STORE_DRAIN_FRAME_LEN 160
+
+// How often a node without neighbors checks whether it can drain
+#define STORE_LINK_CHECK_INTERVAL K_SECONDS(30)
+
+static void store_drain_handler(struct k_work* work);
+static K_WORK_DELAYABLE_DEFINE(store_drain_work, store_drain_handler);
+
+// The drain reads and pops flash blocks, so it runs on the store's work
+// queue rather than the system one
+static void schedule_store_drain(k_timeout_t delay) {
+    k_work_schedule_for_queue(ts_telemetry_store_work_queue(),
+                              &store_drain_work, delay);
+}
+
+// Send the oldest stored readings as one batch, then wait long enough
+// to keep the drain within its duty-cycle share.  Frames that fail to
+// go out are stored again by the LoRa TX task.
+static void store_drain_handler(struct k_work* work) {
+    struct ts_msg_lora_outgoing out_msg = {.type = TS_MSG_TELEMETRY_BATCH};
+
+    if (ts_routing_table_count() == 0) {
+        schedule_store_drain(STORE_LINK_CHECK_INTERVAL);
+        return;
+    }
+    if (ts_telemetry_store_take(&out_msg.data.telemetry_batch) != 0) {
+        return;
+    }
+    ts_routing_prepare_header(&out_msg.route, TS_ROUTING_BROADCAST_ADDR);
+
+    LOG_DBG("Draining %u stored readings from %u",
+            out_msg.data.telemetry_batch.count,
+            out_msg.data.telemetry_batch.base_timestamp);
+
+    int ret = zbus_chan_pub(&ts_lora_out_chan, &out_msg, K_MSEC(200));
+    log_chan_pub_ret(ret);
+
+    uint32_t airtime_ms =
+        ts_airtime_ms(ts_radio_get_config(), STORE_DRAIN_FRAME_LEN);
+    schedule_store_drain(K_MSEC(ts_telemetry_store_drain_delay_ms(airtime_ms)));
+}
+
+// With no neighbor to hear it, a reading goes to the store instead of
+// the air.  Returns true if the reading was taken.
+static bool store_reading(const struct ts_msg_telemetry* p_reading) {
+    bool offline = ts_routing_table_count() == 0;
+
+    if (offline) {
+        int ret = ts_telemetry_store_add(p_reading);
+        if (ret != 0) { LOG_WRN("Failed to store reading: %d", ret); }
+    }
+    if (!ts_telemetry_store_is_empty()) { schedule_store_drain(K_NO_WAIT); }
+    return offline;
+}
+#endif
+
+// Per-channel deadbands, which also bound the prediction error
+static void get_deadbands(const struct ts_config* p_cfg,
+                          int32_t band[TS_TELEMETRY_CHANNEL_COUNT]) {
+    band[TS_TELEMETRY_TEMPERATURE] = p_cfg->telemetry_deadband_temperature;
+    band[TS_TELEMETRY_HUMIDITY] = p_cfg->telemetry_deadband_humidity;
+    band[TS_TELEMETRY_PRESSURE] = p_cfg->telemetry_deadband_pressure;
+}
+
+// Close the window and send its summary if it tells the receiver
+// something new
+static void report_window(const struct ts_config* p_cfg) {
+    struct ts_msg_lora_outgoing out_msg = {.type = TS_MSG_TELEMETRY_SUMMARY};
+    struct ts_msg_telemetry_summary* summary = &out_msg.data.telemetry_summary;
+    int32_t band[TS_TELEMETRY_CHANNEL_COUNT];
+
+    get_deadbands(p_cfg, band);
+    int ret = ts_telemetry_window_summarize(&window, summary);
+    ts_telemetry_window_reset(&window);
+    if (ret != 0) { return; }
+
+    if (!ts_telemetry_deadband_check(&deadband, summary, band,
+                                     p_cfg->telemetry_max_silence_s)) {
+        LOG_DBG("Window of %u readings inside deadband", summary->count);
+        return;
+    }
+
+#if defined(CONFIG_TS_TELEMETRY_STORE)
+    struct ts_msg_telemetry mean;
+    ts_telemetry_summary_mean(summary, &mean);
+    if (store_reading(&mean)) { return; }
+#endif
+
+    LOG_DBG("Sending summary of %u readings over %u s", summary->count,
+            summary->duration_s);
+
+    ts_routing_prepare_header(&out_msg.route, TS_ROUTING_BROADCAST_ADDR);
+    ret = zbus_chan_pub(&ts_lora_out_chan, &out_msg, K_MSEC(200));
+    log_chan_pub_ret(ret);
+}
+
+// Add a reading to the summary window, reporting the window first once
+// the reading falls outside it
+static void window_reading(const struct ts_config* p_cfg,
+                           const struct ts_msg_telemetry* p_reading) {
+    if (window.count > 0 &&
+        p_reading->timestamp - window.start >= p_cfg->telemetry_window_s) {
+        report_window(p_cfg);
+    }
+    if (ts_telemetry_window_add(&window, p_reading) != 0) {
+        report_window(p_cfg);
+        ts_telemetry_window_add(&window, p_reading);
+    }
+}
+
+// Send a reading only if the receiver's copy of the model can't predict
+// it to within the deadbands
+static void predict_reading(const struct ts_config* p_cfg,
+                            const struct ts_msg_telemetry* p_reading) {
+    struct ts_msg_lora_outgoing out_msg = {.type = TS_MSG_TELEMETRY_MODEL};
+    int32_t band[TS_TELEMETRY_CHANNEL_COUNT];
+
+    if (!predicting) {
+        ts_predict_encoder_init(&predict_encoder);
+        predicting = true;
+    }
+    get_deadbands(p_cfg, band);
+    if (!ts_predict_encode(&predict_encoder, p_reading, band,
+                           p_cfg->telemetry_resync_s,
+                           &out_msg.data.telemetry_model)) {
+        LOG_DBG("Reading predicted within bounds");
+        return;
+    }
+
+    LOG_DBG("Sending model %s, seq=%u",
+            out_msg.data.telemetry_model.resync ? "resync" : "update",
+            out_msg.data.telemetry_model.seq);
+
+    ts_routing_prepare_header(&out_msg.route, TS_ROUTING_BROADCAST_ADDR);
+    int ret = zbus_chan_pub(&ts_lora_out_chan, &out_msg, K_MSEC(200));
+    log_chan_pub_ret(ret);
+}
+
+// Replace a reading with its delta-coded form.  Restarting the stream
+// on an interval change also makes its first message a keyframe.
+static void delta_code_reading(struct ts_msg_lora_outgoing* p_msg,
+                               uint8_t keyframe_interval) {
+    struct ts_msg_telemetry reading = p_msg->data.telemetry;
+
+    if (delta_encoder.keyframe_interval != keyframe_interval) {
+        ts_delta_encoder_init(&delta_encoder, keyframe_interval);
+    }
+    p_msg->type = TS_MSG_TELEMETRY_DELTA;
+    ts_delta_encode(&delta_encoder, &reading, &p_msg->data.telemetry_delta);
+}
+
+static void process_reading(const struct ts_msg_telemetry* p_reading) {
+    const struct ts_config* cfg = ts_config_get();
     struct ts_msg_lora_outgoing out_msg = {
         .type = TS_MSG_TELEMETRY,
-        .data.telemetry.timestamp = (uint32_t)k_uptime_seconds(),
+        .data.telemetry = *p_reading,
     };
-    ts_routing_prepare_header(&out_msg.route, TS_ROUTING_BROADCAST_ADDR);
-
-    if (ts_sensor_backend_read(&out_msg.data.telemetry) != 0) { return; }
 
-    LOG_DBG("Sending sensor reading: ts=%d, pressure=%d, temp=%d, hum=%d",
+    LOG_DBG("Sensor reading: ts=%d, pressure=%d, temp=%d, hum=%d",
             out_msg.data.telemetry.timestamp, out_msg.data.telemetry.pressure,
             out_msg.data.telemetry.temperature,
             out_msg.data.telemetry.humidity);
 
+    if (ts_telemetry_range_check(&out_msg.data.telemetry) != 0) {
+        LOG_ERR("Dropping out-of-range sensor reading");
+        return;
+    }
+
+    if (cfg->telemetry_window_s > 0) {
+        window_reading(cfg, &out_msg.data.telemetry);
+        return;
+    }
+    // Windows were just switched off: don't strand the last one
+    if (window.count > 0) { report_window(cfg); }
+
+#if defined(CONFIG_TS_TELEMETRY_STORE)
+    if (store_reading(&out_msg.data.telemetry)) { return; }
+#endif
+
+    if (cfg->telemetry_resync_s > 0) {
+        predict_reading(cfg, &out_msg.data.telemetry);
+        return;
+    }
+    predicting = false;
+
+    apply_batch_config(cfg);
+    if (batch_size > 1) {
+        batch_reading(&out_msg.data.telemetry);
+        return;
+    }
+
+    if (cfg->telemetry_keyframe_interval > 0) {
+        delta_code_reading(&out_msg, cfg->telemetry_keyframe_interval);
+    }
+
+    ts_routing_prepare_header(&out_msg.route, TS_ROUTING_BROADCAST_ADDR);
     int ret = zbus_chan_pub(&ts_lora_out_chan, &out_msg, K_MSEC(200));
     log_chan_pub_ret(ret);
 }
 
-void sensor_take_reading_wrapper(struct k_work* work) {
-    periodic_work_handler(&ts_lora_out_chan);
+// A sample of exactly the temperature, humidity and pressure channels
+// is a telemetry reading; anything else is sent as a list of values
+static bool sample_to_reading(const struct ts_msg_sensor_values* p_sample,
+                              struct ts_msg_telemetry* p_reading) {
+    uint32_t seen = 0;
+
+    if (p_sample->count != TS_TELEMETRY_CHANNEL_COUNT) { return false; }
+
+    p_reading->timestamp = p_sample->timestamp;
+    for (size_t i = 0; i < p_sample->count; i++) {
+        const struct ts_msg_sensor_value* v = &p_sample->values[i];
+        switch (v->id) {
+            case TS_TELEMETRY_TEMPERATURE:
+                p_reading->temperature = v->value;
+                break;
+            case TS_TELEMETRY_HUMIDITY:
+                p_reading->humidity = v->value;
+                break;
+            case TS_TELEMETRY_PRESSURE:
+                p_reading->pressure = v->value;
+                break;
+            default:
+                return false;
+        }
+        seen |= BIT(v->id);
+    }
+    return seen == BIT_MASK(TS_TELEMETRY_CHANNEL_COUNT);
+}
+
+static void process_sample(const struct ts_msg_sensor_values* p_sample) {
+    struct ts_msg_lora_outgoing out_msg = {
+        .type = TS_MSG_SENSOR_VALUES,
+        .data.sensor_values = *p_sample,
+    };
+    struct ts_msg_telemetry reading;
+
+    if (sample_to_reading(p_sample, &reading)) {
+        process_reading(&reading);
+        return;
+    }
+
+    LOG_DBG("Sending %u sensor values, ts=%u", p_sample->count,
+            p_sample->timestamp);
+
+    ts_routing_prepare_header(&out_msg.route, TS_ROUTING_BROADCAST_ADDR);
+    int ret = zbus_chan_pub(&ts_lora_out_chan, &out_msg, K_MSEC(200));
+    log_chan_pub_ret(ret);
+}
+
+static void sample_work_handler(struct k_work* work) {
+    struct ts_msg_sensor_values sample;
+
+    while (k_msgq_get(&sample_q, &sample, K_NO_WAIT) == 0) {
+        process_sample(&sample);
+    }
+}
+
+// Runs in the source's context: stamp the sample and queue it
+static void sample_done(const struct ts_msg_sensor_values* p_sample) {
+    struct ts_msg_sensor_values sample = *p_sample;
+
+    sample.timestamp = (uint32_t)k_uptime_seconds();
+    if (k_msgq_put(&sample_q, &sample, K_NO_WAIT) != 0) {
+        LOG_WRN("Sample dropped, previous ones not processed yet");
+        return;
+    }
+    k_work_submit(&sample_work);
+}
+
+// Per-channel periods follow the live config
+static void apply_period_config(const struct ts_config* p_cfg) {
+    ts_sensor_registry_set_period(TS_TELEMETRY_TEMPERATURE,
+                                  p_cfg->sensor_period_temperature_s);
+    ts_sensor_registry_set_period(TS_TELEMETRY_HUMIDITY,
+                                  p_cfg->sensor_period_humidity_s);
+    ts_sensor_registry_set_period(TS_TELEMETRY_PRESSURE,
+                                  p_cfg->sensor_period_pressure_s);
+}
+
+uint32_t ts_sensor_manager_poll(void) {
+    const struct ts_config* cfg = ts_config_get();
+
+    apply_period_config(cfg);
+    ts_sensor_backend_set_profile(cfg->sensor_profile);
+    return ts_sensor_registry_poll((uint32_t)k_uptime_seconds(),
+                                   cfg->sensor_interval_s);
+}
+
+int ts_sensor_manager_start(void) {
+    ts_sensor_registry_init(sample_done);
+    return ts_sensor_backend_register();
 }
@@ -7,24 +7,31 @@
  * @{
  */
 
-#include <zephyr/kernel.h>
-#include <zephyr/zbus/zbus.h>
-
-#include "messages/messages.h"
+#include <stdint.h>
 
 /**
- * @brief Read sensors and publish telemetry to the LoRa outgoing channel.
+ * @brief Register the sensor backend.
+ *
+ * Sampling happens in ts_sensor_manager_poll().  On the system work
+ * queue, each sample of all three telemetry channels is processed as a
+ * reading and published to the LoRa outgoing channel; any other sample
+ * is published as a TS_MSG_SENSOR_VALUES list.
  *
- * @param chan  Zbus channel to publish to
+ * @return 0 on success, negative errno if the backend could not be
+ *         registered
  */
-void periodic_work_handler(const struct zbus_channel* chan);
+int ts_sensor_manager_start(void);
 
 /**
- * @brief Work queue wrapper for periodic_work_handler.
+ * @brief Start measuring every channel that is due.
+ *
+ * Channels are sampled at their own periods (ts/sensor_period_*_s,
+ * falling back to ts/sensor_interval_s) without waiting for the
+ * sensors.  Meant to run as a periodic scheduler job.
  *
- * @param work  Work item (unused)
+ * @return Seconds until the next channel is due, at least 1
  */
-void sensor_take_reading_wrapper(struct k_work* work);
+uint32_t ts_sensor_manager_poll(void);
 
 /** @} */
 
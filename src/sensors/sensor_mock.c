@@ -1,14 +1,67 @@
+#include <errno.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/random/random.h>
+#include <zephyr/sys/util.h>
 
 #include "sensors/sensor_backend.h"
+#include "sensors/sensor_registry.h"
 
 LOG_MODULE_REGISTER(sensor_mock);
 
-int ts_sensor_backend_read(struct ts_msg_telemetry* p_tel) {
-    p_tel->temperature = sys_rand32_get() / 1000000;
-    p_tel->humidity = sys_rand32_get() / 1000000;
-    p_tel->pressure = sys_rand32_get() / 10000;
+static const struct ts_sensor_channel mock_channels[] = {
+    TS_SENSOR_TELEMETRY_CHANNEL(TEMPERATURE, "temperature"),
+    TS_SENSOR_TELEMETRY_CHANNEL(HUMIDITY, "humidity"),
+    TS_SENSOR_TELEMETRY_CHANNEL(PRESSURE, "pressure"),
+};
 
+static int mock_start(uint32_t mask, ts_sensor_source_cb_t cb);
+
+// Profiles are accepted and reported, but the random values don't
+// depend on them and every measurement takes no time
+static struct ts_sensor_backend_timing timing = {
+    .profile = TS_BME280_PROFILE_STANDARD,
+    .applied = true,
+};
+
+static const struct ts_sensor_source mock_source = {
+    .name = "mock",
+    .channels = mock_channels,
+    .channel_count = ARRAY_SIZE(mock_channels),
+    .start = mock_start,
+};
+
+// Uniform over the channel's declared range, sub-zero values included
+static int32_t random_value(const struct ts_telemetry_range* range) {
+    uint32_t span = (uint32_t)(range->max - range->min) + 1;
+
+    return range->min + (int32_t)(sys_rand32_get() % span);
+}
+
+// No I/O to wait for: the measurement completes before returning
+static int mock_start(uint32_t mask, ts_sensor_source_cb_t cb) {
+    int32_t values[ARRAY_SIZE(mock_channels)];
+
+    for (size_t i = 0; i < ARRAY_SIZE(mock_channels); i++) {
+        values[i] = random_value(&mock_channels[i].range);
+    }
+    timing.count++;
+    cb(&mock_source, 0, mask, values);
     return 0;
 }
+
+int ts_sensor_backend_register(void) {
+    return ts_sensor_registry_add(&mock_source);
+}
+
+int ts_sensor_backend_set_profile(enum ts_bme280_profile profile) {
+    const struct ts_bme280_profile_desc* desc = ts_bme280_profile_get(profile);
+
+    if (desc == NULL) { return -EINVAL; }
+    timing.profile = (uint8_t)profile;
+    timing.expected_us = ts_bme280_profile_max_conversion_us(desc);
+    return 0;
+}
+
+void ts_sensor_backend_get_timing(struct ts_sensor_backend_timing* p_timing) {
+    *p_timing = timing;
+}
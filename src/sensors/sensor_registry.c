@@ -0,0 +1,204 @@
+#include "sensors/sensor_registry.h"
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/util.h>
+
+LOG_MODULE_REGISTER(sensor_registry);
+
+BUILD_ASSERT(TS_SENSOR_MAX_CHANNELS <= 32, "Channel masks are 32 bits");
+
+// Wait before polling a source again that could not be started
+#define RETRY_S 1
+
+struct registry_channel {
+    const struct ts_sensor_source* src;
+    const struct ts_sensor_channel* desc;
+    uint8_t index;      // Bit of this channel in the source's masks
+    uint32_t period_s;  // Runtime override, 0 = descriptor's
+    bool sampled;
+    uint32_t last_sample;
+};
+
+// Sources and channels change only at init and from the poller; the
+// mutex covers the counters, which completions update from the
+// sources' own contexts.
+static K_MUTEX_DEFINE(registry_mutex);
+static const struct ts_sensor_source* sources[TS_SENSOR_MAX_SOURCES];
+static size_t source_count;
+static struct registry_channel channels[TS_SENSOR_MAX_CHANNELS];
+static size_t channel_count;
+static ts_sensor_sink_t sink;
+static struct ts_sensor_registry_stats stats;
+
+static void count(uint32_t* p_counter, uint32_t n) {
+    k_mutex_lock(&registry_mutex, K_FOREVER);
+    *p_counter += n;
+    k_mutex_unlock(&registry_mutex);
+}
+
+static struct registry_channel* find_channel(uint8_t id) {
+    for (size_t i = 0; i < channel_count; i++) {
+        if (channels[i].desc->id == id) { return &channels[i]; }
+    }
+    return NULL;
+}
+
+static uint32_t channel_period(const struct registry_channel* p_ch,
+                               uint32_t default_period_s) {
+    if (p_ch->period_s > 0) { return p_ch->period_s; }
+    if (p_ch->desc->period_s > 0) { return p_ch->desc->period_s; }
+    return MAX(default_period_s, 1);
+}
+
+// Seconds until the channel is due, 0 if it already is.  A clock that
+// went backwards makes it due at once.
+static uint32_t channel_due_in(const struct registry_channel* p_ch,
+                               uint32_t now_s, uint32_t default_period_s) {
+    uint32_t period = channel_period(p_ch, default_period_s);
+
+    if (!p_ch->sampled || now_s < p_ch->last_sample) { return 0; }
+    uint32_t elapsed = now_s - p_ch->last_sample;
+    return elapsed >= period ? 0 : period - elapsed;
+}
+
+static void source_done(const struct ts_sensor_source* p_src, int result,
+                        uint32_t mask, const int32_t* p_values) {
+    struct ts_msg_sensor_values sample = {0};
+    uint32_t dropped = 0;
+
+    if (result != 0) {
+        LOG_ERR("%s measurement failed: %d", p_src->name, result);
+        count(&stats.failures, 1);
+        return;
+    }
+
+    for (size_t i = 0; i < p_src->channel_count; i++) {
+        const struct ts_sensor_channel* ch = &p_src->channels[i];
+        if (!(mask & BIT(i))) { continue; }
+
+        if (p_values[i] < ch->range.min || p_values[i] > ch->range.max) {
+            LOG_ERR("Dropping out-of-range %s value %d", ch->range.name,
+                    p_values[i]);
+            dropped++;
+            continue;
+        }
+        sample.values[sample.count].id = ch->id;
+        sample.values[sample.count].value = p_values[i];
+        sample.count++;
+    }
+
+    count(&stats.out_of_range, dropped);
+    if (sample.count == 0) { return; }
+    count(&stats.samples, 1);
+    sink(&sample);
+}
+
+void ts_sensor_registry_init(ts_sensor_sink_t new_sink) {
+    k_mutex_lock(&registry_mutex, K_FOREVER);
+    memset(sources, 0, sizeof(sources));
+    memset(channels, 0, sizeof(channels));
+    memset(&stats, 0, sizeof(stats));
+    source_count = 0;
+    channel_count = 0;
+    sink = new_sink;
+    k_mutex_unlock(&registry_mutex);
+}
+
+int ts_sensor_registry_add(const struct ts_sensor_source* p_src) {
+    if (p_src->channel_count == 0 || p_src->start == NULL) { return -EINVAL; }
+    if (source_count == TS_SENSOR_MAX_SOURCES ||
+        channel_count + p_src->channel_count > TS_SENSOR_MAX_CHANNELS) {
+        return -ENOMEM;
+    }
+    for (size_t i = 0; i < p_src->channel_count; i++) {
+        uint8_t id = p_src->channels[i].id;
+        if (find_channel(id) != NULL) { return -EEXIST; }
+        for (size_t j = 0; j < i; j++) {
+            if (p_src->channels[j].id == id) { return -EEXIST; }
+        }
+    }
+
+    for (size_t i = 0; i < p_src->channel_count; i++) {
+        channels[channel_count++] = (struct registry_channel){
+            .src = p_src,
+            .desc = &p_src->channels[i],
+            .index = (uint8_t)i,
+        };
+    }
+    sources[source_count++] = p_src;
+    LOG_INF("Registered %s with %u channels", p_src->name,
+            (unsigned)p_src->channel_count);
+    return 0;
+}
+
+const struct ts_sensor_channel* ts_sensor_registry_find(uint8_t id) {
+    const struct registry_channel* ch = find_channel(id);
+
+    return ch != NULL ? ch->desc : NULL;
+}
+
+int ts_sensor_registry_set_period(uint8_t id, uint32_t period_s) {
+    struct registry_channel* ch = find_channel(id);
+
+    if (ch == NULL) { return -ENOENT; }
+    ch->period_s = period_s;
+    return 0;
+}
+
+uint32_t ts_sensor_registry_poll(uint32_t now_s, uint32_t default_period_s) {
+    uint32_t next = UINT32_MAX;
+    bool retry = false;
+
+    for (size_t s = 0; s < source_count; s++) {
+        const struct ts_sensor_source* src = sources[s];
+        uint32_t mask = 0;
+
+        for (size_t i = 0; i < channel_count; i++) {
+            if (channels[i].src == src &&
+                channel_due_in(&channels[i], now_s, default_period_s) == 0) {
+                mask |= BIT(channels[i].index);
+            }
+        }
+        if (mask == 0) { continue; }
+
+        int ret = src->start(mask, source_done);
+        if (ret == -EBUSY) {
+            LOG_WRN("%s still measuring, skipping this poll", src->name);
+            retry = true;
+            continue;
+        }
+        if (ret != 0) {
+            LOG_ERR("Failed to start %s: %d", src->name, ret);
+            count(&stats.failures, 1);
+            retry = true;
+            continue;
+        }
+        for (size_t i = 0; i < channel_count; i++) {
+            if (channels[i].src == src && (mask & BIT(channels[i].index))) {
+                channels[i].sampled = true;
+                channels[i].last_sample = now_s;
+            }
+        }
+    }
+
+    // The channels of a source that could not be started are still due;
+    // poll again shortly rather than at once
+    if (retry) { return RETRY_S; }
+
+    // Every other channel was just started or is not due yet, so this
+    // is at least 1.  Without channels, poll again after a default
+    // period.
+    for (size_t i = 0; i < channel_count; i++) {
+        next = MIN(next, channel_due_in(&channels[i], now_s, default_period_s));
+    }
+    return next != UINT32_MAX ? next : MAX(default_period_s, 1);
+}
+
+void ts_sensor_registry_get_stats(struct ts_sensor_registry_stats* p_stats) {
+    k_mutex_lock(&registry_mutex, K_FOREVER);
+    *p_stats = stats;
+    k_mutex_unlock(&registry_mutex);
+}
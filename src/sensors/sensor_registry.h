@@ -0,0 +1,162 @@
+#ifndef TS_SENSOR_REGISTRY_H
+#define TS_SENSOR_REGISTRY_H
+
+/**
+ * @defgroup sensor_registry Sensor Registry
+ * @brief Sensor sources and their channels, each sampled at its own
+ *        period.
+ *
+ * A source is anything that measures one or more channels in one
+ * operation (a BME280, an ADC, a soil probe).  It registers a table of
+ * channel descriptors giving each channel a node-wide ID, its
+ * fixed-point scale and valid range, and its sample period.  The
+ * registry keeps track of when each channel was last sampled: a poll
+ * starts every source that has a channel due, asking only for the due
+ * ones, and tells the caller how long it may sleep until the next.
+ *
+ * Results arrive as a list of (ID, value) pairs, already range-checked,
+ * which maps directly onto a ts_msg_sensor_values message.  IDs 0–2 are
+ * the temperature, humidity and pressure channels of ts_msg_telemetry
+ * (enum ts_telemetry_channel), so a source that provides them can be
+ * used interchangeably with the original BME280 reading path.
+ * @{
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "messages/messages.h"
+#include "sensors/telemetry_range.h"
+
+/** @brief Most sources that can be registered. */
+#define TS_SENSOR_MAX_SOURCES 4
+
+/** @brief Most channels across all sources (also per sample). */
+#define TS_SENSOR_MAX_CHANNELS TS_MSG_SENSOR_VALUES_MAX
+
+/** @brief Describes one channel of a source. */
+struct ts_sensor_channel {
+    uint8_t id;                      /**< Node-wide channel ID */
+    struct ts_telemetry_range range; /**< Name, scale and valid range */
+    uint32_t period_s;               /**< 0 = the caller's default period */
+};
+
+/**
+ * @brief Descriptor of one of the ts_msg_telemetry channels.
+ *
+ * @param NAME  TEMPERATURE, HUMIDITY or PRESSURE
+ * @param str   Channel name
+ */
+#define TS_SENSOR_TELEMETRY_CHANNEL(NAME, str)             \
+    {                                                      \
+        .id = TS_TELEMETRY_##NAME,                         \
+        .range = {.name = str,                             \
+                  .scale = TS_TELEMETRY_##NAME##_SCALE,    \
+                  .min = TS_TELEMETRY_##NAME##_MIN,        \
+                  .max = TS_TELEMETRY_##NAME##_MAX},       \
+    }
+
+struct ts_sensor_source;
+
+/**
+ * @brief Completion of a measurement started by a source.
+ *
+ * @param p_src     Source that measured
+ * @param result    0 on success, negative errno on failure
+ * @param mask      Channels measured, as indices into p_src->channels
+ * @param p_values  Value per channel index (only the masked ones are
+ *                  read); only valid for the duration of the call
+ */
+typedef void (*ts_sensor_source_cb_t)(const struct ts_sensor_source* p_src,
+                                      int result, uint32_t mask,
+                                      const int32_t* p_values);
+
+/** @brief A sensor that measures one or more channels at once. */
+struct ts_sensor_source {
+    const char* name;
+    const struct ts_sensor_channel* channels;
+    size_t channel_count;
+    /**
+     * Start measuring the channels in mask without waiting.  cb runs in
+     * the source's own context once done, possibly before start
+     * returns, and exactly once if 0 is returned.  Return -EBUSY while
+     * a previous measurement is still in flight.
+     */
+    int (*start)(uint32_t mask, ts_sensor_source_cb_t cb);
+};
+
+/**
+ * @brief Receives the values of one completed measurement.
+ *
+ * p_sample->timestamp is left 0 for the sink to fill in.  Runs in the
+ * source's context; must not block.
+ */
+typedef void (*ts_sensor_sink_t)(const struct ts_msg_sensor_values* p_sample);
+
+/** @brief Registry counters since ts_sensor_registry_init(). */
+struct ts_sensor_registry_stats {
+    uint32_t samples;      /**< Measurements handed to the sink */
+    uint32_t failures;     /**< Measurements that failed to start or complete */
+    uint32_t out_of_range; /**< Values dropped by the range check */
+};
+
+/**
+ * @brief Forget all sources and set where their results go.
+ *
+ * @param sink  Called with every completed measurement
+ */
+void ts_sensor_registry_init(ts_sensor_sink_t sink);
+
+/**
+ * @brief Register a source.  The source must outlive the registry.
+ *
+ * @param p_src  Source with at least one channel
+ * @return 0 on success, -EINVAL if the source has no channels or a
+ *         start function, -EEXIST if one of its channel IDs is taken,
+ *         -ENOMEM if the source or channel limit would be exceeded
+ */
+int ts_sensor_registry_add(const struct ts_sensor_source* p_src);
+
+/**
+ * @brief Look up a registered channel by ID.
+ *
+ * @param id  Channel ID
+ * @return Descriptor, or NULL if no source provides that ID
+ */
+const struct ts_sensor_channel* ts_sensor_registry_find(uint8_t id);
+
+/**
+ * @brief Override a channel's sample period at runtime.
+ *
+ * @param id        Channel ID
+ * @param period_s  New period; 0 restores the descriptor's
+ * @return 0 on success, -ENOENT for an unknown channel
+ */
+int ts_sensor_registry_set_period(uint8_t id, uint32_t period_s);
+
+/**
+ * @brief Start every source that has a channel due.
+ *
+ * A channel is due when it has never been sampled or its period has
+ * elapsed since it was last started.  Each source is started once,
+ * for all its due channels together; one that fails to start (e.g.
+ * still busy) is retried a second later.
+ *
+ * @param now_s             Current time
+ * @param default_period_s  Period of channels that don't set their own
+ * @return Seconds until the next poll: 1 after a source failed to
+ *         start, otherwise until the next channel is due, or
+ *         default_period_s without channels (at least 1)
+ */
+uint32_t ts_sensor_registry_poll(uint32_t now_s, uint32_t default_period_s);
+
+/**
+ * @brief Read the registry counters.
+ *
+ * @param p_stats  Output
+ */
+void ts_sensor_registry_get_stats(struct ts_sensor_registry_stats* p_stats);
+
+/** @} */
+
+#endif  // TS_SENSOR_REGISTRY_H
@@ -0,0 +1,97 @@
+#include "sensors/telemetry_batch.h"
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+
+// Mutex: readings are added from the sensor work item, while the latency
+// deadline can fire from its own delayable work.
+static K_MUTEX_DEFINE(batch_mutex);
+static struct ts_msg_telemetry_batch batch;
+static uint32_t last_timestamp;
+static uint8_t limit_samples = 1;
+static uint32_t limit_latency_s;
+
+int ts_telemetry_batch_init(uint8_t max_samples, uint32_t max_latency_s) {
+    if (max_samples == 0 || max_samples > TS_MSG_TELEMETRY_BATCH_MAX) {
+        return -EINVAL;
+    }
+
+    k_mutex_lock(&batch_mutex, K_FOREVER);
+    memset(&batch, 0, sizeof(batch));
+    limit_samples = max_samples;
+    limit_latency_s = max_latency_s;
+    k_mutex_unlock(&batch_mutex);
+    return 0;
+}
+
+int ts_telemetry_batch_add(const struct ts_msg_telemetry* p_reading) {
+    int ret;
+
+    k_mutex_lock(&batch_mutex, K_FOREVER);
+    uint32_t dt = 0;
+    if (batch.count >= limit_samples) {
+        k_mutex_unlock(&batch_mutex);
+        return -EAGAIN;
+    }
+    if (batch.count > 0) {
+        if (p_reading->timestamp < last_timestamp ||
+            p_reading->timestamp - last_timestamp > UINT16_MAX) {
+            k_mutex_unlock(&batch_mutex);
+            return -EAGAIN;
+        }
+        dt = p_reading->timestamp - last_timestamp;
+    } else {
+        batch.base_timestamp = p_reading->timestamp;
+    }
+
+    batch.samples[batch.count] = (struct ts_msg_telemetry_sample){
+        .dt = (uint16_t)dt,
+        .temperature = p_reading->temperature,
+        .humidity = p_reading->humidity,
+        .pressure = p_reading->pressure,
+    };
+    batch.count++;
+    last_timestamp = p_reading->timestamp;
+
+    ret = (batch.count >= limit_samples ||
+           last_timestamp - batch.base_timestamp >= limit_latency_s)
+              ? 1
+              : 0;
+    k_mutex_unlock(&batch_mutex);
+    return ret;
+}
+
+int ts_telemetry_batch_take(struct ts_msg_telemetry_batch* p_out) {
+    k_mutex_lock(&batch_mutex, K_FOREVER);
+    if (batch.count == 0) {
+        k_mutex_unlock(&batch_mutex);
+        return -ENODATA;
+    }
+    *p_out = batch;
+    memset(&batch, 0, sizeof(batch));
+    k_mutex_unlock(&batch_mutex);
+    return 0;
+}
+
+uint8_t ts_telemetry_batch_count(void) {
+    k_mutex_lock(&batch_mutex, K_FOREVER);
+    uint8_t count = batch.count;
+    k_mutex_unlock(&batch_mutex);
+    return count;
+}
+
+int ts_telemetry_batch_expand(const struct ts_msg_telemetry_batch* p_batch,
+                              uint8_t index, struct ts_msg_telemetry* p_out) {
+    if (index >= p_batch->count) { return -EINVAL; }
+
+    uint32_t timestamp = p_batch->base_timestamp;
+    for (uint8_t i = 0; i <= index; i++) {
+        timestamp += p_batch->samples[i].dt;
+    }
+    p_out->timestamp = timestamp;
+    p_out->temperature = p_batch->samples[index].temperature;
+    p_out->humidity = p_batch->samples[index].humidity;
+    p_out->pressure = p_batch->samples[index].pressure;
+    return 0;
+}
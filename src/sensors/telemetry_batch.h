@@ -0,0 +1,71 @@
+#ifndef TS_TELEMETRY_BATCH_H
+#define TS_TELEMETRY_BATCH_H
+
+/**
+ * @defgroup telemetry_batch Telemetry Batching
+ * @brief Collects readings into TS_MSG_TELEMETRY_BATCH frames.
+ *
+ * Every frame pays for preamble, header, route map and auth tag no
+ * matter how little it carries.  Nodes that don't need real-time data
+ * buffer up to a configured number of readings and send them together,
+ * with one base timestamp and per-sample time deltas.  A batch is sent
+ * when it is full, when the next reading would need a time delta that
+ * doesn't fit, or when its oldest reading reaches the maximum latency.
+ * @{
+ */
+
+#include <stdint.h>
+
+#include "messages/messages.h"
+
+/**
+ * @brief Reset the batch and set its limits.
+ *
+ * @param max_samples    Readings per batch (1–TS_MSG_TELEMETRY_BATCH_MAX)
+ * @param max_latency_s  Longest a reading may wait before it is sent
+ * @return 0 on success, -EINVAL if a limit is out of range
+ */
+int ts_telemetry_batch_init(uint8_t max_samples, uint32_t max_latency_s);
+
+/**
+ * @brief Add a reading to the current batch.
+ *
+ * If the reading can't join the current batch (it is full, time went
+ * backwards, or the delta overflows), -EAGAIN is returned and the batch
+ * is left untouched: take it, then add the reading again.
+ *
+ * @param p_reading  Reading with its absolute timestamp
+ * @return 1 if the batch is now ready to send, 0 if it can wait,
+ *         -EAGAIN if the batch must be taken first
+ */
+int ts_telemetry_batch_add(const struct ts_msg_telemetry* p_reading);
+
+/**
+ * @brief Move the buffered readings out and start a new batch.
+ *
+ * @param p_out  Output batch payload
+ * @return 0 on success, -ENODATA if no readings are buffered
+ */
+int ts_telemetry_batch_take(struct ts_msg_telemetry_batch* p_out);
+
+/**
+ * @brief Number of buffered readings.
+ *
+ * @return Readings waiting in the current batch
+ */
+uint8_t ts_telemetry_batch_count(void);
+
+/**
+ * @brief Expand one sample of a batch back into a single reading.
+ *
+ * @param p_batch  Received batch
+ * @param index    Sample index (< p_batch->count)
+ * @param p_out    Output reading with its absolute timestamp
+ * @return 0 on success, -EINVAL if index is out of range
+ */
+int ts_telemetry_batch_expand(const struct ts_msg_telemetry_batch* p_batch,
+                              uint8_t index, struct ts_msg_telemetry* p_out);
+
+/** @} */
+
+#endif  // TS_TELEMETRY_BATCH_H
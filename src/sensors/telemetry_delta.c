@@ -0,0 +1,219 @@
+#include "sensors/telemetry_delta.h"
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(telemetry_delta);
+
+#define DELTA_FIELDS 4
+
+struct delta_source {
+    bool occupied;
+    bool valid;  // prev holds the last reading; deltas can be applied
+    uint16_t src;
+    uint8_t seq;
+    uint32_t last_used;
+    struct ts_msg_telemetry prev;
+};
+
+// Mutex: decoding runs on the RX thread, but init and stats can be
+// called from anywhere.
+static K_MUTEX_DEFINE(decoder_mutex);
+static struct delta_source sources[TS_DELTA_DECODER_SLOTS];
+static struct ts_delta_decoder_stats stats;
+static uint32_t use_counter;
+
+uint32_t ts_zigzag_encode(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+int32_t ts_zigzag_decode(uint32_t value) {
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+size_t ts_varint_put(uint32_t value, uint8_t* p_buf, size_t buf_size) {
+    size_t n = 0;
+
+    do {
+        if (n == buf_size) { return 0; }
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        p_buf[n++] = byte | (value != 0 ? 0x80 : 0);
+    } while (value != 0);
+    return n;
+}
+
+size_t ts_varint_get(const uint8_t* p_buf, size_t buf_len,
+                     uint32_t* p_value) {
+    uint32_t value = 0;
+
+    for (size_t n = 0; n < buf_len && n < 5; n++) {
+        // The fifth byte may only carry the top 4 bits of a uint32_t
+        if (n == 4 && p_buf[n] > 0x0F) { return 0; }
+        value |= (uint32_t)(p_buf[n] & 0x7F) << (7 * n);
+        if (!(p_buf[n] & 0x80)) {
+            *p_value = value;
+            return n + 1;
+        }
+    }
+    return 0;
+}
+
+static void fields_of(const struct ts_msg_telemetry* p_reading,
+                      uint32_t fields[DELTA_FIELDS]) {
+    fields[0] = p_reading->timestamp;
+    fields[1] = (uint32_t)p_reading->temperature;
+    fields[2] = (uint32_t)p_reading->humidity;
+    fields[3] = (uint32_t)p_reading->pressure;
+}
+
+static void reading_of(const uint32_t fields[DELTA_FIELDS],
+                       struct ts_msg_telemetry* p_reading) {
+    p_reading->timestamp = fields[0];
+    p_reading->temperature = (int32_t)fields[1];
+    p_reading->humidity = (int32_t)fields[2];
+    p_reading->pressure = (int32_t)fields[3];
+}
+
+void ts_delta_encoder_init(struct ts_delta_encoder* p_enc,
+                           uint8_t keyframe_interval) {
+    memset(p_enc, 0, sizeof(*p_enc));
+    p_enc->keyframe_interval = MAX(keyframe_interval, 1);
+    p_enc->keyframe_pending = true;
+}
+
+void ts_delta_encoder_request_keyframe(struct ts_delta_encoder* p_enc) {
+    p_enc->keyframe_pending = true;
+}
+
+void ts_delta_encode(struct ts_delta_encoder* p_enc,
+                     const struct ts_msg_telemetry* p_reading,
+                     struct ts_msg_telemetry_delta* p_out) {
+    uint32_t cur[DELTA_FIELDS];
+    uint32_t prev[DELTA_FIELDS];
+
+    bool keyframe = p_enc->keyframe_pending ||
+                    p_enc->since_keyframe >= p_enc->keyframe_interval;
+
+    fields_of(p_reading, cur);
+    fields_of(&p_enc->prev, prev);
+
+    memset(p_out, 0, sizeof(*p_out));
+    p_out->seq = p_enc->seq++;
+    p_out->keyframe = keyframe;
+    for (int i = 0; i < DELTA_FIELDS; i++) {
+        // Unsigned wrap-around makes the difference exact for any pair
+        // of values; the decoder adds it back modulo 2^32.
+        int32_t value = (int32_t)(keyframe ? cur[i] : cur[i] - prev[i]);
+        // Cannot fail: four varints of at most 5 bytes fit the buffer
+        p_out->len += ts_varint_put(ts_zigzag_encode(value),
+                                    p_out->data + p_out->len,
+                                    sizeof(p_out->data) - p_out->len);
+    }
+
+    p_enc->prev = *p_reading;
+    p_enc->keyframe_pending = false;
+    p_enc->since_keyframe = keyframe ? 1 : p_enc->since_keyframe + 1;
+}
+
+void ts_delta_decoder_init(void) {
+    k_mutex_lock(&decoder_mutex, K_FOREVER);
+    memset(sources, 0, sizeof(sources));
+    memset(&stats, 0, sizeof(stats));
+    use_counter = 0;
+    k_mutex_unlock(&decoder_mutex);
+}
+
+// Slot for a source, evicting the least recently used one if needed
+static struct delta_source* source_slot(uint16_t src) {
+    struct delta_source* victim = NULL;
+
+    for (int i = 0; i < TS_DELTA_DECODER_SLOTS; i++) {
+        if (sources[i].occupied && sources[i].src == src) {
+            return &sources[i];
+        }
+    }
+    for (int i = 0; i < TS_DELTA_DECODER_SLOTS; i++) {
+        if (!sources[i].occupied) {
+            victim = &sources[i];
+            break;
+        }
+        if (victim == NULL || sources[i].last_used < victim->last_used) {
+            victim = &sources[i];
+        }
+    }
+
+    memset(victim, 0, sizeof(*victim));
+    victim->occupied = true;
+    victim->src = src;
+    return victim;
+}
+
+static int unpack(const struct ts_msg_telemetry_delta* p_delta,
+                  uint32_t values[DELTA_FIELDS]) {
+    size_t pos = 0;
+
+    if (p_delta->len > TS_MSG_TELEMETRY_DELTA_MAX_LEN) { return -EBADMSG; }
+    for (int i = 0; i < DELTA_FIELDS; i++) {
+        size_t n = ts_varint_get(p_delta->data + pos, p_delta->len - pos,
+                                 &values[i]);
+        if (n == 0) { return -EBADMSG; }
+        pos += n;
+    }
+    return (pos == p_delta->len) ? 0 : -EBADMSG;
+}
+
+int ts_delta_decode(uint16_t src, const struct ts_msg_telemetry_delta* p_delta,
+                    struct ts_msg_telemetry* p_out) {
+    uint32_t values[DELTA_FIELDS];
+    uint32_t fields[DELTA_FIELDS];
+
+    int ret = unpack(p_delta, values);
+    if (ret != 0) { return ret; }
+
+    k_mutex_lock(&decoder_mutex, K_FOREVER);
+    struct delta_source* slot = source_slot(src);
+    slot->last_used = ++use_counter;
+
+    if (!p_delta->keyframe) {
+        if (slot->valid && p_delta->seq != (uint8_t)(slot->seq + 1)) {
+            // Something in between was lost; applying this delta to the
+            // stale reading would produce plausible but wrong values.
+            LOG_WRN("Delta gap from 0x%04x: seq %u after %u", src,
+                    p_delta->seq, slot->seq);
+            slot->valid = false;
+            stats.gaps++;
+        }
+        if (!slot->valid) {
+            slot->seq = p_delta->seq;
+            stats.dropped++;
+            k_mutex_unlock(&decoder_mutex);
+            return -ENODATA;
+        }
+    }
+
+    fields_of(&slot->prev, fields);
+    for (int i = 0; i < DELTA_FIELDS; i++) {
+        uint32_t value = (uint32_t)ts_zigzag_decode(values[i]);
+        fields[i] = p_delta->keyframe ? value : fields[i] + value;
+    }
+    reading_of(fields, &slot->prev);
+    slot->seq = p_delta->seq;
+    slot->valid = true;
+    if (p_delta->keyframe) {
+        stats.keyframes++;
+    } else {
+        stats.deltas++;
+    }
+    *p_out = slot->prev;
+    k_mutex_unlock(&decoder_mutex);
+    return 0;
+}
+
+void ts_delta_decoder_get_stats(struct ts_delta_decoder_stats* p_stats) {
+    k_mutex_lock(&decoder_mutex, K_FOREVER);
+    *p_stats = stats;
+    k_mutex_unlock(&decoder_mutex);
+}
@@ -0,0 +1,137 @@
+#ifndef TS_TELEMETRY_DELTA_H
+#define TS_TELEMETRY_DELTA_H
+
+/**
+ * @defgroup telemetry_delta Telemetry Delta Coding
+ * @brief Keyframe/delta compression of successive readings.
+ *
+ * Temperature, humidity and pressure change slowly, so most of each
+ * 32-bit field repeats from one reading to the next.  The encoder sends
+ * every field as a zigzag varint of its difference from the previous
+ * reading (usually one byte), with a full keyframe every N messages or
+ * whenever one is requested.  Receivers keep per-source decoder state:
+ * a gap in the sequence number invalidates it until the next keyframe,
+ * so a lost message never turns into silently wrong values.
+ * @{
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "messages/messages.h"
+
+/** @brief Sources the receiver tracks decoder state for. */
+#define TS_DELTA_DECODER_SLOTS 16
+
+/** @brief Sender-side coding state for one stream of readings. */
+struct ts_delta_encoder {
+    struct ts_msg_telemetry prev;
+    uint8_t seq;
+    uint8_t since_keyframe;
+    uint8_t keyframe_interval;
+    bool keyframe_pending;
+};
+
+/** @brief Receiver counters since ts_delta_decoder_init(). */
+struct ts_delta_decoder_stats {
+    uint32_t keyframes; /**< Keyframes decoded */
+    uint32_t deltas;    /**< Delta messages decoded */
+    uint32_t gaps;      /**< Sequence gaps detected */
+    uint32_t dropped;   /**< Deltas dropped while waiting for a keyframe */
+};
+
+/**
+ * @brief Map a signed value to unsigned so small magnitudes stay small.
+ *
+ * @param value  Signed value
+ * @return 0, -1, 1, -2, ... mapped to 0, 1, 2, 3, ...
+ */
+uint32_t ts_zigzag_encode(int32_t value);
+
+/**
+ * @brief Inverse of ts_zigzag_encode().
+ *
+ * @param value  Zigzag-coded value
+ * @return Original signed value
+ */
+int32_t ts_zigzag_decode(uint32_t value);
+
+/**
+ * @brief Append an unsigned LEB128 varint (7 bits per byte).
+ *
+ * @param value     Value to encode
+ * @param p_buf     Output buffer
+ * @param buf_size  Space left in p_buf
+ * @return Bytes written (1–5), or 0 if the buffer is too small
+ */
+size_t ts_varint_put(uint32_t value, uint8_t* p_buf, size_t buf_size);
+
+/**
+ * @brief Read an unsigned LEB128 varint.
+ *
+ * @param p_buf    Input buffer
+ * @param buf_len  Bytes available
+ * @param p_value  Decoded value
+ * @return Bytes consumed (1–5), or 0 if truncated or longer than 32 bits
+ */
+size_t ts_varint_get(const uint8_t* p_buf, size_t buf_len,
+                     uint32_t* p_value);
+
+/**
+ * @brief Start a new stream; the first message will be a keyframe.
+ *
+ * @param p_enc              Encoder state
+ * @param keyframe_interval  Messages per keyframe (1 = keyframes only)
+ */
+void ts_delta_encoder_init(struct ts_delta_encoder* p_enc,
+                           uint8_t keyframe_interval);
+
+/**
+ * @brief Make the next message a keyframe.
+ *
+ * For a sender that knows receivers lost state, e.g. after a restart or
+ * a configuration change.
+ *
+ * @param p_enc  Encoder state
+ */
+void ts_delta_encoder_request_keyframe(struct ts_delta_encoder* p_enc);
+
+/**
+ * @brief Code a reading against the previous one.
+ *
+ * @param p_enc      Encoder state
+ * @param p_reading  Reading to send
+ * @param p_out      Output message payload
+ */
+void ts_delta_encode(struct ts_delta_encoder* p_enc,
+                     const struct ts_msg_telemetry* p_reading,
+                     struct ts_msg_telemetry_delta* p_out);
+
+/**
+ * @brief Forget all per-source state and reset the counters.
+ */
+void ts_delta_decoder_init(void);
+
+/**
+ * @brief Rebuild a reading from a source's delta message.
+ *
+ * @param src      Originating node
+ * @param p_delta  Received payload
+ * @param p_out    Reconstructed reading
+ * @return 0 on success, -ENODATA if the source has no valid state (no
+ *         keyframe seen yet, or a gap since), -EBADMSG if malformed
+ */
+int ts_delta_decode(uint16_t src, const struct ts_msg_telemetry_delta* p_delta,
+                    struct ts_msg_telemetry* p_out);
+
+/**
+ * @brief Copy the receiver counters.
+ *
+ * @param p_stats  Output counters
+ */
+void ts_delta_decoder_get_stats(struct ts_delta_decoder_stats* p_stats);
+
+/** @} */
+
+#endif  // TS_TELEMETRY_DELTA_H
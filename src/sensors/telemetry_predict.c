@@ -0,0 +1,233 @@
+#include "sensors/telemetry_predict.h"
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(telemetry_predict);
+
+struct predict_source {
+    bool occupied;
+    bool valid;  // model matches the sender's; updates can be applied
+    uint16_t src;
+    uint8_t seq;
+    uint32_t last_used;
+    struct ts_telemetry_model model;
+};
+
+// Mutex: decoding runs on the RX thread, but estimates, init and stats
+// can be requested from anywhere.
+static K_MUTEX_DEFINE(decoder_mutex);
+static struct predict_source sources[TS_PREDICT_DECODER_SLOTS];
+static struct ts_predict_decoder_stats stats;
+static uint32_t use_counter;
+
+// Divide rounding to nearest, halves away from zero
+static int64_t div_round(int64_t num, int64_t den) {
+    int64_t half = den / 2;
+    return num >= 0 ? (num + half) / den : (num - half) / den;
+}
+
+static void reading_of(uint32_t timestamp,
+                       const int32_t value[TS_TELEMETRY_CHANNEL_COUNT],
+                       struct ts_msg_telemetry* p_reading) {
+    *p_reading = (struct ts_msg_telemetry){
+        .timestamp = timestamp,
+        .temperature = value[TS_TELEMETRY_TEMPERATURE],
+        .humidity = value[TS_TELEMETRY_HUMIDITY],
+        .pressure = value[TS_TELEMETRY_PRESSURE],
+    };
+}
+
+void ts_telemetry_model_reset(struct ts_telemetry_model* p_model) {
+    memset(p_model, 0, sizeof(*p_model));
+}
+
+void ts_telemetry_model_update(struct ts_telemetry_model* p_model,
+                               const struct ts_msg_telemetry* p_reading) {
+    if (p_model->points == ARRAY_SIZE(p_model->history)) {
+        p_model->history[0] = p_model->history[1];
+        p_model->points--;
+    }
+    p_model->history[p_model->points++] = *p_reading;
+}
+
+int ts_telemetry_model_predict(const struct ts_telemetry_model* p_model,
+                               uint32_t timestamp,
+                               struct ts_msg_telemetry* p_out) {
+    int32_t value[TS_TELEMETRY_CHANNEL_COUNT];
+
+    if (p_model->points == 0) { return -ENODATA; }
+
+    const struct ts_msg_telemetry* first = &p_model->history[0];
+    const struct ts_msg_telemetry* last =
+        &p_model->history[p_model->points - 1];
+    bool extrapolate = p_model->points == 2 &&
+                       last->timestamp > first->timestamp &&
+                       timestamp > last->timestamp;
+
+    for (int ch = 0; ch < TS_TELEMETRY_CHANNEL_COUNT; ch++) {
+        value[ch] = ts_telemetry_value(last, ch);
+        if (!extrapolate) { continue; }
+
+        // Range-checked values and 32-bit times keep this within 64 bits
+        const struct ts_telemetry_range* range = ts_telemetry_range_get(ch);
+        int64_t rise = (int64_t)value[ch] - ts_telemetry_value(first, ch);
+        int64_t predicted =
+            value[ch] + div_round(rise * (timestamp - last->timestamp),
+                                  last->timestamp - first->timestamp);
+        value[ch] = (int32_t)CLAMP(predicted, range->min, range->max);
+    }
+    reading_of(timestamp, value, p_out);
+    return 0;
+}
+
+void ts_predict_encoder_init(struct ts_predict_encoder* p_enc) {
+    memset(p_enc, 0, sizeof(*p_enc));
+    p_enc->resync_pending = true;
+}
+
+void ts_predict_encoder_request_resync(struct ts_predict_encoder* p_enc) {
+    p_enc->resync_pending = true;
+}
+
+bool ts_predict_encode(struct ts_predict_encoder* p_enc,
+                       const struct ts_msg_telemetry* p_reading,
+                       const int32_t* p_bound, uint32_t resync_interval_s,
+                       struct ts_msg_telemetry_model* p_out) {
+    struct ts_telemetry_model* model = &p_enc->model;
+    struct ts_msg_telemetry predicted;
+
+    bool resync = p_enc->resync_pending ||
+                  ts_telemetry_model_predict(model, p_reading->timestamp,
+                                             &predicted) != 0;
+    if (!resync) {
+        // A clock that went backwards would break the line; start over
+        resync = p_reading->timestamp <
+                     model->history[model->points - 1].timestamp ||
+                 p_reading->timestamp - p_enc->last_resync >=
+                     resync_interval_s;
+    }
+    bool send = resync;
+
+    for (int ch = 0; ch < TS_TELEMETRY_CHANNEL_COUNT && !send; ch++) {
+        int64_t error = (int64_t)ts_telemetry_value(p_reading, ch) -
+                        ts_telemetry_value(&predicted, ch);
+        send = error > p_bound[ch] || error < -(int64_t)p_bound[ch];
+    }
+    if (!send) { return false; }
+
+    if (resync) {
+        ts_telemetry_model_reset(model);
+        p_enc->resync_pending = false;
+        p_enc->last_resync = p_reading->timestamp;
+    }
+    ts_telemetry_model_update(model, p_reading);
+
+    *p_out = (struct ts_msg_telemetry_model){
+        .seq = p_enc->seq++,
+        .resync = resync,
+        .timestamp = p_reading->timestamp,
+        .temperature = p_reading->temperature,
+        .humidity = p_reading->humidity,
+        .pressure = p_reading->pressure,
+    };
+    return true;
+}
+
+void ts_predict_decoder_init(void) {
+    k_mutex_lock(&decoder_mutex, K_FOREVER);
+    memset(sources, 0, sizeof(sources));
+    memset(&stats, 0, sizeof(stats));
+    use_counter = 0;
+    k_mutex_unlock(&decoder_mutex);
+}
+
+// Slot for a source, evicting the least recently used one if needed.
+// Returns NULL instead if the source has none and create is false.
+static struct predict_source* source_slot(uint16_t src, bool create) {
+    struct predict_source* victim = NULL;
+
+    for (int i = 0; i < TS_PREDICT_DECODER_SLOTS; i++) {
+        if (sources[i].occupied && sources[i].src == src) {
+            return &sources[i];
+        }
+    }
+    if (!create) { return NULL; }
+    for (int i = 0; i < TS_PREDICT_DECODER_SLOTS; i++) {
+        if (!sources[i].occupied) {
+            victim = &sources[i];
+            break;
+        }
+        if (victim == NULL || sources[i].last_used < victim->last_used) {
+            victim = &sources[i];
+        }
+    }
+
+    memset(victim, 0, sizeof(*victim));
+    victim->occupied = true;
+    victim->src = src;
+    return victim;
+}
+
+int ts_predict_decode(uint16_t src, const struct ts_msg_telemetry_model* p_msg,
+                      struct ts_msg_telemetry* p_out) {
+    struct ts_msg_telemetry reading = {
+        .timestamp = p_msg->timestamp,
+        .temperature = p_msg->temperature,
+        .humidity = p_msg->humidity,
+        .pressure = p_msg->pressure,
+    };
+
+    k_mutex_lock(&decoder_mutex, K_FOREVER);
+    struct predict_source* slot = source_slot(src, true);
+    slot->last_used = ++use_counter;
+
+    if (p_msg->resync) {
+        ts_telemetry_model_reset(&slot->model);
+        slot->valid = true;
+        stats.resyncs++;
+    } else {
+        if (slot->valid && p_msg->seq != (uint8_t)(slot->seq + 1)) {
+            // The sender's model moved on without us; predictions from
+            // ours would be off by more than the bound.
+            LOG_WRN("Model gap from 0x%04x: seq %u after %u", src, p_msg->seq,
+                    slot->seq);
+            slot->valid = false;
+            stats.gaps++;
+        }
+        if (!slot->valid) {
+            slot->seq = p_msg->seq;
+            stats.dropped++;
+            k_mutex_unlock(&decoder_mutex);
+            return -ENODATA;
+        }
+        stats.updates++;
+    }
+
+    ts_telemetry_model_update(&slot->model, &reading);
+    slot->seq = p_msg->seq;
+    *p_out = reading;
+    k_mutex_unlock(&decoder_mutex);
+    return 0;
+}
+
+int ts_predict_estimate(uint16_t src, uint32_t timestamp,
+                        struct ts_msg_telemetry* p_out) {
+    int ret = -ENODATA;
+
+    k_mutex_lock(&decoder_mutex, K_FOREVER);
+    struct predict_source* slot = source_slot(src, false);
+    if (slot != NULL && slot->valid) {
+        ret = ts_telemetry_model_predict(&slot->model, timestamp, p_out);
+    }
+    k_mutex_unlock(&decoder_mutex);
+    return ret;
+}
+
+void ts_predict_decoder_get_stats(struct ts_predict_decoder_stats* p_stats) {
+    k_mutex_lock(&decoder_mutex, K_FOREVER);
+    *p_stats = stats;
+    k_mutex_unlock(&decoder_mutex);
+}
@@ -0,0 +1,170 @@
+#ifndef TS_TELEMETRY_PREDICT_H
+#define TS_TELEMETRY_PREDICT_H
+
+/**
+ * @defgroup telemetry_predict Telemetry Prediction
+ * @brief Dual prediction: send only the readings the receiver cannot
+ *        predict.
+ *
+ * Sender and receiver run the same model on the same input: a linear
+ * extrapolation, per channel, through the last two readings that were
+ * sent.  The sender compares every new reading with the model's
+ * prediction and only sends it as a TS_MSG_TELEMETRY_MODEL when some
+ * channel is off by more than its error bound.  Until then the receiver
+ * can estimate the series from its copy of the model, and that estimate
+ * is within the bound of what the sensor read.  A steady or steadily
+ * drifting signal costs next to nothing; reporting cost follows how
+ * much the signal actually changes course.
+ *
+ * Both copies only stay equal if every message arrives.  seq exposes a
+ * lost message, after which the receiver drops the source's model until
+ * the next resync: a message that restarts the model from its own
+ * reading, sent at least every resync interval.  All arithmetic is
+ * integer so both sides compute bit-identical predictions.
+ * @{
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "messages/messages.h"
+#include "sensors/telemetry_range.h"
+
+/** @brief Sources the receiver tracks a model for. */
+#define TS_PREDICT_DECODER_SLOTS 16
+
+/** @brief Readings a model is built from, newest last. */
+struct ts_telemetry_model {
+    uint8_t points; /**< Readings held (0–2) */
+    struct ts_msg_telemetry history[2];
+};
+
+/** @brief Sender-side state for one stream of readings. */
+struct ts_predict_encoder {
+    struct ts_telemetry_model model;
+    uint8_t seq;
+    bool resync_pending;
+    uint32_t last_resync; /**< Timestamp of the last resync sent */
+};
+
+/** @brief Receiver counters since ts_predict_decoder_init(). */
+struct ts_predict_decoder_stats {
+    uint32_t resyncs; /**< Resync messages applied */
+    uint32_t updates; /**< Other model updates applied */
+    uint32_t gaps;    /**< Sequence gaps detected */
+    uint32_t dropped; /**< Updates dropped while waiting for a resync */
+};
+
+/**
+ * @brief Empty a model.
+ *
+ * @param p_model  Model
+ */
+void ts_telemetry_model_reset(struct ts_telemetry_model* p_model);
+
+/**
+ * @brief Feed a sent reading to a model.
+ *
+ * @param p_model    Model
+ * @param p_reading  Reading the receiver got
+ */
+void ts_telemetry_model_update(struct ts_telemetry_model* p_model,
+                               const struct ts_msg_telemetry* p_reading);
+
+/**
+ * @brief Predict the reading at a given time.
+ *
+ * Extrapolates the line through the last two readings, rounded to the
+ * nearest value and clamped to each channel's declared range.  With a
+ * single reading, two readings at the same time, or a timestamp before
+ * the newest reading, the newest reading is the prediction.
+ *
+ * @param p_model    Model
+ * @param timestamp  Time to predict for
+ * @param p_out      Predicted reading, stamped with timestamp
+ * @return 0 on success, -ENODATA if the model is empty
+ */
+int ts_telemetry_model_predict(const struct ts_telemetry_model* p_model,
+                               uint32_t timestamp,
+                               struct ts_msg_telemetry* p_out);
+
+/**
+ * @brief Start a new stream; the first message will be a resync.
+ *
+ * @param p_enc  Encoder state
+ */
+void ts_predict_encoder_init(struct ts_predict_encoder* p_enc);
+
+/**
+ * @brief Make the next reading go out as a resync.
+ *
+ * For a sender that knows receivers lost state, e.g. after a restart or
+ * a configuration change.
+ *
+ * @param p_enc  Encoder state
+ */
+void ts_predict_encoder_request_resync(struct ts_predict_encoder* p_enc);
+
+/**
+ * @brief Decide whether a reading has to be sent.
+ *
+ * Sends a resync if one is pending, resync_interval_s have passed since
+ * the last one or the clock went backwards; otherwise sends an update
+ * if any channel is more than its bound away from the prediction.  A
+ * reading that is sent also updates the encoder's model.
+ *
+ * @param p_enc              Encoder state
+ * @param p_reading          New reading
+ * @param p_bound            Per-channel error bound, indexed by
+ *                           ts_telemetry_channel (0: any error is sent)
+ * @param resync_interval_s  Longest time between two resyncs
+ * @param p_out              Message to send, filled in if true is
+ *                           returned
+ * @return true if the reading should be sent
+ */
+bool ts_predict_encode(struct ts_predict_encoder* p_enc,
+                       const struct ts_msg_telemetry* p_reading,
+                       const int32_t* p_bound, uint32_t resync_interval_s,
+                       struct ts_msg_telemetry_model* p_out);
+
+/**
+ * @brief Forget all per-source models and reset the counters.
+ */
+void ts_predict_decoder_init(void);
+
+/**
+ * @brief Feed a source's model message to its model.
+ *
+ * @param src    Originating node
+ * @param p_msg  Received payload
+ * @param p_out  Reading the message carries
+ * @return 0 on success, -ENODATA if the source has no valid model (no
+ *         resync seen yet, or a gap since)
+ */
+int ts_predict_decode(uint16_t src, const struct ts_msg_telemetry_model* p_msg,
+                      struct ts_msg_telemetry* p_out);
+
+/**
+ * @brief Reconstruct a source's reading at a given time.
+ *
+ * Within the sender's error bound of what it read, as long as no
+ * message from it was lost since.
+ *
+ * @param src        Originating node
+ * @param timestamp  Time in the source's clock
+ * @param p_out      Estimated reading
+ * @return 0 on success, -ENODATA if the source has no valid model
+ */
+int ts_predict_estimate(uint16_t src, uint32_t timestamp,
+                        struct ts_msg_telemetry* p_out);
+
+/**
+ * @brief Copy the receiver counters.
+ *
+ * @param p_stats  Output counters
+ */
+void ts_predict_decoder_get_stats(struct ts_predict_decoder_stats* p_stats);
+
+/** @} */
+
+#endif  // TS_TELEMETRY_PREDICT_H
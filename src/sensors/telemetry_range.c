@@ -0,0 +1,56 @@
+#include "sensors/telemetry_range.h"
+
+#include <errno.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/util.h>
+
+LOG_MODULE_REGISTER(telemetry_range);
+
+static const struct ts_telemetry_range ranges[TS_TELEMETRY_CHANNEL_COUNT] = {
+    [TS_TELEMETRY_TEMPERATURE] = {.name = "temperature",
+                                  .scale = TS_TELEMETRY_TEMPERATURE_SCALE,
+                                  .min = TS_TELEMETRY_TEMPERATURE_MIN,
+                                  .max = TS_TELEMETRY_TEMPERATURE_MAX},
+    [TS_TELEMETRY_HUMIDITY] = {.name = "humidity",
+                               .scale = TS_TELEMETRY_HUMIDITY_SCALE,
+                               .min = TS_TELEMETRY_HUMIDITY_MIN,
+                               .max = TS_TELEMETRY_HUMIDITY_MAX},
+    [TS_TELEMETRY_PRESSURE] = {.name = "pressure",
+                               .scale = TS_TELEMETRY_PRESSURE_SCALE,
+                               .min = TS_TELEMETRY_PRESSURE_MIN,
+                               .max = TS_TELEMETRY_PRESSURE_MAX},
+};
+
+const struct ts_telemetry_range* ts_telemetry_range_get(
+    enum ts_telemetry_channel channel) {
+    if (channel < 0 || channel >= TS_TELEMETRY_CHANNEL_COUNT) { return NULL; }
+    return &ranges[channel];
+}
+
+int32_t ts_telemetry_value(const struct ts_msg_telemetry* p_reading,
+                           enum ts_telemetry_channel channel) {
+    switch (channel) {
+        case TS_TELEMETRY_TEMPERATURE:
+            return p_reading->temperature;
+        case TS_TELEMETRY_HUMIDITY:
+            return p_reading->humidity;
+        case TS_TELEMETRY_PRESSURE:
+            return p_reading->pressure;
+        default:
+            return 0;
+    }
+}
+
+int ts_telemetry_range_check(const struct ts_msg_telemetry* p_reading) {
+    int ret = 0;
+
+    for (int i = 0; i < TS_TELEMETRY_CHANNEL_COUNT; i++) {
+        int32_t value = ts_telemetry_value(p_reading, i);
+        if (value < ranges[i].min || value > ranges[i].max) {
+            LOG_WRN("%s %d outside [%d, %d]", ranges[i].name, value,
+                    ranges[i].min, ranges[i].max);
+            ret = -ERANGE;
+        }
+    }
+    return ret;
+}
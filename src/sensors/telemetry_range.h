@@ -0,0 +1,65 @@
+#ifndef TS_TELEMETRY_RANGE_H
+#define TS_TELEMETRY_RANGE_H
+
+/**
+ * @defgroup telemetry_range Telemetry Ranges
+ * @brief Per-channel scale and valid range of telemetry readings.
+ *
+ * Every sensor channel is declared once with its fixed-point scale and
+ * the range a working sensor can report (TS_TELEMETRY_*_MIN/MAX in
+ * messages.h).  The sensor manager checks each reading against it
+ * before sending, so a faulty sensor or a conversion bug shows up as a
+ * logged, dropped reading instead of a plausible-looking wrong value.
+ * @{
+ */
+
+#include <stdint.h>
+
+#include "messages/messages.h"
+
+/** @brief Sensor channels of a telemetry reading. */
+enum ts_telemetry_channel {
+    TS_TELEMETRY_TEMPERATURE,
+    TS_TELEMETRY_HUMIDITY,
+    TS_TELEMETRY_PRESSURE,
+    TS_TELEMETRY_CHANNEL_COUNT,
+};
+
+/** @brief Declared range of one channel. */
+struct ts_telemetry_range {
+    const char* name;
+    int32_t scale; /**< Stored value per unit, e.g. 100 for centi-°C */
+    int32_t min;   /**< Lowest valid stored value */
+    int32_t max;   /**< Highest valid stored value */
+};
+
+/**
+ * @brief Look up a channel's declared range.
+ *
+ * @param channel  Channel to look up
+ * @return Range descriptor, or NULL for an unknown channel
+ */
+const struct ts_telemetry_range* ts_telemetry_range_get(
+    enum ts_telemetry_channel channel);
+
+/**
+ * @brief Read one channel of a reading.
+ *
+ * @param p_reading  Reading
+ * @param channel    Channel to read (must be valid)
+ * @return Stored fixed-point value
+ */
+int32_t ts_telemetry_value(const struct ts_msg_telemetry* p_reading,
+                           enum ts_telemetry_channel channel);
+
+/**
+ * @brief Check every channel of a reading against its declared range.
+ *
+ * @param p_reading  Reading to check
+ * @return 0 if all channels are in range, -ERANGE otherwise
+ */
+int ts_telemetry_range_check(const struct ts_msg_telemetry* p_reading);
+
+/** @} */
+
+#endif  // TS_TELEMETRY_RANGE_H
@@ -0,0 +1,422 @@
+#include "sensors/telemetry_store.h"
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+
+#include "storage/flash_log.h"
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(telemetry_store);
+
+#define DUTY_PERMILLE CONFIG_TS_TELEMETRY_STORE_DUTY_CYCLE_PERMILLE
+
+#define BLOCK_BUF_SIZE \
+    TS_TELEMETRY_STORE_BLOCK_SIZE(TS_TELEMETRY_STORE_BLOCK_READINGS)
+
+// Full blocks waiting for the store's work queue to write them.  More
+// than one can be waiting when time steps cut several short blocks in
+// a row.
+#define SEALED_BLOCKS 2
+
+#define STORE_WORKQ_STACK_SIZE 1536
+
+// Every declared channel range must fit its record field
+BUILD_ASSERT(TS_TELEMETRY_TEMPERATURE_MIN >= INT16_MIN &&
+                 TS_TELEMETRY_TEMPERATURE_MAX <= INT16_MAX,
+             "Temperature must fit 16 bits");
+BUILD_ASSERT(TS_TELEMETRY_HUMIDITY_MIN >= 0 &&
+                 TS_TELEMETRY_HUMIDITY_MAX <= UINT16_MAX,
+             "Humidity must fit 16 bits");
+BUILD_ASSERT(TS_TELEMETRY_PRESSURE_MAX - TS_TELEMETRY_PRESSURE_MIN <=
+                 0xFFFFFF,
+             "Pressure offset must fit 24 bits");
+BUILD_ASSERT(TS_TELEMETRY_STORE_BLOCK_READINGS <= UINT8_MAX,
+             "Block count is one byte");
+
+#define PRESSURE_OFFSET_MAX 0xFFFFFF
+
+// Two locks keep flash off the callers of ts_telemetry_store_add(),
+// which run on the system work queue and the LoRa TX thread.
+// stage_mutex guards the RAM side (staged and sealed readings, stats)
+// and is never held across a flash access.  store_mutex guards the log
+// and the drain, and is held through every flash write.  Lock order:
+// store_mutex, then stage_mutex.
+static K_MUTEX_DEFINE(store_mutex);
+static K_MUTEX_DEFINE(stage_mutex);
+static struct ts_flash_log store_log;
+static bool store_ready;
+static struct ts_telemetry_store_stats stats;
+
+static K_THREAD_STACK_DEFINE(store_workq_stack, STORE_WORKQ_STACK_SIZE);
+static struct k_work_q store_workq;
+static bool store_workq_started;
+
+static void write_work_handler(struct k_work* work);
+static K_WORK_DEFINE(write_work, write_work_handler);
+
+// Readings not yet sealed into a block
+static struct ts_msg_telemetry staged[TS_TELEMETRY_STORE_BLOCK_READINGS];
+static uint8_t staged_count;
+
+// Encoded blocks not yet written, oldest at sealed_head
+struct sealed_block {
+    uint8_t data[BLOCK_BUF_SIZE];
+    size_t len;
+};
+static struct sealed_block sealed[SEALED_BLOCKS];
+static uint8_t sealed_head;
+static uint8_t sealed_count;
+
+// Block being drained.  A block read from flash stays in the log until
+// all its readings have been taken.
+static struct ts_msg_telemetry draining[TS_TELEMETRY_STORE_BLOCK_READINGS];
+static uint8_t drain_count;
+static uint8_t drain_pos;
+static bool drain_from_flash;
+
+static uint8_t block_buf[BLOCK_BUF_SIZE];
+
+static int record_pack(const struct ts_msg_telemetry* p_reading,
+                       uint32_t dt, uint8_t* p_out) {
+    int32_t pressure = p_reading->pressure - TS_TELEMETRY_PRESSURE_MIN;
+
+    if (dt > UINT16_MAX || p_reading->temperature < INT16_MIN ||
+        p_reading->temperature > INT16_MAX || p_reading->humidity < 0 ||
+        p_reading->humidity > UINT16_MAX || pressure < 0 ||
+        pressure > PRESSURE_OFFSET_MAX) {
+        return -ERANGE;
+    }
+    sys_put_be16((uint16_t)dt, &p_out[0]);
+    sys_put_be16((uint16_t)p_reading->temperature, &p_out[2]);
+    sys_put_be16((uint16_t)p_reading->humidity, &p_out[4]);
+    sys_put_be24((uint32_t)pressure, &p_out[6]);
+    return 0;
+}
+
+int ts_telemetry_store_encode(const struct ts_msg_telemetry* p_readings,
+                              size_t count, uint8_t* p_out,
+                              size_t out_size) {
+    if (count == 0 || count > UINT8_MAX) { return -EINVAL; }
+    if (out_size < TS_TELEMETRY_STORE_BLOCK_SIZE(count)) { return -EMSGSIZE; }
+
+    p_out[0] = TS_TELEMETRY_STORE_VERSION;
+    sys_put_be32(p_readings[0].timestamp, &p_out[1]);
+    p_out[5] = (uint8_t)count;
+
+    uint8_t* rec = &p_out[TS_TELEMETRY_STORE_HEADER_SIZE];
+    for (size_t i = 0; i < count; i++) {
+        uint32_t prev = i == 0 ? p_readings[0].timestamp
+                               : p_readings[i - 1].timestamp;
+        if (p_readings[i].timestamp < prev) { return -EINVAL; }
+
+        int ret = record_pack(&p_readings[i], p_readings[i].timestamp - prev,
+                              rec);
+        if (ret != 0) { return ret; }
+        rec += TS_TELEMETRY_STORE_RECORD_SIZE;
+    }
+    return TS_TELEMETRY_STORE_BLOCK_SIZE(count);
+}
+
+int ts_telemetry_store_decode(const uint8_t* p_in, size_t len,
+                              struct ts_msg_telemetry* p_readings,
+                              size_t max) {
+    if (len < TS_TELEMETRY_STORE_HEADER_SIZE ||
+        p_in[0] != TS_TELEMETRY_STORE_VERSION) {
+        return -EBADMSG;
+    }
+
+    uint8_t count = p_in[5];
+    if (count == 0 || len != TS_TELEMETRY_STORE_BLOCK_SIZE(count)) {
+        return -EBADMSG;
+    }
+    if (count > max) { return -EMSGSIZE; }
+
+    uint32_t timestamp = sys_get_be32(&p_in[1]);
+    const uint8_t* rec = &p_in[TS_TELEMETRY_STORE_HEADER_SIZE];
+    for (uint8_t i = 0; i < count; i++) {
+        timestamp += sys_get_be16(&rec[0]);
+        p_readings[i] = (struct ts_msg_telemetry){
+            .timestamp = timestamp,
+            .temperature = (int16_t)sys_get_be16(&rec[2]),
+            .humidity = sys_get_be16(&rec[4]),
+            .pressure = (int32_t)sys_get_be24(&rec[6]) +
+                        TS_TELEMETRY_PRESSURE_MIN,
+        };
+        rec += TS_TELEMETRY_STORE_RECORD_SIZE;
+    }
+    return count;
+}
+
+int ts_telemetry_store_init(uint8_t area_id) {
+    k_mutex_lock(&store_mutex, K_FOREVER);
+    if (!store_workq_started) {
+        const struct k_work_queue_config cfg = {.name = "telemetry_store"};
+
+        k_work_queue_init(&store_workq);
+        k_work_queue_start(&store_workq, store_workq_stack,
+                           K_THREAD_STACK_SIZEOF(store_workq_stack),
+                           K_LOWEST_APPLICATION_THREAD_PRIO, &cfg);
+        store_workq_started = true;
+    }
+
+    k_mutex_lock(&stage_mutex, K_FOREVER);
+    memset(&stats, 0, sizeof(stats));
+    staged_count = 0;
+    sealed_count = 0;
+    k_mutex_unlock(&stage_mutex);
+    drain_count = 0;
+    drain_pos = 0;
+    int ret = ts_flash_log_init(&store_log, area_id);
+
+    // Their uptime timestamps belong to the previous boot
+    uint32_t stale = ret == 0 ? ts_flash_log_pending(&store_log) : 0;
+    if (stale > 0) {
+        LOG_WRN("Dropping %u blocks from before reset", stale);
+        ret = ts_flash_log_clear(&store_log);
+        k_mutex_lock(&stage_mutex, K_FOREVER);
+        stats.stale_blocks = stale;
+        k_mutex_unlock(&stage_mutex);
+    }
+    store_ready = ret == 0;
+    k_mutex_unlock(&store_mutex);
+    return ret;
+}
+
+struct k_work_q* ts_telemetry_store_work_queue(void) { return &store_workq; }
+
+// Encode the staged readings as one block and queue it for writing;
+// called with stage_mutex held.  A block that finds the queue full is
+// lost, like one that fails to write.
+static int seal_locked(void) {
+    if (staged_count == 0) { return 0; }
+
+    int ret = -ENOBUFS;
+    if (sealed_count < SEALED_BLOCKS) {
+        struct sealed_block* blk =
+            &sealed[(sealed_head + sealed_count) % SEALED_BLOCKS];
+
+        ret = ts_telemetry_store_encode(staged, staged_count, blk->data,
+                                        sizeof(blk->data));
+        if (ret > 0) {
+            blk->len = ret;
+            sealed_count++;
+            ret = 0;
+        }
+    }
+    if (ret == 0) {
+        k_work_submit_to_queue(&store_workq, &write_work);
+    } else {
+        LOG_ERR("Lost %u stored readings: %d", staged_count, ret);
+        stats.write_errors++;
+    }
+    staged_count = 0;
+    return ret;
+}
+
+// Write every sealed block, oldest first; called with store_mutex held.
+// On a flash error the block is dropped rather than retried forever.
+static int write_sealed_locked(void) {
+    int first_err = 0;
+
+    while (true) {
+        k_mutex_lock(&stage_mutex, K_FOREVER);
+        if (sealed_count == 0) {
+            k_mutex_unlock(&stage_mutex);
+            return first_err;
+        }
+        size_t len = sealed[sealed_head].len;
+        memcpy(block_buf, sealed[sealed_head].data, len);
+        sealed_head = (sealed_head + 1) % SEALED_BLOCKS;
+        sealed_count--;
+        k_mutex_unlock(&stage_mutex);
+
+        int ret = ts_flash_log_append(&store_log, block_buf, len);
+
+        k_mutex_lock(&stage_mutex, K_FOREVER);
+        if (ret == 0) {
+            stats.blocks++;
+        } else {
+            LOG_ERR("Lost a block of stored readings: %d", ret);
+            stats.write_errors++;
+            if (first_err == 0) { first_err = ret; }
+        }
+        k_mutex_unlock(&stage_mutex);
+    }
+}
+
+static void write_work_handler(struct k_work* work) {
+    k_mutex_lock(&store_mutex, K_FOREVER);
+    if (store_ready) { write_sealed_locked(); }
+    k_mutex_unlock(&store_mutex);
+}
+
+int ts_telemetry_store_flush(void) {
+    k_mutex_lock(&store_mutex, K_FOREVER);
+    if (!store_ready) {
+        k_mutex_unlock(&store_mutex);
+        return -ENODEV;
+    }
+    k_mutex_lock(&stage_mutex, K_FOREVER);
+    int ret = seal_locked();
+    k_mutex_unlock(&stage_mutex);
+    int write_ret = write_sealed_locked();
+    k_mutex_unlock(&store_mutex);
+    return ret != 0 ? ret : write_ret;
+}
+
+int ts_telemetry_store_add(const struct ts_msg_telemetry* p_reading) {
+    uint8_t rec[TS_TELEMETRY_STORE_RECORD_SIZE];
+    int ret = 0;
+
+    // Values are checked on their own; the time step only decides
+    // whether the reading can join the staged block
+    if (record_pack(p_reading, 0, rec) != 0) { return -ERANGE; }
+
+    // store_ready only changes in init, before any reading is added
+    if (!store_ready) { return -ENODEV; }
+
+    k_mutex_lock(&stage_mutex, K_FOREVER);
+    if (staged_count > 0) {
+        uint32_t prev = staged[staged_count - 1].timestamp;
+        if (p_reading->timestamp < prev ||
+            p_reading->timestamp - prev > UINT16_MAX) {
+            ret = seal_locked();
+        }
+    }
+
+    staged[staged_count++] = *p_reading;
+    stats.stored++;
+    if (staged_count == TS_TELEMETRY_STORE_BLOCK_READINGS) {
+        int seal_ret = seal_locked();
+        if (ret == 0) { ret = seal_ret; }
+    }
+    k_mutex_unlock(&stage_mutex);
+    return ret;
+}
+
+int ts_telemetry_store_add_batch(
+    const struct ts_msg_telemetry_batch* p_batch) {
+    struct ts_msg_telemetry reading = {.timestamp = p_batch->base_timestamp};
+    int first_err = 0;
+
+    for (uint8_t i = 0; i < p_batch->count; i++) {
+        const struct ts_msg_telemetry_sample* s = &p_batch->samples[i];
+
+        reading.timestamp += s->dt;
+        reading.temperature = s->temperature;
+        reading.humidity = s->humidity;
+        reading.pressure = s->pressure;
+        int ret = ts_telemetry_store_add(&reading);
+        if (ret != 0 && first_err == 0) { first_err = ret; }
+    }
+    return first_err;
+}
+
+// Load the next block to drain: from flash, then blocks not yet written,
+// then the staged readings.  Called with store_mutex held.
+static int load_block(void) {
+    int len = ts_flash_log_peek(&store_log, block_buf, sizeof(block_buf));
+
+    while (len != -ENOENT) {
+        int count = len < 0 ? len
+                            : ts_telemetry_store_decode(block_buf, len,
+                                                        draining,
+                                                        ARRAY_SIZE(draining));
+        if (count > 0) {
+            drain_count = (uint8_t)count;
+            drain_pos = 0;
+            drain_from_flash = true;
+            return 0;
+        }
+        // Unreadable: skip it rather than stall the drain
+        LOG_WRN("Skipping stored block: %d", count);
+        ts_flash_log_pop(&store_log);
+        len = ts_flash_log_peek(&store_log, block_buf, sizeof(block_buf));
+    }
+
+    k_mutex_lock(&stage_mutex, K_FOREVER);
+    int count = -ENODATA;
+    if (sealed_count > 0) {
+        const struct sealed_block* blk = &sealed[sealed_head];
+
+        count = ts_telemetry_store_decode(blk->data, blk->len, draining,
+                                          ARRAY_SIZE(draining));
+        sealed_head = (sealed_head + 1) % SEALED_BLOCKS;
+        sealed_count--;
+    } else if (staged_count > 0) {
+        memcpy(draining, staged, staged_count * sizeof(staged[0]));
+        count = staged_count;
+        staged_count = 0;
+    }
+    k_mutex_unlock(&stage_mutex);
+
+    if (count <= 0) { return -ENODATA; }
+    drain_count = (uint8_t)count;
+    drain_pos = 0;
+    drain_from_flash = false;
+    return 0;
+}
+
+int ts_telemetry_store_take(struct ts_msg_telemetry_batch* p_out) {
+    k_mutex_lock(&store_mutex, K_FOREVER);
+    if (!store_ready ||
+        (drain_pos == drain_count && load_block() != 0)) {
+        k_mutex_unlock(&store_mutex);
+        return -ENODATA;
+    }
+
+    const struct ts_msg_telemetry* first = &draining[drain_pos];
+    uint32_t prev = first->timestamp;
+
+    p_out->base_timestamp = first->timestamp;
+    p_out->count = 0;
+    while (drain_pos < drain_count &&
+           p_out->count < TS_MSG_TELEMETRY_BATCH_MAX) {
+        const struct ts_msg_telemetry* r = &draining[drain_pos++];
+
+        // Readings of one block are in order with steps that fit a dt
+        p_out->samples[p_out->count++] = (struct ts_msg_telemetry_sample){
+            .dt = (uint16_t)(r->timestamp - prev),
+            .temperature = r->temperature,
+            .humidity = r->humidity,
+            .pressure = r->pressure,
+        };
+        prev = r->timestamp;
+    }
+    k_mutex_lock(&stage_mutex, K_FOREVER);
+    stats.drained += p_out->count;
+    k_mutex_unlock(&stage_mutex);
+
+    if (drain_pos == drain_count && drain_from_flash) {
+        ts_flash_log_pop(&store_log);
+        drain_from_flash = false;
+    }
+    k_mutex_unlock(&store_mutex);
+    return 0;
+}
+
+bool ts_telemetry_store_is_empty(void) {
+    // store_mutex is held while a block is written or drained, so there
+    // is something stored; answer without waiting for the flash
+    if (k_mutex_lock(&store_mutex, K_NO_WAIT) != 0) { return false; }
+    k_mutex_lock(&stage_mutex, K_FOREVER);
+    bool empty = !store_ready ||
+                 (drain_pos == drain_count && staged_count == 0 &&
+                  sealed_count == 0 && ts_flash_log_pending(&store_log) == 0);
+    k_mutex_unlock(&stage_mutex);
+    k_mutex_unlock(&store_mutex);
+    return empty;
+}
+
+uint32_t ts_telemetry_store_drain_delay_ms(uint32_t airtime_ms) {
+    return (uint32_t)((uint64_t)airtime_ms * (1000 - DUTY_PERMILLE) /
+                      DUTY_PERMILLE);
+}
+
+void ts_telemetry_store_get_stats(struct ts_telemetry_store_stats* p_stats) {
+    k_mutex_lock(&stage_mutex, K_FOREVER);
+    *p_stats = stats;
+    k_mutex_unlock(&stage_mutex);
+}
@@ -0,0 +1,196 @@
+#ifndef TS_TELEMETRY_STORE_H
+#define TS_TELEMETRY_STORE_H
+
+/**
+ * @defgroup telemetry_store Telemetry Store
+ * @brief Store-and-forward of this node's readings in flash.
+ *
+ * While the node has no neighbor to send through, or a telemetry frame
+ * fails to go out, its readings are kept here instead of being lost.
+ * They are staged in RAM and written to a flash log (see @ref
+ * flash_log) as one block of up to TS_TELEMETRY_STORE_BLOCK_READINGS,
+ * so flash sees one write per block rather than one per reading.
+ * Blocks are written by the store's own work queue, so adding a
+ * reading never waits for a flash write or sector erase.  Once
+ * neighbors are heard again, the sensor manager drains the store as
+ * telemetry batches, oldest first, paced to the duty-cycle share in
+ * CONFIG_TS_TELEMETRY_STORE_DUTY_CYCLE_PERMILLE.
+ *
+ * A block is stored as
+ *
+ *     [version:1 | base_timestamp:4 | count:1 | record ...]
+ *
+ * with 9-byte records
+ *
+ *     [dt:2 | temperature:2 | humidity:2 | pressure:3]
+ *
+ * dt is the time since the previous record (0 for the first), pressure
+ * is stored as an offset from TS_TELEMETRY_PRESSURE_MIN, and every
+ * field is big-endian.  This covers the declared range of every
+ * channel (telemetry_range.h) at full resolution in 9 bytes instead of
+ * the 16 of a ts_msg_telemetry.
+ *
+ * Readings carry uptime timestamps, which cannot be placed on the
+ * gateway's timeline once the node has restarted.  Blocks left from
+ * before a reset are therefore dropped when the store is opened, and
+ * readings still staged in RAM are lost with them.
+ * @{
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/kernel.h>
+
+#include "messages/messages.h"
+
+/** @brief Readings written to flash together (set via Kconfig). */
+#define TS_TELEMETRY_STORE_BLOCK_READINGS \
+    CONFIG_TS_TELEMETRY_STORE_BLOCK_READINGS
+
+/** @brief Block format version, first byte of every block. */
+#define TS_TELEMETRY_STORE_VERSION 1
+
+/** @brief Block header: version, base_timestamp, count. */
+#define TS_TELEMETRY_STORE_HEADER_SIZE 6
+
+/** @brief One stored reading. */
+#define TS_TELEMETRY_STORE_RECORD_SIZE 9
+
+/** @brief Encoded size of a block of count readings. */
+#define TS_TELEMETRY_STORE_BLOCK_SIZE(count) \
+    (TS_TELEMETRY_STORE_HEADER_SIZE +       \
+     (count) * TS_TELEMETRY_STORE_RECORD_SIZE)
+
+/** @brief Store counters since ts_telemetry_store_init(). */
+struct ts_telemetry_store_stats {
+    uint32_t stored;       /**< Readings accepted */
+    uint32_t drained;      /**< Readings handed out for sending */
+    uint32_t blocks;       /**< Blocks written to flash */
+    uint32_t write_errors; /**< Blocks lost to a flash error or backlog */
+    uint32_t stale_blocks; /**< Blocks from before a reset, dropped */
+};
+
+/**
+ * @brief Encode readings as one block.
+ *
+ * @param p_readings  Readings, in time order, each within its channel's
+ *                    declared range
+ * @param count       Number of readings (1–255)
+ * @param p_out       Output buffer
+ * @param out_size    Size of p_out; TS_TELEMETRY_STORE_BLOCK_SIZE(count)
+ *                    suffices
+ * @return Block length, -EINVAL for a bad count or readings out of time
+ *         order, -ERANGE if a value or time step doesn't fit its
+ *         field, -EMSGSIZE if p_out is too small
+ */
+int ts_telemetry_store_encode(const struct ts_msg_telemetry* p_readings,
+                              size_t count, uint8_t* p_out,
+                              size_t out_size);
+
+/**
+ * @brief Decode a block.
+ *
+ * @param p_in        Block
+ * @param len         Block length
+ * @param p_readings  Output readings
+ * @param max         Capacity of p_readings
+ * @return Number of readings, -EBADMSG for a malformed block, or
+ *         -EMSGSIZE if it holds more than max readings
+ */
+int ts_telemetry_store_decode(const uint8_t* p_in, size_t len,
+                              struct ts_msg_telemetry* p_readings,
+                              size_t max);
+
+/**
+ * @brief Open the store in a flash partition.
+ *
+ * Blocks left from before a reset are dropped and counted in
+ * stale_blocks.
+ *
+ * @param area_id  Partition, e.g. DT_FIXED_PARTITION_ID(DT_CHOSEN(
+ *                 terrascope_telemetry_store_partition))
+ * @return 0 on success, or the flash log error
+ */
+int ts_telemetry_store_init(uint8_t area_id);
+
+/**
+ * @brief Get the work queue that writes the store's blocks.
+ *
+ * Work that drains the store reads and pops flash blocks, and belongs
+ * here rather than on the system work queue.  Started by
+ * ts_telemetry_store_init().
+ */
+struct k_work_q* ts_telemetry_store_work_queue(void);
+
+/**
+ * @brief Keep a reading for later.
+ *
+ * The staged block is queued for writing when it is full, or first if
+ * the reading can't join it (time went backwards, or the step is
+ * longer than a dt can hold).  Never waits for flash.
+ *
+ * @param p_reading  Reading with its absolute timestamp
+ * @return 0 on success, -ENODEV if the store is not open, -ERANGE if
+ *         the reading can't be stored, or -ENOBUFS if the previous
+ *         block was lost because too many were waiting to be written
+ *         (the reading itself is kept)
+ */
+int ts_telemetry_store_add(const struct ts_msg_telemetry* p_reading);
+
+/**
+ * @brief Keep every reading of a batch for later.
+ *
+ * @param p_batch  Batch payload
+ * @return 0 on success, or the first error from ts_telemetry_store_add()
+ */
+int ts_telemetry_store_add_batch(
+    const struct ts_msg_telemetry_batch* p_batch);
+
+/**
+ * @brief Write the staged readings, and any blocks waiting for the
+ *        work queue, to flash now.
+ *
+ * Blocks the caller for the writes.
+ *
+ * @return 0 on success (or nothing staged), -ENODEV if the store is not
+ *         open, or the flash error
+ */
+int ts_telemetry_store_flush(void);
+
+/**
+ * @brief Take the oldest stored readings as one telemetry batch.
+ *
+ * Reads flash first, then blocks not yet written, then the staged
+ * readings.  A flash block is consumed once all its readings have been
+ * taken.
+ *
+ * @param p_out  Output batch of up to TS_MSG_TELEMETRY_BATCH_MAX
+ *               readings
+ * @return 0 on success, -ENODATA if the store is empty
+ */
+int ts_telemetry_store_take(struct ts_msg_telemetry_batch* p_out);
+
+/**
+ * @brief Check whether anything is waiting to be drained.
+ */
+bool ts_telemetry_store_is_empty(void);
+
+/**
+ * @brief Wait after a drained frame to stay within the duty-cycle share.
+ *
+ * @param airtime_ms  Time on air of the frame just sent
+ * @return Silence in milliseconds: airtime * (1000 / permille - 1)
+ */
+uint32_t ts_telemetry_store_drain_delay_ms(uint32_t airtime_ms);
+
+/**
+ * @brief Copy the store counters.
+ *
+ * @param p_stats  Output counters
+ */
+void ts_telemetry_store_get_stats(struct ts_telemetry_store_stats* p_stats);
+
+/** @} */
+
+#endif  // TS_TELEMETRY_STORE_H
@@ -0,0 +1,112 @@
+#include "sensors/telemetry_window.h"
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/sys/util.h>
+
+// The summary has one min/max/mean triple per channel
+BUILD_ASSERT(TS_TELEMETRY_CHANNEL_COUNT == 3,
+             "Update ts_msg_telemetry_summary for the new channel");
+
+// Divide rounding to nearest, halves away from zero
+static int32_t div_round(int64_t sum, uint16_t count) {
+    int64_t half = count / 2;
+    return (int32_t)(sum >= 0 ? (sum + half) / count : (sum - half) / count);
+}
+
+void ts_telemetry_window_reset(struct ts_telemetry_window* p_win) {
+    memset(p_win, 0, sizeof(*p_win));
+}
+
+int ts_telemetry_window_add(struct ts_telemetry_window* p_win,
+                            const struct ts_msg_telemetry* p_reading) {
+    if (p_win->count > 0) {
+        if (p_reading->timestamp < p_win->end) { return -EINVAL; }
+        if (p_win->count == UINT16_MAX ||
+            p_reading->timestamp - p_win->start > UINT16_MAX) {
+            return -ENOSPC;
+        }
+    } else {
+        p_win->start = p_reading->timestamp;
+    }
+
+    for (int ch = 0; ch < TS_TELEMETRY_CHANNEL_COUNT; ch++) {
+        int32_t value = ts_telemetry_value(p_reading, ch);
+
+        if (p_win->count == 0 || value < p_win->min[ch]) {
+            p_win->min[ch] = value;
+        }
+        if (p_win->count == 0 || value > p_win->max[ch]) {
+            p_win->max[ch] = value;
+        }
+        p_win->sum[ch] += value;
+    }
+    p_win->end = p_reading->timestamp;
+    p_win->count++;
+    return 0;
+}
+
+int ts_telemetry_window_summarize(const struct ts_telemetry_window* p_win,
+                                  struct ts_msg_telemetry_summary* p_out) {
+    if (p_win->count == 0) { return -ENODATA; }
+
+    *p_out = (struct ts_msg_telemetry_summary){
+        .timestamp = p_win->start,
+        .duration_s = (uint16_t)(p_win->end - p_win->start),
+        .count = p_win->count,
+        .temperature_min = p_win->min[TS_TELEMETRY_TEMPERATURE],
+        .temperature_max = p_win->max[TS_TELEMETRY_TEMPERATURE],
+        .temperature_mean =
+            div_round(p_win->sum[TS_TELEMETRY_TEMPERATURE], p_win->count),
+        .humidity_min = p_win->min[TS_TELEMETRY_HUMIDITY],
+        .humidity_max = p_win->max[TS_TELEMETRY_HUMIDITY],
+        .humidity_mean =
+            div_round(p_win->sum[TS_TELEMETRY_HUMIDITY], p_win->count),
+        .pressure_min = p_win->min[TS_TELEMETRY_PRESSURE],
+        .pressure_max = p_win->max[TS_TELEMETRY_PRESSURE],
+        .pressure_mean =
+            div_round(p_win->sum[TS_TELEMETRY_PRESSURE], p_win->count),
+    };
+    return 0;
+}
+
+bool ts_telemetry_deadband_check(
+    struct ts_telemetry_deadband* p_db,
+    const struct ts_msg_telemetry_summary* p_summary, const int32_t* p_deadband,
+    uint32_t max_silence_s) {
+    const int32_t min[] = {p_summary->temperature_min, p_summary->humidity_min,
+                           p_summary->pressure_min};
+    const int32_t max[] = {p_summary->temperature_max, p_summary->humidity_max,
+                           p_summary->pressure_max};
+    const int32_t mean[] = {p_summary->temperature_mean,
+                            p_summary->humidity_mean, p_summary->pressure_mean};
+    uint32_t end = p_summary->timestamp + p_summary->duration_s;
+    // A clock that went backwards counts as silence
+    bool send = !p_db->reported || end < p_db->last_report ||
+                end - p_db->last_report >= max_silence_s;
+
+    for (int ch = 0; ch < TS_TELEMETRY_CHANNEL_COUNT && !send; ch++) {
+        // 64-bit so that a wide deadband can't overflow
+        int64_t lo = (int64_t)p_db->last_mean[ch] - p_deadband[ch];
+        int64_t hi = (int64_t)p_db->last_mean[ch] + p_deadband[ch];
+        send = min[ch] < lo || max[ch] > hi;
+    }
+
+    if (send) {
+        p_db->reported = true;
+        p_db->last_report = end;
+        memcpy(p_db->last_mean, mean, sizeof(p_db->last_mean));
+    }
+    return send;
+}
+
+void ts_telemetry_summary_mean(
+    const struct ts_msg_telemetry_summary* p_summary,
+    struct ts_msg_telemetry* p_out) {
+    *p_out = (struct ts_msg_telemetry){
+        .timestamp = p_summary->timestamp + p_summary->duration_s,
+        .temperature = p_summary->temperature_mean,
+        .humidity = p_summary->humidity_mean,
+        .pressure = p_summary->pressure_mean,
+    };
+}
@@ -0,0 +1,111 @@
+#ifndef TS_TELEMETRY_WINDOW_H
+#define TS_TELEMETRY_WINDOW_H
+
+/**
+ * @defgroup telemetry_window Telemetry Windows
+ * @brief Windowed min/max/mean of readings and report-on-change
+ *        deadbands.
+ *
+ * Environmental readings change slowly compared to how often they are
+ * worth sampling.  Instead of sending every reading, the sensor manager
+ * can sample often and send one TS_MSG_TELEMETRY_SUMMARY per window
+ * with the lowest, highest and mean value of each channel, so short
+ * excursions still show up in min/max.
+ *
+ * A summary is only sent if it tells the receiver something new: when
+ * some reading of the window left the deadband around the mean last
+ * reported for its channel, or when nothing has been reported for the
+ * maximum silence interval, so a quiet node still shows it is alive.
+ * Comparing against the last report rather than the previous window
+ * means slow drift is reported once it adds up to a deadband.
+ * @{
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "messages/messages.h"
+#include "sensors/telemetry_range.h"
+
+/** @brief Running statistics of the readings in one window. */
+struct ts_telemetry_window {
+    uint32_t start; /**< Timestamp of the first reading */
+    uint32_t end;   /**< Timestamp of the latest reading */
+    uint16_t count;
+    int32_t min[TS_TELEMETRY_CHANNEL_COUNT];
+    int32_t max[TS_TELEMETRY_CHANNEL_COUNT];
+    int64_t sum[TS_TELEMETRY_CHANNEL_COUNT];
+};
+
+/** @brief What the receiver was last told. */
+struct ts_telemetry_deadband {
+    bool reported;        /**< A summary has been sent */
+    uint32_t last_report; /**< End of the last window sent */
+    int32_t last_mean[TS_TELEMETRY_CHANNEL_COUNT];
+};
+
+/**
+ * @brief Empty a window.
+ *
+ * @param p_win  Window
+ */
+void ts_telemetry_window_reset(struct ts_telemetry_window* p_win);
+
+/**
+ * @brief Add a reading to a window.
+ *
+ * @param p_win      Window
+ * @param p_reading  Reading, not older than the previous one
+ * @return 0 on success, -EINVAL if time went backwards, -ENOSPC if the
+ *         window holds UINT16_MAX readings or would span more than
+ *         UINT16_MAX seconds; the window is unchanged on error
+ */
+int ts_telemetry_window_add(struct ts_telemetry_window* p_win,
+                            const struct ts_msg_telemetry* p_reading);
+
+/**
+ * @brief Summarize a window.
+ *
+ * Means are rounded to the nearest value.
+ *
+ * @param p_win  Window
+ * @param p_out  Output summary
+ * @return 0 on success, -ENODATA if the window is empty
+ */
+int ts_telemetry_window_summarize(const struct ts_telemetry_window* p_win,
+                                  struct ts_msg_telemetry_summary* p_out);
+
+/**
+ * @brief Decide whether a summary is worth sending.
+ *
+ * Returns true, and records the summary as reported, for the first
+ * summary, when a channel's min or max lies more than its deadband away
+ * from the mean last reported, or when at least max_silence_s have
+ * passed since the last report.
+ *
+ * @param p_db           Report state
+ * @param p_summary      Summary of the window just closed
+ * @param p_deadband     Per-channel deadband, indexed by
+ *                       ts_telemetry_channel (0: any change is sent)
+ * @param max_silence_s  Longest time between two reports
+ * @return true if the summary should be sent
+ */
+bool ts_telemetry_deadband_check(
+    struct ts_telemetry_deadband* p_db,
+    const struct ts_msg_telemetry_summary* p_summary, const int32_t* p_deadband,
+    uint32_t max_silence_s);
+
+/**
+ * @brief The reading a summary stands for: its means, stamped at the
+ *        end of the window.
+ *
+ * @param p_summary  Summary
+ * @param p_out      Output reading
+ */
+void ts_telemetry_summary_mean(
+    const struct ts_msg_telemetry_summary* p_summary,
+    struct ts_msg_telemetry* p_out);
+
+/** @} */
+
+#endif  // TS_TELEMETRY_WINDOW_H
@@ -0,0 +1,319 @@
+#include "storage/flash_log.h"
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(flash_log);
+
+#define FLASH_LOG_MAGIC 0x54534c47  // "TSLG"
+#define FLASH_LOG_VERSION 2
+
+// Largest flash write block supported; entries are written through a
+// stack buffer of whole blocks
+#define FLASH_LOG_MAX_ALIGN 32
+
+// Every entry starts with a kind byte and a sequence number.  Data
+// entries are numbered in append order.  A marker is appended on each
+// pop and carries the number of the data entry it consumed, so the
+// read position survives a reset.
+#define ENTRY_DATA 0
+#define ENTRY_MARKER 1
+
+struct entry_hdr {
+    uint8_t kind;
+    uint32_t seq;
+};
+
+BUILD_ASSERT(TS_FLASH_LOG_HDR_SIZE == 1 + sizeof(uint32_t));
+
+static int read_hdr(struct ts_flash_log* p_log, const struct fcb_entry* p_loc,
+                    struct entry_hdr* p_hdr) {
+    uint8_t buf[TS_FLASH_LOG_HDR_SIZE];
+
+    if (p_loc->fe_data_len < sizeof(buf)) { return -EBADMSG; }
+    int ret = flash_area_read(p_log->fcb.fap, FCB_ENTRY_FA_DATA_OFF(*p_loc),
+                              buf, sizeof(buf));
+    if (ret != 0) { return ret; }
+    p_hdr->kind = buf[0];
+    memcpy(&p_hdr->seq, &buf[1], sizeof(p_hdr->seq));
+    return 0;
+}
+
+// Advance p_loc to the next data entry, skipping markers
+static int next_data(struct ts_flash_log* p_log, struct fcb_entry* p_loc,
+                     uint32_t* p_seq) {
+    struct entry_hdr hdr;
+
+    while (fcb_getnext(&p_log->fcb, p_loc) == 0) {
+        if (read_hdr(p_log, p_loc, &hdr) == 0 && hdr.kind == ENTRY_DATA) {
+            *p_seq = hdr.seq;
+            return 0;
+        }
+    }
+    return -ENOENT;
+}
+
+// Data entries after the read cursor
+static uint32_t count_pending(struct ts_flash_log* p_log) {
+    struct fcb_entry loc = p_log->read_loc;
+    uint32_t count = 0;
+    uint32_t seq;
+
+    while (next_data(p_log, &loc, &seq) == 0) { count++; }
+    return count;
+}
+
+// Put the read cursor back on the last data entry popped before the
+// reset: the one the newest marker names.  Markers are appended after
+// the entries they consume and sectors are erased oldest first, so
+// when the newest marker is gone so is every entry it covered.
+static void restore_cursor(struct ts_flash_log* p_log) {
+    struct fcb_entry loc = {0};
+    struct entry_hdr hdr;
+    bool any = false;
+    bool consumed_any = false;
+    uint32_t consumed = 0;
+    uint32_t seq;
+
+    while (fcb_getnext(&p_log->fcb, &loc) == 0) {
+        if (read_hdr(p_log, &loc, &hdr) != 0) { continue; }
+        if (hdr.kind == ENTRY_MARKER) {
+            consumed = hdr.seq;
+            consumed_any = true;
+        }
+        p_log->next_seq = any ? MAX(p_log->next_seq, hdr.seq + 1)
+                              : hdr.seq + 1;
+        any = true;
+    }
+    if (!consumed_any) { return; }
+
+    loc = (struct fcb_entry){0};
+    while (next_data(p_log, &loc, &seq) == 0 && seq <= consumed) {
+        p_log->read_loc = loc;
+    }
+}
+
+static int fcb_open(struct ts_flash_log* p_log, uint8_t area_id,
+                    uint32_t sector_cnt) {
+    memset(&p_log->fcb, 0, sizeof(p_log->fcb));
+    p_log->fcb.f_magic = FLASH_LOG_MAGIC;
+    p_log->fcb.f_version = FLASH_LOG_VERSION;
+    p_log->fcb.f_sector_cnt = sector_cnt;
+    p_log->fcb.f_sectors = p_log->sectors;
+    return fcb_init(area_id, &p_log->fcb);
+}
+
+int ts_flash_log_init(struct ts_flash_log* p_log, uint8_t area_id) {
+    const struct flash_area* fa;
+    uint32_t sector_cnt = TS_FLASH_LOG_MAX_SECTORS;
+    int ret;
+
+    memset(p_log, 0, sizeof(*p_log));
+    k_mutex_init(&p_log->mutex);
+
+    ret = flash_area_get_sectors(area_id, &sector_cnt, p_log->sectors);
+    if (ret != 0) { return ret; }
+    if (sector_cnt < 2) { return -EINVAL; }
+
+    ret = flash_area_open(area_id, &fa);
+    if (ret != 0) { return ret; }
+    uint32_t align = flash_area_align(fa);
+    flash_area_close(fa);
+    if (align > FLASH_LOG_MAX_ALIGN) { return -ENOTSUP; }
+
+    ret = fcb_open(p_log, area_id, sector_cnt);
+    if (ret != 0) {
+        // Another user's data, or a layout from a different sector
+        // count: start over
+        LOG_WRN("No usable log in area %u (%d), erasing", area_id, ret);
+        ret = flash_area_open(area_id, &fa);
+        if (ret != 0) { return ret; }
+        ret = flash_area_erase(fa, 0, fa->fa_size);
+        flash_area_close(fa);
+        if (ret != 0) { return ret; }
+        ret = fcb_open(p_log, area_id, sector_cnt);
+        if (ret != 0) { return ret; }
+    }
+
+    restore_cursor(p_log);
+    p_log->stats.pending = count_pending(p_log);
+    if (p_log->stats.pending > 0) {
+        LOG_INF("%u entries left from before reset", p_log->stats.pending);
+    }
+    return 0;
+}
+
+// Erase the oldest sector to make room; called with the mutex held
+static int drop_oldest(struct ts_flash_log* p_log) {
+    if (p_log->read_loc.fe_sector == p_log->fcb.f_oldest) {
+        p_log->read_loc.fe_sector = NULL;
+    }
+
+    int ret = fcb_rotate(&p_log->fcb);
+    if (ret != 0) { return ret; }
+
+    uint32_t pending = count_pending(p_log);
+    p_log->stats.dropped += p_log->stats.pending - pending;
+    p_log->stats.pending = pending;
+    return 0;
+}
+
+// Header and data go out as one stream through a buffer of whole write
+// blocks; the last block is padded with the erased value
+static int write_entry(struct ts_flash_log* p_log, struct fcb_entry* p_loc,
+                       const struct entry_hdr* p_hdr, const uint8_t* p_data,
+                       size_t len) {
+    const struct flash_area* fa = p_log->fcb.fap;
+    uint32_t off = FCB_ENTRY_FA_DATA_OFF(*p_loc);
+    size_t align = flash_area_align(fa);
+    size_t total = TS_FLASH_LOG_HDR_SIZE + len;
+    uint8_t stage[2 * FLASH_LOG_MAX_ALIGN];
+
+    stage[0] = p_hdr->kind;
+    memcpy(&stage[1], &p_hdr->seq, sizeof(p_hdr->seq));
+
+    for (size_t done = 0; done < total;) {
+        size_t start = done == 0 ? TS_FLASH_LOG_HDR_SIZE : 0;
+        size_t n = MIN(sizeof(stage), total - done);
+        size_t padded = ROUND_UP(n, align);
+
+        if (n > start) {
+            memcpy(&stage[start],
+                   &p_data[done + start - TS_FLASH_LOG_HDR_SIZE], n - start);
+        }
+        memset(&stage[n], flash_area_erased_val(fa), padded - n);
+        int ret = flash_area_write(fa, off + done, stage, padded);
+        if (ret != 0) { return ret; }
+        done += n;
+    }
+    return fcb_append_finish(&p_log->fcb, p_loc);
+}
+
+// Called with the mutex held
+static int append_entry(struct ts_flash_log* p_log, uint8_t kind,
+                        uint32_t seq, const uint8_t* p_data, size_t len,
+                        bool may_drop) {
+    struct entry_hdr hdr = {.kind = kind, .seq = seq};
+    struct fcb_entry loc;
+    int ret;
+
+    ret = fcb_append(&p_log->fcb, TS_FLASH_LOG_HDR_SIZE + len, &loc);
+    if (ret == -ENOSPC && may_drop) {
+        ret = drop_oldest(p_log);
+        if (ret == 0) {
+            ret = fcb_append(&p_log->fcb, TS_FLASH_LOG_HDR_SIZE + len, &loc);
+        }
+    }
+    if (ret == 0) { ret = write_entry(p_log, &loc, &hdr, p_data, len); }
+    return ret;
+}
+
+int ts_flash_log_append(struct ts_flash_log* p_log, const void* p_data,
+                        size_t len) {
+    int ret;
+
+    if (len == 0 || len > TS_FLASH_LOG_MAX_ENTRY) { return -EINVAL; }
+
+    k_mutex_lock(&p_log->mutex, K_FOREVER);
+    ret = append_entry(p_log, ENTRY_DATA, p_log->next_seq, p_data, len,
+                       true);
+    if (ret == 0) {
+        p_log->next_seq++;
+        p_log->stats.appended++;
+        p_log->stats.pending++;
+    }
+    k_mutex_unlock(&p_log->mutex);
+    return ret;
+}
+
+int ts_flash_log_peek(struct ts_flash_log* p_log, void* p_buf, size_t size) {
+    struct fcb_entry loc;
+    uint32_t seq;
+    int ret;
+
+    k_mutex_lock(&p_log->mutex, K_FOREVER);
+    loc = p_log->read_loc;
+    if (next_data(p_log, &loc, &seq) != 0) {
+        ret = -ENOENT;
+    } else if (loc.fe_data_len > TS_FLASH_LOG_HDR_SIZE + size) {
+        ret = -EMSGSIZE;
+    } else {
+        size_t len = loc.fe_data_len - TS_FLASH_LOG_HDR_SIZE;
+
+        ret = flash_area_read(p_log->fcb.fap,
+                              FCB_ENTRY_FA_DATA_OFF(loc) +
+                                  TS_FLASH_LOG_HDR_SIZE,
+                              p_buf, len);
+        if (ret == 0) { ret = (int)len; }
+    }
+    k_mutex_unlock(&p_log->mutex);
+    return ret;
+}
+
+int ts_flash_log_pop(struct ts_flash_log* p_log) {
+    struct fcb_entry loc;
+    uint32_t seq;
+    int ret = 0;
+
+    k_mutex_lock(&p_log->mutex, K_FOREVER);
+    loc = p_log->read_loc;
+    if (next_data(p_log, &loc, &seq) != 0) {
+        k_mutex_unlock(&p_log->mutex);
+        return -ENOENT;
+    }
+    p_log->read_loc = loc;
+    p_log->stats.consumed++;
+    p_log->stats.pending--;
+
+    // Sectors behind the cursor hold consumed entries only.  The
+    // cursor's own sector is kept: the next read starts from it.
+    while (ret == 0 && p_log->fcb.f_oldest != loc.fe_sector) {
+        ret = fcb_rotate(&p_log->fcb);
+    }
+
+    // Record the pop.  A marker never pushes out unread entries: with
+    // the log full it is left out, and the entries popped since the
+    // last marker are read again after a reset.
+    if (ret == 0) {
+        ret = append_entry(p_log, ENTRY_MARKER, seq, NULL, 0, false);
+        if (ret == -ENOSPC) { ret = 0; }
+    }
+    k_mutex_unlock(&p_log->mutex);
+    return ret;
+}
+
+int ts_flash_log_clear(struct ts_flash_log* p_log) {
+    const struct flash_area* fa;
+    int ret;
+
+    k_mutex_lock(&p_log->mutex, K_FOREVER);
+    fa = p_log->fcb.fap;
+    ret = flash_area_erase(fa, 0, fa->fa_size);
+    if (ret == 0) {
+        ret = fcb_open(p_log, fa->fa_id, p_log->fcb.f_sector_cnt);
+    }
+    if (ret == 0) {
+        p_log->read_loc = (struct fcb_entry){0};
+        p_log->next_seq = 0;
+        p_log->stats.dropped += p_log->stats.pending;
+        p_log->stats.pending = 0;
+    }
+    k_mutex_unlock(&p_log->mutex);
+    return ret;
+}
+
+uint32_t ts_flash_log_pending(struct ts_flash_log* p_log) {
+    k_mutex_lock(&p_log->mutex, K_FOREVER);
+    uint32_t pending = p_log->stats.pending;
+    k_mutex_unlock(&p_log->mutex);
+    return pending;
+}
+
+void ts_flash_log_get_stats(struct ts_flash_log* p_log,
+                            struct ts_flash_log_stats* p_stats) {
+    k_mutex_lock(&p_log->mutex, K_FOREVER);
+    *p_stats = p_log->stats;
+    k_mutex_unlock(&p_log->mutex);
+}
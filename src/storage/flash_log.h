@@ -0,0 +1,138 @@
+#ifndef TS_FLASH_LOG_H
+#define TS_FLASH_LOG_H
+
+/**
+ * @defgroup flash_log Flash Log
+ * @brief FIFO of variable-length entries in a flash partition, for data
+ *        that has to outlive an outage or a reboot.
+ *
+ * Entries are appended to an FCB (flash circular buffer) and read back
+ * oldest first.  FCB never rewrites an entry in place: reading moves a
+ * cursor, and a sector is erased once every entry in it has been
+ * consumed, so each sector is erased once per pass over the partition.
+ * When the partition is full the oldest sector is erased to make room
+ * and its unread entries are counted as dropped.
+ *
+ * Each pop appends a small marker entry naming the entry it consumed,
+ * and ts_flash_log_init() resumes after the newest marker, so entries
+ * are not read again after a reboot.  The exception is a pop while the
+ * partition is full: its marker is skipped rather than erase unread
+ * entries, and a reboot before the next marker replays those pops.
+ * Consumers should still tolerate the odd duplicate (the uplink frames
+ * carry a sequence number and the records their msg_id).
+ *
+ * One log owns its partition; the partition needs at least two
+ * sectors.
+ * @{
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/fs/fcb.h>
+#include <zephyr/kernel.h>
+#include <zephyr/storage/flash_map.h>
+
+/** @brief Most sectors a log partition may have. */
+#define TS_FLASH_LOG_MAX_SECTORS 32
+
+/** @brief Bytes the log stores in front of every entry. */
+#define TS_FLASH_LOG_HDR_SIZE 5
+
+/** @brief Longest entry, limited by the FCB length encoding. */
+#define TS_FLASH_LOG_MAX_ENTRY (FCB_MAX_LEN - TS_FLASH_LOG_HDR_SIZE)
+
+/** @brief Flash log counters. */
+struct ts_flash_log_stats {
+    uint32_t appended;  ///< Entries written
+    uint32_t consumed;  ///< Entries read and popped
+    uint32_t dropped;   ///< Unread entries erased to make room
+    uint32_t pending;   ///< Entries waiting to be read
+};
+
+/** @brief Flash log instance; treat as opaque. */
+struct ts_flash_log {
+    struct fcb fcb;
+    struct flash_sector sectors[TS_FLASH_LOG_MAX_SECTORS];
+    // Last consumed entry; fe_sector is NULL before the first pop
+    struct fcb_entry read_loc;
+    uint32_t next_seq;  // Sequence number of the next appended entry
+    struct ts_flash_log_stats stats;
+    struct k_mutex mutex;
+};
+
+/**
+ * @brief Open the log in a flash partition.
+ *
+ * Entries left unread before a reboot are kept and read first.  A
+ * partition that holds no valid FCB, or one written by an older log
+ * format, is erased.
+ *
+ * @param p_log    Log to initialize
+ * @param area_id  Partition, e.g. FIXED_PARTITION_ID(storage_partition)
+ * @return 0 on success, -ENOMEM if the partition has more than
+ *         TS_FLASH_LOG_MAX_SECTORS sectors, or a flash/FCB error
+ */
+int ts_flash_log_init(struct ts_flash_log* p_log, uint8_t area_id);
+
+/**
+ * @brief Append an entry.
+ *
+ * Erases the oldest sector when the log is full.
+ *
+ * @param p_log   Log
+ * @param p_data  Entry data
+ * @param len     Entry length, 1 to TS_FLASH_LOG_MAX_ENTRY
+ * @return 0 on success, -EINVAL for a bad length, or a flash error
+ */
+int ts_flash_log_append(struct ts_flash_log* p_log, const void* p_data,
+                        size_t len);
+
+/**
+ * @brief Read the oldest unread entry without consuming it.
+ *
+ * @param p_log  Log
+ * @param p_buf  Output buffer
+ * @param size   Size of p_buf
+ * @return Entry length, -ENOENT if the log is empty, -EMSGSIZE if the
+ *         entry does not fit p_buf, or a flash error
+ */
+int ts_flash_log_peek(struct ts_flash_log* p_log, void* p_buf, size_t size);
+
+/**
+ * @brief Consume the oldest unread entry.
+ *
+ * Call after the entry returned by ts_flash_log_peek() has been
+ * handled.  Sectors left without unread entries are erased.
+ *
+ * @param p_log  Log
+ * @return 0 on success, -ENOENT if the log is empty, or a flash error
+ */
+int ts_flash_log_pop(struct ts_flash_log* p_log);
+
+/**
+ * @brief Drop every entry and start the log over.
+ *
+ * Erases the partition.  Unread entries are counted as dropped.
+ *
+ * @param p_log  Log
+ * @return 0 on success, or a flash/FCB error
+ */
+int ts_flash_log_clear(struct ts_flash_log* p_log);
+
+/**
+ * @brief Number of entries waiting to be read.
+ */
+uint32_t ts_flash_log_pending(struct ts_flash_log* p_log);
+
+/**
+ * @brief Get a snapshot of the counters.
+ *
+ * @param p_log    Log
+ * @param p_stats  Output
+ */
+void ts_flash_log_get_stats(struct ts_flash_log* p_log,
+                            struct ts_flash_log_stats* p_stats);
+
+/** @} */
+
+#endif  // TS_FLASH_LOG_H
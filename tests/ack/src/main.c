@@ -0,0 +1,231 @@
+#include <zephyr/zbus/zbus.h>
+#include <zephyr/ztest.h>
+
+#include "lora/ack.h"
+#include "lora/contention.h"
+#include "lora/tx_power.h"
+#include "routing/routing.h"
+#include "routing/routing_table.h"
+
+// Test-local zbus channel required by the retransmit work handler
+ZBUS_CHAN_DEFINE(ts_lora_out_chan, struct ts_msg_lora_outgoing, NULL, NULL,
+                 ZBUS_OBSERVERS_EMPTY, ZBUS_MSG_INIT(0));
+
+#define SELF 0x0001
+#define PEER 0x0002
+#define AIRTIME_MS 400
+
+static void before_each(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    ts_routing_init(SELF);
+    ts_routing_table_init();
+    ts_tx_power_init(10);
+    ts_ack_init();
+}
+
+static struct ts_msg_lora_outgoing make_unicast(uint32_t msg_id, uint8_t ttl)
+{
+    struct ts_msg_lora_outgoing msg = {
+        .route = {.src = SELF, .dst = PEER, .msg_id = msg_id, .ttl = ttl},
+        .type = TS_MSG_TELEMETRY,
+    };
+    return msg;
+}
+
+/* --- Policy --- */
+
+ZTEST(ack, test_unicast_requires_ack)
+{
+    struct ts_msg_lora_outgoing msg = make_unicast(1, 4);
+    zassert_true(ts_ack_required(&msg));
+}
+
+ZTEST(ack, test_broadcast_ack_and_bulk_frames_exempt)
+{
+    struct ts_msg_lora_outgoing msg = make_unicast(1, 4);
+
+    msg.route.dst = TS_ROUTING_BROADCAST_ADDR;
+    zassert_false(ts_ack_required(&msg), "Broadcast is never acknowledged");
+
+    msg.route.dst = PEER;
+    msg.type = TS_MSG_ACK;
+    zassert_false(ts_ack_required(&msg), "ACKs are never acknowledged");
+
+    msg.type = TS_MSG_BULK_DATA;
+    zassert_false(ts_ack_required(&msg), "Bulk chunks recover end to end");
+    msg.type = TS_MSG_BULK_STATUS;
+    zassert_false(ts_ack_required(&msg), "Bulk statuses recover end to end");
+}
+
+ZTEST(ack, test_timeout_covers_contention_window)
+{
+    zassert_equal(ts_ack_timeout_ms(AIRTIME_MS, 0),
+                  TS_CONTENTION_DELAY_MAX_MS + 2 * AIRTIME_MS);
+}
+
+ZTEST(ack, test_timeout_backoff_doubles_and_saturates)
+{
+    uint32_t base = TS_CONTENTION_DELAY_MAX_MS + AIRTIME_MS;
+
+    zassert_equal(ts_ack_timeout_ms(AIRTIME_MS, 1), base + 2 * AIRTIME_MS);
+    zassert_equal(ts_ack_timeout_ms(AIRTIME_MS, 2), base + 4 * AIRTIME_MS);
+    zassert_equal(ts_ack_timeout_ms(AIRTIME_MS, 10),
+                  base + TS_ACK_BACKOFF_MAX_MS);
+    zassert_equal(ts_ack_timeout_ms(AIRTIME_MS, 40),
+                  base + TS_ACK_BACKOFF_MAX_MS);
+}
+
+/* --- Confirmation --- */
+
+ZTEST(ack, test_downstream_forward_is_implicit_ack)
+{
+    struct ts_msg_lora_outgoing msg = make_unicast(7, 4);
+    struct ts_route_header fwd = msg.route;
+    struct ts_ack_stats stats;
+
+    zassert_ok(ts_ack_track(&msg, AIRTIME_MS));
+    fwd.ttl = 3;
+    zassert_ok(ts_ack_overheard(&fwd));
+
+    ts_ack_get_stats(&stats);
+    zassert_equal(stats.delivered, 1);
+    zassert_equal(stats.implicit_acks, 1);
+}
+
+ZTEST(ack, test_upstream_retransmission_is_not_ack)
+{
+    struct ts_msg_lora_outgoing msg = make_unicast(7, 4);
+    struct ts_route_header upstream = msg.route;
+
+    zassert_ok(ts_ack_track(&msg, AIRTIME_MS));
+    upstream.ttl = 5;
+    zassert_equal(ts_ack_overheard(&upstream), -ENOENT,
+                  "A copy with higher TTL came from the previous hop");
+    upstream.ttl = 4;
+    zassert_equal(ts_ack_overheard(&upstream), -ENOENT,
+                  "A copy with equal TTL was not forwarded");
+}
+
+ZTEST(ack, test_explicit_ack_confirms_once)
+{
+    struct ts_msg_lora_outgoing msg = make_unicast(9, 4);
+    struct ts_msg_ack ack = {.src = SELF, .msg_id = 9, .ttl = 4};
+    struct ts_ack_stats stats;
+
+    zassert_ok(ts_ack_track(&msg, AIRTIME_MS));
+    zassert_ok(ts_ack_confirm(&ack));
+    zassert_equal(ts_ack_confirm(&ack), -ENOENT,
+                  "Duplicate ACK should find nothing pending");
+
+    ts_ack_get_stats(&stats);
+    zassert_equal(stats.delivered, 1);
+    zassert_equal(stats.explicit_acks, 1);
+}
+
+ZTEST(ack, test_ack_for_another_hops_copy_ignored)
+{
+    // We forwarded with TTL 3; the ACK answers the TTL 4 copy we got
+    struct ts_msg_lora_outgoing msg = make_unicast(9, 3);
+    struct ts_msg_ack ack = {.src = SELF, .msg_id = 9, .ttl = 4};
+
+    zassert_ok(ts_ack_track(&msg, AIRTIME_MS));
+    zassert_equal(ts_ack_confirm(&ack), -ENOENT);
+    ack.ttl = 3;
+    zassert_ok(ts_ack_confirm(&ack));
+}
+
+ZTEST(ack, test_ack_for_unknown_frame_ignored)
+{
+    struct ts_msg_ack ack = {.src = PEER, .msg_id = 1};
+    zassert_equal(ts_ack_confirm(&ack), -ENOENT);
+}
+
+/* --- Tracking and accounting --- */
+
+ZTEST(ack, test_retrack_counts_retry_airtime)
+{
+    struct ts_msg_lora_outgoing msg = make_unicast(3, 4);
+    struct ts_ack_stats stats;
+
+    zassert_ok(ts_ack_track(&msg, AIRTIME_MS));
+    zassert_ok(ts_ack_track(&msg, AIRTIME_MS));
+
+    ts_ack_get_stats(&stats);
+    zassert_equal(stats.tracked, 1, "Second send is a retransmission");
+    zassert_equal(stats.tx_airtime_ms, 2 * AIRTIME_MS);
+    zassert_equal(stats.retry_airtime_ms, AIRTIME_MS);
+}
+
+ZTEST(ack, test_unsent_retransmissions_still_time_out)
+{
+    struct ts_msg_lora_outgoing msg = make_unicast(5, 4);
+    struct ts_ack_stats stats;
+    uint32_t wait_ms = 0;
+
+    // The retransmissions are published but never sent, so
+    // ts_ack_track() is not called again
+    for (uint8_t r = 0; r <= TS_ACK_MAX_RETRIES; r++) {
+        wait_ms += ts_ack_timeout_ms(AIRTIME_MS, r) + AIRTIME_MS;
+    }
+    zassert_ok(ts_ack_track(&msg, AIRTIME_MS));
+    k_msleep(wait_ms + 10);
+
+    ts_ack_get_stats(&stats);
+    zassert_equal(stats.retries, TS_ACK_MAX_RETRIES);
+    zassert_equal(stats.failed, 1, "Slot released after the last retry");
+}
+
+ZTEST(ack, test_busy_publish_keeps_retry)
+{
+    struct ts_msg_lora_outgoing msg = make_unicast(6, 4);
+    struct ts_ack_stats stats;
+
+    // Holding the TX channel makes the non-blocking retransmit fail
+    zassert_ok(zbus_chan_claim(&ts_lora_out_chan, K_NO_WAIT));
+    zassert_ok(ts_ack_track(&msg, AIRTIME_MS));
+    k_msleep(ts_ack_timeout_ms(AIRTIME_MS, 0) + AIRTIME_MS + 10);
+
+    ts_ack_get_stats(&stats);
+    zassert_equal(stats.retries, 0, "Unqueued retry not spent");
+    zassert_equal(stats.failed, 0);
+
+    zassert_ok(zbus_chan_finish(&ts_lora_out_chan));
+    k_msleep(100);
+    ts_ack_get_stats(&stats);
+    zassert_equal(stats.retries, 1, "Retried once the channel is free");
+}
+
+ZTEST(ack, test_pool_full_returns_enomem)
+{
+    for (int i = 0; i < TS_ACK_POOL_SIZE; i++) {
+        struct ts_msg_lora_outgoing msg = make_unicast(100 + i, 4);
+        zassert_ok(ts_ack_track(&msg, AIRTIME_MS));
+    }
+
+    struct ts_msg_lora_outgoing extra = make_unicast(999, 4);
+    zassert_equal(ts_ack_track(&extra, AIRTIME_MS), -ENOMEM);
+}
+
+ZTEST(ack, test_build_ack_is_not_forwarded)
+{
+    struct ts_route_header acked = {
+        .src = PEER, .dst = SELF, .msg_id = 42, .ttl = 3};
+    struct ts_msg_lora_outgoing ack;
+    struct ts_ack_stats stats;
+
+    ts_ack_build(&ack, &acked);
+
+    zassert_equal(ack.type, TS_MSG_ACK);
+    zassert_equal(ack.route.src, SELF);
+    zassert_equal(ack.route.dst, PEER);
+    zassert_equal(ack.route.ttl, 0, "TTL 0 keeps the ACK to one hop");
+    zassert_equal(ack.data.ack.src, PEER);
+    zassert_equal(ack.data.ack.msg_id, 42);
+    zassert_equal(ack.data.ack.ttl, 3, "Names the copy it answers");
+
+    ts_ack_get_stats(&stats);
+    zassert_equal(stats.acks_sent, 1);
+}
+
+ZTEST_SUITE(ack, NULL, NULL, before_each, NULL, NULL);
@@ -0,0 +1,123 @@
+#include <string.h>
+#include <zephyr/ztest.h>
+
+#include "lora/aggregate.h"
+
+#define LORA_MAX_FRAME 255
+
+// Stand-ins for signed frames: payload bytes followed by an 8-byte tag
+static const uint8_t sub_a[] = {0xF2, 0x00, 0x02, 0x11, 0x22, 0x33,
+                                0x44, 0x55, 0x66, 0x77, 0x88};
+static const uint8_t sub_b[] = {0xA3, 0x00, 0x02, 0x01, 0xA5, 0x00, 0x04,
+                                0x01, 0x03, 0x02, 0x09, 0x03, 0x00};
+
+/* --- Building --- */
+
+ZTEST(aggregate, test_first_append_writes_marker)
+{
+    uint8_t frame[LORA_MAX_FRAME];
+    size_t len = 0;
+
+    zassert_ok(ts_agg_append(frame, &len, sizeof(frame), sub_a,
+                             sizeof(sub_a)));
+    zassert_equal(len, TS_AGG_HEADER_SIZE + TS_AGG_LEN_SIZE + sizeof(sub_a));
+    zassert_equal(frame[0], TS_AGG_MARKER);
+    zassert_equal(frame[1], sizeof(sub_a));
+    zassert_mem_equal(&frame[2], sub_a, sizeof(sub_a));
+    zassert_true(ts_agg_is_aggregate(frame, len));
+}
+
+ZTEST(aggregate, test_append_full_frame_leaves_it_unchanged)
+{
+    uint8_t frame[32];
+    uint8_t before[32];
+    size_t len = 0;
+
+    zassert_ok(ts_agg_append(frame, &len, sizeof(frame), sub_a,
+                             sizeof(sub_a)));
+    zassert_ok(ts_agg_append(frame, &len, sizeof(frame), sub_a,
+                             sizeof(sub_a)));
+    memcpy(before, frame, sizeof(before));
+    size_t len_before = len;
+
+    zassert_equal(ts_agg_append(frame, &len, sizeof(frame), sub_b,
+                                sizeof(sub_b)),
+                  -EMSGSIZE);
+    zassert_equal(len, len_before);
+    zassert_mem_equal(frame, before, len_before);
+}
+
+ZTEST(aggregate, test_append_rejects_empty_or_oversized_subframe)
+{
+    static uint8_t big[UINT8_MAX + 1];
+    uint8_t frame[LORA_MAX_FRAME];
+    size_t len = 0;
+
+    zassert_equal(ts_agg_append(frame, &len, sizeof(frame), sub_a, 0),
+                  -EINVAL);
+    zassert_equal(ts_agg_append(frame, &len, sizeof(frame), big,
+                                sizeof(big)),
+                  -EINVAL);
+    zassert_equal(len, 0);
+}
+
+/* --- Splitting --- */
+
+ZTEST(aggregate, test_split_returns_subframes_in_order)
+{
+    uint8_t frame[LORA_MAX_FRAME];
+    size_t len = 0;
+    const uint8_t* p_sub;
+    size_t sub_len;
+    size_t offset = 0;
+
+    zassert_ok(ts_agg_append(frame, &len, sizeof(frame), sub_a,
+                             sizeof(sub_a)));
+    zassert_ok(ts_agg_append(frame, &len, sizeof(frame), sub_b,
+                             sizeof(sub_b)));
+
+    zassert_ok(ts_agg_next(frame, len, &offset, &p_sub, &sub_len));
+    zassert_equal(sub_len, sizeof(sub_a));
+    zassert_mem_equal(p_sub, sub_a, sizeof(sub_a));
+
+    zassert_ok(ts_agg_next(frame, len, &offset, &p_sub, &sub_len));
+    zassert_equal(sub_len, sizeof(sub_b));
+    zassert_mem_equal(p_sub, sub_b, sizeof(sub_b));
+
+    zassert_equal(ts_agg_next(frame, len, &offset, &p_sub, &sub_len),
+                  -ENOENT);
+}
+
+ZTEST(aggregate, test_split_rejects_truncated_frame)
+{
+    uint8_t frame[LORA_MAX_FRAME];
+    size_t len = 0;
+    const uint8_t* p_sub;
+    size_t sub_len;
+    size_t offset = 0;
+
+    zassert_ok(ts_agg_append(frame, &len, sizeof(frame), sub_a,
+                             sizeof(sub_a)));
+    zassert_ok(ts_agg_append(frame, &len, sizeof(frame), sub_b,
+                             sizeof(sub_b)));
+
+    // The first sub-frame is intact; the second's length runs past the end
+    len -= 1;
+    zassert_ok(ts_agg_next(frame, len, &offset, &p_sub, &sub_len));
+    zassert_equal(ts_agg_next(frame, len, &offset, &p_sub, &sub_len),
+                  -EBADMSG);
+}
+
+ZTEST(aggregate, test_marker_distinct_from_other_formats)
+{
+    static const uint8_t cbor[] = {0xA3};
+    static const uint8_t packed[] = {0xF2};
+    static const uint8_t fragment[] = {0xF1};
+
+    zassert_false(ts_agg_is_aggregate(cbor, sizeof(cbor)));
+    zassert_false(ts_agg_is_aggregate(packed, sizeof(packed)));
+    zassert_false(ts_agg_is_aggregate(fragment, sizeof(fragment)));
+    zassert_false(ts_agg_is_aggregate(NULL, 0));
+}
+
+ZTEST_SUITE(aggregate, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,70 @@
+#include <zephyr/ztest.h>
+
+#include "lora/airtime.h"
+
+static struct lora_modem_config config;
+
+static void before_each(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    config = (struct lora_modem_config){
+        .bandwidth = BW_125_KHZ,
+        .datarate = SF_10,
+        .coding_rate = CR_4_5,
+        .preamble_len = 8,
+    };
+}
+
+/* --- Symbol time --- */
+
+ZTEST(airtime, test_symbol_time_sf10)
+{
+    zassert_equal(ts_airtime_symbol_us(&config), 8192);
+}
+
+ZTEST(airtime, test_symbol_time_scales_with_bandwidth)
+{
+    config.bandwidth = BW_250_KHZ;
+    zassert_equal(ts_airtime_symbol_us(&config), 4096);
+}
+
+/* --- Time on air --- */
+
+ZTEST(airtime, test_sf7_short_frame)
+{
+    config.datarate = SF_7;
+    zassert_equal(ts_airtime_us(&config, 10), 41216);
+}
+
+ZTEST(airtime, test_sf10_frame)
+{
+    zassert_equal(ts_airtime_us(&config, 20), 370688);
+    zassert_equal(ts_airtime_ms(&config, 20), 371, "Should round up");
+}
+
+ZTEST(airtime, test_sf12_uses_low_data_rate_optimization)
+{
+    config.datarate = SF_12;
+    zassert_equal(ts_airtime_us(&config, 10), 991232);
+}
+
+ZTEST(airtime, test_default_preamble_when_unset)
+{
+    uint32_t explicit_len = ts_airtime_us(&config, 20);
+
+    config.preamble_len = 0;
+    zassert_equal(ts_airtime_us(&config, 20), explicit_len);
+}
+
+ZTEST(airtime, test_longer_payload_never_shorter)
+{
+    uint32_t prev = 0;
+
+    for (size_t len = 0; len <= 255; len++) {
+        uint32_t toa = ts_airtime_us(&config, len);
+        zassert_true(toa >= prev, "ToA decreased at %zu bytes", len);
+        prev = toa;
+    }
+}
+
+ZTEST_SUITE(airtime, NULL, NULL, before_each, NULL, NULL);
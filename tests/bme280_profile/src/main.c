@@ -0,0 +1,77 @@
+#include <zephyr/ztest.h>
+
+#include "sensors/bme280_profile.h"
+
+static bool valid_oversampling(uint8_t osr)
+{
+    return osr == 1 || osr == 2 || osr == 4 || osr == 8 || osr == 16;
+}
+
+ZTEST(bme280_profile, test_every_profile_declared)
+{
+    for (int i = 0; i < TS_BME280_PROFILE_COUNT; i++) {
+        const struct ts_bme280_profile_desc *desc = ts_bme280_profile_get(i);
+
+        zassert_not_null(desc, "Profile %d", i);
+        zassert_not_null(desc->name);
+        zassert_true(valid_oversampling(desc->osr_temperature));
+        zassert_true(valid_oversampling(desc->osr_pressure));
+        zassert_true(valid_oversampling(desc->osr_humidity));
+        zassert_true(desc->iir_filter == 0 ||
+                     (desc->iir_filter > 1 &&
+                      valid_oversampling(desc->iir_filter)));
+    }
+    zassert_is_null(ts_bme280_profile_get(TS_BME280_PROFILE_COUNT));
+}
+
+ZTEST(bme280_profile, test_ultra_low_power_is_datasheet_minimum)
+{
+    const struct ts_bme280_profile_desc *desc =
+        ts_bme280_profile_get(TS_BME280_PROFILE_ULTRA_LOW_POWER);
+
+    // Datasheet: 9.3 ms with every channel sampled once
+    zassert_equal(ts_bme280_profile_max_conversion_us(desc), 9300);
+    zassert_equal(desc->iir_filter, 0, "Filter off");
+}
+
+ZTEST(bme280_profile, test_conversion_time_per_profile)
+{
+    zassert_equal(ts_bme280_profile_max_conversion_us(ts_bme280_profile_get(
+                      TS_BME280_PROFILE_STANDARD)),
+                  18500);
+    zassert_equal(ts_bme280_profile_max_conversion_us(ts_bme280_profile_get(
+                      TS_BME280_PROFILE_HIGH_RESOLUTION)),
+                  46100);
+}
+
+ZTEST(bme280_profile, test_resolution_costs_time)
+{
+    uint32_t prev = 0;
+
+    for (int i = 0; i < TS_BME280_PROFILE_COUNT; i++) {
+        const struct ts_bme280_profile_desc *desc = ts_bme280_profile_get(i);
+        uint32_t us = ts_bme280_profile_max_conversion_us(desc);
+
+        zassert_true(us > prev, "%s not slower than the one before",
+                     desc->name);
+        prev = us;
+    }
+}
+
+ZTEST(bme280_profile, test_find_by_settings)
+{
+    struct ts_bme280_profile_desc settings;
+
+    for (int i = 0; i < TS_BME280_PROFILE_COUNT; i++) {
+        settings = *ts_bme280_profile_get(i);
+        settings.name = NULL;
+        zassert_equal(ts_bme280_profile_find(&settings), i);
+    }
+
+    // Standard oversampling without the filter is no profile
+    settings = *ts_bme280_profile_get(TS_BME280_PROFILE_STANDARD);
+    settings.iir_filter = 0;
+    zassert_equal(ts_bme280_profile_find(&settings), TS_BME280_PROFILE_COUNT);
+}
+
+ZTEST_SUITE(bme280_profile, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,290 @@
+#include <string.h>
+#include <zephyr/zbus/zbus.h>
+#include <zephyr/ztest.h>
+
+#include "lora/auth.h"
+#include "lora/bulk.h"
+#include "lora/cbor.h"
+#include "routing/routing.h"
+
+#define SELF 0x0001
+#define PEER 0x0002
+#define TEST_SIZE TS_BULK_MAX_SIZE
+#define TEST_CHUNKS DIV_ROUND_UP(TEST_SIZE, TS_MSG_BULK_CHUNK_SIZE)
+#define LORA_MAX_FRAME 255
+
+// The bulk module holds both session ends, so the test plays the radio
+// link between them: every published frame is queued, pushed through the
+// CBOR codec like a real frame, dropped at the configured loss rate and
+// fed back in.  Statuses are re-addressed as if they came from PEER.
+K_MSGQ_DEFINE(link_q, sizeof(struct ts_msg_lora_outgoing), 16, 4);
+
+static void link_cb(const struct zbus_channel* chan)
+{
+    const struct ts_msg_lora_outgoing* msg = zbus_chan_const_msg(chan);
+
+    zassert_ok(k_msgq_put(&link_q, msg, K_NO_WAIT), "Link queue overflow");
+}
+
+ZBUS_LISTENER_DEFINE(link_lis, link_cb);
+
+// Test-local zbus channel required by the bulk sender and receiver
+ZBUS_CHAN_DEFINE(ts_lora_out_chan, struct ts_msg_lora_outgoing, NULL, NULL,
+                 ZBUS_OBSERVERS(link_lis), ZBUS_MSG_INIT(0));
+
+static const struct lora_modem_config config = {
+    .bandwidth = BW_500_KHZ,
+    .datarate = SF_7,
+    .coding_rate = CR_4_5,
+    .preamble_len = 8,
+};
+
+static uint8_t tx_buf[TEST_SIZE];
+static uint8_t rx_copy[TEST_SIZE];
+static size_t rx_len;
+static uint16_t rx_src;
+static int rx_count;
+static int tx_result;
+static int tx_done_count;
+static uint32_t loss_state;
+
+static void on_rx(uint16_t src, const uint8_t* p_data, size_t len)
+{
+    rx_src = src;
+    rx_len = len;
+    memcpy(rx_copy, p_data, len);
+    rx_count++;
+}
+
+static void on_tx_done(int result)
+{
+    tx_result = result;
+    tx_done_count++;
+}
+
+static void before_each(void* fixture)
+{
+    ARG_UNUSED(fixture);
+    ts_routing_init(SELF);
+    ts_bulk_init(&config, on_rx, on_tx_done);
+    k_msgq_purge(&link_q);
+    for (size_t i = 0; i < sizeof(tx_buf); i++) {
+        tx_buf[i] = (uint8_t)(i * 7 + (i >> 8));
+    }
+    memset(rx_copy, 0, sizeof(rx_copy));
+    rx_len = 0;
+    rx_src = 0;
+    rx_count = 0;
+    tx_result = 1;
+    tx_done_count = 0;
+    loss_state = 12345;
+}
+
+// Deterministic pseudo-random loss so runs are repeatable
+static bool lost(int loss_percent)
+{
+    loss_state = loss_state * 1103515245u + 12345u;
+    return (int)((loss_state >> 16) % 100) < loss_percent;
+}
+
+// Carry frames over the simulated link until the sender finishes
+static void run_link(int loss_percent)
+{
+    uint8_t frame[ZBOR_ENCODE_BUFFER_SIZE];
+    struct ts_msg_lora_outgoing msg;
+    struct ts_msg_lora_outgoing rx_msg;
+    size_t frame_len;
+
+    while (tx_done_count == 0) {
+        if (k_msgq_get(&link_q, &msg, K_SECONDS(1)) != 0) { continue; }
+
+        zassert_ok(cbor_serialize(&msg, frame, sizeof(frame), &frame_len));
+        zassert_true(frame_len + TS_AUTH_TAG_SIZE <= LORA_MAX_FRAME,
+                     "Bulk frames must never need fragmentation");
+        zassert_ok(cbor_deserialize(frame, frame_len, &rx_msg));
+
+        if (lost(loss_percent)) { continue; }
+        if (rx_msg.type == TS_MSG_BULK_STATUS) { rx_msg.route.src = PEER; }
+        zassert_ok(ts_bulk_handle(&rx_msg));
+    }
+}
+
+/* --- Pacing --- */
+
+ZTEST(bulk, test_pacing_one_percent_duty)
+{
+    zassert_equal(ts_bulk_pacing_ms(400, 10), 39600,
+                  "One percent duty needs 99x the airtime off");
+}
+
+ZTEST(bulk, test_pacing_full_duty_is_zero)
+{
+    zassert_equal(ts_bulk_pacing_ms(400, 1000), 0);
+    zassert_equal(ts_bulk_pacing_ms(400, 500), 400);
+}
+
+/* --- Send validation --- */
+
+ZTEST(bulk, test_send_rejects_invalid_arguments)
+{
+    zassert_equal(ts_bulk_send(TS_ROUTING_BROADCAST_ADDR, tx_buf, 10),
+                  -EINVAL, "Bulk transfers are unicast only");
+    zassert_equal(ts_bulk_send(PEER, tx_buf, 0), -EINVAL);
+    zassert_equal(ts_bulk_send(PEER, tx_buf, TS_BULK_MAX_SIZE + 1),
+                  -EMSGSIZE);
+    zassert_false(ts_bulk_tx_active());
+}
+
+ZTEST(bulk, test_second_send_is_busy)
+{
+    zassert_ok(ts_bulk_send(PEER, tx_buf, 10));
+    zassert_equal(ts_bulk_send(PEER, tx_buf, 10), -EBUSY);
+    zassert_true(ts_bulk_tx_active());
+}
+
+/* --- Receiver --- */
+
+ZTEST(bulk, test_malformed_chunk_rejected)
+{
+    struct ts_msg_lora_outgoing msg = {
+        .route = {.src = PEER, .dst = SELF},
+        .type = TS_MSG_BULK_DATA,
+        .data.bulk_data = {.session = 1, .seq = 2, .total = 2, .len = 1},
+    };
+
+    zassert_equal(ts_bulk_handle(&msg), -EINVAL, "seq beyond total");
+
+    msg.data.bulk_data.seq = 0;
+    zassert_equal(ts_bulk_handle(&msg), -EINVAL,
+                  "Only the last chunk may be short");
+}
+
+ZTEST(bulk, test_chunk_beyond_max_size_rejected)
+{
+    // TS_BULK_MAX_SIZE is not a multiple of the chunk size here, so a
+    // full-length last chunk would end past it
+    struct ts_msg_lora_outgoing msg = {
+        .route = {.src = PEER, .dst = SELF},
+        .type = TS_MSG_BULK_DATA,
+        .data.bulk_data = {.session = 1,
+                           .seq = TEST_CHUNKS - 1,
+                           .total = TEST_CHUNKS,
+                           .len = TS_MSG_BULK_CHUNK_SIZE},
+    };
+
+    zassert_true(TEST_CHUNKS * TS_MSG_BULK_CHUNK_SIZE > TS_BULK_MAX_SIZE);
+    zassert_equal(ts_bulk_handle(&msg), -EMSGSIZE);
+
+    msg.data.bulk_data.len = TEST_SIZE % TS_MSG_BULK_CHUNK_SIZE;
+    zassert_ok(ts_bulk_handle(&msg), "Last chunk ending at the maximum");
+}
+
+ZTEST(bulk, test_receiver_reports_gap)
+{
+    struct ts_msg_lora_outgoing msg = {
+        .route = {.src = PEER, .dst = SELF},
+        .type = TS_MSG_BULK_DATA,
+        .data.bulk_data = {.session = 7, .total = 4,
+                           .len = TS_MSG_BULK_CHUNK_SIZE},
+    };
+    struct ts_msg_lora_outgoing status;
+
+    zassert_ok(ts_bulk_handle(&msg));
+    msg.data.bulk_data.seq = 3;
+    msg.data.bulk_data.ack_req = true;
+    zassert_ok(ts_bulk_handle(&msg));
+
+    zassert_ok(k_msgq_get(&link_q, &status, K_NO_WAIT),
+               "Status requested with the last chunk of the burst");
+    zassert_equal(status.type, TS_MSG_BULK_STATUS);
+    zassert_equal(status.route.dst, PEER);
+    zassert_equal(status.data.bulk_status.session, 7);
+    zassert_equal(status.data.bulk_status.ack_base, 1);
+    zassert_equal(status.data.bulk_status.nack_bitmap, BIT(0),
+                  "Chunk 2 is missing, chunk 3 arrived");
+}
+
+ZTEST(bulk, test_status_for_unknown_session_ignored)
+{
+    struct ts_msg_lora_outgoing msg = {
+        .route = {.src = PEER, .dst = SELF},
+        .type = TS_MSG_BULK_STATUS,
+        .data.bulk_status = {.session = 1},
+    };
+
+    zassert_equal(ts_bulk_handle(&msg), -ENOENT);
+
+    msg.type = TS_MSG_TELEMETRY;
+    zassert_equal(ts_bulk_handle(&msg), -ENOTSUP);
+}
+
+/* --- End to end over the simulated link --- */
+
+ZTEST(bulk, test_lossless_transfer_sends_each_chunk_once)
+{
+    struct ts_bulk_stats stats;
+
+    zassert_ok(ts_bulk_send(PEER, tx_buf, TEST_SIZE));
+    run_link(0);
+
+    ts_bulk_get_stats(&stats);
+    zassert_ok(tx_result);
+    zassert_equal(rx_count, 1, "Buffer should be delivered exactly once");
+    zassert_equal(rx_src, SELF);
+    zassert_equal(rx_len, TEST_SIZE);
+    zassert_mem_equal(rx_copy, tx_buf, TEST_SIZE);
+    zassert_equal(stats.chunks_sent, TEST_CHUNKS);
+    zassert_equal(stats.chunks_resent, 0);
+    zassert_equal(stats.sessions_ok, 1);
+}
+
+ZTEST(bulk, test_short_last_chunk)
+{
+    zassert_ok(ts_bulk_send(PEER, tx_buf, TS_MSG_BULK_CHUNK_SIZE + 5));
+    run_link(0);
+
+    zassert_ok(tx_result);
+    zassert_equal(rx_len, TS_MSG_BULK_CHUNK_SIZE + 5);
+    zassert_mem_equal(rx_copy, tx_buf, rx_len);
+}
+
+ZTEST(bulk, test_lossy_link_resends_only_missing_chunks)
+{
+    struct ts_bulk_stats stats;
+
+    zassert_ok(ts_bulk_send(PEER, tx_buf, TEST_SIZE));
+    run_link(20);
+
+    ts_bulk_get_stats(&stats);
+    zassert_ok(tx_result);
+    zassert_equal(rx_count, 1);
+    zassert_mem_equal(rx_copy, tx_buf, TEST_SIZE);
+    zassert_true(stats.chunks_resent > 0, "A lossy link should need resends");
+    zassert_true(stats.chunks_sent < 2 * TEST_CHUNKS,
+                 "Selective NACKs should not resend whole windows");
+
+    // The link adds no airtime of its own, so this is the pacing-bound
+    // goodput a session reaches at this duty cycle and loss rate.
+    TC_PRINT("%u bytes in %u ms (%u bit/s), %u of %u chunks resent, "
+             "%u status timeouts\n",
+             stats.last_bytes, stats.last_duration_ms,
+             stats.last_bytes * 8000 / MAX(stats.last_duration_ms, 1),
+             stats.chunks_resent, stats.chunks_sent, stats.status_timeouts);
+}
+
+ZTEST(bulk, test_silent_receiver_aborts_session)
+{
+    struct ts_bulk_stats stats;
+
+    zassert_ok(ts_bulk_send(PEER, tx_buf, TEST_SIZE));
+    run_link(100);
+
+    ts_bulk_get_stats(&stats);
+    zassert_equal(tx_result, -ETIMEDOUT);
+    zassert_equal(rx_count, 0);
+    zassert_equal(stats.sessions_failed, 1);
+    zassert_equal(stats.status_timeouts, TS_BULK_MAX_STATUS_RETRIES + 1);
+    zassert_false(ts_bulk_tx_active());
+}
+
+ZTEST_SUITE(bulk, NULL, NULL, before_each, NULL, NULL);
@@ -1,5 +1,7 @@
 #include <zephyr/ztest.h>
 #include "lora/cbor.h"
+#include "lora/cbor_schema.h"
+#include "lora/packed.h"
 #include "messages/messages.h"
 #include "routing/routing.h"
 
@@ -136,6 +138,482 @@ ZTEST(cbor, test_roundtrip_node_status)
     zassert_equal(decoded.data.node_status.status, ERROR);
 }
 
+ZTEST(cbor, test_roundtrip_ack)
+{
+    struct ts_msg_lora_outgoing original = {
+        .route = {.src = 0x0004, .dst = 0x0003, .msg_id = 9, .ttl = 0},
+        .type = TS_MSG_ACK,
+        .data.ack = {.src = 0x0003, .msg_id = 70000, .ttl = 4}};
+    uint8_t buf[ZBOR_ENCODE_BUFFER_SIZE];
+    size_t size = 0;
+
+    int ret = cbor_serialize(&original, buf, sizeof(buf), &size);
+    zassert_ok(ret);
+
+    struct ts_msg_lora_outgoing decoded = {0};
+    ret = cbor_deserialize(buf, size, &decoded);
+
+    zassert_ok(ret, "deserialize should succeed");
+    zassert_equal(decoded.type, TS_MSG_ACK);
+    zassert_equal(decoded.route.ttl, 0);
+    zassert_equal(decoded.data.ack.src, 0x0003);
+    zassert_equal(decoded.data.ack.msg_id, 70000);
+    zassert_equal(decoded.data.ack.ttl, 4);
+}
+
+ZTEST(cbor, test_ack_matches_schema_golden_vector)
+{
+    // messages.cddl: {0: version, 1: type, 2: {0: src, 1: dst, 2: msg_id,
+    // 3: ttl, 4: key_id, 5: tx_power}, 3: {0: src, 1: msg_id, 2: ttl}}
+    static const uint8_t expected[] = {
+        0xA4, 0x00, 0x01,                               // version 1
+        0x01, 0x02,                                     // type: ACK
+        0x02, 0xA6, 0x00, 0x04, 0x01, 0x03, 0x02, 0x09, // route
+        0x03, 0x00, 0x04, 0x00, 0x05, 0x26,
+        0x03, 0xA3, 0x00, 0x03, 0x01, 0x1A, 0x00, 0x01, // data
+        0x11, 0x70, 0x02, 0x06};
+    struct ts_msg_lora_outgoing msg = {
+        .route = {.src = 0x0004, .dst = 0x0003, .msg_id = 9, .ttl = 0,
+                  .tx_power = -7},
+        .type = TS_MSG_ACK,
+        .data.ack = {.src = 0x0003, .msg_id = 70000, .ttl = 6}};
+    uint8_t buf[ZBOR_ENCODE_BUFFER_SIZE];
+    size_t size = 0;
+
+    zassert_ok(cbor_serialize(&msg, buf, sizeof(buf), &size));
+    zassert_equal(size, sizeof(expected), "Encoded %zu B", size);
+    zassert_mem_equal(buf, expected, sizeof(expected));
+}
+
+ZTEST(cbor, test_deserialize_rejects_unexpected_key)
+{
+    struct ts_msg_lora_outgoing msg = {
+        .route = TEST_ROUTE,
+        .type = TS_MSG_ACK,
+        .data.ack = {.src = 0x0003, .msg_id = 5, .ttl = 2}};
+    struct ts_msg_lora_outgoing decoded = {0};
+    uint8_t buf[ZBOR_ENCODE_BUFFER_SIZE];
+    size_t size = 0;
+
+    zassert_ok(cbor_serialize(&msg, buf, sizeof(buf), &size));
+    zassert_ok(cbor_deserialize(buf, size, &decoded));
+
+    // The frame ends with ttl's key (2) and value (2); swap the key for
+    // one the ack doesn't have
+    zassert_equal(buf[size - 2], 0x02);
+    buf[size - 2] = 0x07;
+    zassert_equal(cbor_deserialize(buf, size, &decoded), -EBADMSG);
+}
+
+ZTEST(cbor, test_deserialize_rejects_other_wire_version)
+{
+    struct ts_msg_lora_outgoing msg = {
+        .route = TEST_ROUTE,
+        .type = TS_MSG_ACK,
+        .data.ack = {.src = 0x0003, .msg_id = 5, .ttl = 2}};
+    struct ts_msg_lora_outgoing decoded = {0};
+    uint8_t buf[ZBOR_ENCODE_BUFFER_SIZE];
+    size_t size = 0;
+
+    zassert_ok(cbor_serialize(&msg, buf, sizeof(buf), &size));
+
+    // Envelope header, version key (0), then the version itself
+    zassert_equal(buf[2], TS_CBOR_WIRE_VERSION);
+    buf[2] = TS_CBOR_WIRE_VERSION + 1;
+    zassert_equal(cbor_deserialize(buf, size, &decoded), -EPROTONOSUPPORT);
+}
+
+ZTEST(cbor, test_schema_max_size_fits_one_frame)
+{
+    // Largest message plus the 8-byte auth tag in one LoRa frame
+    zassert_true(TS_CBOR_MAX_SIZE + 8 <= 255, "Max size %zu",
+                 (size_t)TS_CBOR_MAX_SIZE);
+    zassert_true(TS_CBOR_MAX_SIZE <= ZBOR_ENCODE_BUFFER_SIZE);
+}
+
+ZTEST(cbor, test_roundtrip_full_bulk_chunk_fits_one_frame)
+{
+    struct ts_msg_lora_outgoing original = {
+        .route = {.src = 0x0002, .dst = 0x0001, .msg_id = 0xFFFFFFFF,
+                  .ttl = TS_ROUTING_DEFAULT_TTL, .key_id = 255},
+        .type = TS_MSG_BULK_DATA,
+        .data.bulk_data = {.session = 0xFFFF, .seq = 0xFFFF, .total = 0xFFFF,
+                           .ack_req = true,
+                           .len = TS_MSG_BULK_CHUNK_SIZE}};
+    for (int i = 0; i < TS_MSG_BULK_CHUNK_SIZE; i++) {
+        original.data.bulk_data.data[i] = (uint8_t)(0xFF - i);
+    }
+    uint8_t buf[ZBOR_ENCODE_BUFFER_SIZE];
+    size_t size = 0;
+
+    int ret = cbor_serialize(&original, buf, sizeof(buf), &size);
+    zassert_ok(ret);
+    zassert_true(size + 8 <= 255, "Worst-case chunk must fit one frame (%zu)",
+                 size);
+    zassert_true(size <= TS_CBOR_MAX_SIZE, "Chunk exceeds the schema bound");
+
+    struct ts_msg_lora_outgoing decoded = {0};
+    ret = cbor_deserialize(buf, size, &decoded);
+
+    zassert_ok(ret, "deserialize should succeed");
+    zassert_equal(decoded.type, TS_MSG_BULK_DATA);
+    zassert_equal(decoded.data.bulk_data.seq, 0xFFFF);
+    zassert_true(decoded.data.bulk_data.ack_req);
+    zassert_equal(decoded.data.bulk_data.len, TS_MSG_BULK_CHUNK_SIZE);
+    zassert_mem_equal(decoded.data.bulk_data.data,
+                      original.data.bulk_data.data, TS_MSG_BULK_CHUNK_SIZE);
+}
+
+ZTEST(cbor, test_roundtrip_bulk_status)
+{
+    struct ts_msg_lora_outgoing original = {
+        .route = TEST_ROUTE,
+        .type = TS_MSG_BULK_STATUS,
+        .data.bulk_status = {.session = 3, .ack_base = 17,
+                             .nack_bitmap = 0x80000005}};
+    uint8_t buf[ZBOR_ENCODE_BUFFER_SIZE];
+    size_t size = 0;
+
+    zassert_ok(cbor_serialize(&original, buf, sizeof(buf), &size));
+
+    struct ts_msg_lora_outgoing decoded = {0};
+    zassert_ok(cbor_deserialize(buf, size, &decoded));
+    zassert_equal(decoded.type, TS_MSG_BULK_STATUS);
+    zassert_equal(decoded.data.bulk_status.session, 3);
+    zassert_equal(decoded.data.bulk_status.ack_base, 17);
+    zassert_equal(decoded.data.bulk_status.nack_bitmap, 0x80000005);
+}
+
+static struct ts_msg_lora_outgoing make_full_batch(void)
+{
+    struct ts_msg_lora_outgoing msg = {
+        .route = TEST_ROUTE,
+        .type = TS_MSG_TELEMETRY_BATCH,
+        .data.telemetry_batch = {.base_timestamp = 86400 * 365,
+                                 .count = TS_MSG_TELEMETRY_BATCH_MAX}};
+
+    // Realistic worst case: hot, humid, high pressure, 10 min apart
+    for (int i = 0; i < TS_MSG_TELEMETRY_BATCH_MAX; i++) {
+        msg.data.telemetry_batch.samples[i] = (struct ts_msg_telemetry_sample){
+            .dt = (i == 0) ? 0 : 600,
+            .temperature = 8500 - i,
+            .humidity = 10000 - i,
+            .pressure = 110000 - i,
+        };
+    }
+    return msg;
+}
+
+ZTEST(cbor, test_roundtrip_full_telemetry_batch_fits_one_frame)
+{
+    struct ts_msg_lora_outgoing original = make_full_batch();
+    uint8_t buf[ZBOR_ENCODE_BUFFER_SIZE];
+    size_t size = 0;
+
+    zassert_ok(cbor_serialize(&original, buf, sizeof(buf), &size));
+    zassert_true(size + 8 <= 255, "Full batch must fit one frame (%zu)",
+                 size);
+    zassert_true(size <= TS_CBOR_MAX_SIZE, "Batch exceeds the schema bound");
+
+    struct ts_msg_lora_outgoing decoded = {0};
+    zassert_ok(cbor_deserialize(buf, size, &decoded));
+    zassert_equal(decoded.type, TS_MSG_TELEMETRY_BATCH);
+    zassert_equal(decoded.data.telemetry_batch.base_timestamp,
+                  original.data.telemetry_batch.base_timestamp);
+    zassert_equal(decoded.data.telemetry_batch.count,
+                  TS_MSG_TELEMETRY_BATCH_MAX);
+    zassert_mem_equal(decoded.data.telemetry_batch.samples,
+                      original.data.telemetry_batch.samples,
+                      sizeof(original.data.telemetry_batch.samples));
+}
+
+ZTEST(cbor, test_telemetry_batch_cuts_per_reading_overhead)
+{
+    struct ts_msg_lora_outgoing batch = make_full_batch();
+    struct ts_msg_lora_outgoing single = {
+        .route = TEST_ROUTE,
+        .type = TS_MSG_TELEMETRY,
+        .data.telemetry = {.timestamp = 86400 * 365,
+                           .temperature = 8500,
+                           .humidity = 10000,
+                           .pressure = 110000}};
+    uint8_t buf[ZBOR_ENCODE_BUFFER_SIZE];
+    size_t batch_size = 0;
+    size_t single_size = 0;
+
+    zassert_ok(cbor_serialize(&batch, buf, sizeof(buf), &batch_size));
+    zassert_ok(cbor_serialize(&single, buf, sizeof(buf), &single_size));
+
+    // Per reading on air, including the 8-byte tag every frame carries.
+    // With integer keys a single reading is 52 B on air, 31 B of them
+    // envelope, route header and tag; a batched one is its 4 values and
+    // dt, about 19 B.  Text keys put the single frame at 116 B, which is
+    // why batching once saved two thirds and now saves half.
+    size_t per_batched = (batch_size + 8) / TS_MSG_TELEMETRY_BATCH_MAX;
+    zassert_true(per_batched * 2 < single_size + 8,
+                 "Batched reading (%zu B) should cost under half of a "
+                 "single frame (%zu B)",
+                 per_batched, single_size + 8);
+    zassert_true(per_batched <= 20, "Batched reading %zu B", per_batched);
+}
+
+ZTEST(cbor, test_roundtrip_telemetry_delta)
+{
+    struct ts_msg_lora_outgoing original = {
+        .route = TEST_ROUTE,
+        .type = TS_MSG_TELEMETRY_DELTA,
+        .data.telemetry_delta = {.seq = 200, .keyframe = false, .len = 4,
+                                 .data = {0x14, 0x02, 0x03, 0x00}}};
+    uint8_t buf[ZBOR_ENCODE_BUFFER_SIZE];
+    size_t size = 0;
+
+    zassert_ok(cbor_serialize(&original, buf, sizeof(buf), &size));
+
+    struct ts_msg_lora_outgoing decoded = {0};
+    zassert_ok(cbor_deserialize(buf, size, &decoded));
+    zassert_equal(decoded.type, TS_MSG_TELEMETRY_DELTA);
+    zassert_equal(decoded.data.telemetry_delta.seq, 200);
+    zassert_false(decoded.data.telemetry_delta.keyframe);
+    zassert_equal(decoded.data.telemetry_delta.len, 4);
+    zassert_mem_equal(decoded.data.telemetry_delta.data,
+                      original.data.telemetry_delta.data, 4);
+}
+
+ZTEST(cbor, test_roundtrip_telemetry_summary)
+{
+    struct ts_msg_lora_outgoing original = {
+        .route = TEST_ROUTE,
+        .type = TS_MSG_TELEMETRY_SUMMARY,
+        .data.telemetry_summary = {.timestamp = 86400,
+                                   .duration_s = 290,
+                                   .count = 30,
+                                   .temperature_min = -1250,
+                                   .temperature_max = -980,
+                                   .temperature_mean = -1101,
+                                   .humidity_min = 8800,
+                                   .humidity_max = 9400,
+                                   .humidity_mean = 9012,
+                                   .pressure_min = 98700,
+                                   .pressure_max = 98850,
+                                   .pressure_mean = 98777}};
+    uint8_t buf[ZBOR_ENCODE_BUFFER_SIZE];
+    size_t size = 0;
+
+    zassert_ok(cbor_serialize(&original, buf, sizeof(buf), &size));
+
+    struct ts_msg_lora_outgoing decoded = {0};
+    zassert_ok(cbor_deserialize(buf, size, &decoded));
+    zassert_equal(decoded.type, TS_MSG_TELEMETRY_SUMMARY);
+    zassert_mem_equal(&decoded.data.telemetry_summary,
+                      &original.data.telemetry_summary,
+                      sizeof(original.data.telemetry_summary));
+}
+
+ZTEST(cbor, test_roundtrip_telemetry_model)
+{
+    struct ts_msg_lora_outgoing original = {
+        .route = TEST_ROUTE,
+        .type = TS_MSG_TELEMETRY_MODEL,
+        .data.telemetry_model = {.seq = 255,
+                                 .resync = true,
+                                 .timestamp = 86400,
+                                 .temperature = -1250,
+                                 .humidity = 9012,
+                                 .pressure = 98777}};
+    uint8_t buf[ZBOR_ENCODE_BUFFER_SIZE];
+    size_t size = 0;
+
+    zassert_ok(cbor_serialize(&original, buf, sizeof(buf), &size));
+
+    struct ts_msg_lora_outgoing decoded = {0};
+    zassert_ok(cbor_deserialize(buf, size, &decoded));
+    zassert_equal(decoded.type, TS_MSG_TELEMETRY_MODEL);
+    zassert_equal(decoded.data.telemetry_model.seq, 255);
+    zassert_true(decoded.data.telemetry_model.resync);
+    zassert_equal(decoded.data.telemetry_model.timestamp, 86400);
+    zassert_equal(decoded.data.telemetry_model.temperature, -1250);
+    zassert_equal(decoded.data.telemetry_model.humidity, 9012);
+    zassert_equal(decoded.data.telemetry_model.pressure, 98777);
+}
+
+ZTEST(cbor, test_roundtrip_sensor_values)
+{
+    struct ts_msg_lora_outgoing original = {
+        .route = TEST_ROUTE,
+        .type = TS_MSG_SENSOR_VALUES,
+        .data.sensor_values = {.timestamp = 86400, .count = 3}};
+    uint8_t buf[ZBOR_ENCODE_BUFFER_SIZE];
+    size_t size = 0;
+
+    original.data.sensor_values.values[0] =
+        (struct ts_msg_sensor_value){.id = 0, .value = -1250};
+    original.data.sensor_values.values[1] =
+        (struct ts_msg_sensor_value){.id = 2, .value = 98777};
+    original.data.sensor_values.values[2] =
+        (struct ts_msg_sensor_value){.id = 200, .value = INT32_MIN};
+
+    zassert_ok(cbor_serialize(&original, buf, sizeof(buf), &size));
+
+    struct ts_msg_lora_outgoing decoded = {0};
+    zassert_ok(cbor_deserialize(buf, size, &decoded));
+    zassert_equal(decoded.type, TS_MSG_SENSOR_VALUES);
+    zassert_equal(decoded.data.sensor_values.timestamp, 86400);
+    zassert_equal(decoded.data.sensor_values.count, 3);
+    for (int i = 0; i < 3; i++) {
+        zassert_equal(decoded.data.sensor_values.values[i].id,
+                      original.data.sensor_values.values[i].id);
+        zassert_equal(decoded.data.sensor_values.values[i].value,
+                      original.data.sensor_values.values[i].value);
+    }
+}
+
+ZTEST(cbor, test_telemetry_delta_smaller_than_full_reading)
+{
+    struct ts_msg_lora_outgoing full = {
+        .route = TEST_ROUTE,
+        .type = TS_MSG_TELEMETRY,
+        .data.telemetry = {.timestamp = 86400,
+                           .temperature = 2150,
+                           .humidity = 5500,
+                           .pressure = 101325}};
+    struct ts_msg_lora_outgoing delta = {
+        .route = TEST_ROUTE,
+        .type = TS_MSG_TELEMETRY_DELTA,
+        .data.telemetry_delta = {.seq = 1, .len = 4,
+                                 .data = {0x14, 0x02, 0x03, 0x00}}};
+    uint8_t buf[ZBOR_ENCODE_BUFFER_SIZE];
+    size_t full_size, delta_size;
+
+    zassert_ok(cbor_serialize(&full, buf, sizeof(buf), &full_size));
+    zassert_ok(cbor_serialize(&delta, buf, sizeof(buf), &delta_size));
+
+    TC_PRINT("Full reading %zu B, delta %zu B\n", full_size, delta_size);
+    // Both share the 23 B envelope and route header, so the saving is
+    // all payload: 21 B of keyed values against 11 B of seq, keyframe
+    // and 4 B of varints.  With text keys the full payload was some
+    // 40 B longer, hence the 32 B margin of earlier versions.
+    zassert_true(delta_size + 8 <= full_size,
+                 "Delta frame (%zu B) should save at least 8 B over the "
+                 "full reading (%zu B)",
+                 delta_size, full_size);
+    zassert_true(delta_size <= 34, "Delta frame %zu B", delta_size);
+}
+
+ZTEST(cbor, test_negative_temperature_is_compact)
+{
+    // -12.34 C: a signed field encodes as a CBOR negative integer sized
+    // by its magnitude, not as the 4-byte body of a wrapped uint32
+    struct ts_msg_lora_outgoing winter = {
+        .route = TEST_ROUTE,
+        .type = TS_MSG_TELEMETRY,
+        .data.telemetry = {.timestamp = 100,
+                           .temperature = -1234,
+                           .humidity = 8000,
+                           .pressure = 101325}};
+    struct ts_msg_lora_outgoing summer = winter;
+    struct ts_msg_lora_outgoing decoded = {0};
+    uint8_t buf[ZBOR_ENCODE_BUFFER_SIZE];
+    size_t winter_size, summer_size;
+
+    summer.data.telemetry.temperature = 1234;
+    zassert_ok(cbor_serialize(&summer, buf, sizeof(buf), &summer_size));
+    zassert_ok(cbor_serialize(&winter, buf, sizeof(buf), &winter_size));
+    zassert_equal(winter_size, summer_size,
+                  "Sign must not change the encoded size");
+
+    zassert_ok(cbor_deserialize(buf, winter_size, &decoded));
+    zassert_equal(decoded.data.telemetry.temperature, -1234);
+}
+
+ZTEST(cbor, test_negative_batch_sample_roundtrip)
+{
+    struct ts_msg_lora_outgoing original = {
+        .route = TEST_ROUTE,
+        .type = TS_MSG_TELEMETRY_BATCH,
+        .data.telemetry_batch = {
+            .base_timestamp = 500,
+            .count = 2,
+            .samples = {{.dt = 0, .temperature = -4000, .humidity = 100,
+                         .pressure = 30000},
+                        {.dt = 60, .temperature = -1, .humidity = 0,
+                         .pressure = 110000}}}};
+    struct ts_msg_lora_outgoing decoded = {0};
+    uint8_t buf[ZBOR_ENCODE_BUFFER_SIZE];
+    size_t size;
+
+    zassert_ok(cbor_serialize(&original, buf, sizeof(buf), &size));
+    zassert_ok(cbor_deserialize(buf, size, &decoded));
+    zassert_equal(decoded.data.telemetry_batch.samples[0].temperature, -4000);
+    zassert_equal(decoded.data.telemetry_batch.samples[1].temperature, -1);
+}
+
+/* --- Packed telemetry vs CBOR --- */
+
+#define CODEC_BENCH_ROUNDS 1000
+
+static const struct ts_msg_lora_outgoing bench_msg = {
+    .route = TEST_ROUTE,
+    .type = TS_MSG_TELEMETRY,
+    .data.telemetry = {.timestamp = 3600,
+                       .temperature = 2150,
+                       .humidity = 5500,
+                       .pressure = 101325}};
+
+ZTEST(cbor, test_packed_telemetry_cuts_frame_size)
+{
+    struct ts_msg_lora_outgoing msg = bench_msg;
+    uint8_t buf[ZBOR_ENCODE_BUFFER_SIZE];
+    size_t cbor_size, packed_size;
+
+    zassert_ok(cbor_serialize(&msg, buf, sizeof(buf), &cbor_size));
+    zassert_ok(ts_packed_serialize(&msg, buf, sizeof(buf), &packed_size));
+
+    TC_PRINT("Telemetry frame: CBOR %zu B, packed %zu B\n", cbor_size,
+             packed_size);
+    zassert_equal(packed_size, TS_PACKED_TELEMETRY_SIZE);
+    // Packed drops the keys and container headers CBOR still spends
+    // 23 B on.  Against text-keyed CBOR the packed frame was under a
+    // quarter; integer keys took most of that gap already.
+    zassert_true(2 * packed_size <= cbor_size,
+                 "Packed frame (%zu B) should be under half of CBOR "
+                 "(%zu B)",
+                 packed_size, cbor_size);
+}
+
+ZTEST(cbor, test_packed_vs_cbor_codec_throughput)
+{
+    struct ts_msg_lora_outgoing msg = bench_msg;
+    struct ts_msg_lora_outgoing out;
+    uint8_t buf[ZBOR_ENCODE_BUFFER_SIZE];
+    size_t size;
+    uint32_t start, cbor_cycles, packed_cycles;
+    int failures = 0;
+
+    start = k_cycle_get_32();
+    for (int i = 0; i < CODEC_BENCH_ROUNDS; i++) {
+        failures += cbor_serialize(&msg, buf, sizeof(buf), &size) != 0;
+        failures += cbor_deserialize(buf, size, &out) != 0;
+    }
+    cbor_cycles = k_cycle_get_32() - start;
+
+    start = k_cycle_get_32();
+    for (int i = 0; i < CODEC_BENCH_ROUNDS; i++) {
+        failures += ts_packed_serialize(&msg, buf, sizeof(buf), &size) != 0;
+        failures += ts_packed_deserialize(buf, size, &out) != 0;
+    }
+    packed_cycles = k_cycle_get_32() - start;
+
+    // Timing under emulation is only indicative, so report it without
+    // asserting on it.
+    TC_PRINT("Encode+decode per reading: CBOR %u ns, packed %u ns\n",
+             (uint32_t)(k_cyc_to_ns_floor64(cbor_cycles) / CODEC_BENCH_ROUNDS),
+             (uint32_t)(k_cyc_to_ns_floor64(packed_cycles) /
+                        CODEC_BENCH_ROUNDS));
+    zassert_equal(failures, 0);
+    zassert_mem_equal(&out.data.telemetry, &msg.data.telemetry,
+                      sizeof(msg.data.telemetry));
+}
+
 ZTEST(cbor, test_deserialize_truncated_buffer)
 {
     struct ts_msg_lora_outgoing msg = {
@@ -1,6 +1,67 @@
+#include <string.h>
 #include <zephyr/ztest.h>
 
 #include "config/config.h"
+#include "messages/messages.h"
+
+// Every key of config.c, each with a value other than its default
+#define KEY(field, v)                                      \
+    {                                                      \
+        .name = "ts/" #field,                              \
+        .offset = offsetof(struct ts_config, field),       \
+        .size = sizeof(((struct ts_config *)0)->field),    \
+        .value = (v),                                      \
+    }
+
+static const struct {
+    const char *name;
+    size_t offset;
+    size_t size;
+    int32_t value;
+} all_keys[] = {
+    KEY(routing_ttl, 9),
+    KEY(contention_delay_min_ms, 100),
+    KEY(contention_delay_max_ms, 2000),
+    KEY(contention_rssi_weak, -110),
+    KEY(contention_rssi_strong, -40),
+    KEY(routing_table_stale_timeout_s, 600),
+    KEY(node_id, 0x1234),
+    KEY(lora_frequency, 868300000),
+    KEY(lora_sf, 7),
+    KEY(lora_bw, 250),
+    KEY(lora_cr, 2),
+    KEY(lora_tx_power, -3),
+    KEY(sensor_interval_s, 30),
+    KEY(sensor_period_temperature_s, 60),
+    KEY(sensor_period_humidity_s, 120),
+    KEY(sensor_period_pressure_s, 300),
+    KEY(sensor_profile, 2),
+    KEY(heartbeat_interval_s, 11),
+    KEY(routing_table_age_interval_s, 90),
+    KEY(telemetry_batch_size, 4),
+    KEY(telemetry_max_latency_s, 600),
+    KEY(telemetry_keyframe_interval, 8),
+    KEY(telemetry_window_s, 900),
+    KEY(telemetry_deadband_temperature, 35),
+    KEY(telemetry_deadband_humidity, 250),
+    KEY(telemetry_deadband_pressure, 80),
+    KEY(telemetry_max_silence_s, 1800),
+    KEY(telemetry_resync_s, 7200),
+};
+
+// Compare a field with a value at the field's own width
+static bool field_equals(const struct ts_config *cfg, size_t i, int32_t value) {
+    const uint8_t *p = (const uint8_t *)cfg + all_keys[i].offset;
+
+    switch (all_keys[i].size) {
+        case 1:
+            return *p == (uint8_t)value;
+        case 2:
+            return *(const uint16_t *)p == (uint16_t)value;
+        default:
+            return *(const uint32_t *)p == (uint32_t)value;
+    }
+}
 
 static void before_each(void *fixture) {
     ARG_UNUSED(fixture);
@@ -48,12 +109,50 @@ ZTEST(config, test_defaults_when_empty) {
     zassert_equal(cfg->sensor_interval_s,
                   TS_CONFIG_SENSOR_INTERVAL_S_DEFAULT,
                   "sensor_interval_s should be default");
+    zassert_equal(cfg->sensor_period_temperature_s,
+                  TS_CONFIG_SENSOR_PERIOD_TEMPERATURE_S_DEFAULT,
+                  "sensor_period_temperature_s should be default");
+    zassert_equal(cfg->sensor_period_humidity_s,
+                  TS_CONFIG_SENSOR_PERIOD_HUMIDITY_S_DEFAULT,
+                  "sensor_period_humidity_s should be default");
+    zassert_equal(cfg->sensor_period_pressure_s,
+                  TS_CONFIG_SENSOR_PERIOD_PRESSURE_S_DEFAULT,
+                  "sensor_period_pressure_s should be default");
+    zassert_equal(cfg->sensor_profile, TS_CONFIG_SENSOR_PROFILE_DEFAULT,
+                  "sensor_profile should be default");
     zassert_equal(cfg->heartbeat_interval_s,
                   TS_CONFIG_HEARTBEAT_INTERVAL_S_DEFAULT,
                   "heartbeat_interval_s should be default");
     zassert_equal(cfg->routing_table_age_interval_s,
                   TS_CONFIG_ROUTING_TABLE_AGE_INTERVAL_S_DEFAULT,
                   "routing_table_age_interval_s should be default");
+    zassert_equal(cfg->telemetry_batch_size,
+                  TS_CONFIG_TELEMETRY_BATCH_SIZE_DEFAULT,
+                  "telemetry_batch_size should be default");
+    zassert_equal(cfg->telemetry_max_latency_s,
+                  TS_CONFIG_TELEMETRY_MAX_LATENCY_S_DEFAULT,
+                  "telemetry_max_latency_s should be default");
+    zassert_equal(cfg->telemetry_keyframe_interval,
+                  TS_CONFIG_TELEMETRY_KEYFRAME_INTERVAL_DEFAULT,
+                  "telemetry_keyframe_interval should be default");
+    zassert_equal(cfg->telemetry_window_s,
+                  TS_CONFIG_TELEMETRY_WINDOW_S_DEFAULT,
+                  "telemetry_window_s should be default");
+    zassert_equal(cfg->telemetry_deadband_temperature,
+                  TS_CONFIG_TELEMETRY_DEADBAND_TEMPERATURE_DEFAULT,
+                  "telemetry_deadband_temperature should be default");
+    zassert_equal(cfg->telemetry_deadband_humidity,
+                  TS_CONFIG_TELEMETRY_DEADBAND_HUMIDITY_DEFAULT,
+                  "telemetry_deadband_humidity should be default");
+    zassert_equal(cfg->telemetry_deadband_pressure,
+                  TS_CONFIG_TELEMETRY_DEADBAND_PRESSURE_DEFAULT,
+                  "telemetry_deadband_pressure should be default");
+    zassert_equal(cfg->telemetry_max_silence_s,
+                  TS_CONFIG_TELEMETRY_MAX_SILENCE_S_DEFAULT,
+                  "telemetry_max_silence_s should be default");
+    zassert_equal(cfg->telemetry_resync_s,
+                  TS_CONFIG_TELEMETRY_RESYNC_S_DEFAULT,
+                  "telemetry_resync_s should be default");
 }
 
 /* --- Persistence across re-init --- */
@@ -75,6 +174,37 @@ ZTEST(config, test_set_value_survives_reinit) {
                   "routing_ttl should survive re-init");
 }
 
+ZTEST(config, test_every_key_survives_reinit) {
+    static const struct ts_config defaults = TS_CONFIG_DEFAULTS;
+
+    for (size_t i = 0; i < ARRAY_SIZE(all_keys); i++) {
+        zassert_false(field_equals(&defaults, i, all_keys[i].value),
+                      "%s: pick a value other than the default",
+                      all_keys[i].name);
+        zassert_ok(ts_config_set(all_keys[i].name, all_keys[i].value),
+                   "%s", all_keys[i].name);
+    }
+
+    // Each key is saved under its full name and found again on load
+    zassert_ok(ts_config_init());
+    for (size_t i = 0; i < ARRAY_SIZE(all_keys); i++) {
+        zassert_true(field_equals(ts_config_get(), i, all_keys[i].value),
+                     "%s lost across re-init", all_keys[i].name);
+    }
+
+    // ... and deleted under the same name
+    zassert_ok(ts_config_reset());
+    zassert_ok(ts_config_init());
+    for (size_t i = 0; i < ARRAY_SIZE(all_keys); i++) {
+        const uint8_t *p = (const uint8_t *)&defaults + all_keys[i].offset;
+
+        zassert_mem_equal((const uint8_t *)ts_config_get() +
+                              all_keys[i].offset,
+                          p, all_keys[i].size, "%s not reset",
+                          all_keys[i].name);
+    }
+}
+
 /* --- Validation --- */
 
 ZTEST(config, test_set_out_of_range_returns_einval) {
@@ -139,6 +269,16 @@ ZTEST(config, test_set_boundary_values_accepted) {
     zassert_ok(ret, "TTL=1 (lower bound) should be accepted");
     ret = ts_config_set("ts/routing_ttl", 255);
     zassert_ok(ret, "TTL=255 (upper bound) should be accepted");
+
+    // Telemetry batch size: 1 (unbatched) up to what fits one frame
+    ret = ts_config_set("ts/telemetry_batch_size", 1);
+    zassert_ok(ret, "Batch size 1 (lower bound) should be accepted");
+    ret = ts_config_set("ts/telemetry_batch_size",
+                        TS_MSG_TELEMETRY_BATCH_MAX);
+    zassert_ok(ret, "Largest batch should be accepted");
+    ret = ts_config_set("ts/telemetry_batch_size",
+                        TS_MSG_TELEMETRY_BATCH_MAX + 1);
+    zassert_equal(ret, -EINVAL, "Batch beyond one frame should be rejected");
 }
 
 /* --- Signed fields --- */
@@ -4,14 +4,38 @@
 #include "lora/contention.h"
 #include "messages/messages.h"
 
-// Test-local zbus channel required by contention work handler
+static int single_count;
+static int agg_count;
+static struct ts_msg_lora_aggregate last_agg;
+
+static void single_cb(const struct zbus_channel *chan)
+{
+    ARG_UNUSED(chan);
+    single_count++;
+}
+
+static void agg_cb(const struct zbus_channel *chan)
+{
+    last_agg = *(const struct ts_msg_lora_aggregate *)zbus_chan_const_msg(
+        chan);
+    agg_count++;
+}
+
+ZBUS_LISTENER_DEFINE(single_lis, single_cb);
+ZBUS_LISTENER_DEFINE(agg_lis, agg_cb);
+
+// Test-local zbus channels required by contention work handler
 ZBUS_CHAN_DEFINE(ts_lora_out_chan, struct ts_msg_lora_outgoing, NULL, NULL,
-                 ZBUS_OBSERVERS_EMPTY, ZBUS_MSG_INIT(0));
+                 ZBUS_OBSERVERS(single_lis), ZBUS_MSG_INIT(0));
+ZBUS_CHAN_DEFINE(ts_lora_agg_chan, struct ts_msg_lora_aggregate, NULL, NULL,
+                 ZBUS_OBSERVERS(agg_lis), ZBUS_MSG_INIT(0));
 
 static void before_each(void *fixture)
 {
     ARG_UNUSED(fixture);
     ts_contention_init();
+    single_count = 0;
+    agg_count = 0;
 }
 
 /* --- RSSI-to-delay mapping --- */
@@ -126,4 +150,111 @@ ZTEST(contention, test_cancel_nonexistent_returns_enoent)
                   "Cancel of nonexistent forward should return -ENOENT");
 }
 
+ZTEST(contention, test_is_pending_until_cancelled)
+{
+    struct ts_msg_lora_outgoing msg = make_msg(0x0002, 42);
+
+    zassert_false(ts_contention_is_pending(0x0002, 42));
+    zassert_ok(ts_contention_schedule(&msg, -75));
+    zassert_true(ts_contention_is_pending(0x0002, 42));
+    zassert_ok(ts_contention_cancel(0x0002, 42));
+    zassert_false(ts_contention_is_pending(0x0002, 42));
+}
+
+ZTEST(contention, test_upstream_relay_ack_keeps_forward)
+{
+    // Held forward has TTL 3: its copy came in with TTL 4
+    struct ts_msg_lora_outgoing msg = make_msg(0x0002, 42);
+    struct ts_msg_ack ack = {.src = 0x0002, .msg_id = 42, .ttl = 5};
+
+    zassert_ok(ts_contention_schedule(&msg, -75));
+    zassert_equal(ts_contention_cancel_acked(&ack), -ENOENT,
+                  "ACK for a copy upstream of ours");
+    zassert_true(ts_contention_is_pending(0x0002, 42));
+
+    ack.ttl = 4;
+    zassert_ok(ts_contention_cancel_acked(&ack), "ACK for the same copy");
+    zassert_false(ts_contention_is_pending(0x0002, 42));
+}
+
+/* --- Relay aggregation --- */
+
+// RSSI giving a forwarding delay of delay_ms
+static int16_t rssi_for_delay(uint32_t delay_ms)
+{
+    return TS_CONTENTION_RSSI_WEAK +
+           (int16_t)DIV_ROUND_UP(delay_ms * (TS_CONTENTION_RSSI_STRONG -
+                                             TS_CONTENTION_RSSI_WEAK),
+                                 TS_CONTENTION_DELAY_MAX_MS);
+}
+
+ZTEST(contention, test_forwards_due_within_window_share_a_frame)
+{
+    struct ts_msg_lora_outgoing a = make_msg(0x0002, 1);
+    struct ts_msg_lora_outgoing b = make_msg(0x0003, 2);
+    struct ts_msg_lora_outgoing c = make_msg(0x0004, 3);
+
+    zassert_ok(ts_contention_schedule(&a, rssi_for_delay(1000)));
+    zassert_ok(ts_contention_schedule(&b, rssi_for_delay(1200)));
+    zassert_ok(ts_contention_schedule(&c, rssi_for_delay(1400)));
+
+    k_msleep(1000 + 10);
+
+    zassert_equal(agg_count, 1, "One aggregate should be published");
+    zassert_equal(single_count, 0);
+    zassert_equal(last_agg.count, 3);
+    zassert_equal(last_agg.msgs[0].route.msg_id, 1,
+                  "The slot that fired comes first");
+
+    // The claimed slots are gone: nothing fires later, cancel finds none
+    k_msleep(TS_CONTENTION_DELAY_MAX_MS);
+    zassert_equal(agg_count, 1);
+    zassert_equal(single_count, 0);
+    zassert_equal(ts_contention_cancel(0x0003, 2), -ENOENT);
+}
+
+ZTEST(contention, test_forward_beyond_window_sent_alone)
+{
+    struct ts_msg_lora_outgoing a = make_msg(0x0002, 1);
+    struct ts_msg_lora_outgoing b = make_msg(0x0003, 2);
+
+    zassert_ok(ts_contention_schedule(&a, rssi_for_delay(1000)));
+    zassert_ok(ts_contention_schedule(
+        &b, rssi_for_delay(1000 + 2 * CONFIG_TS_RELAY_AGGREGATION_WINDOW_MS)));
+
+    k_msleep(TS_CONTENTION_DELAY_MAX_MS);
+
+    zassert_equal(agg_count, 0);
+    zassert_equal(single_count, 2, "Each forward should go out on its own");
+}
+
+ZTEST(contention, test_different_destination_not_aggregated)
+{
+    struct ts_msg_lora_outgoing a = make_msg(0x0002, 1);
+    struct ts_msg_lora_outgoing b = make_msg(0x0003, 2);
+
+    b.route.dst = 0x0009;
+    zassert_ok(ts_contention_schedule(&a, rssi_for_delay(1000)));
+    zassert_ok(ts_contention_schedule(&b, rssi_for_delay(1100)));
+
+    k_msleep(TS_CONTENTION_DELAY_MAX_MS);
+
+    zassert_equal(agg_count, 0);
+    zassert_equal(single_count, 2);
+}
+
+ZTEST(contention, test_aggregate_capped_at_max)
+{
+    for (uint32_t i = 0; i < TS_MSG_AGGREGATE_MAX + 1; i++) {
+        struct ts_msg_lora_outgoing msg = make_msg(0x0002, i);
+        zassert_ok(ts_contention_schedule(&msg, rssi_for_delay(1000)));
+    }
+
+    k_msleep(TS_CONTENTION_DELAY_MAX_MS);
+
+    zassert_equal(agg_count, 1);
+    zassert_equal(last_agg.count, TS_MSG_AGGREGATE_MAX);
+    zassert_equal(single_count, 1, "The leftover forward fires on its own");
+}
+
 ZTEST_SUITE(contention, NULL, NULL, before_each, NULL, NULL);
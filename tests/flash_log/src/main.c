@@ -0,0 +1,260 @@
+#include <errno.h>
+#include <string.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/ztest.h>
+
+#include "storage/flash_log.h"
+
+#define LOG_AREA FIXED_PARTITION_ID(backlog_partition)
+
+// About 20 entries per 4 KiB sector of the 64 KiB test partition
+#define ENTRY_SIZE 200
+
+static struct ts_flash_log flash_log;
+
+static void make_entry(uint8_t* p_buf, uint32_t n)
+{
+    for (size_t i = 0; i < ENTRY_SIZE; i++) {
+        p_buf[i] = (uint8_t)(n * 7 + i);
+    }
+    memcpy(p_buf, &n, sizeof(n));
+}
+
+static void append_n(uint32_t first, uint32_t count)
+{
+    uint8_t buf[ENTRY_SIZE];
+
+    for (uint32_t n = first; n < first + count; n++) {
+        make_entry(buf, n);
+        zassert_ok(ts_flash_log_append(&flash_log, buf, sizeof(buf)),
+                   "Append %u failed", n);
+    }
+}
+
+// Peek and pop the next entry; returns its number
+static uint32_t pop_entry(void)
+{
+    uint8_t buf[ENTRY_SIZE];
+    uint8_t expected[ENTRY_SIZE];
+    uint32_t n;
+
+    zassert_equal(ts_flash_log_peek(&flash_log, buf, sizeof(buf)),
+                  ENTRY_SIZE);
+    memcpy(&n, buf, sizeof(n));
+    make_entry(expected, n);
+    zassert_mem_equal(buf, expected, ENTRY_SIZE, "Entry %u corrupted", n);
+    zassert_ok(ts_flash_log_pop(&flash_log));
+    return n;
+}
+
+static void before_each(void* fixture)
+{
+    const struct flash_area* fa;
+
+    ARG_UNUSED(fixture);
+    zassert_ok(flash_area_open(LOG_AREA, &fa));
+    zassert_ok(flash_area_erase(fa, 0, fa->fa_size));
+    flash_area_close(fa);
+    zassert_ok(ts_flash_log_init(&flash_log, LOG_AREA));
+}
+
+ZTEST(flash_log, test_empty)
+{
+    uint8_t buf[4];
+
+    zassert_equal(ts_flash_log_pending(&flash_log), 0);
+    zassert_equal(ts_flash_log_peek(&flash_log, buf, sizeof(buf)), -ENOENT);
+    zassert_equal(ts_flash_log_pop(&flash_log), -ENOENT);
+}
+
+ZTEST(flash_log, test_fifo_order)
+{
+    append_n(0, 5);
+    zassert_equal(ts_flash_log_pending(&flash_log), 5);
+
+    for (uint32_t n = 0; n < 5; n++) {
+        zassert_equal(pop_entry(), n, "Out of order");
+    }
+    zassert_equal(ts_flash_log_pending(&flash_log), 0);
+    zassert_equal(ts_flash_log_pop(&flash_log), -ENOENT);
+}
+
+ZTEST(flash_log, test_peek_does_not_consume)
+{
+    uint8_t buf[ENTRY_SIZE];
+
+    append_n(0, 2);
+    zassert_equal(ts_flash_log_peek(&flash_log, buf, sizeof(buf)),
+                  ENTRY_SIZE);
+    zassert_equal(ts_flash_log_peek(&flash_log, buf, sizeof(buf)),
+                  ENTRY_SIZE);
+    zassert_equal(ts_flash_log_pending(&flash_log), 2);
+    zassert_equal(pop_entry(), 0);
+}
+
+ZTEST(flash_log, test_bad_sizes)
+{
+    uint8_t buf[ENTRY_SIZE] = {0};
+
+    zassert_equal(ts_flash_log_append(&flash_log, buf, 0), -EINVAL);
+    zassert_equal(ts_flash_log_append(&flash_log, buf,
+                                      TS_FLASH_LOG_MAX_ENTRY + 1),
+                  -EINVAL);
+
+    append_n(0, 1);
+    zassert_equal(ts_flash_log_peek(&flash_log, buf, ENTRY_SIZE - 1),
+                  -EMSGSIZE);
+    zassert_equal(ts_flash_log_pending(&flash_log), 1,
+                  "A failed peek must not consume");
+}
+
+ZTEST(flash_log, test_odd_lengths)
+{
+    static const uint8_t one[] = {0xAB};
+    static const uint8_t three[] = {1, 2, 3};
+    uint8_t buf[8];
+
+    zassert_ok(ts_flash_log_append(&flash_log, one, sizeof(one)));
+    zassert_ok(ts_flash_log_append(&flash_log, three, sizeof(three)));
+
+    zassert_equal(ts_flash_log_peek(&flash_log, buf, sizeof(buf)), 1);
+    zassert_equal(buf[0], 0xAB);
+    zassert_ok(ts_flash_log_pop(&flash_log));
+    zassert_equal(ts_flash_log_peek(&flash_log, buf, sizeof(buf)), 3);
+    zassert_mem_equal(buf, three, sizeof(three));
+}
+
+ZTEST(flash_log, test_entries_survive_reinit)
+{
+    append_n(0, 30);
+
+    // Reboot: the log is reopened from flash
+    zassert_ok(ts_flash_log_init(&flash_log, LOG_AREA));
+    zassert_equal(ts_flash_log_pending(&flash_log), 30);
+    for (uint32_t n = 0; n < 30; n++) { zassert_equal(pop_entry(), n); }
+}
+
+ZTEST(flash_log, test_reinit_resumes_after_last_pop)
+{
+    struct ts_flash_log_stats stats;
+
+    append_n(0, 60);
+    for (uint32_t n = 0; n < 50; n++) { pop_entry(); }
+
+    // Reboot mid-drain: nothing popped is read again
+    zassert_ok(ts_flash_log_init(&flash_log, LOG_AREA));
+    ts_flash_log_get_stats(&flash_log, &stats);
+    zassert_equal(stats.pending, 10);
+    for (uint32_t n = 50; n < 60; n++) { zassert_equal(pop_entry(), n); }
+    zassert_equal(ts_flash_log_pop(&flash_log), -ENOENT);
+
+    // Appends after the reboot continue the sequence
+    append_n(60, 5);
+    zassert_ok(ts_flash_log_init(&flash_log, LOG_AREA));
+    zassert_equal(ts_flash_log_pending(&flash_log), 5);
+    zassert_equal(pop_entry(), 60);
+}
+
+ZTEST(flash_log, test_repeated_reinit_while_draining)
+{
+    uint32_t next = 0;
+    uint32_t appended = 0;
+
+    // Several passes over the partition with a reboot every few pops,
+    // some of them right after a sector was freed
+    while (appended < 600) {
+        append_n(appended, 30);
+        appended += 30;
+        for (int i = 0; i < 30; i++) {
+            zassert_equal(pop_entry(), next++, "Replayed or lost entry");
+            if (i % 7 == 3) {
+                zassert_ok(ts_flash_log_init(&flash_log, LOG_AREA));
+                zassert_equal(ts_flash_log_pending(&flash_log),
+                              appended - next);
+            }
+        }
+    }
+}
+
+ZTEST(flash_log, test_clear)
+{
+    struct ts_flash_log_stats stats;
+
+    append_n(0, 30);
+    zassert_equal(pop_entry(), 0);
+    zassert_ok(ts_flash_log_clear(&flash_log));
+
+    ts_flash_log_get_stats(&flash_log, &stats);
+    zassert_equal(stats.pending, 0);
+    zassert_equal(stats.dropped, 29);
+    zassert_equal(ts_flash_log_peek(&flash_log, NULL, 0), -ENOENT);
+
+    // Cleared for good: nothing comes back after a reboot, and the log
+    // takes new entries
+    zassert_ok(ts_flash_log_init(&flash_log, LOG_AREA));
+    zassert_equal(ts_flash_log_pending(&flash_log), 0);
+    append_n(100, 3);
+    zassert_ok(ts_flash_log_init(&flash_log, LOG_AREA));
+    for (uint32_t n = 100; n < 103; n++) { zassert_equal(pop_entry(), n); }
+}
+
+ZTEST(flash_log, test_wraps_without_loss_when_drained)
+{
+    struct ts_flash_log_stats stats;
+    uint32_t next = 0;
+
+    // Several passes over the partition, never more than a few sectors
+    // outstanding
+    for (uint32_t n = 0; n < 1000; n += 50) {
+        append_n(n, 50);
+        for (int i = 0; i < 50; i++) {
+            zassert_equal(pop_entry(), next++, "Lost an entry");
+        }
+    }
+
+    ts_flash_log_get_stats(&flash_log, &stats);
+    zassert_equal(stats.appended, 1000);
+    zassert_equal(stats.consumed, 1000);
+    zassert_equal(stats.dropped, 0);
+    zassert_equal(stats.pending, 0);
+}
+
+ZTEST(flash_log, test_full_log_drops_oldest)
+{
+    struct ts_flash_log_stats stats;
+
+    // Far more than the partition holds
+    append_n(0, 1000);
+
+    ts_flash_log_get_stats(&flash_log, &stats);
+    zassert_true(stats.dropped > 0, "Nothing dropped");
+    zassert_equal(stats.appended, 1000);
+    zassert_equal(stats.pending + stats.dropped, 1000,
+                  "Every entry is either pending or dropped");
+
+    // The newest entries are kept, in order
+    uint32_t first = pop_entry();
+    zassert_equal(first, stats.dropped, "Oldest survivor should follow "
+                  "the dropped ones");
+    for (uint32_t n = first + 1; n < 1000; n++) {
+        zassert_equal(pop_entry(), n);
+    }
+}
+
+ZTEST(flash_log, test_overflow_while_reading)
+{
+    struct ts_flash_log_stats stats;
+
+    append_n(0, 10);
+    zassert_equal(pop_entry(), 0);
+
+    // Overwrite the sector holding the read cursor
+    append_n(10, 1000);
+    ts_flash_log_get_stats(&flash_log, &stats);
+    zassert_equal(stats.pending + stats.dropped + stats.consumed, 1010);
+
+    uint32_t first = pop_entry();
+    zassert_equal(first, 1 + stats.dropped);
+}
+
+ZTEST_SUITE(flash_log, NULL, NULL, before_each, NULL, NULL);
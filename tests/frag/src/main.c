@@ -0,0 +1,198 @@
+#include <string.h>
+#include <zephyr/ztest.h>
+
+#include "lora/auth.h"
+#include "lora/frag.h"
+#include "routing/routing.h"
+
+#define SELF 0x0001
+#define PAYLOAD_LEN 600
+
+static uint8_t payload[TS_FRAG_MAX_PAYLOAD];
+static uint8_t frames[TS_FRAG_MAX_COUNT][TS_FRAG_MAX_FRAME];
+static size_t frame_lens[TS_FRAG_MAX_COUNT];
+static uint8_t out[TS_FRAG_MAX_PAYLOAD];
+
+static void *frag_suite_setup(void)
+{
+    for (int i = 0; i < TS_FRAG_MAX_PAYLOAD; i++) {
+        payload[i] = (uint8_t)(i * 7);
+    }
+    zassert_ok(ts_auth_init(), "ts_auth_init should succeed");
+    return NULL;
+}
+
+static void before_each(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    ts_routing_init(SELF);
+    ts_frag_init();
+}
+
+// Build every fragment of payload[0..len) into frames[]
+static int build_all(size_t len, uint16_t frag_id)
+{
+    int count = ts_frag_count(len);
+
+    for (int i = 0; i < count; i++) {
+        zassert_ok(ts_frag_build(payload, len, frag_id, (uint8_t)i, frames[i],
+                                 &frame_lens[i]));
+    }
+    return count;
+}
+
+/* --- Splitting --- */
+
+ZTEST(frag, test_count)
+{
+    zassert_equal(ts_frag_count(1), 1);
+    zassert_equal(ts_frag_count(TS_FRAG_CHUNK_SIZE), 1);
+    zassert_equal(ts_frag_count(TS_FRAG_CHUNK_SIZE + 1), 2);
+    zassert_equal(ts_frag_count(TS_FRAG_MAX_PAYLOAD + 1), -EMSGSIZE);
+}
+
+ZTEST(frag, test_fragments_fit_one_frame)
+{
+    int count = build_all(PAYLOAD_LEN, 1);
+
+    zassert_equal(count, 3);
+    zassert_equal(frame_lens[0], TS_FRAG_MAX_FRAME);
+    zassert_equal(frame_lens[2], TS_FRAG_HEADER_SIZE +
+                                     (PAYLOAD_LEN - 2 * TS_FRAG_CHUNK_SIZE) +
+                                     TS_AUTH_TAG_SIZE);
+    zassert_true(ts_frag_is_fragment(frames[0], frame_lens[0]));
+}
+
+ZTEST(frag, test_build_rejects_bad_index)
+{
+    size_t len;
+    zassert_equal(ts_frag_build(payload, PAYLOAD_LEN, 1, 3, frames[0], &len),
+                  -EINVAL);
+}
+
+ZTEST(frag, test_cbor_frame_is_not_fragment)
+{
+    uint8_t cbor_map[] = {0xA3, 0x64};
+    zassert_false(ts_frag_is_fragment(cbor_map, sizeof(cbor_map)));
+}
+
+/* --- Reassembly --- */
+
+ZTEST(frag, test_reassemble_in_order)
+{
+    int count = build_all(PAYLOAD_LEN, 5);
+    size_t out_len = 0;
+
+    for (int i = 0; i < count - 1; i++) {
+        zassert_equal(ts_frag_reassemble(frames[i], frame_lens[i], out,
+                                         sizeof(out), &out_len),
+                      -EINPROGRESS);
+    }
+    zassert_ok(ts_frag_reassemble(frames[count - 1], frame_lens[count - 1],
+                                  out, sizeof(out), &out_len));
+    zassert_equal(out_len, PAYLOAD_LEN);
+    zassert_mem_equal(out, payload, PAYLOAD_LEN);
+}
+
+ZTEST(frag, test_reassemble_out_of_order_with_duplicate)
+{
+    build_all(PAYLOAD_LEN, 6);
+    size_t out_len = 0;
+
+    zassert_equal(ts_frag_reassemble(frames[2], frame_lens[2], out,
+                                     sizeof(out), &out_len),
+                  -EINPROGRESS);
+    zassert_equal(ts_frag_reassemble(frames[0], frame_lens[0], out,
+                                     sizeof(out), &out_len),
+                  -EINPROGRESS);
+    zassert_equal(ts_frag_reassemble(frames[0], frame_lens[0], out,
+                                     sizeof(out), &out_len),
+                  -EINPROGRESS, "Duplicate fragment is harmless");
+    zassert_ok(ts_frag_reassemble(frames[1], frame_lens[1], out, sizeof(out),
+                                  &out_len));
+    zassert_mem_equal(out, payload, PAYLOAD_LEN);
+}
+
+ZTEST(frag, test_tampered_fragment_rejected)
+{
+    struct ts_frag_stats stats;
+    size_t out_len;
+
+    build_all(PAYLOAD_LEN, 7);
+    frames[1][TS_FRAG_HEADER_SIZE + 10] ^= 0x01;
+
+    zassert_equal(ts_frag_reassemble(frames[1], frame_lens[1], out,
+                                     sizeof(out), &out_len),
+                  -EACCES);
+    ts_frag_get_stats(&stats);
+    zassert_equal(stats.auth_failures, 1);
+}
+
+ZTEST(frag, test_tampered_header_rejected)
+{
+    size_t out_len;
+
+    build_all(PAYLOAD_LEN, 8);
+    frames[0][5] = 1;  // claim to be the second fragment
+
+    zassert_equal(ts_frag_reassemble(frames[0], frame_lens[0], out,
+                                     sizeof(out), &out_len),
+                  -EACCES, "Header is covered by the tag");
+}
+
+ZTEST(frag, test_interleaved_sets_use_separate_slots)
+{
+    size_t out_len;
+    int count = build_all(PAYLOAD_LEN, 10);
+    uint8_t other[TS_FRAG_MAX_FRAME];
+    size_t other_len;
+
+    zassert_ok(ts_frag_build(payload, PAYLOAD_LEN, 11, 0, other, &other_len));
+
+    zassert_equal(ts_frag_reassemble(other, other_len, out, sizeof(out),
+                                     &out_len),
+                  -EINPROGRESS);
+    for (int i = 0; i < count - 1; i++) {
+        ts_frag_reassemble(frames[i], frame_lens[i], out, sizeof(out),
+                           &out_len);
+    }
+    zassert_ok(ts_frag_reassemble(frames[count - 1], frame_lens[count - 1],
+                                  out, sizeof(out), &out_len));
+}
+
+ZTEST(frag, test_pool_exhaustion)
+{
+    size_t out_len;
+    uint8_t frame[TS_FRAG_MAX_FRAME];
+    size_t len;
+
+    for (int i = 0; i < TS_FRAG_REASSEMBLY_SLOTS; i++) {
+        ts_frag_build(payload, PAYLOAD_LEN, 20 + i, 0, frame, &len);
+        zassert_equal(ts_frag_reassemble(frame, len, out, sizeof(out),
+                                         &out_len),
+                      -EINPROGRESS);
+    }
+    ts_frag_build(payload, PAYLOAD_LEN, 99, 0, frame, &len);
+    zassert_equal(ts_frag_reassemble(frame, len, out, sizeof(out), &out_len),
+                  -ENOBUFS);
+}
+
+ZTEST(frag, test_incomplete_set_times_out)
+{
+    struct ts_frag_stats stats;
+    size_t out_len;
+
+    build_all(PAYLOAD_LEN, 30);
+    ts_frag_reassemble(frames[0], frame_lens[0], out, sizeof(out), &out_len);
+    ts_frag_reassemble(frames[1], frame_lens[1], out, sizeof(out), &out_len);
+
+    k_msleep(TS_FRAG_REASSEMBLY_TIMEOUT_MS + 10);
+
+    zassert_equal(ts_frag_reassemble(frames[2], frame_lens[2], out,
+                                     sizeof(out), &out_len),
+                  -EINPROGRESS, "Earlier fragments should have expired");
+    ts_frag_get_stats(&stats);
+    zassert_equal(stats.timeouts, 1);
+}
+
+ZTEST_SUITE(frag, NULL, frag_suite_setup, before_each, NULL, NULL);
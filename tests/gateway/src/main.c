@@ -0,0 +1,467 @@
+#include <errno.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+
+#include "gateway/gateway.h"
+#include "lora/packed.h"
+#include "sensors/telemetry_delta.h"
+#include "sensors/telemetry_predict.h"
+
+#define NODE_A 0x0010
+#define NODE_B 0x0020
+
+// Mock uplink: keeps the last batch and counts calls
+static struct ts_gateway_record sent[TS_GATEWAY_BATCH_SIZE];
+static size_t sent_count;
+static int send_calls;
+static int send_result;
+
+static int mock_send(const struct ts_gateway_record* p_records, size_t count)
+{
+    memcpy(sent, p_records, count * sizeof(p_records[0]));
+    sent_count = count;
+    send_calls++;
+    return send_result;
+}
+
+static const struct ts_gateway_uplink mock_uplink = {
+    .name = "mock",
+    .send = mock_send,
+};
+
+static struct ts_msg_lora_incoming make_in(uint16_t src, uint32_t msg_id,
+                                           ts_msg_type_t type)
+{
+    struct ts_msg_lora_incoming in = {
+        .msg = {.route = {.src = src, .dst = 0xFFFF, .msg_id = msg_id},
+                .type = type},
+        .rssi = -80,
+        .snr = 7,
+    };
+    return in;
+}
+
+static struct ts_msg_lora_incoming make_telemetry(uint16_t src,
+                                                  uint32_t msg_id,
+                                                  int32_t temperature)
+{
+    struct ts_msg_lora_incoming in = make_in(src, msg_id, TS_MSG_TELEMETRY);
+
+    in.msg.data.telemetry = (struct ts_msg_telemetry){
+        .timestamp = 1000 + msg_id,
+        .temperature = temperature,
+        .humidity = 5000,
+        .pressure = 101325,
+    };
+    return in;
+}
+
+static void before_each(void* fixture)
+{
+    ARG_UNUSED(fixture);
+    zassert_ok(ts_gateway_init(&mock_uplink));
+    sent_count = 0;
+    send_calls = 0;
+    send_result = 0;
+}
+
+ZTEST(gateway, test_init_requires_send)
+{
+    static const struct ts_gateway_uplink no_send = {.name = "none"};
+
+    zassert_equal(ts_gateway_init(NULL), -EINVAL);
+    zassert_equal(ts_gateway_init(&no_send), -EINVAL);
+}
+
+ZTEST(gateway, test_telemetry_uplinked)
+{
+    struct ts_msg_lora_incoming in = make_telemetry(NODE_A, 1, -250);
+
+    zassert_ok(ts_gateway_handle(&in));
+    zassert_equal(ts_gateway_flush(), 1, "One record should be sent");
+    zassert_equal(send_calls, 1);
+    zassert_equal(sent[0].src, NODE_A);
+    zassert_equal(sent[0].msg_id, 1);
+    zassert_equal(sent[0].type, TS_MSG_TELEMETRY);
+    zassert_equal(sent[0].rssi, -80);
+    zassert_equal(sent[0].snr, 7);
+    zassert_equal(sent[0].data.telemetry.temperature, -250);
+    zassert_equal(ts_gateway_flush(), 0, "Queue should be empty");
+    zassert_equal(send_calls, 1, "Empty queue must not be sent");
+}
+
+ZTEST(gateway, test_latest_value_table)
+{
+    struct ts_msg_lora_incoming tel = make_telemetry(NODE_A, 1, 2100);
+    struct ts_msg_lora_incoming st = make_in(NODE_A, 2, TS_MSG_NODE_STATUS);
+    struct ts_gateway_node node;
+
+    st.msg.data.node_status.uptime = 3600;
+    zassert_ok(ts_gateway_handle(&tel));
+    tel = make_telemetry(NODE_A, 3, 2200);
+    zassert_ok(ts_gateway_handle(&tel));
+    zassert_ok(ts_gateway_handle(&st));
+
+    zassert_ok(ts_gateway_node_get(NODE_A, &node));
+    zassert_true(node.has_telemetry);
+    zassert_equal(node.telemetry.temperature, 2200, "Latest reading kept");
+    zassert_true(node.has_status);
+    zassert_equal(node.status.uptime, 3600);
+    zassert_equal(node.messages, 3);
+    zassert_equal(ts_gateway_node_get(NODE_B, &node), -ENOENT);
+    zassert_equal(ts_gateway_node_count(), 1);
+}
+
+ZTEST(gateway, test_packed_timestamp_unwrapped)
+{
+    // Two days in, just before the 16-bit timestamp wraps
+    const uint32_t now_s = 3 * 65536 - 2;
+    struct ts_msg_lora_incoming st = make_in(NODE_A, 1, TS_MSG_NODE_STATUS);
+    struct ts_msg_lora_incoming tel = make_telemetry(NODE_B, 2, 2100);
+
+    tel.msg.short_timestamp = true;
+    tel.msg.data.telemetry.timestamp = (now_s + 5) & 0xFFFF;
+    zassert_ok(ts_gateway_handle(&tel));
+    zassert_equal(ts_gateway_flush(), 1);
+    zassert_equal(sent[0].data.telemetry.timestamp, 3,
+                  "No clock reference yet: wire value passed on");
+
+    st.msg.data.node_status.timestamp = now_s;
+    zassert_ok(ts_gateway_handle(&st));
+    tel.msg.route.src = NODE_A;
+    zassert_ok(ts_gateway_handle(&tel));
+    tel.msg.route.msg_id = 3;
+    tel.msg.data.telemetry.timestamp = (now_s - 10) & 0xFFFF;
+    zassert_ok(ts_gateway_handle(&tel));
+    zassert_equal(ts_gateway_flush(), 3);
+    zassert_equal(sent[1].data.telemetry.timestamp, now_s + 5);
+    zassert_equal(sent[2].data.telemetry.timestamp, now_s - 10);
+}
+
+ZTEST(gateway, test_packed_reading_relayed_unwrapped)
+{
+    // The relay is built without CONFIG_TS_TELEMETRY_PACKED, like this
+    // test, so it would send its own readings as CBOR
+    const uint32_t now_s = 3 * 65536 - 2;
+    struct ts_msg_lora_incoming st = make_in(NODE_A, 1, TS_MSG_NODE_STATUS);
+    struct ts_msg_lora_incoming tel = make_telemetry(NODE_A, 2, 2100);
+    struct ts_msg_lora_incoming fwd = make_in(NODE_A, 0, TS_MSG_TELEMETRY);
+    uint8_t frame[TS_PACKED_TELEMETRY_SIZE];
+    size_t len;
+
+    st.msg.data.node_status.timestamp = now_s;
+    zassert_ok(ts_gateway_handle(&st));
+
+    // Origin -> relay: packed
+    tel.msg.data.telemetry.timestamp = now_s + 5;
+    zassert_ok(ts_packed_serialize(&tel.msg, frame, sizeof(frame), &len));
+    zassert_ok(ts_packed_deserialize(frame, len, &fwd.msg));
+
+    // Relay -> gateway: still packed, so the gateway knows to unwrap
+    zassert_true(ts_packed_wanted(&fwd.msg));
+    zassert_ok(ts_packed_serialize(&fwd.msg, frame, sizeof(frame), &len));
+    zassert_ok(ts_packed_deserialize(frame, len, &fwd.msg));
+    zassert_ok(ts_gateway_handle(&fwd));
+
+    zassert_equal(ts_gateway_flush(), 2);
+    zassert_equal(sent[1].data.telemetry.timestamp, now_s + 5);
+}
+
+ZTEST(gateway, test_duplicate_dropped)
+{
+    struct ts_msg_lora_incoming in = make_telemetry(NODE_A, 5, 2000);
+    struct ts_gateway_stats stats;
+
+    zassert_ok(ts_gateway_handle(&in));
+    in.rssi = -110;  // Same message over a different path
+    zassert_equal(ts_gateway_handle(&in), -EALREADY);
+    zassert_equal(ts_gateway_flush(), 1, "Duplicate must not be queued");
+
+    ts_gateway_get_stats(&stats);
+    zassert_equal(stats.messages, 1);
+    zassert_equal(stats.duplicates, 1);
+}
+
+ZTEST(gateway, test_late_copy_within_window)
+{
+    struct ts_msg_lora_incoming in;
+
+    for (uint32_t id = 10; id <= 15; id++) {
+        in = make_telemetry(NODE_A, id, 2000);
+        zassert_ok(ts_gateway_handle(&in));
+    }
+    // A copy of an older message arriving late over a longer route
+    in = make_telemetry(NODE_A, 11, 2000);
+    zassert_equal(ts_gateway_handle(&in), -EALREADY);
+}
+
+ZTEST(gateway, test_out_of_order_accepted)
+{
+    struct ts_msg_lora_incoming in = make_telemetry(NODE_A, 8, 2000);
+
+    zassert_ok(ts_gateway_handle(&in));
+    in = make_telemetry(NODE_A, 6, 2000);
+    zassert_ok(ts_gateway_handle(&in), "Older unseen id is new");
+    zassert_equal(ts_gateway_handle(&in), -EALREADY);
+}
+
+ZTEST(gateway, test_sender_restart_accepted)
+{
+    struct ts_msg_lora_incoming in = make_telemetry(NODE_A, 5000, 2000);
+
+    zassert_ok(ts_gateway_handle(&in));
+    // Counter began again after a reboot
+    in = make_telemetry(NODE_A, 0, 2000);
+    zassert_ok(ts_gateway_handle(&in));
+    in = make_telemetry(NODE_A, 1, 2000);
+    zassert_ok(ts_gateway_handle(&in));
+}
+
+ZTEST(gateway, test_batch_expanded)
+{
+    struct ts_msg_lora_incoming in =
+        make_in(NODE_B, 1, TS_MSG_TELEMETRY_BATCH);
+    struct ts_msg_telemetry_batch* batch = &in.msg.data.telemetry_batch;
+    struct ts_gateway_node node;
+
+    batch->base_timestamp = 500;
+    batch->count = 3;
+    for (int i = 0; i < 3; i++) {
+        batch->samples[i].dt = (i == 0) ? 0 : 10;
+        batch->samples[i].temperature = 2000 + i;
+    }
+
+    zassert_ok(ts_gateway_handle(&in));
+    zassert_equal(ts_gateway_flush(), 3, "One record per sample");
+    for (int i = 0; i < 3; i++) {
+        zassert_equal(sent[i].msg_id, 1);
+        zassert_equal(sent[i].data.telemetry.timestamp, 500 + 10 * i);
+        zassert_equal(sent[i].data.telemetry.temperature, 2000 + i);
+    }
+    zassert_ok(ts_gateway_node_get(NODE_B, &node));
+    zassert_equal(node.telemetry.temperature, 2002, "Last sample is latest");
+}
+
+ZTEST(gateway, test_delta_decoded)
+{
+    struct ts_delta_encoder enc;
+    struct ts_msg_telemetry reading = {
+        .timestamp = 100, .temperature = -500, .humidity = 4000,
+        .pressure = 99000,
+    };
+    struct ts_msg_lora_incoming in;
+
+    ts_delta_encoder_init(&enc, 4);
+    for (uint32_t id = 1; id <= 2; id++) {
+        in = make_in(NODE_A, id, TS_MSG_TELEMETRY_DELTA);
+        ts_delta_encode(&enc, &reading, &in.msg.data.telemetry_delta);
+        zassert_ok(ts_gateway_handle(&in));
+        // The duplicate must not be mistaken for a sequence gap
+        zassert_equal(ts_gateway_handle(&in), -EALREADY);
+        reading.timestamp += 10;
+        reading.temperature += 3;
+    }
+
+    zassert_equal(ts_gateway_flush(), 2);
+    zassert_equal(sent[0].data.telemetry.temperature, -500);
+    zassert_equal(sent[1].data.telemetry.temperature, -497);
+    zassert_equal(sent[1].data.telemetry.timestamp, 110);
+}
+
+ZTEST(gateway, test_delta_without_keyframe)
+{
+    struct ts_delta_encoder enc;
+    struct ts_msg_telemetry reading = {.timestamp = 100};
+    struct ts_msg_lora_incoming in = make_in(NODE_A, 1,
+                                             TS_MSG_TELEMETRY_DELTA);
+    struct ts_gateway_stats stats;
+
+    ts_delta_encoder_init(&enc, 4);
+    ts_delta_encode(&enc, &reading, &in.msg.data.telemetry_delta);
+    ts_delta_encode(&enc, &reading, &in.msg.data.telemetry_delta);
+    zassert_equal(ts_gateway_handle(&in), -ENODATA);
+
+    ts_gateway_get_stats(&stats);
+    zassert_equal(stats.undecodable, 1);
+    zassert_equal(ts_gateway_flush(), 0);
+}
+
+ZTEST(gateway, test_summary_forwarded)
+{
+    struct ts_msg_lora_incoming in = make_in(NODE_A, 1,
+                                             TS_MSG_TELEMETRY_SUMMARY);
+    struct ts_gateway_node node;
+
+    in.msg.data.telemetry_summary = (struct ts_msg_telemetry_summary){
+        .timestamp = 1000,
+        .duration_s = 290,
+        .count = 30,
+        .temperature_min = 2000,
+        .temperature_mean = 2050,
+        .temperature_max = 2100,
+        .humidity_mean = 5000,
+        .pressure_mean = 101325,
+    };
+    zassert_ok(ts_gateway_handle(&in));
+    zassert_equal(ts_gateway_flush(), 1, "One record per summary");
+    zassert_equal(sent[0].type, TS_MSG_TELEMETRY_SUMMARY);
+    zassert_equal(sent[0].data.telemetry_summary.count, 30);
+    zassert_equal(sent[0].data.telemetry_summary.temperature_max, 2100);
+
+    // The table keeps the window's means, as of its end
+    zassert_ok(ts_gateway_node_get(NODE_A, &node));
+    zassert_true(node.has_telemetry);
+    zassert_equal(node.telemetry.timestamp, 1290);
+    zassert_equal(node.telemetry.temperature, 2050);
+}
+
+ZTEST(gateway, test_sensor_values_forwarded)
+{
+    struct ts_msg_lora_incoming tel = make_telemetry(NODE_A, 1, 2000);
+    struct ts_msg_lora_incoming in = make_in(NODE_A, 2,
+                                             TS_MSG_SENSOR_VALUES);
+    struct ts_gateway_node node;
+
+    in.msg.data.sensor_values = (struct ts_msg_sensor_values){
+        .timestamp = 1500,
+        .count = 2,
+        .values = {{.id = 0, .value = 2150}, {.id = 9, .value = 42}},
+    };
+    zassert_ok(ts_gateway_handle(&tel));
+    zassert_ok(ts_gateway_handle(&in));
+    zassert_equal(ts_gateway_flush(), 2);
+    zassert_equal(sent[1].type, TS_MSG_SENSOR_VALUES);
+    zassert_equal(sent[1].data.sensor_values.count, 2);
+    zassert_equal(sent[1].data.sensor_values.values[1].value, 42);
+
+    // Only the temperature channel of the latest reading moves
+    zassert_ok(ts_gateway_node_get(NODE_A, &node));
+    zassert_equal(node.telemetry.timestamp, 1500);
+    zassert_equal(node.telemetry.temperature, 2150);
+    zassert_equal(node.telemetry.humidity, 5000);
+}
+
+ZTEST(gateway, test_model_reconstructed)
+{
+    static const int32_t bound[TS_TELEMETRY_CHANNEL_COUNT] = {20, 100, 50};
+    struct ts_predict_encoder enc;
+    struct ts_msg_lora_incoming in;
+    struct ts_msg_telemetry estimate;
+    uint32_t id = 0;
+
+    zassert_equal(ts_gateway_node_estimate(NODE_A, 0, &estimate), -ENODATA);
+
+    // Steady rise of 1 per second: a resync and one update suffice
+    ts_predict_encoder_init(&enc);
+    for (int i = 0; i < 30; i++) {
+        struct ts_msg_telemetry r = {
+            .timestamp = 10 * i,
+            .temperature = 2000 + 10 * i,
+            .humidity = 5000,
+            .pressure = 101325,
+        };
+        in = make_in(NODE_A, id + 1, TS_MSG_TELEMETRY_MODEL);
+        if (ts_predict_encode(&enc, &r, bound, 3600,
+                              &in.msg.data.telemetry_model)) {
+            zassert_ok(ts_gateway_handle(&in));
+            id++;
+        }
+    }
+    zassert_equal(id, 2);
+    zassert_equal(ts_gateway_flush(), 2, "Only sent readings are uplinked");
+    zassert_equal(sent[0].type, TS_MSG_TELEMETRY);
+    zassert_equal(sent[1].data.telemetry.temperature, 2030);
+
+    zassert_ok(ts_gateway_node_estimate(NODE_A, 290, &estimate));
+    zassert_equal(estimate.temperature, 2290);
+    zassert_equal(estimate.pressure, 101325);
+}
+
+ZTEST(gateway, test_model_update_after_gap)
+{
+    struct ts_msg_lora_incoming in = make_in(NODE_A, 1,
+                                             TS_MSG_TELEMETRY_MODEL);
+    struct ts_msg_telemetry estimate;
+    struct ts_gateway_stats stats;
+
+    in.msg.data.telemetry_model = (struct ts_msg_telemetry_model){
+        .seq = 5, .timestamp = 100, .temperature = 2000, .humidity = 5000,
+        .pressure = 101325,
+    };
+    zassert_equal(ts_gateway_handle(&in), -ENODATA, "No resync seen yet");
+    zassert_equal(ts_gateway_node_estimate(NODE_A, 100, &estimate),
+                  -ENODATA);
+
+    ts_gateway_get_stats(&stats);
+    zassert_equal(stats.undecodable, 1);
+    zassert_equal(ts_gateway_flush(), 0);
+}
+
+ZTEST(gateway, test_unsupported_type)
+{
+    struct ts_msg_lora_incoming in = make_in(NODE_A, 1, TS_MSG_BULK_DATA);
+
+    zassert_equal(ts_gateway_handle(&in), -ENOTSUP);
+    zassert_equal(ts_gateway_node_count(), 0);
+}
+
+ZTEST(gateway, test_flush_on_size)
+{
+    struct ts_msg_lora_incoming in;
+
+    for (uint32_t id = 1; id <= TS_GATEWAY_BATCH_SIZE; id++) {
+        in = make_telemetry(NODE_A, id, 2000);
+        zassert_ok(ts_gateway_handle(&in));
+    }
+    k_sleep(K_MSEC(10));
+    zassert_equal(send_calls, 1, "Full batch should be sent at once");
+    zassert_equal(sent_count, TS_GATEWAY_BATCH_SIZE);
+}
+
+ZTEST(gateway, test_flush_on_timeout)
+{
+    struct ts_msg_lora_incoming in = make_telemetry(NODE_A, 1, 2000);
+
+    zassert_ok(ts_gateway_handle(&in));
+    k_sleep(K_MSEC(TS_GATEWAY_FLUSH_MS / 2));
+    zassert_equal(send_calls, 0, "Partial batch sent too early");
+    k_sleep(K_MSEC(TS_GATEWAY_FLUSH_MS));
+    zassert_equal(send_calls, 1, "Partial batch should be sent on timeout");
+    zassert_equal(sent_count, 1);
+}
+
+ZTEST(gateway, test_send_error_counted)
+{
+    struct ts_msg_lora_incoming in = make_telemetry(NODE_A, 1, 2000);
+    struct ts_gateway_stats stats;
+
+    send_result = -EIO;
+    zassert_ok(ts_gateway_handle(&in));
+    zassert_equal(ts_gateway_flush(), -EIO);
+
+    ts_gateway_get_stats(&stats);
+    zassert_equal(stats.send_errors, 1);
+    zassert_equal(stats.batches, 0);
+}
+
+ZTEST(gateway, test_oldest_node_evicted)
+{
+    struct ts_msg_lora_incoming in;
+    struct ts_gateway_node node;
+    struct ts_gateway_stats stats;
+
+    for (uint16_t i = 0; i <= TS_GATEWAY_MAX_NODES; i++) {
+        in = make_telemetry(NODE_A + i, 1, 2000);
+        zassert_ok(ts_gateway_handle(&in));
+        k_sleep(K_MSEC(1));
+    }
+
+    zassert_equal(ts_gateway_node_count(), TS_GATEWAY_MAX_NODES);
+    zassert_equal(ts_gateway_node_get(NODE_A, &node), -ENOENT,
+                  "Node heard from longest ago should be evicted");
+    zassert_ok(ts_gateway_node_get(NODE_A + TS_GATEWAY_MAX_NODES, &node));
+    ts_gateway_get_stats(&stats);
+    zassert_equal(stats.evictions, 1);
+}
+
+ZTEST_SUITE(gateway, NULL, NULL, before_each, NULL, NULL);
@@ -0,0 +1,142 @@
+#include <zephyr/zbus/zbus.h>
+#include <zephyr/ztest.h>
+
+#include "messages/msg_pool.h"
+
+static const struct ts_msg_lora_incoming* seen[2];
+static int seen_count;
+
+static void first_cb(const struct zbus_channel* chan)
+{
+    seen[0] = ts_msg_pool_peek(chan);
+    seen_count++;
+}
+
+static void second_cb(const struct zbus_channel* chan)
+{
+    seen[1] = ts_msg_pool_peek(chan);
+    seen_count++;
+}
+
+ZBUS_LISTENER_DEFINE(first_lis, first_cb);
+ZBUS_LISTENER_DEFINE(second_lis, second_cb);
+
+ZBUS_CHAN_DEFINE(test_in_chan, const struct ts_msg_lora_incoming*, NULL, NULL,
+                 ZBUS_OBSERVERS(first_lis, second_lis), ZBUS_MSG_INIT(NULL));
+
+static void after_each(void* fixture)
+{
+    ARG_UNUSED(fixture);
+
+    // Release whatever the channel still holds so every test starts
+    // with a full pool
+    const struct ts_msg_lora_incoming** pp_slot = zbus_chan_msg(&test_in_chan);
+    ts_msg_pool_unref(*pp_slot);
+    *pp_slot = NULL;
+    seen_count = 0;
+}
+
+/* --- Allocation --- */
+
+ZTEST(msg_pool, test_alloc_returns_zeroed_message)
+{
+    struct ts_msg_lora_incoming* p_msg = ts_msg_pool_alloc();
+
+    zassert_not_null(p_msg);
+    zassert_equal(p_msg->msg.route.msg_id, 0);
+    zassert_equal(p_msg->rssi, 0);
+    zassert_equal(ts_msg_pool_num_free(), TS_MSG_POOL_BLOCKS - 1);
+
+    p_msg->msg.route.msg_id = 7;
+    ts_msg_pool_unref(p_msg);
+
+    p_msg = ts_msg_pool_alloc();
+    zassert_equal(p_msg->msg.route.msg_id, 0, "Reused block must be zeroed");
+    ts_msg_pool_unref(p_msg);
+}
+
+ZTEST(msg_pool, test_exhausted_pool_returns_null)
+{
+    struct ts_msg_lora_incoming* msgs[TS_MSG_POOL_BLOCKS];
+
+    for (int i = 0; i < TS_MSG_POOL_BLOCKS; i++) {
+        msgs[i] = ts_msg_pool_alloc();
+        zassert_not_null(msgs[i]);
+    }
+    zassert_is_null(ts_msg_pool_alloc());
+
+    for (int i = 0; i < TS_MSG_POOL_BLOCKS; i++) {
+        ts_msg_pool_unref(msgs[i]);
+    }
+    zassert_equal(ts_msg_pool_num_free(), TS_MSG_POOL_BLOCKS);
+}
+
+ZTEST(msg_pool, test_block_freed_with_last_reference)
+{
+    struct ts_msg_lora_incoming* p_msg = ts_msg_pool_alloc();
+
+    ts_msg_pool_ref(p_msg);
+    ts_msg_pool_unref(p_msg);
+    zassert_equal(ts_msg_pool_num_free(), TS_MSG_POOL_BLOCKS - 1,
+                  "A reference is still held");
+
+    ts_msg_pool_unref(p_msg);
+    zassert_equal(ts_msg_pool_num_free(), TS_MSG_POOL_BLOCKS);
+}
+
+/* --- Channel handoff --- */
+
+ZTEST(msg_pool, test_listeners_share_one_copy)
+{
+    struct ts_msg_lora_incoming* p_msg = ts_msg_pool_alloc();
+
+    p_msg->msg.route.msg_id = 42;
+    zassert_ok(ts_msg_pool_publish(&test_in_chan, p_msg, K_NO_WAIT));
+
+    zassert_equal(seen_count, 2);
+    zassert_equal_ptr(seen[0], p_msg, "Listener should see the pool block");
+    zassert_equal_ptr(seen[1], p_msg);
+    zassert_equal(seen[0]->msg.route.msg_id, 42);
+    zassert_equal(ts_msg_pool_num_free(), TS_MSG_POOL_BLOCKS - 1,
+                  "The channel keeps its message");
+}
+
+ZTEST(msg_pool, test_publish_releases_previous_message)
+{
+    struct ts_msg_lora_incoming* p_first = ts_msg_pool_alloc();
+    struct ts_msg_lora_incoming* p_second = ts_msg_pool_alloc();
+
+    zassert_ok(ts_msg_pool_publish(&test_in_chan, p_first, K_NO_WAIT));
+    zassert_ok(ts_msg_pool_publish(&test_in_chan, p_second, K_NO_WAIT));
+
+    zassert_equal(ts_msg_pool_num_free(), TS_MSG_POOL_BLOCKS - 1,
+                  "Only the current message stays allocated");
+    zassert_equal_ptr(ts_msg_pool_peek(&test_in_chan), p_second);
+}
+
+ZTEST(msg_pool, test_subscriber_reference_outlives_replacement)
+{
+    struct ts_msg_lora_incoming* p_first = ts_msg_pool_alloc();
+
+    p_first->msg.route.msg_id = 1;
+    zassert_ok(ts_msg_pool_publish(&test_in_chan, p_first, K_NO_WAIT));
+
+    const struct ts_msg_lora_incoming* p_held =
+        ts_msg_pool_get(&test_in_chan, K_NO_WAIT);
+    zassert_equal_ptr(p_held, p_first);
+
+    zassert_ok(ts_msg_pool_publish(&test_in_chan, ts_msg_pool_alloc(),
+                                   K_NO_WAIT));
+    zassert_equal(p_held->msg.route.msg_id, 1, "Held message stays intact");
+    zassert_equal(ts_msg_pool_num_free(), TS_MSG_POOL_BLOCKS - 2);
+
+    ts_msg_pool_unref(p_held);
+    zassert_equal(ts_msg_pool_num_free(), TS_MSG_POOL_BLOCKS - 1);
+}
+
+ZTEST(msg_pool, test_get_on_empty_channel_returns_null)
+{
+    zassert_is_null(ts_msg_pool_get(&test_in_chan, K_NO_WAIT));
+}
+
+ZTEST_SUITE(msg_pool, NULL, NULL, NULL, after_each, NULL);
@@ -0,0 +1,209 @@
+#include <zephyr/ztest.h>
+
+#include "lora/packed.h"
+
+static struct ts_msg_lora_outgoing make_telemetry(int32_t temperature,
+                                                  int32_t humidity,
+                                                  int32_t pressure)
+{
+    struct ts_msg_lora_outgoing msg = {
+        .route = {.src = 0x0102,
+                  .dst = 0xFFFF,
+                  .msg_id = 0xA1B2C3D4,
+                  .ttl = 5,
+                  .key_id = 3,
+                  .tx_power = -2},
+        .type = TS_MSG_TELEMETRY,
+        .data.telemetry = {.timestamp = 1234,
+                           .temperature = temperature,
+                           .humidity = humidity,
+                           .pressure = pressure}};
+    return msg;
+}
+
+static int roundtrip(const struct ts_msg_lora_outgoing *p_msg,
+                     struct ts_msg_lora_outgoing *p_out)
+{
+    uint8_t buf[TS_PACKED_TELEMETRY_SIZE];
+    size_t size = 0;
+
+    int ret = ts_packed_serialize(p_msg, buf, sizeof(buf), &size);
+    if (ret != 0) {
+        return ret;
+    }
+    if (size != TS_PACKED_TELEMETRY_SIZE) {
+        return -EMSGSIZE;
+    }
+    return ts_packed_deserialize(buf, size, p_out);
+}
+
+/* --- Layout --- */
+
+ZTEST(packed, test_frame_is_nineteen_bytes)
+{
+    zassert_equal(TS_PACKED_FIELDS_SIZE, 7, "54 bits of fields");
+    zassert_equal(TS_PACKED_TELEMETRY_SIZE, 19);
+}
+
+ZTEST(packed, test_wire_layout)
+{
+    // 20.0 C, 50.0 %RH, 101325 Pa at t = 0x1234
+    struct ts_msg_lora_outgoing msg = make_telemetry(2000, 5000, 101325);
+    uint8_t buf[TS_PACKED_TELEMETRY_SIZE];
+    size_t size;
+
+    msg.data.telemetry.timestamp = 0x1234;
+    zassert_ok(ts_packed_serialize(&msg, buf, sizeof(buf), &size));
+
+    uint8_t expected[] = {TS_PACKED_MARKER,
+                          0x01, 0x02,              // src
+                          0xFF, 0xFF,              // dst
+                          0xA1, 0xB2, 0xC3, 0xD4,  // msg_id
+                          0x05, 0x03, 0xFE,        // ttl, key_id, tx_power
+                          // t=0x1234 | temp=200 | hum=500 | pres=71325
+                          0x12, 0x34, 0x19, 0x0F, 0xA4, 0x5A, 0x74};
+    zassert_mem_equal(buf, expected, sizeof(expected));
+}
+
+/* --- Round trip --- */
+
+ZTEST(packed, test_roundtrip_keeps_route_and_values)
+{
+    struct ts_msg_lora_outgoing msg = make_telemetry(2150, 5500, 101325);
+    struct ts_msg_lora_outgoing out;
+
+    zassert_ok(roundtrip(&msg, &out));
+    zassert_mem_equal(&out.route, &msg.route, sizeof(msg.route));
+    zassert_equal(out.type, TS_MSG_TELEMETRY);
+    zassert_mem_equal(&out.data.telemetry, &msg.data.telemetry,
+                      sizeof(msg.data.telemetry),
+                      "Values on the 0.1 grid survive exactly");
+}
+
+ZTEST(packed, test_rounds_to_tenths)
+{
+    struct ts_msg_lora_outgoing msg = make_telemetry(2156, 5504, 101325);
+    struct ts_msg_lora_outgoing out;
+
+    zassert_ok(roundtrip(&msg, &out));
+    zassert_equal(out.data.telemetry.temperature, 2160);
+    zassert_equal(out.data.telemetry.humidity, 5500);
+}
+
+ZTEST(packed, test_negative_temperature)
+{
+    struct ts_msg_lora_outgoing msg =
+        make_telemetry(-1234, 9000, 95000);
+    struct ts_msg_lora_outgoing out;
+
+    zassert_ok(roundtrip(&msg, &out));
+    zassert_equal(out.data.telemetry.temperature, -1230,
+                  "-12.34 C rounds to -12.3 C");
+}
+
+ZTEST(packed, test_range_limits)
+{
+    struct ts_msg_lora_outgoing lo =
+        make_telemetry(-10240, 0, TS_PACKED_PRESSURE_OFFSET_PA);
+    struct ts_msg_lora_outgoing hi = make_telemetry(
+        10230, 10230, TS_PACKED_PRESSURE_OFFSET_PA + BIT(17) - 1);
+    struct ts_msg_lora_outgoing out;
+
+    zassert_ok(roundtrip(&lo, &out));
+    zassert_mem_equal(&out.data.telemetry, &lo.data.telemetry,
+                      sizeof(lo.data.telemetry));
+    zassert_ok(roundtrip(&hi, &out));
+    zassert_mem_equal(&out.data.telemetry, &hi.data.telemetry,
+                      sizeof(hi.data.telemetry));
+}
+
+ZTEST(packed, test_timestamp_wraps)
+{
+    struct ts_msg_lora_outgoing msg = make_telemetry(2000, 5000, 101325);
+    struct ts_msg_lora_outgoing out;
+
+    msg.data.telemetry.timestamp = 0x10000 + 42;
+    zassert_ok(roundtrip(&msg, &out));
+    zassert_equal(out.data.telemetry.timestamp, 42);
+}
+
+ZTEST(packed, test_unwrap_timestamp_nearest_reference)
+{
+    zassert_equal(ts_packed_unwrap_timestamp(42, 0x10000 + 40), 0x10000 + 42);
+    zassert_equal(ts_packed_unwrap_timestamp(0xFFF0, 0x20000 + 5),
+                  0x10000 + 0xFFF0, "Sent just before the wrap");
+    zassert_equal(ts_packed_unwrap_timestamp(5, 0x2FFF0), 0x30000 + 5,
+                  "Reference just before the wrap");
+    zassert_equal(ts_packed_unwrap_timestamp(0xFFF0, 10), 0xFFF0,
+                  "Never before zero");
+    zassert_equal(ts_packed_unwrap_timestamp(5, UINT32_MAX - 2),
+                  0xFFFF0000 + 5, "Never past UINT32_MAX");
+}
+
+ZTEST(packed, test_forward_of_packed_reading_stays_packed)
+{
+    // Built without CONFIG_TS_TELEMETRY_PACKED, like a CBOR-only relay
+    struct ts_msg_lora_outgoing msg = make_telemetry(2000, 5000, 101325);
+    struct ts_msg_lora_outgoing out;
+
+    zassert_false(ts_packed_wanted(&msg), "Own readings go out as CBOR");
+    zassert_ok(roundtrip(&msg, &out));
+    zassert_true(out.short_timestamp);
+    zassert_true(ts_packed_wanted(&out), "Forward keeps the short marker");
+
+    out.type = TS_MSG_NODE_STATUS;
+    zassert_false(ts_packed_wanted(&out));
+}
+
+/* --- Rejection --- */
+
+ZTEST(packed, test_out_of_range_rejected)
+{
+    struct ts_msg_lora_outgoing cases[] = {
+        make_telemetry(10240, 5000, 101325),
+        make_telemetry(-10250, 5000, 101325),
+        make_telemetry(2000, 10240, 101325),
+        make_telemetry(2000, 5000, TS_PACKED_PRESSURE_OFFSET_PA - 1),
+        make_telemetry(2000, 5000, TS_PACKED_PRESSURE_OFFSET_PA + BIT(17)),
+    };
+    uint8_t buf[TS_PACKED_TELEMETRY_SIZE];
+    size_t size;
+
+    for (int i = 0; i < ARRAY_SIZE(cases); i++) {
+        zassert_equal(ts_packed_serialize(&cases[i], buf, sizeof(buf), &size),
+                      -ERANGE, "Case %d", i);
+    }
+}
+
+ZTEST(packed, test_only_telemetry_is_packed)
+{
+    struct ts_msg_lora_outgoing msg = {.type = TS_MSG_NODE_STATUS};
+    uint8_t buf[TS_PACKED_TELEMETRY_SIZE];
+    size_t size;
+
+    zassert_equal(ts_packed_serialize(&msg, buf, sizeof(buf), &size),
+                  -ENOTSUP);
+    msg = make_telemetry(2000, 5000, 101325);
+    zassert_equal(ts_packed_serialize(&msg, buf, sizeof(buf) - 1, &size),
+                  -ENOMEM);
+}
+
+ZTEST(packed, test_bad_frames_rejected)
+{
+    struct ts_msg_lora_outgoing msg = make_telemetry(2000, 5000, 101325);
+    struct ts_msg_lora_outgoing out;
+    uint8_t buf[TS_PACKED_TELEMETRY_SIZE];
+    size_t size;
+
+    zassert_ok(ts_packed_serialize(&msg, buf, sizeof(buf), &size));
+    zassert_true(ts_packed_is_packed(buf, size));
+    zassert_equal(ts_packed_deserialize(buf, size - 1, &out), -EBADMSG,
+                  "Truncated");
+
+    buf[0] = 0xBF;  // CBOR indefinite-length map
+    zassert_false(ts_packed_is_packed(buf, size));
+    zassert_equal(ts_packed_deserialize(buf, size, &out), -EBADMSG);
+    zassert_false(ts_packed_is_packed(buf, 0));
+}
+
+ZTEST_SUITE(packed, NULL, NULL, NULL, NULL, NULL);
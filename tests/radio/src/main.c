@@ -0,0 +1,286 @@
+#include <errno.h>
+#include <string.h>
+#include <zephyr/drivers/lora.h>
+#include <zephyr/ztest.h>
+
+#include "lora/airtime.h"
+#include "lora/radio.h"
+
+// Fake modem: records what the arbiter asks of it
+static struct {
+    int config_calls;
+    struct lora_modem_config last_config;
+    int config_ret;
+    int send_calls;
+    int send_ret;
+    enum ts_radio_state state_in_send;
+    bool rx_armed_in_send;
+    lora_recv_cb recv_cb;
+    int recv_ret;
+} fake;
+
+static int rx_cb_calls;
+static uint16_t rx_cb_len;
+
+static int fake_config(const struct device* dev,
+                       struct lora_modem_config* config)
+{
+    fake.config_calls++;
+    fake.last_config = *config;
+    return fake.config_ret;
+}
+
+static int fake_send(const struct device* dev, uint8_t* data,
+                     uint32_t data_len)
+{
+    fake.send_calls++;
+    fake.state_in_send = ts_radio_get_state();
+    fake.rx_armed_in_send = fake.recv_cb != NULL;
+    return fake.send_ret;
+}
+
+static int fake_recv_async(const struct device* dev, lora_recv_cb cb,
+                           void* user_data)
+{
+    if (cb == NULL) {
+        fake.recv_cb = NULL;
+        return 0;
+    }
+    if (fake.recv_ret == 0) { fake.recv_cb = cb; }
+    return fake.recv_ret;
+}
+
+static const struct lora_driver_api fake_api = {
+    .config = fake_config,
+    .send = fake_send,
+    .recv_async = fake_recv_async,
+};
+
+static const struct device fake_dev = {
+    .name = "fake_lora",
+    .api = &fake_api,
+};
+
+static const struct lora_modem_config modem_config = {
+    .frequency = 865100000,
+    .bandwidth = BW_125_KHZ,
+    .datarate = SF_10,
+    .coding_rate = CR_4_5,
+    .preamble_len = 8,
+    .tx_power = 4,
+};
+
+static void rx_cb(const uint8_t* p_data, uint16_t len, int16_t rssi,
+                  int8_t snr)
+{
+    rx_cb_calls++;
+    rx_cb_len = len;
+}
+
+static void before_each(void* fixture)
+{
+    ARG_UNUSED(fixture);
+    memset(&fake, 0, sizeof(fake));
+    rx_cb_calls = 0;
+    rx_cb_len = 0;
+    zassert_ok(ts_radio_init(&fake_dev, &modem_config, rx_cb));
+    fake.config_calls = 0;
+}
+
+/* --- Init --- */
+
+ZTEST(radio, test_init_programs_both_paths_and_listens)
+{
+    fake.config_calls = 0;
+    zassert_ok(ts_radio_init(&fake_dev, &modem_config, rx_cb));
+
+    zassert_equal(fake.config_calls, 2, "RX and TX parameter sets");
+    zassert_true(fake.last_config.tx, "TX set is left active");
+    zassert_not_null(fake.recv_cb);
+    zassert_equal(ts_radio_get_state(), TS_RADIO_STATE_RX);
+}
+
+ZTEST(radio, test_init_config_failure_stays_idle)
+{
+    fake.recv_cb = NULL;
+    fake.config_ret = -EIO;
+
+    zassert_equal(ts_radio_init(&fake_dev, &modem_config, rx_cb), -EIO);
+    zassert_is_null(fake.recv_cb);
+    zassert_equal(ts_radio_get_state(), TS_RADIO_STATE_IDLE);
+}
+
+/* --- Transitions --- */
+
+ZTEST(radio, test_send_parks_rx_and_returns_to_rx)
+{
+    uint8_t frame[16] = {0};
+    struct ts_radio_stats st;
+
+    zassert_ok(ts_radio_send(frame, sizeof(frame), modem_config.tx_power));
+
+    zassert_equal(fake.send_calls, 1);
+    zassert_equal(fake.state_in_send, TS_RADIO_STATE_TX);
+    zassert_false(fake.rx_armed_in_send, "Receive parked while sending");
+    zassert_not_null(fake.recv_cb, "Receive re-armed after sending");
+    zassert_equal(ts_radio_get_state(), TS_RADIO_STATE_RX);
+
+    ts_radio_get_stats(&st);
+    zassert_equal(st.tx_frames, 1);
+    zassert_equal(st.tx_errors, 0);
+}
+
+ZTEST(radio, test_send_failure_returns_to_rx)
+{
+    uint8_t frame[16] = {0};
+    struct ts_radio_stats st;
+
+    fake.send_ret = -EIO;
+    zassert_equal(ts_radio_send(frame, sizeof(frame), modem_config.tx_power),
+                  -EIO);
+    zassert_equal(ts_radio_get_state(), TS_RADIO_STATE_RX);
+
+    ts_radio_get_stats(&st);
+    zassert_equal(st.tx_frames, 0);
+    zassert_equal(st.tx_errors, 1);
+}
+
+ZTEST(radio, test_rx_restart_failure_leaves_idle)
+{
+    uint8_t frame[16] = {0};
+
+    fake.recv_ret = -EIO;
+    zassert_ok(ts_radio_send(frame, sizeof(frame), modem_config.tx_power));
+    zassert_equal(ts_radio_get_state(), TS_RADIO_STATE_IDLE);
+}
+
+ZTEST(radio, test_oversized_frame_rejected)
+{
+    static uint8_t frame[256];
+
+    zassert_equal(ts_radio_send(frame, sizeof(frame), modem_config.tx_power),
+                  -EMSGSIZE);
+    zassert_equal(fake.send_calls, 0);
+    zassert_equal(ts_radio_get_state(), TS_RADIO_STATE_RX);
+}
+
+/* --- TX power --- */
+
+ZTEST(radio, test_power_change_reprograms_once)
+{
+    uint8_t frame[16] = {0};
+
+    zassert_ok(ts_radio_send(frame, sizeof(frame), modem_config.tx_power));
+    zassert_equal(fake.config_calls, 0, "Same power, no reconfig");
+
+    zassert_ok(ts_radio_send(frame, sizeof(frame), 10));
+    zassert_ok(ts_radio_send(frame, sizeof(frame), 10));
+    zassert_equal(fake.config_calls, 1);
+    zassert_equal(fake.last_config.tx_power, 10);
+    zassert_equal(ts_radio_get_config()->tx_power, 10);
+}
+
+ZTEST(radio, test_power_config_failure_keeps_old_power)
+{
+    uint8_t frame[16] = {0};
+    struct ts_radio_stats st;
+
+    fake.config_ret = -EIO;
+    zassert_equal(ts_radio_send(frame, sizeof(frame), 10), -EIO);
+    zassert_equal(fake.send_calls, 0, "Not sent at an unknown power");
+    zassert_equal(ts_radio_get_config()->tx_power, modem_config.tx_power);
+    zassert_equal(ts_radio_get_state(), TS_RADIO_STATE_RX);
+
+    ts_radio_get_stats(&st);
+    zassert_equal(st.tx_errors, 1);
+}
+
+/* --- Receive and accounting --- */
+
+ZTEST(radio, test_rx_frame_delivered_and_counted)
+{
+    uint8_t frame[12] = {0};
+    struct ts_radio_stats st;
+
+    fake.recv_cb(&fake_dev, frame, sizeof(frame), -80, 7, NULL);
+
+    zassert_equal(rx_cb_calls, 1);
+    zassert_equal(rx_cb_len, sizeof(frame));
+    zassert_equal(ts_radio_get_state(), TS_RADIO_STATE_RX);
+    ts_radio_get_stats(&st);
+    zassert_equal(st.rx_frames, 1);
+}
+
+ZTEST(radio, test_time_accounted_per_state)
+{
+    struct ts_radio_stats st;
+
+    k_sleep(K_MSEC(50));
+    ts_radio_get_stats(&st);
+    zassert_true(st.state_ms[TS_RADIO_STATE_RX] >= 50, "%llu ms in RX",
+                 (unsigned long long)st.state_ms[TS_RADIO_STATE_RX]);
+    zassert_equal(st.state_ms[TS_RADIO_STATE_TX], 0);
+}
+
+/* --- Receptions in flight --- */
+
+ZTEST(radio, test_preamble_marks_rx_busy_until_frame)
+{
+    uint8_t frame[12] = {0};
+
+    ts_radio_notify_preamble();
+    zassert_equal(ts_radio_get_state(), TS_RADIO_STATE_RX_BUSY);
+
+    fake.recv_cb(&fake_dev, frame, sizeof(frame), -80, 7, NULL);
+    zassert_equal(rx_cb_calls, 1);
+    zassert_equal(ts_radio_get_state(), TS_RADIO_STATE_RX);
+}
+
+ZTEST(radio, test_send_waits_out_lost_reception)
+{
+    // Fast modem settings keep the maximum frame time short
+    struct lora_modem_config fast = modem_config;
+    uint8_t frame[16] = {0};
+    struct ts_radio_stats st;
+
+    fast.bandwidth = BW_500_KHZ;
+    fast.datarate = SF_7;
+    zassert_ok(ts_radio_init(&fake_dev, &fast, rx_cb));
+
+    ts_radio_notify_preamble();
+    int64_t start = k_uptime_get();
+    zassert_ok(ts_radio_send(frame, sizeof(frame), fast.tx_power));
+    int64_t waited = k_uptime_get() - start;
+
+    zassert_true(waited >= ts_airtime_ms(&fast, 255), "Waited %lld ms",
+                 (long long)waited);
+    zassert_equal(fake.send_calls, 1);
+    zassert_equal(ts_radio_get_state(), TS_RADIO_STATE_RX);
+    ts_radio_get_stats(&st);
+    zassert_equal(st.tx_deferred, 1);
+    zassert_true(st.state_ms[TS_RADIO_STATE_RX_BUSY] > 0);
+}
+
+ZTEST(radio, test_send_without_reception_not_deferred)
+{
+    uint8_t frame[16] = {0};
+    struct ts_radio_stats st;
+
+    zassert_ok(ts_radio_send(frame, sizeof(frame), modem_config.tx_power));
+    ts_radio_get_stats(&st);
+    zassert_equal(st.tx_deferred, 0);
+}
+
+ZTEST(radio, test_preamble_ignored_unless_listening)
+{
+    uint8_t frame[16] = {0};
+
+    fake.recv_ret = -EIO;
+    zassert_ok(ts_radio_send(frame, sizeof(frame), modem_config.tx_power));
+    zassert_equal(ts_radio_get_state(), TS_RADIO_STATE_IDLE);
+
+    ts_radio_notify_preamble();
+    zassert_equal(ts_radio_get_state(), TS_RADIO_STATE_IDLE);
+}
+
+ZTEST_SUITE(radio, NULL, NULL, before_each, NULL, NULL);
@@ -132,6 +132,21 @@ ZTEST(routing, test_different_src_not_duplicate)
                   "Same msg_id from different source should not be duplicate");
 }
 
+ZTEST(routing, test_repeat_needs_ttl_not_below_first_copy)
+{
+    struct ts_route_header hdr = {.src = OTHER_NODE_ID, .msg_id = 42};
+
+    hdr.ttl = 5;
+    zassert_false(ts_routing_is_repeat(&hdr), "Not seen yet");
+    ts_routing_mark_seen(&hdr);
+
+    zassert_true(ts_routing_is_repeat(&hdr), "Sent again by the same hop");
+    hdr.ttl = 6;
+    zassert_true(ts_routing_is_repeat(&hdr));
+    hdr.ttl = 4;
+    zassert_false(ts_routing_is_repeat(&hdr), "Forwarded downstream");
+}
+
 ZTEST(routing, test_cache_evicts_oldest_entries)
 {
     struct ts_route_header hdr = {.src = OTHER_NODE_ID};
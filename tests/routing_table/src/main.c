@@ -3,6 +3,9 @@
 #include "routing/routing.h"
 #include "routing/routing_table.h"
 
+// Transmit power the neighbors report in their headers
+#define TX_DBM 14
+
 static void before_each(void *fixture)
 {
     ARG_UNUSED(fixture);
@@ -28,7 +31,7 @@ ZTEST(routing_table, test_lookup_empty_returns_enoent)
 
 ZTEST(routing_table, test_update_and_lookup)
 {
-    ts_routing_table_update(0x0002, -75, 8, TS_ROUTING_DEFAULT_TTL);
+    ts_routing_table_update(0x0002, -75, 8, TX_DBM, TS_ROUTING_DEFAULT_TTL);
 
     struct ts_neighbor nb;
     int ret = ts_routing_table_lookup(0x0002, &nb);
@@ -40,20 +43,21 @@ ZTEST(routing_table, test_update_and_lookup)
 
 ZTEST(routing_table, test_update_same_node_refreshes_rssi)
 {
-    ts_routing_table_update(0x0002, -75, 8, TS_ROUTING_DEFAULT_TTL);
-    ts_routing_table_update(0x0002, -90, 3, TS_ROUTING_DEFAULT_TTL);
+    ts_routing_table_update(0x0002, -75, 8, TX_DBM, TS_ROUTING_DEFAULT_TTL);
+    ts_routing_table_update(0x0002, -90, 3, 6, TS_ROUTING_DEFAULT_TTL);
 
     struct ts_neighbor nb;
     ts_routing_table_lookup(0x0002, &nb);
     zassert_equal(nb.rssi, -90, "RSSI should be updated to latest value");
     zassert_equal(nb.snr, 3, "SNR should be updated to latest value");
+    zassert_equal(nb.tx_power, 6, "TX power should be updated too");
 }
 
 /* --- Direct flag --- */
 
 ZTEST(routing_table, test_direct_flag_full_ttl)
 {
-    ts_routing_table_update(0x0002, -75, 8, TS_ROUTING_DEFAULT_TTL);
+    ts_routing_table_update(0x0002, -75, 8, TX_DBM, TS_ROUTING_DEFAULT_TTL);
 
     struct ts_neighbor nb;
     ts_routing_table_lookup(0x0002, &nb);
@@ -62,7 +66,7 @@ ZTEST(routing_table, test_direct_flag_full_ttl)
 
 ZTEST(routing_table, test_direct_flag_decremented_ttl)
 {
-    ts_routing_table_update(0x0002, -75, 8, TS_ROUTING_DEFAULT_TTL - 1);
+    ts_routing_table_update(0x0002, -75, 8, TX_DBM, TS_ROUTING_DEFAULT_TTL - 1);
 
     struct ts_neighbor nb;
     ts_routing_table_lookup(0x0002, &nb);
@@ -71,8 +75,8 @@ ZTEST(routing_table, test_direct_flag_decremented_ttl)
 
 ZTEST(routing_table, test_direct_flag_not_downgraded)
 {
-    ts_routing_table_update(0x0002, -75, 8, TS_ROUTING_DEFAULT_TTL);
-    ts_routing_table_update(0x0002, -90, 3, TS_ROUTING_DEFAULT_TTL - 1);
+    ts_routing_table_update(0x0002, -75, 8, TX_DBM, TS_ROUTING_DEFAULT_TTL);
+    ts_routing_table_update(0x0002, -90, 3, TX_DBM, TS_ROUTING_DEFAULT_TTL - 1);
 
     struct ts_neighbor nb;
     ts_routing_table_lookup(0x0002, &nb);
@@ -84,9 +88,9 @@ ZTEST(routing_table, test_direct_flag_not_downgraded)
 
 ZTEST(routing_table, test_count_after_inserts)
 {
-    ts_routing_table_update(0x0002, -75, 8, TS_ROUTING_DEFAULT_TTL);
-    ts_routing_table_update(0x0003, -80, 6, TS_ROUTING_DEFAULT_TTL);
-    ts_routing_table_update(0x0004, -90, 3, TS_ROUTING_DEFAULT_TTL);
+    ts_routing_table_update(0x0002, -75, 8, TX_DBM, TS_ROUTING_DEFAULT_TTL);
+    ts_routing_table_update(0x0003, -80, 6, TX_DBM, TS_ROUTING_DEFAULT_TTL);
+    ts_routing_table_update(0x0004, -90, 3, TX_DBM, TS_ROUTING_DEFAULT_TTL);
 
     zassert_equal(ts_routing_table_count(), 3);
 }
@@ -97,12 +101,13 @@ ZTEST(routing_table, test_table_full_evicts_oldest)
 {
     // Fill table — first entry (node 0x0100) will be the oldest
     for (uint16_t i = 0; i < TS_ROUTING_TABLE_SIZE; i++) {
-        ts_routing_table_update(0x0100 + i, -75, 8, TS_ROUTING_DEFAULT_TTL);
+        ts_routing_table_update(0x0100 + i, -75, 8, TX_DBM,
+                                TS_ROUTING_DEFAULT_TTL);
         k_sleep(K_MSEC(10));
     }
 
     // Add one more — should evict 0x0100 (oldest)
-    ts_routing_table_update(0x0200, -60, 10, TS_ROUTING_DEFAULT_TTL);
+    ts_routing_table_update(0x0200, -60, 10, TX_DBM, TS_ROUTING_DEFAULT_TTL);
 
     struct ts_neighbor nb;
     int ret = ts_routing_table_lookup(0x0100, &nb);
@@ -112,11 +117,12 @@ ZTEST(routing_table, test_table_full_evicts_oldest)
 ZTEST(routing_table, test_table_full_new_entry_present)
 {
     for (uint16_t i = 0; i < TS_ROUTING_TABLE_SIZE; i++) {
-        ts_routing_table_update(0x0100 + i, -75, 8, TS_ROUTING_DEFAULT_TTL);
+        ts_routing_table_update(0x0100 + i, -75, 8, TX_DBM,
+                                TS_ROUTING_DEFAULT_TTL);
         k_sleep(K_MSEC(10));
     }
 
-    ts_routing_table_update(0x0200, -60, 10, TS_ROUTING_DEFAULT_TTL);
+    ts_routing_table_update(0x0200, -60, 10, TX_DBM, TS_ROUTING_DEFAULT_TTL);
 
     struct ts_neighbor nb;
     int ret = ts_routing_table_lookup(0x0200, &nb);
@@ -128,7 +134,7 @@ ZTEST(routing_table, test_table_full_new_entry_present)
 
 ZTEST(routing_table, test_age_removes_stale)
 {
-    ts_routing_table_update(0x0002, -75, 8, TS_ROUTING_DEFAULT_TTL);
+    ts_routing_table_update(0x0002, -75, 8, TX_DBM, TS_ROUTING_DEFAULT_TTL);
     k_sleep(K_SECONDS(2));
 
     ts_routing_table_age_seconds(1);
@@ -140,7 +146,7 @@ ZTEST(routing_table, test_age_removes_stale)
 
 ZTEST(routing_table, test_age_keeps_fresh)
 {
-    ts_routing_table_update(0x0002, -75, 8, TS_ROUTING_DEFAULT_TTL);
+    ts_routing_table_update(0x0002, -75, 8, TX_DBM, TS_ROUTING_DEFAULT_TTL);
 
     ts_routing_table_age_seconds(TS_ROUTING_TABLE_STALE_TIMEOUT_S);
 
@@ -151,21 +157,44 @@ ZTEST(routing_table, test_age_keeps_fresh)
 
 ZTEST(routing_table, test_age_returns_removal_count)
 {
-    ts_routing_table_update(0x0002, -75, 8, TS_ROUTING_DEFAULT_TTL);
-    ts_routing_table_update(0x0003, -80, 6, TS_ROUTING_DEFAULT_TTL);
-    ts_routing_table_update(0x0004, -90, 3, TS_ROUTING_DEFAULT_TTL);
+    ts_routing_table_update(0x0002, -75, 8, TX_DBM, TS_ROUTING_DEFAULT_TTL);
+    ts_routing_table_update(0x0003, -80, 6, TX_DBM, TS_ROUTING_DEFAULT_TTL);
+    ts_routing_table_update(0x0004, -90, 3, TX_DBM, TS_ROUTING_DEFAULT_TTL);
     k_sleep(K_SECONDS(2));
 
     int removed = ts_routing_table_age_seconds(1);
     zassert_equal(removed, 3, "Should report 3 entries removed");
 }
 
+/* --- Snapshot --- */
+
+ZTEST(routing_table, test_snapshot_copies_occupied_entries)
+{
+    ts_routing_table_update(0x0002, -75, 8, TX_DBM, TS_ROUTING_DEFAULT_TTL);
+    ts_routing_table_update(0x0003, -80, 6, TX_DBM, TS_ROUTING_DEFAULT_TTL);
+
+    struct ts_neighbor out[TS_ROUTING_TABLE_SIZE];
+    size_t n = ts_routing_table_snapshot(out, ARRAY_SIZE(out));
+    zassert_equal(n, 2, "Snapshot should contain both neighbors");
+    zassert_true(out[0].occupied && out[1].occupied);
+}
+
+ZTEST(routing_table, test_snapshot_respects_capacity)
+{
+    ts_routing_table_update(0x0002, -75, 8, TX_DBM, TS_ROUTING_DEFAULT_TTL);
+    ts_routing_table_update(0x0003, -80, 6, TX_DBM, TS_ROUTING_DEFAULT_TTL);
+
+    struct ts_neighbor out[1];
+    zassert_equal(ts_routing_table_snapshot(out, 1), 1,
+                  "Snapshot must not write past the output array");
+}
+
 /* --- Clear --- */
 
 ZTEST(routing_table, test_clear_resets_table)
 {
-    ts_routing_table_update(0x0002, -75, 8, TS_ROUTING_DEFAULT_TTL);
-    ts_routing_table_update(0x0003, -80, 6, TS_ROUTING_DEFAULT_TTL);
+    ts_routing_table_update(0x0002, -75, 8, TX_DBM, TS_ROUTING_DEFAULT_TTL);
+    ts_routing_table_update(0x0003, -80, 6, TX_DBM, TS_ROUTING_DEFAULT_TTL);
 
     ts_routing_table_init();
 
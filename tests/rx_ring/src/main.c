@@ -0,0 +1,118 @@
+#include <zephyr/ztest.h>
+
+#include "lora/rx_ring.h"
+
+static void before_each(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    ts_rx_ring_init();
+}
+
+static int put_byte(uint8_t value)
+{
+    return ts_rx_ring_put(&value, 1, -80, 5);
+}
+
+/* --- Empty ring --- */
+
+ZTEST(rx_ring, test_empty_peek_times_out)
+{
+    zassert_is_null(ts_rx_ring_peek(K_NO_WAIT),
+                    "Empty ring should not return a frame");
+    zassert_equal(ts_rx_ring_count(), 0);
+}
+
+/* --- Put and peek --- */
+
+ZTEST(rx_ring, test_put_peek_preserves_frame_and_metadata)
+{
+    const uint8_t payload[] = {0xA3, 0x01, 0x02, 0x03};
+    zassert_ok(ts_rx_ring_put(payload, sizeof(payload), -97, -4));
+
+    const struct ts_rx_frame *frame = ts_rx_ring_peek(K_NO_WAIT);
+    zassert_not_null(frame);
+    zassert_equal(frame->len, sizeof(payload));
+    zassert_mem_equal(frame->data, payload, sizeof(payload));
+    zassert_equal(frame->rssi, -97);
+    zassert_equal(frame->snr, -4);
+    zassert_true(frame->timestamp_ms <= k_uptime_get(),
+                 "Timestamp should be taken at put time");
+    ts_rx_ring_release();
+    zassert_equal(ts_rx_ring_count(), 0);
+}
+
+ZTEST(rx_ring, test_frames_returned_in_order)
+{
+    for (uint8_t i = 0; i < 3; i++) {
+        zassert_ok(put_byte(i));
+    }
+    for (uint8_t i = 0; i < 3; i++) {
+        const struct ts_rx_frame *frame = ts_rx_ring_peek(K_NO_WAIT);
+        zassert_not_null(frame);
+        zassert_equal(frame->data[0], i, "Frames must come out FIFO");
+        ts_rx_ring_release();
+    }
+}
+
+ZTEST(rx_ring, test_oversized_frame_rejected)
+{
+    static uint8_t big[TS_RX_FRAME_MAX_LEN + 1];
+    zassert_equal(ts_rx_ring_put(big, sizeof(big), 0, 0), -EMSGSIZE);
+    zassert_equal(ts_rx_ring_count(), 0);
+}
+
+/* --- Overflow and statistics --- */
+
+ZTEST(rx_ring, test_full_ring_counts_overflow)
+{
+    for (uint8_t i = 0; i < TS_RX_RING_SLOTS; i++) {
+        zassert_ok(put_byte(i));
+    }
+    zassert_equal(put_byte(0xFF), -ENOBUFS, "Full ring should reject");
+
+    struct ts_rx_ring_stats stats;
+    ts_rx_ring_get_stats(&stats);
+    zassert_equal(stats.received, TS_RX_RING_SLOTS);
+    zassert_equal(stats.overflows, 1);
+    zassert_equal(stats.high_water, TS_RX_RING_SLOTS);
+}
+
+ZTEST(rx_ring, test_overflow_keeps_oldest_frames)
+{
+    for (uint8_t i = 0; i < TS_RX_RING_SLOTS + 2; i++) {
+        put_byte(i);
+    }
+    const struct ts_rx_frame *frame = ts_rx_ring_peek(K_NO_WAIT);
+    zassert_equal(frame->data[0], 0, "Queued frames must not be overwritten");
+}
+
+ZTEST(rx_ring, test_high_water_tracks_peak_not_current)
+{
+    put_byte(1);
+    put_byte(2);
+    ts_rx_ring_peek(K_NO_WAIT);
+    ts_rx_ring_release();
+    ts_rx_ring_peek(K_NO_WAIT);
+    ts_rx_ring_release();
+    put_byte(3);
+
+    struct ts_rx_ring_stats stats;
+    ts_rx_ring_get_stats(&stats);
+    zassert_equal(stats.high_water, 2);
+    zassert_equal(ts_rx_ring_count(), 1);
+}
+
+ZTEST(rx_ring, test_wraparound)
+{
+    // Cycle through the ring several times to cross the index wrap
+    for (uint32_t i = 0; i < TS_RX_RING_SLOTS * 3; i++) {
+        zassert_ok(put_byte((uint8_t)i));
+        const struct ts_rx_frame *frame = ts_rx_ring_peek(K_NO_WAIT);
+        zassert_not_null(frame);
+        zassert_equal(frame->data[0], (uint8_t)i);
+        ts_rx_ring_release();
+    }
+    zassert_equal(ts_rx_ring_count(), 0);
+}
+
+ZTEST_SUITE(rx_ring, NULL, NULL, before_each, NULL, NULL);
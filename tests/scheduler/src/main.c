@@ -0,0 +1,244 @@
+#include <errno.h>
+#include <zephyr/ztest.h>
+
+#include "scheduler/scheduler.h"
+
+// Intervals as they would come from the live config
+static uint32_t sensor_interval_s;
+static uint32_t heartbeat_interval_s;
+static uint32_t aging_interval_s;
+
+static int sensor_runs;
+static int heartbeat_runs;
+static int aging_runs;
+static uint32_t sensor_next_s;  // What the sensor job asks for, 0 = interval
+
+static uint32_t sensor_run(void)
+{
+    sensor_runs++;
+    return sensor_next_s;
+}
+
+static uint32_t heartbeat_run(void)
+{
+    heartbeat_runs++;
+    return 0;
+}
+
+static uint32_t aging_run(void)
+{
+    aging_runs++;
+    return 0;
+}
+
+static struct ts_sched_job sensor_job = {
+    .name = "sensor",
+    .run = sensor_run,
+    .p_interval_s = &sensor_interval_s,
+    .tolerance_s = 0,
+};
+
+static struct ts_sched_job heartbeat_job = {
+    .name = "heartbeat",
+    .run = heartbeat_run,
+    .p_interval_s = &heartbeat_interval_s,
+    .tolerance_s = 3,
+};
+
+static struct ts_sched_job aging_job = {
+    .name = "aging",
+    .run = aging_run,
+    .p_interval_s = &aging_interval_s,
+    .tolerance_s = 30,
+};
+
+static void before_each(void* fixture)
+{
+    ARG_UNUSED(fixture);
+    sensor_interval_s = 10;
+    heartbeat_interval_s = 7;
+    aging_interval_s = 60;
+    sensor_runs = 0;
+    heartbeat_runs = 0;
+    aging_runs = 0;
+    sensor_next_s = 0;
+    ts_sched_init();
+}
+
+/* --- Registration --- */
+
+ZTEST(scheduler, test_add_rejects_invalid)
+{
+    struct ts_sched_job no_run = {.p_interval_s = &sensor_interval_s};
+    struct ts_sched_job no_interval = {.run = sensor_run};
+
+    zassert_equal(ts_sched_add(&no_run, 0), -EINVAL);
+    zassert_equal(ts_sched_add(&no_interval, 0), -EINVAL);
+    zassert_ok(ts_sched_add(&sensor_job, 0));
+    zassert_equal(ts_sched_add(&sensor_job, 0), -EEXIST);
+}
+
+ZTEST(scheduler, test_add_limit)
+{
+    static struct ts_sched_job extra[TS_SCHED_MAX_JOBS];
+
+    for (int i = 0; i < TS_SCHED_MAX_JOBS; i++) {
+        extra[i] = (struct ts_sched_job){
+            .run = heartbeat_run,
+            .p_interval_s = &heartbeat_interval_s,
+        };
+        zassert_ok(ts_sched_add(&extra[i], 0));
+    }
+    zassert_equal(ts_sched_add(&sensor_job, 0), -ENOMEM);
+}
+
+ZTEST(scheduler, test_no_jobs_no_wakeup)
+{
+    zassert_equal(ts_sched_run_due(0), UINT32_MAX);
+    zassert_equal(ts_sched_get_wakeups(), 0);
+}
+
+/* --- Timing --- */
+
+ZTEST(scheduler, test_strict_job_runs_on_time)
+{
+    zassert_ok(ts_sched_add(&sensor_job, 10));
+
+    zassert_equal(ts_sched_run_due(0), 10);
+    zassert_equal(sensor_runs, 0);
+    zassert_equal(ts_sched_run_due(10), 10);
+    zassert_equal(sensor_runs, 1);
+}
+
+ZTEST(scheduler, test_tolerance_defers_wakeup)
+{
+    zassert_ok(ts_sched_add(&aging_job, 60));
+
+    // Alone, a tolerant job waits until its window closes
+    zassert_equal(ts_sched_run_due(0), 90);
+    zassert_equal(ts_sched_run_due(89), 61);
+    zassert_equal(aging_runs, 1, "Window open, runs if woken anyway");
+}
+
+ZTEST(scheduler, test_keeps_phase)
+{
+    struct ts_sched_job_stats st;
+
+    zassert_ok(ts_sched_add(&heartbeat_job, 7));
+    zassert_equal(ts_sched_run_due(10), 7, "Next due at 14, wake at 17");
+    zassert_equal(ts_sched_run_due(17), 7);
+    zassert_equal(heartbeat_runs, 2);
+
+    ts_sched_get_stats(&heartbeat_job, &st);
+    zassert_equal(st.max_late_s, 3);
+}
+
+ZTEST(scheduler, test_skips_missed_runs)
+{
+    zassert_ok(ts_sched_add(&sensor_job, 10));
+
+    // Stalled through four periods: one run, then back on the interval
+    zassert_equal(ts_sched_run_due(55), 10);
+    zassert_equal(sensor_runs, 1);
+}
+
+ZTEST(scheduler, test_job_chooses_next_run)
+{
+    zassert_ok(ts_sched_add(&sensor_job, 0));
+
+    sensor_next_s = 3;
+    zassert_equal(ts_sched_run_due(0), 3);
+    sensor_next_s = 0;
+    zassert_equal(ts_sched_run_due(3), 10);
+}
+
+ZTEST(scheduler, test_interval_follows_config)
+{
+    zassert_ok(ts_sched_add(&sensor_job, 10));
+    zassert_equal(ts_sched_run_due(10), 10);
+
+    sensor_interval_s = 30;
+    zassert_equal(ts_sched_run_due(20), 30, "Next due at 50");
+}
+
+/* --- Coalescing --- */
+
+ZTEST(scheduler, test_coalesces_within_tolerance)
+{
+    struct ts_sched_job_stats st;
+
+    zassert_ok(ts_sched_add(&sensor_job, 10));
+    zassert_ok(ts_sched_add(&heartbeat_job, 7));
+
+    // The heartbeat can wait until the sensor wakeup at 10
+    zassert_equal(ts_sched_run_due(0), 10);
+    ts_sched_run_due(10);
+    zassert_equal(sensor_runs, 1);
+    zassert_equal(heartbeat_runs, 1);
+    zassert_equal(ts_sched_get_wakeups(), 1);
+
+    ts_sched_get_stats(&heartbeat_job, &st);
+    zassert_equal(st.coalesced, 1);
+    zassert_equal(st.max_late_s, 3);
+}
+
+ZTEST(scheduler, test_runs_early_within_tolerance)
+{
+    struct ts_sched_job_stats st;
+
+    zassert_ok(ts_sched_add(&sensor_job, 20));
+    zassert_ok(ts_sched_add(&heartbeat_job, 21));
+
+    ts_sched_run_due(20);
+    zassert_equal(heartbeat_runs, 1, "Due at 21, joins the wakeup at 20");
+
+    ts_sched_get_stats(&heartbeat_job, &st);
+    zassert_equal(st.max_early_s, 1);
+    zassert_equal(ts_sched_run_due(20), 10,
+                  "Heartbeat due at 28 waits for the sensor at 30");
+}
+
+ZTEST(scheduler, test_fewer_wakeups_than_timers)
+{
+    struct ts_sched_job_stats st;
+    uint32_t now = 0;
+
+    zassert_ok(ts_sched_add(&sensor_job, 1));
+    zassert_ok(ts_sched_add(&heartbeat_job, 7));
+    zassert_ok(ts_sched_add(&aging_job, 60));
+
+    while (now <= 420) { now += ts_sched_run_due(now); }
+
+    // Separate timers would wake 42 + 60 + 7 times, less the few
+    // instants two of them coincide
+    zassert_equal(sensor_runs, 42);
+    zassert_true(heartbeat_runs >= 59, "%d heartbeats", heartbeat_runs);
+    zassert_equal(aging_runs, 7);
+    zassert_true(ts_sched_get_wakeups() <= 60, "%u wakeups",
+                 ts_sched_get_wakeups());
+
+    ts_sched_get_stats(&heartbeat_job, &st);
+    zassert_true(st.max_early_s <= 3 && st.max_late_s <= 3);
+    zassert_true(st.coalesced > 0);
+    ts_sched_get_stats(&aging_job, &st);
+    zassert_equal(st.coalesced, st.runs, "Aging never wakes on its own");
+}
+
+/* --- Stats --- */
+
+ZTEST(scheduler, test_run_time_stats)
+{
+    struct ts_sched_job_stats st;
+
+    zassert_ok(ts_sched_add(&sensor_job, 0));
+    ts_sched_run_due(0);
+    ts_sched_run_due(10);
+
+    ts_sched_get_stats(&sensor_job, &st);
+    zassert_equal(st.runs, 2);
+    zassert_equal(st.coalesced, 0);
+    zassert_true(st.max_run_us >= st.last_run_us);
+    zassert_true(st.total_run_us >= st.max_run_us);
+}
+
+ZTEST_SUITE(scheduler, NULL, NULL, before_each, NULL, NULL);
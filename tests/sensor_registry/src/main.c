@@ -0,0 +1,261 @@
+#include <errno.h>
+#include <zephyr/ztest.h>
+
+#include "sensors/sensor_registry.h"
+
+#define DEFAULT_PERIOD_S 10
+
+// Two channels of an environmental sensor and two of a soil probe, one
+// of which runs on its own period
+static const struct ts_sensor_channel env_channels[] = {
+    TS_SENSOR_TELEMETRY_CHANNEL(TEMPERATURE, "temperature"),
+    TS_SENSOR_TELEMETRY_CHANNEL(HUMIDITY, "humidity"),
+};
+
+static const struct ts_sensor_channel soil_channels[] = {
+    {.id = 10,
+     .range = {.name = "moisture", .scale = 10, .min = 0, .max = 1000}},
+    {.id = 11,
+     .range = {.name = "soil_temp", .scale = 100, .min = -4000, .max = 8500},
+     .period_s = 60},
+};
+
+struct fake {
+    int ret;
+    int result;
+    int starts;
+    uint32_t mask;
+    int32_t values[2];
+};
+
+static struct fake env_fake;
+static struct fake soil_fake;
+static struct ts_msg_sensor_values received[16];
+static int received_count;
+
+static int env_start(uint32_t mask, ts_sensor_source_cb_t cb);
+static int soil_start(uint32_t mask, ts_sensor_source_cb_t cb);
+
+static const struct ts_sensor_source env_source = {
+    .name = "env",
+    .channels = env_channels,
+    .channel_count = ARRAY_SIZE(env_channels),
+    .start = env_start,
+};
+
+static const struct ts_sensor_source soil_source = {
+    .name = "soil",
+    .channels = soil_channels,
+    .channel_count = ARRAY_SIZE(soil_channels),
+    .start = soil_start,
+};
+
+// Completes synchronously, as the mock backend does
+static int fake_start(struct fake* p_fake,
+                      const struct ts_sensor_source* p_src, uint32_t mask,
+                      ts_sensor_source_cb_t cb)
+{
+    p_fake->starts++;
+    p_fake->mask = mask;
+    if (p_fake->ret != 0) { return p_fake->ret; }
+    cb(p_src, p_fake->result, mask, p_fake->values);
+    return 0;
+}
+
+static int env_start(uint32_t mask, ts_sensor_source_cb_t cb)
+{
+    return fake_start(&env_fake, &env_source, mask, cb);
+}
+
+static int soil_start(uint32_t mask, ts_sensor_source_cb_t cb)
+{
+    return fake_start(&soil_fake, &soil_source, mask, cb);
+}
+
+static void sink(const struct ts_msg_sensor_values* p_sample)
+{
+    zassert_true(received_count < ARRAY_SIZE(received));
+    received[received_count++] = *p_sample;
+}
+
+static void before_each(void* fixture)
+{
+    ARG_UNUSED(fixture);
+    env_fake = (struct fake){.values = {2150, 5500}};
+    soil_fake = (struct fake){.values = {420, 1800}};
+    received_count = 0;
+    ts_sensor_registry_init(sink);
+}
+
+static void add_both(void)
+{
+    zassert_ok(ts_sensor_registry_add(&env_source));
+    zassert_ok(ts_sensor_registry_add(&soil_source));
+}
+
+/* --- Registration --- */
+
+ZTEST(sensor_registry, test_add_and_find)
+{
+    const struct ts_sensor_channel* ch;
+
+    add_both();
+    ch = ts_sensor_registry_find(11);
+    zassert_not_null(ch);
+    zassert_equal(ch->period_s, 60);
+    zassert_equal(ch->range.scale, 100);
+    zassert_is_null(ts_sensor_registry_find(TS_TELEMETRY_PRESSURE));
+}
+
+ZTEST(sensor_registry, test_add_rejects_invalid)
+{
+    struct ts_sensor_source empty = env_source;
+    struct ts_sensor_source no_start = env_source;
+
+    empty.channel_count = 0;
+    no_start.start = NULL;
+    zassert_equal(ts_sensor_registry_add(&empty), -EINVAL);
+    zassert_equal(ts_sensor_registry_add(&no_start), -EINVAL);
+
+    zassert_ok(ts_sensor_registry_add(&env_source));
+    zassert_equal(ts_sensor_registry_add(&env_source), -EEXIST,
+                  "Channel IDs are unique node-wide");
+}
+
+ZTEST(sensor_registry, test_add_limits)
+{
+    static struct ts_sensor_channel many[TS_SENSOR_MAX_CHANNELS];
+    struct ts_sensor_source big = {
+        .name = "big",
+        .channels = many,
+        .channel_count = ARRAY_SIZE(many),
+        .start = env_start,
+    };
+
+    for (int i = 0; i < ARRAY_SIZE(many); i++) { many[i].id = 100 + i; }
+    zassert_ok(ts_sensor_registry_add(&big));
+    zassert_equal(ts_sensor_registry_add(&soil_source), -ENOMEM);
+}
+
+ZTEST(sensor_registry, test_telemetry_channel_descriptor)
+{
+    const struct ts_telemetry_range* range =
+        ts_telemetry_range_get(TS_TELEMETRY_HUMIDITY);
+
+    zassert_equal(env_channels[1].id, TS_TELEMETRY_HUMIDITY);
+    zassert_equal(env_channels[1].range.scale, range->scale);
+    zassert_equal(env_channels[1].range.min, range->min);
+    zassert_equal(env_channels[1].range.max, range->max);
+}
+
+/* --- Polling --- */
+
+ZTEST(sensor_registry, test_first_poll_starts_everything)
+{
+    add_both();
+    zassert_equal(ts_sensor_registry_poll(0, DEFAULT_PERIOD_S),
+                  DEFAULT_PERIOD_S);
+    zassert_equal(env_fake.mask, 0x3);
+    zassert_equal(soil_fake.mask, 0x3);
+    zassert_equal(received_count, 2);
+
+    zassert_equal(ts_sensor_registry_poll(4, DEFAULT_PERIOD_S), 6,
+                  "Nothing due yet");
+    zassert_equal(env_fake.starts, 1);
+}
+
+ZTEST(sensor_registry, test_channels_keep_own_periods)
+{
+    add_both();
+    zassert_equal(ts_sensor_registry_poll(0, DEFAULT_PERIOD_S), 10);
+
+    // Soil temperature runs every 60 s, moisture every 10 s
+    zassert_equal(ts_sensor_registry_poll(10, DEFAULT_PERIOD_S), 10);
+    zassert_equal(soil_fake.mask, 0x1);
+    zassert_equal(received[3].count, 1);
+    zassert_equal(received[3].values[0].id, 10);
+    zassert_equal(received[3].values[0].value, 420);
+
+    for (uint32_t t = 20; t <= 50; t += 10) {
+        ts_sensor_registry_poll(t, DEFAULT_PERIOD_S);
+    }
+    zassert_equal(ts_sensor_registry_poll(60, DEFAULT_PERIOD_S), 10);
+    zassert_equal(soil_fake.mask, 0x3, "Both channels due together");
+    zassert_equal(soil_fake.starts, 7);
+}
+
+ZTEST(sensor_registry, test_period_override)
+{
+    add_both();
+    zassert_equal(ts_sensor_registry_set_period(99, 5), -ENOENT);
+    zassert_ok(ts_sensor_registry_set_period(TS_TELEMETRY_HUMIDITY, 300));
+    zassert_ok(ts_sensor_registry_set_period(11, 0));
+
+    ts_sensor_registry_poll(0, DEFAULT_PERIOD_S);
+    ts_sensor_registry_poll(10, DEFAULT_PERIOD_S);
+    zassert_equal(env_fake.mask, BIT(0), "Humidity slowed down");
+
+    zassert_equal(soil_fake.mask, BIT(0));
+    zassert_ok(ts_sensor_registry_set_period(11, 10));
+    ts_sensor_registry_poll(20, DEFAULT_PERIOD_S);
+    zassert_equal(soil_fake.mask, 0x3, "Override replaces descriptor");
+}
+
+ZTEST(sensor_registry, test_busy_source_retried)
+{
+    add_both();
+    env_fake.ret = -EBUSY;
+    zassert_equal(ts_sensor_registry_poll(0, DEFAULT_PERIOD_S), 1);
+    zassert_equal(received_count, 1, "Only the soil probe measured");
+
+    env_fake.ret = 0;
+    zassert_equal(ts_sensor_registry_poll(1, DEFAULT_PERIOD_S), 9);
+    zassert_equal(env_fake.starts, 2);
+    zassert_equal(env_fake.mask, 0x3);
+}
+
+ZTEST(sensor_registry, test_clock_step_back_samples)
+{
+    add_both();
+    ts_sensor_registry_poll(1000, DEFAULT_PERIOD_S);
+    ts_sensor_registry_poll(5, DEFAULT_PERIOD_S);
+    zassert_equal(env_fake.starts, 2);
+}
+
+/* --- Completion --- */
+
+ZTEST(sensor_registry, test_out_of_range_dropped)
+{
+    struct ts_sensor_registry_stats stats;
+
+    add_both();
+    env_fake.values[0] = TS_TELEMETRY_TEMPERATURE_MAX + 1;
+    ts_sensor_registry_poll(0, DEFAULT_PERIOD_S);
+
+    zassert_equal(received[0].count, 1);
+    zassert_equal(received[0].values[0].id, TS_TELEMETRY_HUMIDITY);
+    zassert_equal(received[0].values[0].value, 5500);
+    zassert_equal(received[0].timestamp, 0, "Stamped by the sink");
+
+    ts_sensor_registry_get_stats(&stats);
+    zassert_equal(stats.samples, 2);
+    zassert_equal(stats.out_of_range, 1);
+}
+
+ZTEST(sensor_registry, test_failures_counted)
+{
+    struct ts_sensor_registry_stats stats;
+
+    add_both();
+    env_fake.result = -EIO;
+    soil_fake.ret = -ENODEV;
+    zassert_equal(ts_sensor_registry_poll(0, DEFAULT_PERIOD_S), 1,
+                  "Soil probe is retried a second later");
+
+    zassert_equal(received_count, 0);
+    ts_sensor_registry_get_stats(&stats);
+    zassert_equal(stats.failures, 2);
+    zassert_equal(stats.samples, 0);
+}
+
+ZTEST_SUITE(sensor_registry, NULL, NULL, before_each, NULL, NULL);
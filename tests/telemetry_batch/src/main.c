@@ -0,0 +1,141 @@
+#include <zephyr/ztest.h>
+
+#include "sensors/telemetry_batch.h"
+
+#define BATCH_SIZE 4
+#define LATENCY_S 300
+#define INTERVAL_S 10
+
+static struct ts_msg_telemetry reading_at(uint32_t timestamp)
+{
+    struct ts_msg_telemetry reading = {
+        .timestamp = timestamp,
+        .temperature = 2000 + timestamp,
+        .humidity = 5000,
+        .pressure = 101325,
+    };
+    return reading;
+}
+
+static void before_each(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    zassert_ok(ts_telemetry_batch_init(BATCH_SIZE, LATENCY_S));
+}
+
+/* --- Limits --- */
+
+ZTEST(telemetry_batch, test_init_rejects_invalid_size)
+{
+    zassert_equal(ts_telemetry_batch_init(0, LATENCY_S), -EINVAL);
+    zassert_equal(ts_telemetry_batch_init(TS_MSG_TELEMETRY_BATCH_MAX + 1,
+                                          LATENCY_S),
+                  -EINVAL, "A batch must fit one message");
+}
+
+ZTEST(telemetry_batch, test_ready_when_full)
+{
+    for (int i = 0; i < BATCH_SIZE - 1; i++) {
+        struct ts_msg_telemetry r = reading_at(100 + i * INTERVAL_S);
+        zassert_equal(ts_telemetry_batch_add(&r), 0);
+    }
+    struct ts_msg_telemetry last =
+        reading_at(100 + (BATCH_SIZE - 1) * INTERVAL_S);
+    zassert_equal(ts_telemetry_batch_add(&last), 1,
+                  "Last reading should complete the batch");
+
+    struct ts_msg_telemetry extra = reading_at(200);
+    zassert_equal(ts_telemetry_batch_add(&extra), -EAGAIN,
+                  "A full batch has to be taken first");
+    zassert_equal(ts_telemetry_batch_count(), BATCH_SIZE);
+}
+
+ZTEST(telemetry_batch, test_ready_when_latency_reached)
+{
+    struct ts_msg_telemetry first = reading_at(1000);
+    struct ts_msg_telemetry late = reading_at(1000 + LATENCY_S);
+
+    zassert_equal(ts_telemetry_batch_add(&first), 0);
+    zassert_equal(ts_telemetry_batch_add(&late), 1,
+                  "Oldest reading has waited the maximum latency");
+}
+
+/* --- Delta encoding --- */
+
+ZTEST(telemetry_batch, test_sample_times_are_deltas)
+{
+    uint32_t times[] = {5000, 5010, 5025, 5030};
+    struct ts_msg_telemetry_batch batch;
+
+    for (int i = 0; i < ARRAY_SIZE(times); i++) {
+        struct ts_msg_telemetry r = reading_at(times[i]);
+        ts_telemetry_batch_add(&r);
+    }
+    zassert_ok(ts_telemetry_batch_take(&batch));
+
+    zassert_equal(batch.base_timestamp, 5000);
+    zassert_equal(batch.count, 4);
+    zassert_equal(batch.samples[0].dt, 0);
+    zassert_equal(batch.samples[1].dt, 10);
+    zassert_equal(batch.samples[2].dt, 15);
+    zassert_equal(batch.samples[3].dt, 5);
+}
+
+ZTEST(telemetry_batch, test_expand_restores_readings)
+{
+    uint32_t times[] = {5000, 5010, 5025};
+    struct ts_msg_telemetry_batch batch;
+    struct ts_msg_telemetry out;
+
+    for (int i = 0; i < ARRAY_SIZE(times); i++) {
+        struct ts_msg_telemetry r = reading_at(times[i]);
+        ts_telemetry_batch_add(&r);
+    }
+    ts_telemetry_batch_take(&batch);
+
+    for (int i = 0; i < ARRAY_SIZE(times); i++) {
+        struct ts_msg_telemetry expected = reading_at(times[i]);
+        zassert_ok(ts_telemetry_batch_expand(&batch, i, &out));
+        zassert_mem_equal(&out, &expected, sizeof(out));
+    }
+    zassert_equal(ts_telemetry_batch_expand(&batch, 3, &out), -EINVAL);
+}
+
+ZTEST(telemetry_batch, test_delta_overflow_needs_new_batch)
+{
+    struct ts_msg_telemetry first = reading_at(0);
+    struct ts_msg_telemetry far = reading_at(UINT16_MAX + 1);
+
+    zassert_ok(ts_telemetry_batch_init(BATCH_SIZE, 86400));
+    ts_telemetry_batch_add(&first);
+    zassert_equal(ts_telemetry_batch_add(&far), -EAGAIN,
+                  "Gap beyond a 16-bit delta can't join the batch");
+    zassert_equal(ts_telemetry_batch_count(), 1, "Batch left untouched");
+}
+
+ZTEST(telemetry_batch, test_time_going_backwards_needs_new_batch)
+{
+    struct ts_msg_telemetry first = reading_at(500);
+    struct ts_msg_telemetry earlier = reading_at(400);
+
+    ts_telemetry_batch_add(&first);
+    zassert_equal(ts_telemetry_batch_add(&earlier), -EAGAIN);
+}
+
+/* --- Take --- */
+
+ZTEST(telemetry_batch, test_take_empties_batch)
+{
+    struct ts_msg_telemetry_batch batch;
+    struct ts_msg_telemetry r = reading_at(100);
+
+    zassert_equal(ts_telemetry_batch_take(&batch), -ENODATA);
+
+    ts_telemetry_batch_add(&r);
+    zassert_ok(ts_telemetry_batch_take(&batch));
+    zassert_equal(batch.count, 1);
+    zassert_equal(ts_telemetry_batch_count(), 0);
+    zassert_equal(ts_telemetry_batch_take(&batch), -ENODATA);
+}
+
+ZTEST_SUITE(telemetry_batch, NULL, NULL, before_each, NULL, NULL);
@@ -0,0 +1,232 @@
+#include <zephyr/ztest.h>
+
+#include "sensors/telemetry_delta.h"
+
+#define NODE_A 0x0002
+#define NODE_B 0x0003
+#define KEYFRAME_INTERVAL 4
+
+static struct ts_delta_encoder enc;
+
+// Slowly drifting series: 10 s apart, small changes in every field
+static struct ts_msg_telemetry reading(int i)
+{
+    struct ts_msg_telemetry r = {
+        .timestamp = 1000 + 10 * i,
+        .temperature = 2150 + i,
+        .humidity = 5500 - 2 * i,
+        .pressure = 101325 + (i % 3),
+    };
+    return r;
+}
+
+static void before_each(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    ts_delta_encoder_init(&enc, KEYFRAME_INTERVAL);
+    ts_delta_decoder_init();
+}
+
+/* --- Primitives --- */
+
+ZTEST(telemetry_delta, test_zigzag_keeps_small_values_small)
+{
+    zassert_equal(ts_zigzag_encode(0), 0);
+    zassert_equal(ts_zigzag_encode(-1), 1);
+    zassert_equal(ts_zigzag_encode(1), 2);
+    zassert_equal(ts_zigzag_encode(-2), 3);
+    zassert_equal(ts_zigzag_decode(ts_zigzag_encode(INT32_MIN)), INT32_MIN);
+    zassert_equal(ts_zigzag_decode(ts_zigzag_encode(INT32_MAX)), INT32_MAX);
+}
+
+ZTEST(telemetry_delta, test_varint_boundaries)
+{
+    uint32_t values[] = {0, 127, 128, 16383, 16384, UINT32_MAX};
+    size_t sizes[] = {1, 1, 2, 2, 3, 5};
+    uint8_t buf[5];
+    uint32_t out;
+
+    for (int i = 0; i < ARRAY_SIZE(values); i++) {
+        zassert_equal(ts_varint_put(values[i], buf, sizeof(buf)), sizes[i]);
+        zassert_equal(ts_varint_get(buf, sizes[i], &out), sizes[i]);
+        zassert_equal(out, values[i]);
+    }
+    zassert_equal(ts_varint_put(UINT32_MAX, buf, 4), 0, "Buffer too small");
+}
+
+ZTEST(telemetry_delta, test_varint_rejects_malformed)
+{
+    uint8_t truncated[] = {0x80, 0x80};
+    uint8_t too_long[] = {0xFF, 0xFF, 0xFF, 0xFF, 0x1F};
+    uint32_t out;
+
+    zassert_equal(ts_varint_get(truncated, sizeof(truncated), &out), 0);
+    zassert_equal(ts_varint_get(too_long, sizeof(too_long), &out), 0,
+                  "More than 32 bits must be rejected");
+}
+
+/* --- Encoder --- */
+
+ZTEST(telemetry_delta, test_first_message_is_keyframe)
+{
+    struct ts_msg_telemetry r = reading(0);
+    struct ts_msg_telemetry_delta msg;
+
+    ts_delta_encode(&enc, &r, &msg);
+    zassert_true(msg.keyframe);
+    zassert_equal(msg.seq, 0);
+}
+
+ZTEST(telemetry_delta, test_deltas_are_one_byte_per_field)
+{
+    struct ts_msg_telemetry_delta msg;
+
+    for (int i = 0; i < KEYFRAME_INTERVAL; i++) {
+        struct ts_msg_telemetry r = reading(i);
+        ts_delta_encode(&enc, &r, &msg);
+    }
+    zassert_false(msg.keyframe);
+    zassert_equal(msg.len, 4, "Slow drift should cost a byte per field");
+}
+
+ZTEST(telemetry_delta, test_keyframe_every_interval)
+{
+    struct ts_msg_telemetry_delta msg;
+
+    for (int i = 0; i < 3 * KEYFRAME_INTERVAL; i++) {
+        struct ts_msg_telemetry r = reading(i);
+        ts_delta_encode(&enc, &r, &msg);
+        zassert_equal(msg.keyframe, i % KEYFRAME_INTERVAL == 0,
+                      "Message %d", i);
+    }
+}
+
+ZTEST(telemetry_delta, test_keyframe_on_request)
+{
+    struct ts_msg_telemetry_delta msg;
+    struct ts_msg_telemetry r0 = reading(0);
+    struct ts_msg_telemetry r1 = reading(1);
+
+    ts_delta_encode(&enc, &r0, &msg);
+    ts_delta_encoder_request_keyframe(&enc);
+    ts_delta_encode(&enc, &r1, &msg);
+    zassert_true(msg.keyframe);
+}
+
+/* --- Decoder --- */
+
+ZTEST(telemetry_delta, test_roundtrip_series)
+{
+    struct ts_msg_telemetry_delta msg;
+    struct ts_msg_telemetry out;
+
+    for (int i = 0; i < 3 * KEYFRAME_INTERVAL; i++) {
+        struct ts_msg_telemetry r = reading(i);
+        ts_delta_encode(&enc, &r, &msg);
+        zassert_ok(ts_delta_decode(NODE_A, &msg, &out));
+        zassert_mem_equal(&out, &r, sizeof(r), "Reading %d", i);
+    }
+}
+
+ZTEST(telemetry_delta, test_roundtrip_extreme_jumps)
+{
+    struct ts_msg_telemetry a = {0, 0, 0, 0};
+    struct ts_msg_telemetry b = {UINT32_MAX, INT32_MIN, 1, INT32_MAX};
+    struct ts_msg_telemetry_delta msg;
+    struct ts_msg_telemetry out;
+
+    ts_delta_encode(&enc, &a, &msg);
+    zassert_ok(ts_delta_decode(NODE_A, &msg, &out));
+    ts_delta_encode(&enc, &b, &msg);
+    zassert_false(msg.keyframe);
+    zassert_ok(ts_delta_decode(NODE_A, &msg, &out));
+    zassert_mem_equal(&out, &b, sizeof(b));
+}
+
+ZTEST(telemetry_delta, test_delta_before_keyframe_dropped)
+{
+    struct ts_msg_telemetry_delta msg;
+    struct ts_msg_telemetry out;
+    struct ts_delta_decoder_stats stats;
+
+    for (int i = 0; i < 2; i++) {
+        struct ts_msg_telemetry r = reading(i);
+        ts_delta_encode(&enc, &r, &msg);
+    }
+    zassert_equal(ts_delta_decode(NODE_A, &msg, &out), -ENODATA,
+                  "Receiver joined mid-stream");
+
+    ts_delta_decoder_get_stats(&stats);
+    zassert_equal(stats.dropped, 1);
+    zassert_equal(stats.gaps, 0);
+}
+
+ZTEST(telemetry_delta, test_gap_waits_for_next_keyframe)
+{
+    struct ts_msg_telemetry_delta msg;
+    struct ts_msg_telemetry out;
+    struct ts_delta_decoder_stats stats;
+    int i = 0;
+
+    for (; i < 2; i++) {
+        struct ts_msg_telemetry r = reading(i);
+        ts_delta_encode(&enc, &r, &msg);
+        zassert_ok(ts_delta_decode(NODE_A, &msg, &out));
+    }
+
+    // Message 2 is lost; 3 must not be applied to reading 1
+    struct ts_msg_telemetry r2 = reading(i++);
+    ts_delta_encode(&enc, &r2, &msg);
+    struct ts_msg_telemetry r3 = reading(i++);
+    ts_delta_encode(&enc, &r3, &msg);
+    zassert_equal(ts_delta_decode(NODE_A, &msg, &out), -ENODATA);
+
+    // Message 4 is the next keyframe and resynchronises the stream
+    struct ts_msg_telemetry r4 = reading(i++);
+    ts_delta_encode(&enc, &r4, &msg);
+    zassert_true(msg.keyframe);
+    zassert_ok(ts_delta_decode(NODE_A, &msg, &out));
+    zassert_mem_equal(&out, &r4, sizeof(r4));
+
+    ts_delta_decoder_get_stats(&stats);
+    zassert_equal(stats.gaps, 1);
+    zassert_equal(stats.keyframes, 2);
+}
+
+ZTEST(telemetry_delta, test_sources_decoded_independently)
+{
+    struct ts_delta_encoder enc_b;
+    struct ts_msg_telemetry_delta msg;
+    struct ts_msg_telemetry out;
+    struct ts_msg_telemetry a = reading(0);
+    struct ts_msg_telemetry b = reading(50);
+
+    ts_delta_encoder_init(&enc_b, KEYFRAME_INTERVAL);
+    ts_delta_encode(&enc, &a, &msg);
+    zassert_ok(ts_delta_decode(NODE_A, &msg, &out));
+    ts_delta_encode(&enc_b, &b, &msg);
+    zassert_ok(ts_delta_decode(NODE_B, &msg, &out));
+
+    a = reading(1);
+    ts_delta_encode(&enc, &a, &msg);
+    zassert_ok(ts_delta_decode(NODE_A, &msg, &out));
+    zassert_mem_equal(&out, &a, sizeof(a), "B must not disturb A's state");
+}
+
+ZTEST(telemetry_delta, test_malformed_payload_rejected)
+{
+    struct ts_msg_telemetry_delta msg = {
+        .keyframe = true, .len = 3, .data = {1, 2, 3}};
+    struct ts_msg_telemetry out;
+
+    zassert_equal(ts_delta_decode(NODE_A, &msg, &out), -EBADMSG,
+                  "Three varints can't describe four fields");
+
+    msg.len = 5;
+    msg.data[3] = 4;
+    msg.data[4] = 5;
+    zassert_equal(ts_delta_decode(NODE_A, &msg, &out), -EBADMSG,
+                  "Trailing bytes");
+}
+
+ZTEST_SUITE(telemetry_delta, NULL, NULL, before_each, NULL, NULL);
@@ -0,0 +1,222 @@
+#include <errno.h>
+#include <zephyr/ztest.h>
+
+#include "sensors/telemetry_predict.h"
+
+#define NODE_A 0x0002
+#define RESYNC_S 3600
+
+static const int32_t bound[TS_TELEMETRY_CHANNEL_COUNT] = {
+    [TS_TELEMETRY_TEMPERATURE] = 20,
+    [TS_TELEMETRY_HUMIDITY] = 100,
+    [TS_TELEMETRY_PRESSURE] = 50,
+};
+
+static struct ts_predict_encoder enc;
+static struct ts_telemetry_model model;
+
+static struct ts_msg_telemetry reading(uint32_t timestamp,
+                                       int32_t temperature)
+{
+    return (struct ts_msg_telemetry){
+        .timestamp = timestamp,
+        .temperature = temperature,
+        .humidity = 5000,
+        .pressure = 101325,
+    };
+}
+
+static bool encode(const struct ts_msg_telemetry* p_reading,
+                   struct ts_msg_telemetry_model* p_out)
+{
+    return ts_predict_encode(&enc, p_reading, bound, RESYNC_S, p_out);
+}
+
+static void before_each(void* fixture)
+{
+    ARG_UNUSED(fixture);
+    ts_telemetry_model_reset(&model);
+    ts_predict_encoder_init(&enc);
+    ts_predict_decoder_init();
+}
+
+/* --- Model --- */
+
+ZTEST(telemetry_predict, test_empty_model)
+{
+    struct ts_msg_telemetry out;
+
+    zassert_equal(ts_telemetry_model_predict(&model, 0, &out), -ENODATA);
+}
+
+ZTEST(telemetry_predict, test_single_reading_holds)
+{
+    struct ts_msg_telemetry r = reading(1000, 2000);
+    struct ts_msg_telemetry out;
+
+    ts_telemetry_model_update(&model, &r);
+    zassert_ok(ts_telemetry_model_predict(&model, 5000, &out));
+    zassert_equal(out.timestamp, 5000);
+    zassert_equal(out.temperature, 2000);
+    zassert_equal(out.humidity, 5000);
+    zassert_equal(out.pressure, 101325);
+}
+
+ZTEST(telemetry_predict, test_linear_extrapolation)
+{
+    struct ts_msg_telemetry a = reading(1000, 2000);
+    struct ts_msg_telemetry b = reading(1010, 2010);
+    struct ts_msg_telemetry c = reading(1030, 2000);
+    struct ts_msg_telemetry out;
+
+    ts_telemetry_model_update(&model, &a);
+    ts_telemetry_model_update(&model, &b);
+    zassert_ok(ts_telemetry_model_predict(&model, 1020, &out));
+    zassert_equal(out.temperature, 2020);
+    zassert_ok(ts_telemetry_model_predict(&model, 1005, &out));
+    zassert_equal(out.temperature, 2010, "No extrapolation into the past");
+
+    // Only the last two readings count: slope is now -0.5 per second
+    ts_telemetry_model_update(&model, &c);
+    zassert_ok(ts_telemetry_model_predict(&model, 1033, &out));
+    zassert_equal(out.temperature, 1998, "-1.5 rounds away from zero");
+}
+
+ZTEST(telemetry_predict, test_prediction_clamped_to_range)
+{
+    struct ts_msg_telemetry a = reading(0, TS_TELEMETRY_TEMPERATURE_MAX - 10);
+    struct ts_msg_telemetry b = reading(10, TS_TELEMETRY_TEMPERATURE_MAX);
+    struct ts_msg_telemetry out;
+
+    ts_telemetry_model_update(&model, &a);
+    ts_telemetry_model_update(&model, &b);
+    zassert_ok(ts_telemetry_model_predict(&model, UINT32_MAX, &out));
+    zassert_equal(out.temperature, TS_TELEMETRY_TEMPERATURE_MAX);
+    zassert_equal(out.pressure, 101325);
+}
+
+/* --- Encoder --- */
+
+ZTEST(telemetry_predict, test_first_reading_resyncs)
+{
+    struct ts_msg_telemetry r = reading(1000, 2000);
+    struct ts_msg_telemetry_model msg;
+
+    zassert_true(encode(&r, &msg));
+    zassert_true(msg.resync);
+    zassert_equal(msg.seq, 0);
+    zassert_equal(msg.timestamp, 1000);
+    zassert_equal(msg.temperature, 2000);
+    zassert_false(encode(&r, &msg), "Predicted exactly");
+}
+
+ZTEST(telemetry_predict, test_ramp_costs_two_messages)
+{
+    struct ts_msg_telemetry_model msg;
+    int sent = 0;
+
+    // +5 per reading: the flat start is off by more than 20 at the
+    // fifth step, after which the line predicts every reading
+    for (int i = 0; i < 60; i++) {
+        struct ts_msg_telemetry r = reading(10 * i, 2000 + 5 * i);
+        if (encode(&r, &msg)) {
+            zassert_equal(msg.seq, sent);
+            zassert_equal(msg.resync, sent == 0);
+            sent++;
+        }
+    }
+    zassert_equal(sent, 2);
+}
+
+ZTEST(telemetry_predict, test_resync_interval)
+{
+    struct ts_msg_telemetry r = reading(0, 2000);
+    struct ts_msg_telemetry_model msg;
+
+    zassert_true(encode(&r, &msg));
+    r.timestamp = RESYNC_S - 1;
+    zassert_false(encode(&r, &msg));
+    r.timestamp = RESYNC_S;
+    zassert_true(encode(&r, &msg));
+    zassert_true(msg.resync);
+
+    ts_predict_encoder_request_resync(&enc);
+    r.timestamp++;
+    zassert_true(encode(&r, &msg));
+    zassert_true(msg.resync, "Requested resync");
+}
+
+ZTEST(telemetry_predict, test_clock_step_back_resyncs)
+{
+    struct ts_msg_telemetry r = reading(1000, 2000);
+    struct ts_msg_telemetry_model msg;
+
+    zassert_true(encode(&r, &msg));
+    r.timestamp = 10;
+    zassert_true(encode(&r, &msg));
+    zassert_true(msg.resync);
+}
+
+/* --- Receiver --- */
+
+ZTEST(telemetry_predict, test_receiver_within_bound)
+{
+    struct ts_msg_telemetry_model msg;
+    struct ts_msg_telemetry out;
+    int sent = 0;
+
+    // Accelerating rise, then a turn: the model has to keep catching up
+    for (int i = 0; i < 100; i++) {
+        int32_t temp = i < 60 ? 2000 + i * i / 4 : 2900 - 10 * (i - 60);
+        struct ts_msg_telemetry r = reading(10 * i, temp);
+        r.humidity = 5000 + 7 * i;
+
+        if (encode(&r, &msg)) {
+            zassert_ok(ts_predict_decode(NODE_A, &msg, &out));
+            zassert_equal(out.temperature, r.temperature);
+            sent++;
+        }
+        zassert_ok(ts_predict_estimate(NODE_A, r.timestamp, &out));
+        zassert_within(out.temperature, r.temperature,
+                       bound[TS_TELEMETRY_TEMPERATURE], "step %d", i);
+        zassert_within(out.humidity, r.humidity,
+                       bound[TS_TELEMETRY_HUMIDITY], "step %d", i);
+        zassert_equal(out.pressure, r.pressure);
+    }
+    zassert_true(sent < 50, "Only %d of 100 readings should be sent", sent);
+}
+
+ZTEST(telemetry_predict, test_gap_waits_for_resync)
+{
+    struct ts_msg_telemetry_model msgs[3];
+    struct ts_predict_decoder_stats stats;
+    struct ts_msg_telemetry out;
+    int n = 0;
+
+    zassert_equal(ts_predict_estimate(NODE_A, 0, &out), -ENODATA,
+                  "Unknown source");
+
+    for (int i = 0; n < ARRAY_SIZE(msgs); i++) {
+        struct ts_msg_telemetry r = reading(10 * i, 2000 + 100 * (i % 2));
+        if (encode(&r, &msgs[n])) { n++; }
+    }
+
+    zassert_ok(ts_predict_decode(NODE_A, &msgs[0], &out));
+    // msgs[1] lost
+    zassert_equal(ts_predict_decode(NODE_A, &msgs[2], &out), -ENODATA);
+    zassert_equal(ts_predict_estimate(NODE_A, 100, &out), -ENODATA);
+
+    ts_predict_decoder_get_stats(&stats);
+    zassert_equal(stats.resyncs, 1);
+    zassert_equal(stats.gaps, 1);
+    zassert_equal(stats.dropped, 1);
+
+    ts_predict_encoder_request_resync(&enc);
+    struct ts_msg_telemetry r = reading(1000, 2000);
+    zassert_true(encode(&r, &msgs[0]));
+    zassert_ok(ts_predict_decode(NODE_A, &msgs[0], &out));
+    zassert_ok(ts_predict_estimate(NODE_A, 1010, &out));
+    zassert_equal(out.temperature, 2000);
+}
+
+ZTEST_SUITE(telemetry_predict, NULL, NULL, before_each, NULL, NULL);
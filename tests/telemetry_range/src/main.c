@@ -0,0 +1,79 @@
+#include <zephyr/ztest.h>
+
+#include "sensors/telemetry_range.h"
+
+static struct ts_msg_telemetry reading(int32_t temperature, int32_t humidity,
+                                       int32_t pressure)
+{
+    struct ts_msg_telemetry r = {
+        .timestamp = 100,
+        .temperature = temperature,
+        .humidity = humidity,
+        .pressure = pressure,
+    };
+    return r;
+}
+
+ZTEST(telemetry_range, test_every_channel_declared)
+{
+    for (int i = 0; i < TS_TELEMETRY_CHANNEL_COUNT; i++) {
+        const struct ts_telemetry_range *range = ts_telemetry_range_get(i);
+
+        zassert_not_null(range, "Channel %d", i);
+        zassert_not_null(range->name);
+        zassert_true(range->scale > 0);
+        zassert_true(range->min < range->max);
+    }
+    zassert_is_null(ts_telemetry_range_get(TS_TELEMETRY_CHANNEL_COUNT));
+}
+
+ZTEST(telemetry_range, test_temperature_range_is_signed)
+{
+    const struct ts_telemetry_range *range =
+        ts_telemetry_range_get(TS_TELEMETRY_TEMPERATURE);
+
+    zassert_equal(range->min, -4000, "-40.00 C");
+    zassert_equal(range->max, 8500, "85.00 C");
+    zassert_equal(range->scale, 100);
+}
+
+ZTEST(telemetry_range, test_value_reads_channel)
+{
+    struct ts_msg_telemetry r = reading(-525, 6543, 101325);
+
+    zassert_equal(ts_telemetry_value(&r, TS_TELEMETRY_TEMPERATURE), -525);
+    zassert_equal(ts_telemetry_value(&r, TS_TELEMETRY_HUMIDITY), 6543);
+    zassert_equal(ts_telemetry_value(&r, TS_TELEMETRY_PRESSURE), 101325);
+}
+
+ZTEST(telemetry_range, test_limits_accepted)
+{
+    struct ts_msg_telemetry lo =
+        reading(TS_TELEMETRY_TEMPERATURE_MIN, TS_TELEMETRY_HUMIDITY_MIN,
+                TS_TELEMETRY_PRESSURE_MIN);
+    struct ts_msg_telemetry hi =
+        reading(TS_TELEMETRY_TEMPERATURE_MAX, TS_TELEMETRY_HUMIDITY_MAX,
+                TS_TELEMETRY_PRESSURE_MAX);
+
+    zassert_ok(ts_telemetry_range_check(&lo));
+    zassert_ok(ts_telemetry_range_check(&hi));
+}
+
+ZTEST(telemetry_range, test_out_of_range_rejected)
+{
+    struct ts_msg_telemetry cases[] = {
+        reading(TS_TELEMETRY_TEMPERATURE_MIN - 1, 5000, 101325),
+        reading(TS_TELEMETRY_TEMPERATURE_MAX + 1, 5000, 101325),
+        reading(2000, -1, 101325),
+        reading(2000, TS_TELEMETRY_HUMIDITY_MAX + 1, 101325),
+        reading(2000, 5000, TS_TELEMETRY_PRESSURE_MIN - 1),
+        reading(2000, 5000, TS_TELEMETRY_PRESSURE_MAX + 1),
+    };
+
+    for (int i = 0; i < ARRAY_SIZE(cases); i++) {
+        zassert_equal(ts_telemetry_range_check(&cases[i]), -ERANGE,
+                      "Case %d", i);
+    }
+}
+
+ZTEST_SUITE(telemetry_range, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,316 @@
+#include <errno.h>
+#include <string.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/ztest.h>
+
+#include "sensors/telemetry_store.h"
+
+#define STORE_AREA FIXED_PARTITION_ID(store_partition)
+
+#define BLOCK TS_TELEMETRY_STORE_BLOCK_READINGS
+
+static struct ts_msg_telemetry reading(uint32_t timestamp, int32_t n)
+{
+    return (struct ts_msg_telemetry){
+        .timestamp = timestamp,
+        .temperature = 2000 + n,
+        .humidity = 5000 + n,
+        .pressure = 101325 + n,
+    };
+}
+
+// Take batches until the store is empty; returns the readings seen
+static size_t take_all(struct ts_msg_telemetry* p_out, size_t max)
+{
+    struct ts_msg_telemetry_batch batch;
+    size_t n = 0;
+
+    while (ts_telemetry_store_take(&batch) == 0) {
+        uint32_t timestamp = batch.base_timestamp;
+
+        zassert_true(batch.count > 0, "Empty batch");
+        for (uint8_t i = 0; i < batch.count; i++) {
+            zassert_true(n < max, "More readings than stored");
+            timestamp += batch.samples[i].dt;
+            p_out[n++] = (struct ts_msg_telemetry){
+                .timestamp = timestamp,
+                .temperature = batch.samples[i].temperature,
+                .humidity = batch.samples[i].humidity,
+                .pressure = batch.samples[i].pressure,
+            };
+        }
+    }
+    return n;
+}
+
+// Let the store's work queue write the blocks sealed so far
+static void wait_for_writes(void)
+{
+    k_msleep(10);
+}
+
+static void before_each(void* fixture)
+{
+    const struct flash_area* fa;
+
+    ARG_UNUSED(fixture);
+    zassert_ok(flash_area_open(STORE_AREA, &fa));
+    zassert_ok(flash_area_erase(fa, 0, fa->fa_size));
+    flash_area_close(fa);
+    zassert_ok(ts_telemetry_store_init(STORE_AREA));
+}
+
+ZTEST(telemetry_store, test_codec_roundtrip)
+{
+    struct ts_msg_telemetry in[3] = {
+        reading(1000, 0),
+        reading(1030, 1),
+        reading(1030 + UINT16_MAX, 2),
+    };
+    struct ts_msg_telemetry out[3];
+    uint8_t buf[TS_TELEMETRY_STORE_BLOCK_SIZE(3)];
+
+    in[1].temperature = TS_TELEMETRY_TEMPERATURE_MIN;
+    in[1].pressure = TS_TELEMETRY_PRESSURE_MIN;
+    in[2].temperature = TS_TELEMETRY_TEMPERATURE_MAX;
+    in[2].humidity = TS_TELEMETRY_HUMIDITY_MAX;
+    in[2].pressure = TS_TELEMETRY_PRESSURE_MAX;
+
+    zassert_equal(ts_telemetry_store_encode(in, 3, buf, sizeof(buf)),
+                  sizeof(buf));
+    zassert_equal(ts_telemetry_store_decode(buf, sizeof(buf), out, 3), 3);
+    zassert_mem_equal(out, in, sizeof(in));
+}
+
+ZTEST(telemetry_store, test_codec_errors)
+{
+    struct ts_msg_telemetry in[2] = {reading(1000, 0), reading(999, 1)};
+    struct ts_msg_telemetry out[2];
+    uint8_t buf[TS_TELEMETRY_STORE_BLOCK_SIZE(2)];
+
+    zassert_equal(ts_telemetry_store_encode(in, 0, buf, sizeof(buf)),
+                  -EINVAL);
+    zassert_equal(ts_telemetry_store_encode(in, 2, buf, sizeof(buf) - 1),
+                  -EMSGSIZE);
+    zassert_equal(ts_telemetry_store_encode(in, 2, buf, sizeof(buf)),
+                  -EINVAL, "Readings out of time order");
+
+    in[1].timestamp = 1000 + UINT16_MAX + 1;
+    zassert_equal(ts_telemetry_store_encode(in, 2, buf, sizeof(buf)),
+                  -ERANGE, "Step too long for a dt");
+
+    in[1].timestamp = 1001;
+    in[1].pressure = TS_TELEMETRY_PRESSURE_MIN - 1;
+    zassert_equal(ts_telemetry_store_encode(in, 2, buf, sizeof(buf)),
+                  -ERANGE);
+
+    in[1].pressure = TS_TELEMETRY_PRESSURE_MIN;
+    zassert_equal(ts_telemetry_store_encode(in, 2, buf, sizeof(buf)),
+                  sizeof(buf));
+    zassert_equal(ts_telemetry_store_decode(buf, sizeof(buf) - 1, out, 2),
+                  -EBADMSG);
+    zassert_equal(ts_telemetry_store_decode(buf, sizeof(buf), out, 1),
+                  -EMSGSIZE);
+    buf[0] = TS_TELEMETRY_STORE_VERSION + 1;
+    zassert_equal(ts_telemetry_store_decode(buf, sizeof(buf), out, 2),
+                  -EBADMSG);
+}
+
+ZTEST(telemetry_store, test_empty)
+{
+    struct ts_msg_telemetry_batch batch;
+
+    zassert_true(ts_telemetry_store_is_empty());
+    zassert_equal(ts_telemetry_store_take(&batch), -ENODATA);
+    zassert_ok(ts_telemetry_store_flush());
+}
+
+ZTEST(telemetry_store, test_rejects_out_of_range)
+{
+    struct ts_msg_telemetry r = reading(1000, 0);
+    struct ts_telemetry_store_stats stats;
+
+    r.humidity = -1;
+    zassert_equal(ts_telemetry_store_add(&r), -ERANGE);
+    zassert_true(ts_telemetry_store_is_empty());
+    ts_telemetry_store_get_stats(&stats);
+    zassert_equal(stats.stored, 0);
+}
+
+ZTEST(telemetry_store, test_drains_in_order)
+{
+    struct ts_msg_telemetry in[2 * BLOCK + 3];
+    struct ts_msg_telemetry out[ARRAY_SIZE(in)];
+    struct ts_telemetry_store_stats stats;
+
+    for (int i = 0; i < ARRAY_SIZE(in); i++) {
+        in[i] = reading(1000 + 60 * i, i);
+        zassert_ok(ts_telemetry_store_add(&in[i]));
+    }
+    zassert_false(ts_telemetry_store_is_empty());
+
+    ts_telemetry_store_get_stats(&stats);
+    zassert_equal(stats.blocks, 0, "Not written by the caller");
+    wait_for_writes();
+    ts_telemetry_store_get_stats(&stats);
+    zassert_equal(stats.blocks, 2, "Full blocks go to flash");
+
+    // Flash blocks first, then the readings still staged
+    zassert_equal(take_all(out, ARRAY_SIZE(out)), ARRAY_SIZE(in));
+    zassert_mem_equal(out, in, sizeof(in));
+    zassert_true(ts_telemetry_store_is_empty());
+
+    ts_telemetry_store_get_stats(&stats);
+    zassert_equal(stats.stored, ARRAY_SIZE(in));
+    zassert_equal(stats.drained, ARRAY_SIZE(in));
+}
+
+ZTEST(telemetry_store, test_batches_stay_within_block)
+{
+    struct ts_msg_telemetry_batch batch;
+
+    for (int i = 0; i < BLOCK; i++) {
+        struct ts_msg_telemetry r = reading(1000 + i, i);
+        zassert_ok(ts_telemetry_store_add(&r));
+    }
+
+    zassert_ok(ts_telemetry_store_take(&batch));
+    zassert_equal(batch.count, MIN(BLOCK, TS_MSG_TELEMETRY_BATCH_MAX));
+    zassert_equal(batch.base_timestamp, 1000);
+    zassert_equal(batch.samples[0].dt, 0);
+    zassert_equal(batch.samples[1].dt, 1);
+
+    if (BLOCK > TS_MSG_TELEMETRY_BATCH_MAX) {
+        zassert_ok(ts_telemetry_store_take(&batch));
+        zassert_equal(batch.count, BLOCK - TS_MSG_TELEMETRY_BATCH_MAX);
+        zassert_equal(batch.base_timestamp,
+                      1000 + TS_MSG_TELEMETRY_BATCH_MAX);
+    }
+    zassert_true(ts_telemetry_store_is_empty());
+}
+
+ZTEST(telemetry_store, test_long_gap_starts_new_block)
+{
+    struct ts_msg_telemetry in[3] = {
+        reading(1000, 0),
+        reading(1000 + UINT16_MAX + 1, 1),
+        reading(500, 2),
+    };
+    struct ts_msg_telemetry out[3];
+    struct ts_telemetry_store_stats stats;
+
+    for (int i = 0; i < ARRAY_SIZE(in); i++) {
+        zassert_ok(ts_telemetry_store_add(&in[i]));
+    }
+
+    // A gap too long for a dt, then a clock step back, each close a block
+    wait_for_writes();
+    ts_telemetry_store_get_stats(&stats);
+    zassert_equal(stats.blocks, 2);
+
+    zassert_equal(take_all(out, ARRAY_SIZE(out)), 3);
+    zassert_mem_equal(out, in, sizeof(in));
+}
+
+ZTEST(telemetry_store, test_unwritten_blocks_drain_in_order)
+{
+    struct ts_msg_telemetry in[BLOCK + 2];
+    struct ts_msg_telemetry out[ARRAY_SIZE(in)];
+    struct ts_telemetry_store_stats stats;
+
+    for (int i = 0; i < ARRAY_SIZE(in); i++) {
+        in[i] = reading(1000 + 60 * i, i);
+        zassert_ok(ts_telemetry_store_add(&in[i]));
+    }
+
+    // Taken before the work queue got to write the full block
+    zassert_equal(take_all(out, ARRAY_SIZE(out)), ARRAY_SIZE(in));
+    zassert_mem_equal(out, in, sizeof(in));
+    wait_for_writes();
+    ts_telemetry_store_get_stats(&stats);
+    zassert_equal(stats.blocks, 0);
+    zassert_true(ts_telemetry_store_is_empty());
+}
+
+ZTEST(telemetry_store, test_write_backlog_full_loses_block)
+{
+    struct ts_telemetry_store_stats stats;
+
+    // Every clock step back seals a block of one
+    for (int i = 0; i < 3; i++) {
+        struct ts_msg_telemetry r = reading(1000 - i, i);
+        zassert_ok(ts_telemetry_store_add(&r));
+    }
+    struct ts_msg_telemetry r = reading(900, 3);
+    zassert_equal(ts_telemetry_store_add(&r), -ENOBUFS);
+
+    wait_for_writes();
+    ts_telemetry_store_get_stats(&stats);
+    zassert_equal(stats.blocks, 2);
+    zassert_equal(stats.write_errors, 1);
+    zassert_equal(stats.stored, 4, "Last reading still staged");
+}
+
+ZTEST(telemetry_store, test_reinit_drops_previous_boot)
+{
+    struct ts_telemetry_store_stats stats;
+    struct ts_msg_telemetry in[BLOCK + 2];
+    struct ts_msg_telemetry out[ARRAY_SIZE(in)];
+
+    for (int i = 0; i < ARRAY_SIZE(in); i++) {
+        in[i] = reading(1000 + 60 * i, i);
+        zassert_ok(ts_telemetry_store_add(&in[i]));
+    }
+    zassert_ok(ts_telemetry_store_flush());
+
+    // Reboot: the timestamps no longer mean anything, the blocks go
+    zassert_ok(ts_telemetry_store_init(STORE_AREA));
+    zassert_true(ts_telemetry_store_is_empty());
+    ts_telemetry_store_get_stats(&stats);
+    zassert_equal(stats.stale_blocks, 2);
+
+    // Readings of the new boot are kept as usual
+    zassert_ok(ts_telemetry_store_add(&in[0]));
+    zassert_ok(ts_telemetry_store_flush());
+    zassert_equal(take_all(out, ARRAY_SIZE(out)), 1);
+    zassert_mem_equal(out, in, sizeof(in[0]));
+
+    zassert_ok(ts_telemetry_store_init(STORE_AREA));
+    ts_telemetry_store_get_stats(&stats);
+    zassert_equal(stats.stale_blocks, 0, "Drained block was popped");
+}
+
+ZTEST(telemetry_store, test_add_batch)
+{
+    struct ts_msg_telemetry_batch batch = {
+        .base_timestamp = 5000,
+        .count = 3,
+        .samples = {
+            {.dt = 0, .temperature = 1, .humidity = 2, .pressure = 90000},
+            {.dt = 10, .temperature = 3, .humidity = 4, .pressure = 90001},
+            {.dt = 20, .temperature = 5, .humidity = 6, .pressure = 90002},
+        },
+    };
+    struct ts_msg_telemetry_batch out;
+
+    zassert_ok(ts_telemetry_store_add_batch(&batch));
+    zassert_ok(ts_telemetry_store_take(&out));
+    zassert_equal(out.base_timestamp, batch.base_timestamp);
+    zassert_equal(out.count, batch.count);
+    for (uint8_t i = 0; i < batch.count; i++) {
+        zassert_equal(out.samples[i].dt, batch.samples[i].dt);
+        zassert_equal(out.samples[i].temperature,
+                      batch.samples[i].temperature);
+        zassert_equal(out.samples[i].humidity, batch.samples[i].humidity);
+        zassert_equal(out.samples[i].pressure, batch.samples[i].pressure);
+    }
+}
+
+ZTEST(telemetry_store, test_drain_delay)
+{
+    // 10 permille: 99 ms of silence per ms on air
+    zassert_equal(ts_telemetry_store_drain_delay_ms(100), 9900);
+    zassert_equal(ts_telemetry_store_drain_delay_ms(0), 0);
+}
+
+ZTEST_SUITE(telemetry_store, NULL, NULL, before_each, NULL, NULL);
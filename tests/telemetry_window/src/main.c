@@ -0,0 +1,185 @@
+#include <errno.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+
+#include "sensors/telemetry_window.h"
+
+static const int32_t deadband[TS_TELEMETRY_CHANNEL_COUNT] = {
+    [TS_TELEMETRY_TEMPERATURE] = 20,
+    [TS_TELEMETRY_HUMIDITY] = 100,
+    [TS_TELEMETRY_PRESSURE] = 50,
+};
+
+#define MAX_SILENCE_S 3600
+
+static struct ts_telemetry_window window;
+static struct ts_telemetry_deadband db;
+
+static struct ts_msg_telemetry reading(uint32_t timestamp,
+                                       int32_t temperature)
+{
+    return (struct ts_msg_telemetry){
+        .timestamp = timestamp,
+        .temperature = temperature,
+        .humidity = 5000,
+        .pressure = 101325,
+    };
+}
+
+// Summary of one window of readings at 10 s steps
+static struct ts_msg_telemetry_summary summarize(uint32_t start,
+                                                 const int32_t* p_temps,
+                                                 size_t count)
+{
+    struct ts_msg_telemetry_summary summary;
+
+    ts_telemetry_window_reset(&window);
+    for (size_t i = 0; i < count; i++) {
+        struct ts_msg_telemetry r = reading(start + 10 * i, p_temps[i]);
+        zassert_ok(ts_telemetry_window_add(&window, &r));
+    }
+    zassert_ok(ts_telemetry_window_summarize(&window, &summary));
+    return summary;
+}
+
+static bool check(const struct ts_msg_telemetry_summary* p_summary)
+{
+    return ts_telemetry_deadband_check(&db, p_summary, deadband,
+                                       MAX_SILENCE_S);
+}
+
+static void before_each(void* fixture)
+{
+    ARG_UNUSED(fixture);
+    ts_telemetry_window_reset(&window);
+    memset(&db, 0, sizeof(db));
+}
+
+ZTEST(telemetry_window, test_empty_window)
+{
+    struct ts_msg_telemetry_summary summary;
+
+    zassert_equal(ts_telemetry_window_summarize(&window, &summary),
+                  -ENODATA);
+}
+
+ZTEST(telemetry_window, test_min_max_mean)
+{
+    static const int32_t temps[] = {2000, 2100, 1950, 2030};
+    struct ts_msg_telemetry_summary s = summarize(1000, temps, 4);
+
+    zassert_equal(s.timestamp, 1000);
+    zassert_equal(s.duration_s, 30);
+    zassert_equal(s.count, 4);
+    zassert_equal(s.temperature_min, 1950);
+    zassert_equal(s.temperature_max, 2100);
+    zassert_equal(s.temperature_mean, 2020);
+    zassert_equal(s.humidity_min, 5000);
+    zassert_equal(s.humidity_max, 5000);
+    zassert_equal(s.pressure_mean, 101325);
+}
+
+ZTEST(telemetry_window, test_mean_rounds_to_nearest)
+{
+    static const int32_t up[] = {1, 2};
+    static const int32_t down[] = {-1, -2};
+    static const int32_t below_half[] = {-1, -1, 0};
+
+    zassert_equal(summarize(0, up, 2).temperature_mean, 2);
+    zassert_equal(summarize(0, down, 2).temperature_mean, -2);
+    zassert_equal(summarize(0, below_half, 3).temperature_mean, -1);
+}
+
+ZTEST(telemetry_window, test_add_rejects_bad_time)
+{
+    struct ts_msg_telemetry r = reading(1000, 0);
+
+    zassert_ok(ts_telemetry_window_add(&window, &r));
+    r.timestamp = 999;
+    zassert_equal(ts_telemetry_window_add(&window, &r), -EINVAL);
+    r.timestamp = 1000 + UINT16_MAX + 1;
+    zassert_equal(ts_telemetry_window_add(&window, &r), -ENOSPC);
+    zassert_equal(window.count, 1, "Window must be unchanged");
+}
+
+ZTEST(telemetry_window, test_first_summary_sent)
+{
+    static const int32_t temps[] = {2000, 2000};
+    struct ts_msg_telemetry_summary s = summarize(0, temps, 2);
+
+    zassert_true(check(&s));
+    zassert_false(check(&s), "Same values again are inside the deadband");
+}
+
+ZTEST(telemetry_window, test_excursion_sent)
+{
+    static const int32_t steady[] = {2000, 2010, 1990};
+    // Mean stays close, but one reading left the deadband
+    static const int32_t spike[] = {2000, 2030, 2000};
+    struct ts_msg_telemetry_summary s = summarize(0, steady, 3);
+
+    zassert_true(check(&s));
+    s = summarize(60, steady, 3);
+    zassert_false(check(&s));
+    s = summarize(120, spike, 3);
+    zassert_true(check(&s), "Max outside the deadband must be sent");
+}
+
+ZTEST(telemetry_window, test_drift_accumulates)
+{
+    struct ts_msg_telemetry_summary s;
+    int32_t temp = 2000;
+    int sent = 0;
+
+    // +5 per window: never 20 from the previous window, but it adds up
+    for (int i = 0; i <= 10; i++) {
+        s = summarize(60 * i, &temp, 1);
+        if (check(&s)) { sent++; }
+        temp += 5;
+    }
+    zassert_equal(sent, 3, "Sent at 2000, 2025 and 2050");
+}
+
+ZTEST(telemetry_window, test_max_silence)
+{
+    static const int32_t temps[] = {2000};
+    struct ts_msg_telemetry_summary s = summarize(0, temps, 1);
+
+    zassert_true(check(&s));
+    s = summarize(MAX_SILENCE_S - 1, temps, 1);
+    zassert_false(check(&s));
+    s = summarize(MAX_SILENCE_S, temps, 1);
+    zassert_true(check(&s), "Liveness report after max silence");
+    s = summarize(MAX_SILENCE_S + 60, temps, 1);
+    zassert_false(check(&s), "Silence restarts from the last report");
+}
+
+ZTEST(telemetry_window, test_zero_deadband_sends_any_change)
+{
+    static const int32_t zero[TS_TELEMETRY_CHANNEL_COUNT] = {0};
+    struct ts_msg_telemetry r = reading(0, 2000);
+    struct ts_msg_telemetry_summary s;
+
+    zassert_ok(ts_telemetry_window_add(&window, &r));
+    ts_telemetry_window_summarize(&window, &s);
+    zassert_true(ts_telemetry_deadband_check(&db, &s, zero, MAX_SILENCE_S));
+    zassert_false(ts_telemetry_deadband_check(&db, &s, zero, MAX_SILENCE_S));
+
+    s.pressure_max++;
+    zassert_true(ts_telemetry_deadband_check(&db, &s, zero, MAX_SILENCE_S));
+}
+
+ZTEST(telemetry_window, test_summary_mean)
+{
+    static const int32_t temps[] = {2000, 2100};
+    struct ts_msg_telemetry_summary s = summarize(1000, temps, 2);
+    struct ts_msg_telemetry mean;
+
+    ts_telemetry_summary_mean(&s, &mean);
+    zassert_equal(mean.timestamp, 1010, "Stamped at the window's end");
+    zassert_equal(mean.temperature, 2050);
+    zassert_equal(mean.humidity, 5000);
+    zassert_equal(mean.pressure, 101325);
+}
+
+ZTEST_SUITE(telemetry_window, NULL, NULL, before_each, NULL, NULL);
@@ -0,0 +1,170 @@
+#include <zephyr/ztest.h>
+
+#include "lora/tx_power.h"
+#include "routing/routing.h"
+#include "routing/routing_table.h"
+
+#define TEST_SF 10
+#define NODE_A 0x0002
+#define NODE_B 0x0003
+
+// Power the neighbors report sending at, unless a test says otherwise
+#define NB_DBM TS_TX_POWER_INITIAL_DBM
+
+// SNR that yields the given margin at TEST_SF (floor is -15 dB)
+#define SNR_FOR_MARGIN(m) ((int8_t)((m) - 15))
+
+static void before_each(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    ts_routing_table_init();
+    ts_tx_power_init(TEST_SF);
+}
+
+/* --- Margin estimation --- */
+
+ZTEST(tx_power, test_snr_floor_sf10)
+{
+    zassert_equal(ts_tx_power_snr_floor_db(10), -15);
+}
+
+ZTEST(tx_power, test_snr_floor_clamped)
+{
+    zassert_equal(ts_tx_power_snr_floor_db(3), ts_tx_power_snr_floor_db(5));
+    zassert_equal(ts_tx_power_snr_floor_db(15), ts_tx_power_snr_floor_db(12));
+}
+
+ZTEST(tx_power, test_margin_from_snr)
+{
+    struct ts_neighbor nb = {.rssi = -120, .snr = -5};
+    zassert_equal(ts_tx_power_link_margin_db(&nb), 10,
+                  "Margin should be SNR above the SF10 floor");
+}
+
+ZTEST(tx_power, test_margin_from_rssi_when_snr_saturated)
+{
+    struct ts_neighbor nb = {.rssi = -100, .snr = 10};
+    zassert_equal(ts_tx_power_link_margin_db(&nb), 32,
+                  "Saturated SNR should fall back to RSSI over sensitivity");
+}
+
+/* --- Power selection --- */
+
+ZTEST(tx_power, test_no_neighbors_uses_max_power)
+{
+    zassert_equal(ts_tx_power_select(TS_ROUTING_BROADCAST_ADDR),
+                  TS_TX_POWER_MAX_DBM);
+}
+
+ZTEST(tx_power, test_indirect_neighbors_ignored)
+{
+    ts_routing_table_update(NODE_A, -80, SNR_FOR_MARGIN(20),
+                            NB_DBM, TS_ROUTING_DEFAULT_TTL - 1);
+    zassert_equal(ts_tx_power_select(TS_ROUTING_BROADCAST_ADDR),
+                  TS_TX_POWER_MAX_DBM,
+                  "Multi-hop neighbors don't hear us directly");
+}
+
+ZTEST(tx_power, test_weak_link_raises_power_immediately)
+{
+    ts_routing_table_update(NODE_A, -125, SNR_FOR_MARGIN(3),
+                            NB_DBM, TS_ROUTING_DEFAULT_TTL);
+    zassert_equal(ts_tx_power_select(TS_ROUTING_BROADCAST_ADDR),
+                  TS_TX_POWER_INITIAL_DBM + TS_TX_POWER_TARGET_MARGIN_DB - 3);
+}
+
+ZTEST(tx_power, test_spare_margin_steps_down_gradually)
+{
+    ts_routing_table_update(NODE_A, -110, SNR_FOR_MARGIN(18),
+                            NB_DBM, TS_ROUTING_DEFAULT_TTL);
+
+    zassert_equal(ts_tx_power_select(TS_ROUTING_BROADCAST_ADDR),
+                  TS_TX_POWER_INITIAL_DBM - TS_TX_POWER_STEP_DB,
+                  "Power should drop by one step per frame");
+    zassert_equal(ts_tx_power_select(TS_ROUTING_BROADCAST_ADDR),
+                  TS_TX_POWER_MIN_DBM, "Second frame reaches the floor");
+    zassert_equal(ts_tx_power_select(TS_ROUTING_BROADCAST_ADDR),
+                  TS_TX_POWER_MIN_DBM, "Power should clamp at the minimum");
+}
+
+ZTEST(tx_power, test_broadcast_uses_weakest_neighbor)
+{
+    ts_routing_table_update(NODE_A, -110, SNR_FOR_MARGIN(15),
+                            NB_DBM, TS_ROUTING_DEFAULT_TTL);
+    ts_routing_table_update(NODE_B, -125, SNR_FOR_MARGIN(5),
+                            NB_DBM, TS_ROUTING_DEFAULT_TTL);
+
+    zassert_equal(ts_tx_power_select(TS_ROUTING_BROADCAST_ADDR),
+                  TS_TX_POWER_INITIAL_DBM + TS_TX_POWER_TARGET_MARGIN_DB - 5);
+}
+
+ZTEST(tx_power, test_unicast_uses_destination_margin)
+{
+    ts_routing_table_update(NODE_A, -110, SNR_FOR_MARGIN(12),
+                            NB_DBM, TS_ROUTING_DEFAULT_TTL);
+    ts_routing_table_update(NODE_B, -125, SNR_FOR_MARGIN(2),
+                            NB_DBM, TS_ROUTING_DEFAULT_TTL);
+
+    zassert_equal(ts_tx_power_select(NODE_A), TS_TX_POWER_INITIAL_DBM - 2,
+                  "Unicast to a direct neighbor ignores weaker neighbors");
+}
+
+ZTEST(tx_power, test_margin_scaled_by_neighbor_power)
+{
+    // Heard with 3 dB margin, but sent at full power: at our 4 dBm it
+    // would have none left
+    struct ts_neighbor nb = {.rssi = -125,
+                             .snr = SNR_FOR_MARGIN(3),
+                             .tx_power = TS_TX_POWER_MAX_DBM};
+
+    zassert_equal(ts_tx_power_needed_dbm(&nb),
+                  TS_TX_POWER_MAX_DBM + TS_TX_POWER_TARGET_MARGIN_DB - 3);
+
+    nb.tx_power = TS_TX_POWER_MIN_DBM;
+    zassert_equal(ts_tx_power_needed_dbm(&nb),
+                  TS_TX_POWER_MIN_DBM + TS_TX_POWER_TARGET_MARGIN_DB - 3,
+                  "Same margin at lower power is an easier link");
+}
+
+ZTEST(tx_power, test_broadcast_uses_hardest_neighbor_not_lowest_margin)
+{
+    // A has the lower margin but sends at 0 dBm; B has more margin only
+    // because it was still at full power
+    ts_routing_table_update(NODE_A, -110, SNR_FOR_MARGIN(8),
+                            TS_TX_POWER_MIN_DBM, TS_ROUTING_DEFAULT_TTL);
+    ts_routing_table_update(NODE_B, -110, SNR_FOR_MARGIN(14),
+                            TS_TX_POWER_MAX_DBM, TS_ROUTING_DEFAULT_TTL);
+
+    zassert_equal(ts_tx_power_select(TS_ROUTING_BROADCAST_ADDR),
+                  TS_TX_POWER_MAX_DBM + TS_TX_POWER_TARGET_MARGIN_DB - 14);
+}
+
+/* --- Delivery feedback --- */
+
+ZTEST(tx_power, test_failure_steps_up_success_steps_down)
+{
+    ts_routing_table_update(NODE_A, -120, SNR_FOR_MARGIN(10),
+                            NB_DBM, TS_ROUTING_DEFAULT_TTL);
+    zassert_equal(ts_tx_power_select(NODE_A), TS_TX_POWER_INITIAL_DBM);
+
+    ts_tx_power_report_delivery(false);
+    zassert_equal(ts_tx_power_select(NODE_A),
+                  TS_TX_POWER_INITIAL_DBM + TS_TX_POWER_STEP_DB,
+                  "Failed delivery should add one step");
+
+    ts_tx_power_report_delivery(true);
+    zassert_equal(ts_tx_power_select(NODE_A), TS_TX_POWER_INITIAL_DBM,
+                  "Successful delivery should remove the boost");
+}
+
+ZTEST(tx_power, test_repeated_failures_saturate_at_max)
+{
+    ts_routing_table_update(NODE_A, -120, SNR_FOR_MARGIN(10),
+                            NB_DBM, TS_ROUTING_DEFAULT_TTL);
+    for (int i = 0; i < 20; i++) {
+        ts_tx_power_report_delivery(false);
+    }
+    zassert_equal(ts_tx_power_select(NODE_A), TS_TX_POWER_MAX_DBM);
+}
+
+ZTEST_SUITE(tx_power, NULL, NULL, before_each, NULL, NULL);
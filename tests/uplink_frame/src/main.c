@@ -0,0 +1,298 @@
+#include <errno.h>
+#include <string.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/crc.h>
+#include <zephyr/ztest.h>
+
+#include "gateway/uplink_frame.h"
+
+static uint8_t frame[TS_UPLINK_FRAME_MAX_SIZE(TS_UPLINK_MAX_RECORDS)];
+static uint8_t raw[sizeof(frame)];
+static struct ts_gateway_record records[TS_UPLINK_MAX_RECORDS];
+
+static struct ts_gateway_record make_telemetry(uint32_t msg_id)
+{
+    struct ts_gateway_record rec = {
+        .rx_ms = 123456,
+        .src = 0x0102,
+        .msg_id = msg_id,
+        .rssi = -95,
+        .snr = -3,
+        .type = TS_MSG_TELEMETRY,
+        .data.telemetry = {.timestamp = 1700000000,
+                           .temperature = -1234,
+                           .humidity = 5678,
+                           .pressure = 101325},
+    };
+    return rec;
+}
+
+// Strip the delimiters and undo COBS; returns the raw frame length
+static size_t unframe(const uint8_t* p_frame, int len)
+{
+    size_t raw_len;
+
+    zassert_true(len >= 2, "Frame too short");
+    zassert_equal(p_frame[0], 0, "Missing leading delimiter");
+    zassert_equal(p_frame[len - 1], 0, "Missing trailing delimiter");
+    for (int i = 1; i < len - 1; i++) {
+        zassert_not_equal(p_frame[i], 0, "Zero inside frame at %d", i);
+    }
+    zassert_ok(ts_cobs_decode(&p_frame[1], len - 2, raw, sizeof(raw),
+                              &raw_len));
+    return raw_len;
+}
+
+/* --- COBS --- */
+
+ZTEST(uplink_frame, test_cobs_known_vector)
+{
+    static const uint8_t in[] = {0x11, 0x00, 0x22, 0x00, 0x00, 0x33};
+    static const uint8_t expected[] = {0x02, 0x11, 0x02, 0x22,
+                                       0x01, 0x02, 0x33};
+    uint8_t out[TS_COBS_MAX_SIZE(sizeof(in))];
+
+    zassert_equal(ts_cobs_encode(in, sizeof(in), out, sizeof(out)),
+                  sizeof(expected));
+    zassert_mem_equal(out, expected, sizeof(expected));
+}
+
+ZTEST(uplink_frame, test_cobs_empty)
+{
+    uint8_t out[1];
+    size_t len;
+
+    zassert_equal(ts_cobs_encode(NULL, 0, out, sizeof(out)), 1);
+    zassert_equal(out[0], 0x01);
+    zassert_ok(ts_cobs_decode(out, 1, raw, sizeof(raw), &len));
+    zassert_equal(len, 0);
+}
+
+ZTEST(uplink_frame, test_cobs_long_run_roundtrip)
+{
+    uint8_t in[600];
+    uint8_t out[TS_COBS_MAX_SIZE(sizeof(in))];
+    size_t len;
+
+    // Runs of non-zero bytes longer than one COBS block, with zeros
+    // right at and just after the block boundary
+    for (size_t i = 0; i < sizeof(in); i++) { in[i] = (uint8_t)(i % 255 + 1); }
+    in[254] = 0;
+    in[510] = 0;
+
+    size_t enc = ts_cobs_encode(in, sizeof(in), out, sizeof(out));
+    zassert_true(enc > 0 && enc <= sizeof(out), "Bad encoded size %zu", enc);
+    zassert_is_null(memchr(out, 0, enc), "Encoding contains a zero");
+    zassert_ok(ts_cobs_decode(out, enc, raw, sizeof(raw), &len));
+    zassert_equal(len, sizeof(in));
+    zassert_mem_equal(raw, in, sizeof(in));
+}
+
+ZTEST(uplink_frame, test_cobs_encode_too_small)
+{
+    static const uint8_t in[] = {1, 2, 3, 4};
+    uint8_t out[4];
+
+    zassert_equal(ts_cobs_encode(in, sizeof(in), out, sizeof(out)), 0);
+}
+
+ZTEST(uplink_frame, test_cobs_decode_rejects_bad_input)
+{
+    static const uint8_t zero_inside[] = {0x03, 0x11, 0x00};
+    static const uint8_t truncated[] = {0x05, 0x11, 0x22};
+    size_t len;
+
+    zassert_equal(ts_cobs_decode(zero_inside, sizeof(zero_inside), raw,
+                                 sizeof(raw), &len),
+                  -EBADMSG);
+    zassert_equal(ts_cobs_decode(truncated, sizeof(truncated), raw,
+                                 sizeof(raw), &len),
+                  -EBADMSG);
+}
+
+/* --- Frames --- */
+
+ZTEST(uplink_frame, test_frame_header_and_crc)
+{
+    records[0] = make_telemetry(7);
+    int len = ts_uplink_frame_encode(0x0304, records, 1, frame,
+                                     sizeof(frame));
+    zassert_true(len > 0, "Encode failed: %d", len);
+
+    size_t raw_len = unframe(frame, len);
+    zassert_equal(raw_len, TS_UPLINK_HEADER_SIZE +
+                               TS_UPLINK_TELEMETRY_RECORD_SIZE +
+                               TS_UPLINK_CRC_SIZE);
+    zassert_equal(raw[0], TS_UPLINK_FRAME_VERSION);
+    zassert_equal(sys_get_be16(&raw[1]), 0x0304, "Wrong seq");
+    zassert_equal(raw[3], 1, "Wrong count");
+    // CRC-16/CCITT-FALSE over the data and its own CRC leaves zero
+    zassert_equal(crc16_itu_t(0xFFFF, raw, raw_len), 0, "CRC mismatch");
+}
+
+ZTEST(uplink_frame, test_frame_telemetry_record)
+{
+    records[0] = make_telemetry(0x0A0B0C0D);
+    int len = ts_uplink_frame_encode(0, records, 1, frame, sizeof(frame));
+    unframe(frame, len);
+
+    const uint8_t* rec = &raw[TS_UPLINK_HEADER_SIZE];
+    const uint8_t* body = &rec[TS_UPLINK_RECORD_HEADER_SIZE];
+    zassert_equal(rec[0], TS_UPLINK_KIND_TELEMETRY);
+    zassert_equal(sys_get_be32(&rec[1]), 123456, "Wrong rx_ms");
+    zassert_equal(sys_get_be16(&rec[5]), 0x0102, "Wrong src");
+    zassert_equal(sys_get_be32(&rec[7]), 0x0A0B0C0D, "Wrong msg_id");
+    zassert_equal((int16_t)sys_get_be16(&rec[11]), -95, "Wrong RSSI");
+    zassert_equal((int8_t)rec[13], -3, "Wrong SNR");
+    zassert_equal(sys_get_be32(&body[0]), 1700000000, "Wrong timestamp");
+    zassert_equal((int32_t)sys_get_be32(&body[4]), -1234,
+                  "Wrong temperature");
+    zassert_equal((int32_t)sys_get_be32(&body[8]), 5678, "Wrong humidity");
+    zassert_equal((int32_t)sys_get_be32(&body[12]), 101325,
+                  "Wrong pressure");
+}
+
+ZTEST(uplink_frame, test_frame_status_record)
+{
+    struct ts_gateway_record st = make_telemetry(1);
+
+    st.type = TS_MSG_NODE_STATUS;
+    st.data.node_status = (struct ts_msg_node_status){
+        .timestamp = 100, .uptime = 3600, .status = ERROR};
+    records[0] = st;
+    records[1] = make_telemetry(2);
+
+    int len = ts_uplink_frame_encode(0, records, 2, frame, sizeof(frame));
+    size_t raw_len = unframe(frame, len);
+    zassert_equal(raw_len, TS_UPLINK_HEADER_SIZE +
+                               TS_UPLINK_STATUS_RECORD_SIZE +
+                               TS_UPLINK_TELEMETRY_RECORD_SIZE +
+                               TS_UPLINK_CRC_SIZE);
+
+    const uint8_t* body = &raw[TS_UPLINK_HEADER_SIZE +
+                               TS_UPLINK_RECORD_HEADER_SIZE];
+    zassert_equal(raw[TS_UPLINK_HEADER_SIZE], TS_UPLINK_KIND_STATUS);
+    zassert_equal(sys_get_be32(&body[4]), 3600, "Wrong uptime");
+    zassert_equal(body[8], ERROR, "Wrong status");
+    zassert_equal(raw[TS_UPLINK_HEADER_SIZE + TS_UPLINK_STATUS_RECORD_SIZE],
+                  TS_UPLINK_KIND_TELEMETRY, "Second record misplaced");
+}
+
+ZTEST(uplink_frame, test_frame_summary_record)
+{
+    struct ts_gateway_record sum = make_telemetry(1);
+
+    sum.type = TS_MSG_TELEMETRY_SUMMARY;
+    sum.data.telemetry_summary = (struct ts_msg_telemetry_summary){
+        .timestamp = 1000,
+        .duration_s = 290,
+        .count = 30,
+        .temperature_min = -150,
+        .temperature_mean = -100,
+        .temperature_max = -50,
+        .humidity_min = 4000,
+        .humidity_mean = 4100,
+        .humidity_max = 4200,
+        .pressure_min = 101000,
+        .pressure_mean = 101100,
+        .pressure_max = 101200,
+    };
+    records[0] = sum;
+
+    int len = ts_uplink_frame_encode(0, records, 1, frame, sizeof(frame));
+    size_t raw_len = unframe(frame, len);
+    zassert_equal(raw_len, TS_UPLINK_HEADER_SIZE +
+                               TS_UPLINK_SUMMARY_RECORD_SIZE +
+                               TS_UPLINK_CRC_SIZE);
+
+    const uint8_t* body = &raw[TS_UPLINK_HEADER_SIZE +
+                               TS_UPLINK_RECORD_HEADER_SIZE];
+    zassert_equal(raw[TS_UPLINK_HEADER_SIZE], TS_UPLINK_KIND_SUMMARY);
+    zassert_equal(sys_get_be32(&body[0]), 1000, "Wrong timestamp");
+    zassert_equal(sys_get_be16(&body[4]), 290, "Wrong duration");
+    zassert_equal(sys_get_be16(&body[6]), 30, "Wrong count");
+    zassert_equal((int32_t)sys_get_be32(&body[8]), -150, "Wrong min");
+    zassert_equal((int32_t)sys_get_be32(&body[12]), -50, "Wrong max");
+    zassert_equal((int32_t)sys_get_be32(&body[16]), -100, "Wrong mean");
+    zassert_equal((int32_t)sys_get_be32(&body[40]), 101100,
+                  "Wrong pressure mean");
+}
+
+ZTEST(uplink_frame, test_frame_values_record)
+{
+    struct ts_gateway_record vals = make_telemetry(1);
+
+    vals.type = TS_MSG_SENSOR_VALUES;
+    vals.data.sensor_values = (struct ts_msg_sensor_values){
+        .timestamp = 2000,
+        .count = 2,
+        .values = {{.id = 0, .value = -150}, {.id = 7, .value = 4096}},
+    };
+    records[0] = vals;
+    records[1] = make_telemetry(2);
+
+    int len = ts_uplink_frame_encode(0, records, 2, frame, sizeof(frame));
+    size_t raw_len = unframe(frame, len);
+    zassert_equal(raw_len, TS_UPLINK_HEADER_SIZE +
+                               TS_UPLINK_VALUES_RECORD_SIZE(2) +
+                               TS_UPLINK_TELEMETRY_RECORD_SIZE +
+                               TS_UPLINK_CRC_SIZE);
+
+    const uint8_t* body = &raw[TS_UPLINK_HEADER_SIZE +
+                               TS_UPLINK_RECORD_HEADER_SIZE];
+    zassert_equal(raw[TS_UPLINK_HEADER_SIZE], TS_UPLINK_KIND_VALUES);
+    zassert_equal(sys_get_be32(&body[0]), 2000, "Wrong timestamp");
+    zassert_equal(body[4], 2, "Wrong count");
+    zassert_equal(body[5], 0, "Wrong first id");
+    zassert_equal((int32_t)sys_get_be32(&body[6]), -150, "Wrong value");
+    zassert_equal(body[10], 7, "Wrong second id");
+    zassert_equal((int32_t)sys_get_be32(&body[11]), 4096, "Wrong value");
+    zassert_equal(raw[TS_UPLINK_HEADER_SIZE + TS_UPLINK_VALUES_RECORD_SIZE(2)],
+                  TS_UPLINK_KIND_TELEMETRY, "Next record misplaced");
+}
+
+ZTEST(uplink_frame, test_frame_max_records_fit)
+{
+    for (int i = 0; i < TS_UPLINK_MAX_RECORDS; i++) {
+        records[i] = make_telemetry(i);
+    }
+
+    int len = ts_uplink_frame_encode(1, records, TS_UPLINK_MAX_RECORDS,
+                                     frame, sizeof(frame));
+    zassert_true(len > 0, "Worst-case frame must fit: %d", len);
+    size_t raw_len = unframe(frame, len);
+    zassert_equal(raw[3], TS_UPLINK_MAX_RECORDS);
+    zassert_equal(crc16_itu_t(0xFFFF, raw, raw_len), 0, "CRC mismatch");
+}
+
+ZTEST(uplink_frame, test_frame_pack_matches_unstuffed_frame)
+{
+    static uint8_t packed[TS_UPLINK_PACKED_MAX_SIZE(3)];
+
+    records[0] = make_telemetry(1);
+    records[1] = make_telemetry(0x100);
+    records[2] = make_telemetry(0);
+    int len = ts_uplink_frame_encode(9, records, 3, frame, sizeof(frame));
+    size_t raw_len = unframe(frame, len);
+
+    int packed_len = ts_uplink_frame_pack(9, records, 3, packed,
+                                          sizeof(packed));
+    zassert_equal(packed_len, raw_len, "Packed length differs");
+    zassert_mem_equal(packed, raw, raw_len);
+    zassert_equal(ts_uplink_frame_pack(9, records, 3, packed, raw_len - 1),
+                  -EMSGSIZE);
+}
+
+ZTEST(uplink_frame, test_frame_errors)
+{
+    records[0] = make_telemetry(1);
+
+    zassert_equal(ts_uplink_frame_encode(0, records, 1, frame, 20),
+                  -EMSGSIZE);
+    zassert_equal(ts_uplink_frame_encode(0, records,
+                                         TS_UPLINK_MAX_RECORDS + 1, frame,
+                                         sizeof(frame)),
+                  -EINVAL);
+}
+
+ZTEST_SUITE(uplink_frame, NULL, NULL, NULL, NULL, NULL);